@@ -96,6 +96,8 @@ function(core_add_library name)
 endfunction()
 
 # Add a test library, and add sources to list for gtest integration macros
+# Optional ALLOC_SOURCES are built into the alloc-test binary instead, which
+# counts heap allocations (see xbmc/test/AllocationCounter.h)
 function(core_add_test_library name)
   if(ENABLE_STATIC_LIBS)
     add_library(${name} STATIC ${SOURCES} ${SUPPORTED_SOURCES} ${HEADERS} ${OTHERS})
@@ -109,6 +111,10 @@ function(core_add_test_library name)
     get_filename_component(src_path "${src}" ABSOLUTE)
     set(test_sources "${src_path}" ${test_sources} CACHE STRING "" FORCE)
   endforeach()
+  foreach(src IN LISTS ALLOC_SOURCES)
+    get_filename_component(src_path "${src}" ABSOLUTE)
+    set(alloc_test_sources "${src_path}" ${alloc_test_sources} CACHE STRING "" FORCE)
+  endforeach()
 endfunction()
 
 # Add an addon callback library
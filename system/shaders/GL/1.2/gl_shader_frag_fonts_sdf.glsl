@@ -0,0 +1,24 @@
+/*
+ *  Copyright (C) 2019 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#version 120
+
+uniform sampler2D m_samp0;
+varying vec4 m_cord0;
+varying vec4 m_colour;
+
+// SM_FONTS_SDF shader, glyphs are distance fields with the outline at 0.5
+void main ()
+{
+  float distance = texture2D(m_samp0, m_cord0.xy).r;
+  float width = fwidth(distance) * 0.7;
+  gl_FragColor.r   = m_colour.r;
+  gl_FragColor.g   = m_colour.g;
+  gl_FragColor.b   = m_colour.b;
+  gl_FragColor.a   = m_colour.a * smoothstep(0.5 - width, 0.5 + width, distance);
+}
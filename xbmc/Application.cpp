@@ -320,6 +320,14 @@ extern "C" void __stdcall init_emu_environ();
 extern "C" void __stdcall update_emu_environ();
 extern "C" void __stdcall cleanup_emu_environ();
 
+// publishes the player state to the tracked player infos
+static void PlayerStateChanged()
+{
+  CGUIComponent *gui = CServiceBroker::GetGUI();
+  if (gui)
+    gui->GetInfoManager().GetInfoProviders().GetPlayerInfoProvider().PlayerStateChanged();
+}
+
 //
 // Utility function used to copy files from the application bundle
 // over to the user data directory in Application Support/Kodi.
@@ -1563,7 +1571,7 @@ void CApplication::Render()
   // fresh for the next process(), or after a windowclose animation (where process()
   // isn't called)
   CGUIInfoManager& infoMgr = CServiceBroker::GetGUI()->GetInfoManager();
-  infoMgr.ResetCache();
+  infoMgr.ResetFrameCache();
   infoMgr.GetInfoProviders().GetGUIControlsInfoProvider().ResetContainerMovingCache();
 
   if (hasRendered)
@@ -2525,6 +2533,7 @@ void CApplication::Stop(int exitCode)
 {
   CLog::Log(LOGNOTICE, "Stopping player");
   m_appPlayer.ClosePlayer();
+  PlayerStateChanged();
 
   {
     // close inbound port
@@ -2961,6 +2970,7 @@ bool CApplication::PlayFile(CFileItem item, const std::string& player, bool bRes
   }
 
   m_appPlayer.OpenFile(item, options, m_ServiceManager->GetPlayerCoreFactory(), player, *this);
+  PlayerStateChanged();
   m_appPlayer.SetVolume(m_volumeLevel);
   m_appPlayer.SetMute(m_muted);
 
@@ -3023,6 +3033,7 @@ void CApplication::PlaybackCleanup()
   {
     m_stackHelper.Clear();
     m_appPlayer.ResetPlayer();
+    PlayerStateChanged();
   }
 
   if (IsEnableTestMode())
@@ -3038,6 +3049,7 @@ void CApplication::OnPlayBackEnded()
   CVariant data(CVariant::VariantTypeObject);
   data["end"] = true;
   CServiceBroker::GetAnnouncementManager()->Announce(ANNOUNCEMENT::Player, "xbmc", "OnStop", m_itemCurrentFile, data);
+  PlayerStateChanged();
 
   CGUIMessage msg(GUI_MSG_PLAYBACK_ENDED, 0, 0);
   CServiceBroker::GetGUI()->GetWindowManager().SendThreadMessage(msg);
@@ -3068,6 +3080,7 @@ void CApplication::OnPlayBackStarted(const CFileItem &file)
   m_stackHelper.OnPlayBackStarted(file);
 
   m_playerEvent.Reset();
+  PlayerStateChanged();
 
   CGUIMessage msg(GUI_MSG_PLAYBACK_STARTED, 0, 0);
   CServiceBroker::GetGUI()->GetWindowManager().SendThreadMessage(msg);
@@ -3159,6 +3172,7 @@ void CApplication::OnPlayBackStopped()
   CVariant data(CVariant::VariantTypeObject);
   data["end"] = false;
   CServiceBroker::GetAnnouncementManager()->Announce(ANNOUNCEMENT::Player, "xbmc", "OnStop", m_itemCurrentFile, data);
+  PlayerStateChanged();
 
   CGUIMessage msg(GUI_MSG_PLAYBACK_STOPPED, 0, 0);
   CServiceBroker::GetGUI()->GetWindowManager().SendThreadMessage(msg);
@@ -3241,6 +3255,7 @@ void CApplication::OnPlayBackSeekChapter(int iChapter)
 void CApplication::OnAVStarted(const CFileItem &file)
 {
   CLog::LogF(LOGDEBUG, "CApplication::OnAVStarted");
+  PlayerStateChanged();
 
   CGUIMessage msg(GUI_MSG_PLAYBACK_AVSTARTED, 0, 0);
   CServiceBroker::GetGUI()->GetWindowManager().SendThreadMessage(msg);
@@ -3256,6 +3271,7 @@ void CApplication::OnAVChange()
   CLog::LogF(LOGDEBUG, "CApplication::OnAVChange");
 
   CServiceBroker::GetGUI()->GetStereoscopicsManager().OnStreamChange();
+  PlayerStateChanged();
 
   CGUIMessage msg(GUI_MSG_PLAYBACK_AVCHANGE, 0, 0);
   CServiceBroker::GetGUI()->GetWindowManager().SendThreadMessage(msg);
@@ -3323,6 +3339,7 @@ void CApplication::StopPlaying()
     if (m_appPlayer.IsPlaying())
     {
       m_appPlayer.ClosePlayer();
+      PlayerStateChanged();
 
       // turn off visualisation window when stopping
       if ((iWin == WINDOW_VISUALISATION ||
@@ -3883,7 +3900,10 @@ bool CApplication::OnMessage(CGUIMessage& message)
     m_itemCurrentFile->Reset();
     CServiceBroker::GetGUI()->GetInfoManager().ResetCurrentItem();
     if (!CServiceBroker::GetPlaylistPlayer().PlayNext(1, true))
+    {
       m_appPlayer.ClosePlayer();
+      PlayerStateChanged();
+    }
 
     PlaybackCleanup();
 
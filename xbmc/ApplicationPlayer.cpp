@@ -957,6 +957,15 @@ bool CApplicationPlayer::RenderCaptureGetPixels(unsigned int captureId, unsigned
     return false;
 }
 
+unsigned int CApplicationPlayer::RenderCaptureStream(ICaptureStreamCallback *callback, unsigned int width, unsigned int height, unsigned int interval, const std::string &format)
+{
+  std::shared_ptr<IPlayer> player = GetInternal();
+  if (player)
+    return player->RenderCaptureStream(callback, width, height, interval, format);
+  else
+    return 0;
+}
+
 bool CApplicationPlayer::IsExternalPlaying()
 {
   std::shared_ptr<IPlayer> player = GetInternal();
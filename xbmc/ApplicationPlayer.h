@@ -65,6 +65,7 @@ public:
   void RenderCapture(unsigned int captureId, unsigned int width, unsigned int height, int flags = 0);
   void RenderCaptureRelease(unsigned int captureId);
   bool RenderCaptureGetPixels(unsigned int captureId, unsigned int millis, uint8_t *buffer, unsigned int size);
+  unsigned int RenderCaptureStream(ICaptureStreamCallback *callback, unsigned int width, unsigned int height, unsigned int interval, const std::string &format);
   bool IsExternalPlaying();
   bool IsRemotePlaying();
 
@@ -892,6 +892,30 @@ const infomap player_times[] =   {{ "seektime",         PLAYER_SEEKTIME },
 ///     @skinning_v17 **[New Infolabel]** \link Player_Process_audiobitspersample `Player.Process(audiobitspersample)`\endlink
 ///     <p>
 ///   }
+///   \table_row3{   <b>`Player.Process(timetofirstframe)`</b>,
+///                  \anchor Player_Process_timetofirstframe
+///                  _string_,
+///     @return The time in milliseconds from opening the currently playing item until playback started.
+///     <p><hr>
+///     @skinning_v18 **[New Infolabel]** \link Player_Process_timetofirstframe `Player.Process(timetofirstframe)`\endlink
+///     <p>
+///   }
+///   \table_row3{   <b>`Player.Process(videothreads)`</b>,
+///                  \anchor Player_Process_videothreads
+///                  _string_,
+///     @return The threading type (frame, slice or none) and thread count of the video decoder.
+///     <p><hr>
+///     @skinning_v18 **[New Infolabel]** \link Player_Process_videothreads `Player.Process(videothreads)`\endlink
+///     <p>
+///   }
+///   \table_row3{   <b>`Player.Process(videodropped)`</b>,
+///                  \anchor Player_Process_videodropped
+///                  _string_,
+///     @return The frames dropped so far by the decoder, the deinterlacer, before output and by the renderer.
+///     <p><hr>
+///     @skinning_v18 **[New Infolabel]** \link Player_Process_videodropped `Player.Process(videodropped)`\endlink
+///     <p>
+///   }
 /// \table_end
 ///
 /// -----------------------------------------------------------------------------
@@ -909,7 +933,10 @@ const infomap player_process[] =
   { "audiodecoder", PLAYER_PROCESS_AUDIODECODER },
   { "audiochannels", PLAYER_PROCESS_AUDIOCHANNELS },
   { "audiosamplerate", PLAYER_PROCESS_AUDIOSAMPLERATE },
-  { "audiobitspersample", PLAYER_PROCESS_AUDIOBITSPERSAMPLE }
+  { "audiobitspersample", PLAYER_PROCESS_AUDIOBITSPERSAMPLE },
+  { "timetofirstframe", PLAYER_PROCESS_TIMETOFIRSTFRAME },
+  { "videothreads", PLAYER_PROCESS_VIDEOTHREADS },
+  { "videodropped", PLAYER_PROCESS_VIDEODROPPED }
 };
 
 /// \page modules__infolabels_boolean_conditions
@@ -9233,9 +9260,9 @@ INFO::InfoPtr CGUIInfoManager::Register(const std::string &expression, int conte
   std::pair<INFOBOOLTYPE::iterator, bool> res;
 
   if (condition.find_first_of("|+[]!") != condition.npos)
-    res = m_bools.insert(std::make_shared<InfoExpression>(condition, context, m_refreshCounter));
+    res = m_bools.insert(std::make_shared<InfoExpression>(condition, context, m_refreshCounter, m_evaluations));
   else
-    res = m_bools.insert(std::make_shared<InfoSingle>(condition, context, m_refreshCounter));
+    res = m_bools.insert(std::make_shared<InfoSingle>(condition, context, m_refreshCounter, m_evaluations));
 
   if (res.second)
     res.first->get()->Initialize();
@@ -9280,6 +9307,20 @@ bool CGUIInfoManager::GetBool(int condition1, int contextWindow, const CGUIListI
   return (condition1 < 0) ? !bReturn : bReturn;
 }
 
+void CGUIInfoManager::GetInfoVersions(int condition, INFO::InfoVersions &versions) const
+{
+  int info = std::abs(condition);
+  if (info >= MULTI_INFO_START && info <= MULTI_INFO_END)
+    info = std::abs(m_multiInfo[info - MULTI_INFO_START].m_info);
+
+  const INFO::InfoVersion *version = m_infoProviders.GetInfoVersion(info);
+  if (version)
+  {
+    versions.push_back(&m_infoProviders.GetResetVersion());
+    versions.push_back(version);
+  }
+}
+
 bool CGUIInfoManager::GetMultiInfoBool(const CGUIInfo &info, int contextWindow, const CGUIListItem *item)
 {
   bool bReturn = false;
@@ -9804,8 +9845,18 @@ bool CGUIInfoManager::GetItemBool(const CGUIListItem *item, int contextWindow, i
 
 void CGUIInfoManager::ResetCache()
 {
-  // mark our infobools as dirty
+  // mark all our infobools as dirty, including the tracked ones
+  CSingleLock lock(m_critInfo);
+  m_infoProviders.InfosChanged();
+  ++m_refreshCounter;
+}
+
+void CGUIInfoManager::ResetFrameCache()
+{
+  // mark our infobools as dirty, tracked ones only update if their infos changed
   CSingleLock lock(m_critInfo);
+  m_frameEvaluations = m_evaluations;
+  m_evaluations = 0;
   ++m_refreshCounter;
 }
 
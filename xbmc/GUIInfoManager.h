@@ -60,8 +60,21 @@ public:
   void Initialize();
 
   void Clear();
+
+  /*! \brief Mark all info bools as dirty, they are re-evaluated when used the next time
+   */
   void ResetCache();
 
+  /*! \brief Start a new frame, marking the info bools as dirty that may have changed since the previous one
+   Tracked info bools are only re-evaluated if one of the infos they depend on published a change.
+   \sa KODI::GUILIB::GUIINFO::IGUIInfoProvider::GetTrackedInfos
+   */
+  void ResetFrameCache();
+
+  /*! \brief Get the number of info bools evaluated during the previous frame
+   */
+  unsigned int GetFrameEvaluations() const { return m_frameEvaluations; }
+
   // KODI::MESSAGING::IMessageTarget implementation
   int GetMessageMask() override;
   void OnApplicationMessage(KODI::MESSAGING::ThreadMessage* pMsg) override;
@@ -97,6 +110,12 @@ public:
   bool GetInt(int &value, int info, int contextWindow = 0, const CGUIListItem *item = nullptr) const;
   bool GetBool(int condition, int contextWindow = 0, const CGUIListItem *item = nullptr);
 
+  /*! \brief Get the version counters of a condition if its value is tracked by the info providers
+   \param condition the condition as returned by TranslateSingleString
+   \param versions the counters are appended, nothing is appended if the condition isn't tracked
+   */
+  void GetInfoVersions(int condition, INFO::InfoVersions &versions) const;
+
   std::string GetItemLabel(const CFileItem *item, int contextWindow, int info, std::string *fallback = nullptr) const;
   std::string GetItemImage(const CGUIListItem *item, int contextWindow, int info, std::string *fallback = nullptr) const;
   /*! \brief Get integer value of info.
@@ -202,6 +221,8 @@ private:
   typedef std::set<INFO::InfoPtr, bool(*)(const INFO::InfoPtr&, const INFO::InfoPtr&)> INFOBOOLTYPE;
   INFOBOOLTYPE m_bools;
   unsigned int m_refreshCounter = 0;
+  unsigned int m_evaluations = 0;
+  unsigned int m_frameEvaluations = 0;
   std::vector<INFO::CSkinVariableString> m_skinVariableStrings;
 
   CCriticalSection m_critInfo;
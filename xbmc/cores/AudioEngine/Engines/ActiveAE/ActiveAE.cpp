@@ -15,6 +15,7 @@ using namespace ActiveAE;
 #include "ActiveAEStream.h"
 #include "ServiceBroker.h"
 #include "cores/AudioEngine/Interfaces/IAudioCallback.h"
+#include "cores/AudioEngine/Utils/AEKernels.h"
 #include "cores/AudioEngine/Utils/AEUtil.h"
 #include "cores/AudioEngine/Utils/AEStreamData.h"
 #include "cores/AudioEngine/Utils/AEStreamInfo.h"
@@ -29,6 +30,11 @@ using namespace ActiveAE;
 #define MAX_CACHE_LEVEL 0.4   // total cache time of stream in seconds
 #define MAX_WATER_LEVEL 0.2   // buffered time after stream stages in seconds
 #define MAX_BUFFER_TIME 0.1   // max time of a buffer in seconds
+#define WARMUP_PERIODS 100    // sink periods after configure until no buffers are allocated anymore
+
+#define LOW_LATENCY_CACHE_LEVEL 0.1   // total cache time of low latency streams in seconds
+#define LOW_LATENCY_WATER_LEVEL 0.04  // buffered time after stream stages with low latency streams
+#define LOW_LATENCY_PERIOD 0.01       // period requested from the sink with low latency streams
 
 void CEngineStats::Reset(unsigned int sampleRate, bool pcm)
 {
@@ -117,11 +123,10 @@ void CEngineStats::UpdateStream(CActiveAEStream *stream)
       }
 
       CSingleLock lock(stream->m_statsLock);
-      std::deque<CSampleBuffer*>::iterator itBuf;
-      for(itBuf=stream->m_processingSamples.begin(); itBuf!=stream->m_processingSamples.end(); ++itBuf)
+      for (auto buf : stream->m_processingSamples)
       {
         if (m_pcmOutput)
-          delay += (float)(*itBuf)->pkt->nb_samples / (*itBuf)->pkt->config.sample_rate;
+          delay += (float)buf->pkt->nb_samples / buf->pkt->config.sample_rate;
         else
           delay += m_sinkFormat.m_streamInfo.GetDuration() / 1000;
       }
@@ -203,14 +208,20 @@ float CEngineStats::GetCacheTime(CActiveAEStream *stream)
   return delay;
 }
 
-float CEngineStats::GetCacheTotal()
+float CEngineStats::GetCacheTotal(CActiveAEStream *stream) const
 {
-  return MAX_CACHE_LEVEL;
+  return stream->m_lowLatency && m_lowLatency ? LOW_LATENCY_CACHE_LEVEL : MAX_CACHE_LEVEL;
 }
 
-float CEngineStats::GetMaxDelay() const
+float CEngineStats::GetMaxDelay(CActiveAEStream *stream) const
 {
-  return MAX_CACHE_LEVEL + MAX_WATER_LEVEL + m_sinkCacheTotal;
+  return GetCacheTotal(stream) + m_maxWaterLevel + m_sinkCacheTotal;
+}
+
+void CEngineStats::SetLowLatency(bool lowLatency)
+{
+  m_lowLatency = lowLatency;
+  m_maxWaterLevel = lowLatency ? LOW_LATENCY_WATER_LEVEL : MAX_WATER_LEVEL;
 }
 
 float CEngineStats::GetWaterLevel()
@@ -268,7 +279,11 @@ CActiveAE::CActiveAE() :
   m_sinkHasVolume = false;
   m_aeGUISoundForce = false;
   m_stats.Reset(44100, true);
+  m_stats.SetLowLatency(false);
   m_streamIdGen = 0;
+  m_lowLatency = false;
+  m_warmupPeriods = 0;
+  m_bufferAllocations = 0;
 
   m_settingsHandler.reset(new CActiveAESettings(*this));
 }
@@ -296,6 +311,9 @@ void CActiveAE::Dispose()
   m_controlPort.Purge();
   m_dataPort.Purge();
   m_sink.Dispose();
+
+  // the spares of discarded pools only serve a running engine
+  CActiveAEBufferArena::Clear();
 }
 
 //-----------------------------------------------------------------------------
@@ -1131,17 +1149,34 @@ void CActiveAE::Configure(AEAudioFormat *desiredFmt)
   AEAudioFormat oldSinkRequestFormat = m_sinkRequestFormat;
 
   inputFormat = GetInputFormat(desiredFmt);
+  m_warmupPeriods = 0;
 
   m_sinkRequestFormat = inputFormat;
   ApplySettingsToFormat(m_sinkRequestFormat, m_settings, (int*)&m_mode);
   m_extKeepConfig = 0;
 
+  // low latency streams shorten the period of the sink, it has to be opened again
+  bool lowLatency = false;
+  if (m_settings.lowlatency && m_sinkRequestFormat.m_dataFormat != AE_FMT_RAW)
+  {
+    for (auto stream : m_streams)
+      lowLatency |= stream->m_lowLatency;
+  }
+  bool latencyChanged = lowLatency != m_lowLatency;
+  if (latencyChanged)
+  {
+    CLog::Log(LOGINFO, "ActiveAE::%s - low latency mode %s", __FUNCTION__, lowLatency ? "on" : "off");
+    m_lowLatency = lowLatency;
+  }
+  m_stats.SetLowLatency(m_lowLatency);
+
   std::string device = (m_sinkRequestFormat.m_dataFormat == AE_FMT_RAW) ? m_settings.passthroughdevice : m_settings.device;
   std::string driver;
   CAESinkFactory::ParseDevice(device, driver);
   if ((!CompareFormat(m_sinkRequestFormat, m_sinkFormat) && !CompareFormat(m_sinkRequestFormat, oldSinkRequestFormat)) ||
       m_currDevice.compare(device) != 0 ||
-      m_settings.driver.compare(driver) != 0)
+      m_settings.driver.compare(driver) != 0 ||
+      latencyChanged)
   {
     FlushEngine();
     if (!InitSink())
@@ -1166,7 +1201,7 @@ void CActiveAE::Configure(AEAudioFormat *desiredFmt)
 
   if (m_silenceBuffers)
   {
-    m_discardBufferPools.push_back(m_silenceBuffers);
+    DiscardBufferPool(m_silenceBuffers);
     m_silenceBuffers = NULL;
   }
 
@@ -1183,7 +1218,7 @@ void CActiveAE::Configure(AEAudioFormat *desiredFmt)
     inputFormat.m_frameSize = inputFormat.m_channelLayout.Count() *
                               (CAEUtil::DataFormatToBits(inputFormat.m_dataFormat) >> 3);
     m_silenceBuffers = new CActiveAEBufferPool(inputFormat);
-    m_silenceBuffers->Create(MAX_WATER_LEVEL*1000);
+    m_silenceBuffers->Create(m_stats.GetMaxWaterLevel()*1000);
     sinkInputFormat = inputFormat;
     m_internalFormat = inputFormat;
 
@@ -1195,17 +1230,17 @@ void CActiveAE::Configure(AEAudioFormat *desiredFmt)
 
     if (m_encoderBuffers)
     {
-      m_discardBufferPools.push_back(m_encoderBuffers);
+      DiscardBufferPool(m_encoderBuffers);
       m_encoderBuffers = NULL;
     }
     if (m_vizBuffers)
     {
-      m_discardBufferPools.push_back(m_vizBuffers);
+      DiscardBufferPool(m_vizBuffers);
       m_vizBuffers = NULL;
     }
     if (m_vizBuffersInput)
     {
-      m_discardBufferPools.push_back(m_vizBuffersInput);
+      DiscardBufferPool(m_vizBuffersInput);
       m_vizBuffersInput = NULL;
     }
   }
@@ -1257,7 +1292,7 @@ void CActiveAE::Configure(AEAudioFormat *desiredFmt)
         //! @todo implement
         if (m_encoderBuffers && initSink)
         {
-          m_discardBufferPools.push_back(m_encoderBuffers);
+          DiscardBufferPool(m_encoderBuffers);
           m_encoderBuffers = NULL;
         }
         if (!m_encoderBuffers)
@@ -1305,7 +1340,8 @@ void CActiveAE::Configure(AEAudioFormat *desiredFmt)
 
         // create buffer pool
         (*it)->m_inputBuffers = new CActiveAEBufferPool((*it)->m_format);
-        (*it)->m_inputBuffers->Create(MAX_CACHE_LEVEL*1000);
+        (*it)->m_inputBuffers->Create(m_stats.GetCacheTotal(*it)*1000);
+        (*it)->m_processingSamples.reserve((*it)->m_inputBuffers->m_allSamples.size());
         (*it)->m_streamSpace = (*it)->m_format.m_frameSize * (*it)->m_format.m_frames;
 
         // if input format does not follow ffmpeg channel mask, we may need to remap channels
@@ -1314,8 +1350,8 @@ void CActiveAE::Configure(AEAudioFormat *desiredFmt)
       if (initSink && (*it)->m_processingBuffers)
       {
         (*it)->m_processingBuffers->Flush();
-        m_discardBufferPools.push_back((*it)->m_processingBuffers->GetResampleBuffers());
-        m_discardBufferPools.push_back((*it)->m_processingBuffers->GetAtempoBuffers());
+        DiscardBufferPool((*it)->m_processingBuffers->GetResampleBuffers());
+        DiscardBufferPool((*it)->m_processingBuffers->GetAtempoBuffers());
         delete (*it)->m_processingBuffers;
         (*it)->m_processingBuffers = nullptr;
       }
@@ -1323,8 +1359,9 @@ void CActiveAE::Configure(AEAudioFormat *desiredFmt)
       {
         (*it)->m_processingBuffers = new CActiveAEStreamBuffers((*it)->m_inputBuffers->m_format, outputFormat, m_settings.resampleQuality);
         (*it)->m_processingBuffers->ForceResampler((*it)->m_forceResampler);
+        (*it)->m_processingBuffers->BypassAtempo((*it)->m_lowLatency && m_lowLatency);
 
-        (*it)->m_processingBuffers->Create(MAX_CACHE_LEVEL*1000, false, m_settings.stereoupmix, m_settings.normalizelevels);
+        (*it)->m_processingBuffers->Create(m_stats.GetCacheTotal(*it)*1000, false, m_settings.stereoupmix, m_settings.normalizelevels);
       }
       if (m_mode == MODE_TRANSCODE || m_streams.size() > 1)
         (*it)->m_processingBuffers->FillBuffer();
@@ -1341,9 +1378,9 @@ void CActiveAE::Configure(AEAudioFormat *desiredFmt)
     {
       if (initSink && m_vizBuffers)
       {
-        m_discardBufferPools.push_back(m_vizBuffers);
+        DiscardBufferPool(m_vizBuffers);
         m_vizBuffers = NULL;
-        m_discardBufferPools.push_back(m_vizBuffersInput);
+        DiscardBufferPool(m_vizBuffersInput);
         m_vizBuffersInput = NULL;
       }
       if (!m_vizBuffers && !m_audioCallback.empty())
@@ -1376,13 +1413,13 @@ void CActiveAE::Configure(AEAudioFormat *desiredFmt)
       !CompareFormat(m_sinkBuffers->m_inputFormat, sinkInputFormat) ||
       m_sinkBuffers->m_format.m_frames != m_sinkFormat.m_frames))
   {
-    m_discardBufferPools.push_back(m_sinkBuffers);
+    DiscardBufferPool(m_sinkBuffers);
     m_sinkBuffers = NULL;
   }
   if (!m_sinkBuffers)
   {
     m_sinkBuffers = new CActiveAEBufferPoolResample(sinkInputFormat, m_sinkFormat, m_settings.resampleQuality);
-    m_sinkBuffers->Create(MAX_WATER_LEVEL*1000, true, false);
+    m_sinkBuffers->Create(m_stats.GetMaxWaterLevel()*1000, true, false);
   }
 
   // reset gui sounds
@@ -1403,6 +1440,9 @@ void CActiveAE::Configure(AEAudioFormat *desiredFmt)
 
   ClearDiscardedBuffers();
   m_extDrain = false;
+
+  CLog::Log(LOGDEBUG, "ActiveAE::%s - buffers allocated: %u, reused: %u", __FUNCTION__,
+            CActiveAEBufferArena::GetAllocations(), CActiveAEBufferArena::GetReused());
 }
 
 CActiveAEStream* CActiveAE::CreateStream(MsgStreamNew *streamMsg)
@@ -1447,6 +1487,10 @@ CActiveAEStream* CActiveAE::CreateStream(MsgStreamNew *streamMsg)
   if (streamMsg->options & AESTREAM_FORCE_RESAMPLE)
     stream->m_forceResampler = true;
 
+  // passthrough is paced by the frames of the bitstream, it keeps normal buffering
+  if ((streamMsg->options & AESTREAM_LOW_LATENCY) && streamMsg->format.m_dataFormat != AE_FMT_RAW)
+    stream->m_lowLatency = true;
+
   stream->m_pClock = streamMsg->clock;
 
   m_streams.push_back(stream);
@@ -1468,12 +1512,12 @@ void CActiveAE::DiscardStream(CActiveAEStream *stream)
         (*it)->m_processingSamples.pop_front();
       }
       if ((*it)->m_inputBuffers)
-        m_discardBufferPools.push_back((*it)->m_inputBuffers);
+        DiscardBufferPool((*it)->m_inputBuffers);
       if ((*it)->m_processingBuffers)
       {
         (*it)->m_processingBuffers->Flush();
-        m_discardBufferPools.push_back((*it)->m_processingBuffers->GetResampleBuffers());
-        m_discardBufferPools.push_back((*it)->m_processingBuffers->GetAtempoBuffers());
+        DiscardBufferPool((*it)->m_processingBuffers->GetResampleBuffers());
+        DiscardBufferPool((*it)->m_processingBuffers->GetAtempoBuffers());
       }
       delete (*it)->m_processingBuffers;
       CLog::Log(LOGDEBUG, "CActiveAE::DiscardStream - audio stream deleted");
@@ -1541,6 +1585,16 @@ void CActiveAE::FlushEngine()
   m_stats.Reset(m_sinkFormat.m_sampleRate, m_mode == MODE_PCM);
 }
 
+void CActiveAE::DiscardBufferPool(CActiveAEBufferPool *pool)
+{
+  if (!pool)
+    return;
+
+  // buffers not in use can serve the pools of the new configuration
+  pool->ReleaseFreeBuffers();
+  m_discardBufferPools.push_back(pool);
+}
+
 void CActiveAE::ClearDiscardedBuffers()
 {
   auto it = m_discardBufferPools.begin();
@@ -1745,6 +1799,10 @@ bool CActiveAE::InitSink()
 {
   SinkConfig config;
   config.format = m_sinkRequestFormat;
+  // a period of 0 leaves the choice to the sink
+  config.format.m_frames = 0;
+  if (m_lowLatency)
+    config.format.m_frames = m_sinkRequestFormat.m_sampleRate * LOW_LATENCY_PERIOD;
   config.stats = &m_stats;
   config.device = (m_sinkRequestFormat.m_dataFormat == AE_FMT_RAW) ? &m_settings.passthroughdevice :
                                                                      &m_settings.device;
@@ -1877,7 +1935,7 @@ bool CActiveAE::RunStages()
       float buftime = (float)(*it)->m_inputBuffers->m_format.m_frames / (*it)->m_inputBuffers->m_format.m_sampleRate;
       if ((*it)->m_inputBuffers->m_format.m_dataFormat == AE_FMT_RAW)
         buftime = (*it)->m_inputBuffers->m_format.m_streamInfo.GetDuration() / 1000;
-      while ((time < MAX_CACHE_LEVEL || (*it)->m_streamIsBuffering) && !(*it)->m_inputBuffers->m_freeSamples.empty())
+      while ((time < m_stats.GetCacheTotal(*it) || (*it)->m_streamIsBuffering) && !(*it)->m_inputBuffers->m_freeSamples.empty())
       {
         buffer = (*it)->m_inputBuffers->GetFreeBuffer();
         (*it)->m_processingSamples.push_back(buffer);
@@ -1916,7 +1974,7 @@ bool CActiveAE::RunStages()
     }
   }
 
-  if (m_stats.GetWaterLevel() < MAX_WATER_LEVEL &&
+  if (m_stats.GetWaterLevel() < m_stats.GetMaxWaterLevel() &&
      (m_mode != MODE_TRANSCODE || (m_encoderBuffers && !m_encoderBuffers->m_freeSamples.empty())))
   {
     // calculate sync error
@@ -2066,15 +2124,7 @@ bool CActiveAE::RunStages()
 
               for(int j=0; j<out->pkt->planes; j++)
               {
-#if defined(HAVE_SSE) && defined(__SSE__)
-                CAEUtil::SSEMulArray((float*)out->pkt->data[j]+i*nb_floats, volume, nb_floats);
-#else
-                float* fbuffer = (float*) out->pkt->data[j]+i*nb_floats;
-                for (int k = 0; k < nb_floats; ++k)
-                {
-                  fbuffer[k] *= volume;
-                }
-#endif
+                CAEKernels::Mul((float*)out->pkt->data[j]+i*nb_floats, volume, nb_floats);
               }
             }
           }
@@ -2135,24 +2185,9 @@ bool CActiveAE::RunStages()
               {
                 float *dst = (float*)out->pkt->data[j]+i*nb_floats;
                 float *src = (float*)mix->pkt->data[j]+i*nb_floats;
-#if defined(HAVE_SSE) && defined(__SSE__)
-                CAEUtil::SSEMulAddArray(dst, src, volume, nb_floats);
-                for (int k = 0; k < nb_floats; ++k)
-                {
-                  if (fabs(dst[k]) > 1.0f)
-                  {
-                    needClamp = true;
-                    break;
-                  }
-                }
-#else
-                for (int k = 0; k < nb_floats; ++k)
-                {
-                  dst[k] += src[k] * volume;
-                  if (fabs(dst[k]) > 1.0f)
-                    needClamp = true;
-                }
-#endif
+                CAEKernels::MulAdd(dst, src, volume, nb_floats);
+                if (!needClamp && CAEKernels::MaxAbs(dst, nb_floats) > 1.0f)
+                  needClamp = true;
               }
             }
             mix->Return();
@@ -2167,7 +2202,7 @@ bool CActiveAE::RunStages()
         int nb_floats = out->pkt->nb_samples * out->pkt->config.channels / out->pkt->planes;
         for (int i=0; i<out->pkt->planes; i++)
         {
-          CAEUtil::ClampArray((float*)out->pkt->data[i], nb_floats);
+          CAEKernels::SoftClamp((float*)out->pkt->data[i], nb_floats);
         }
       }
 
@@ -2293,6 +2328,24 @@ bool CActiveAE::RunStages()
     m_sink.m_dataPort.SendOutMessage(CSinkDataProtocol::SAMPLE,
         &out, sizeof(CSampleBuffer*));
     busy = true;
+
+    if (m_warmupPeriods < WARMUP_PERIODS)
+    {
+      if (++m_warmupPeriods == WARMUP_PERIODS)
+        m_bufferAllocations = CActiveAEBufferArena::GetAllocations();
+    }
+  }
+
+  // once warm, processing must not allocate
+  if (m_warmupPeriods == WARMUP_PERIODS)
+  {
+    unsigned int allocations = CActiveAEBufferArena::GetAllocations();
+    if (allocations != m_bufferAllocations)
+    {
+      CLog::Log(LOGWARNING, "ActiveAE::%s - %u buffer allocations after warm-up", __FUNCTION__,
+                allocations - m_bufferAllocations);
+      m_bufferAllocations = allocations;
+    }
   }
 
   return busy;
@@ -2535,12 +2588,7 @@ void CActiveAE::MixSounds(CSoundPacket &dstSample)
       out = (float*)dstSample.data[j];
       sample_buffer = (float*)(it->sound->GetSound(false)->data[j]+start);
       int nb_floats = mix_samples * dstSample.config.channels / dstSample.planes;
-#if defined(HAVE_SSE) && defined(__SSE__)
-      CAEUtil::SSEMulAddArray(out, sample_buffer, volume, nb_floats);
-#else
-      for (int k = 0; k < nb_floats; ++k)
-        *out++ += *sample_buffer++ * volume;
-#endif
+      CAEKernels::MulAdd(out, sample_buffer, volume, nb_floats);
     }
 
     it->samples_played += mix_samples;
@@ -2565,13 +2613,7 @@ void CActiveAE::Deamplify(CSoundPacket &dstSample)
     for(int j=0; j<dstSample.planes; j++)
     {
       float* buffer = reinterpret_cast<float*>(dstSample.data[j]);
-#if defined(HAVE_SSE) && defined(__SSE__)
-      CAEUtil::SSEMulArray(buffer, volume, nb_floats);
-#else
-      float *fbuffer = buffer;
-      for (int i = 0; i < nb_floats; i++)
-        *fbuffer++ *= volume;
-#endif
+      CAEKernels::Mul(buffer, volume, nb_floats);
     }
   }
 }
@@ -2593,6 +2635,7 @@ void CActiveAE::LoadSettings()
 
   m_settings.stereoupmix = IsSettingVisible(CSettings::SETTING_AUDIOOUTPUT_STEREOUPMIX) ? settings->GetBool(CSettings::SETTING_AUDIOOUTPUT_STEREOUPMIX) : false;
   m_settings.normalizelevels = !settings->GetBool(CSettings::SETTING_AUDIOOUTPUT_MAINTAINORIGINALVOLUME);
+  m_settings.lowlatency = settings->GetBool(CSettings::SETTING_AUDIOOUTPUT_LOWLATENCY);
   m_settings.guisoundmode = settings->GetInt(CSettings::SETTING_AUDIOOUTPUT_GUISOUNDMODE);
 
   m_settings.passthrough = m_settings.config == AE_CONFIG_FIXED ? false : settings->GetBool(CSettings::SETTING_AUDIOOUTPUT_PASSTHROUGH);
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <list>
 #include <string>
 #include <vector>
@@ -53,6 +54,7 @@ struct AudioSettings
   bool dtshdpassthrough;
   bool stereoupmix;
   bool normalizelevels;
+  bool lowlatency;
   bool passthrough;
   int config;
   int guisoundmode;
@@ -183,9 +185,11 @@ public:
   void GetDelay(AEDelayStatus& status, CActiveAEStream *stream);
   void GetSyncInfo(CAESyncInfo& info, CActiveAEStream *stream);
   float GetCacheTime(CActiveAEStream *stream);
-  float GetCacheTotal();
-  float GetMaxDelay() const;
+  float GetCacheTotal(CActiveAEStream *stream) const;
+  float GetMaxDelay(CActiveAEStream *stream) const;
   float GetWaterLevel();
+  float GetMaxWaterLevel() const { return m_maxWaterLevel; }
+  void SetLowLatency(bool lowLatency);
   void SetSuspended(bool state);
   void SetCurrentSinkFormat(const AEAudioFormat& SinkFormat);
   void SetSinkCacheTotal(float time) { m_sinkCacheTotal = time; }
@@ -195,6 +199,8 @@ public:
 protected:
   float m_sinkCacheTotal;
   float m_sinkLatency;
+  std::atomic<bool> m_lowLatency;
+  std::atomic<float> m_maxWaterLevel;
   int m_bufferedSamples;
   unsigned int m_sinkSampleRate;
   AEDelayStatus m_sinkDelay;
@@ -270,8 +276,8 @@ protected:
   void GetDelay(AEDelayStatus& status, CActiveAEStream *stream) { m_stats.GetDelay(status, stream); }
   void GetSyncInfo(CAESyncInfo& info, CActiveAEStream *stream) { m_stats.GetSyncInfo(info, stream); }
   float GetCacheTime(CActiveAEStream *stream) { return m_stats.GetCacheTime(stream); }
-  float GetCacheTotal() { return m_stats.GetCacheTotal(); }
-  float GetMaxDelay() { return m_stats.GetMaxDelay(); }
+  float GetCacheTotal(CActiveAEStream *stream) { return m_stats.GetCacheTotal(stream); }
+  float GetMaxDelay(CActiveAEStream *stream) { return m_stats.GetMaxDelay(stream); }
   void FlushStream(CActiveAEStream *stream);
   void PauseStream(CActiveAEStream *stream, bool pause);
   void StopSound(CActiveAESound *sound);
@@ -300,6 +306,7 @@ protected:
   void DiscardStream(CActiveAEStream *stream);
   void SFlushStream(CActiveAEStream *stream);
   void FlushEngine();
+  void DiscardBufferPool(CActiveAEBufferPool *pool);
   void ClearDiscardedBuffers();
   void SStopSound(CActiveAESound *sound);
   void DiscardSound(CActiveAESound *sound);
@@ -360,6 +367,9 @@ protected:
   // streams
   std::list<CActiveAEStream*> m_streams;
   std::list<CActiveAEBufferPool*> m_discardBufferPools;
+  bool m_lowLatency;                  // enabled and a stream asked for low latency, sink and buffers are kept short
+  int m_warmupPeriods;                // sink periods since configure, buffers may be allocated until warm
+  unsigned int m_bufferAllocations;   // arena allocations when the engine got warm
   unsigned int m_streamIdGen;
 
   // gui sounds
@@ -11,6 +11,11 @@
 #include "ActiveAEFilter.h"
 #include "cores/AudioEngine/Utils/AEUtil.h"
 #include "cores/AudioEngine/AEResampleFactory.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
+
+#include <algorithm>
+#include <atomic>
 
 using namespace ActiveAE;
 
@@ -20,6 +25,7 @@ CSoundPacket::CSoundPacket(SampleConfig conf, int samples) : config(conf)
   max_nb_samples = samples;
   nb_samples = 0;
   pause_burst_ms = 0;
+  buffer_size = av_samples_get_buffer_size(nullptr, config.channels, samples, config.fmt, 16);
 }
 
 CSoundPacket::~CSoundPacket()
@@ -50,6 +56,162 @@ void CSampleBuffer::Return()
     pool->ReturnBuffer(this);
 }
 
+// ----------------------------------------------------------------------------------
+// Queue
+// ----------------------------------------------------------------------------------
+
+void CSampleBufferQueue::push_back(CSampleBuffer *buffer)
+{
+  if (m_size == m_ring.size())
+    reserve(m_ring.empty() ? 16 : m_ring.size() * 2);
+
+  m_ring[(m_head + m_size) % m_ring.size()] = buffer;
+  m_size++;
+}
+
+void CSampleBufferQueue::pop_front()
+{
+  m_head = (m_head + 1) % m_ring.size();
+  m_size--;
+}
+
+void CSampleBufferQueue::reserve(size_t capacity)
+{
+  if (capacity <= m_ring.size())
+    return;
+
+  std::vector<CSampleBuffer*> ring(capacity);
+  for (size_t i = 0; i < m_size; i++)
+    ring[i] = (*this)[i];
+  m_ring.swap(ring);
+  m_head = 0;
+  CActiveAEBufferArena::CountAllocation();
+}
+
+// ----------------------------------------------------------------------------------
+// Arena
+// ----------------------------------------------------------------------------------
+
+namespace
+{
+// spares beyond this are freed, oldest first
+const int MAX_SPARE_BYTES = 16 * 1024 * 1024;
+
+struct SpareBuffers
+{
+  ~SpareBuffers()
+  {
+    for (auto buffer : buffers)
+      delete buffer;
+  }
+
+  CCriticalSection lock;
+  std::deque<CSampleBuffer*> buffers;
+  int bytes = 0;
+  std::atomic<unsigned int> allocations{0};
+  std::atomic<unsigned int> reused{0};
+};
+
+SpareBuffers& GetSpares()
+{
+  static SpareBuffers spares;
+  return spares;
+}
+}
+
+CSampleBuffer* CActiveAEBufferArena::NewBuffer(const SampleConfig &config, int samples)
+{
+  SpareBuffers &spares = GetSpares();
+  int planes = av_sample_fmt_is_planar(config.fmt) ? config.channels : 1;
+  int size = av_samples_get_buffer_size(nullptr, config.channels, samples, config.fmt, 16);
+
+  CSingleLock lock(spares.lock);
+
+  // smallest spare the format fits into
+  auto best = spares.buffers.end();
+  for (auto it = spares.buffers.begin(); it != spares.buffers.end(); ++it)
+  {
+    CSoundPacket *pkt = (*it)->pkt;
+    if (size > 0 && pkt->planes == planes && pkt->buffer_size >= size &&
+        (best == spares.buffers.end() || pkt->buffer_size < (*best)->pkt->buffer_size))
+      best = it;
+  }
+
+  if (best != spares.buffers.end())
+  {
+    CSampleBuffer *buffer = *best;
+    spares.buffers.erase(best);
+    spares.bytes -= buffer->pkt->buffer_size;
+    lock.Leave();
+
+    CSoundPacket *pkt = buffer->pkt;
+    pkt->config = config;
+    av_samples_fill_arrays(pkt->data, &pkt->linesize, pkt->data[0], config.channels, samples, config.fmt, 16);
+    pkt->bytes_per_sample = av_get_bytes_per_sample(config.fmt);
+    pkt->max_nb_samples = samples;
+    pkt->nb_samples = 0;
+    pkt->pause_burst_ms = 0;
+    buffer->timestamp = 0;
+    buffer->pkt_start_offset = 0;
+    buffer->refCount = 0;
+    spares.reused++;
+    return buffer;
+  }
+  lock.Leave();
+
+  CSampleBuffer *buffer = new CSampleBuffer();
+  buffer->pkt = new CSoundPacket(config, samples);
+  spares.allocations++;
+  return buffer;
+}
+
+void CActiveAEBufferArena::RecycleBuffer(CSampleBuffer *buffer)
+{
+  SpareBuffers &spares = GetSpares();
+  buffer->pool = nullptr;
+
+  CSingleLock lock(spares.lock);
+  spares.buffers.push_back(buffer);
+  spares.bytes += buffer->pkt->buffer_size;
+  while (spares.bytes > MAX_SPARE_BYTES)
+  {
+    CSampleBuffer *oldest = spares.buffers.front();
+    spares.buffers.pop_front();
+    spares.bytes -= oldest->pkt->buffer_size;
+    delete oldest;
+  }
+}
+
+void CActiveAEBufferArena::Clear()
+{
+  SpareBuffers &spares = GetSpares();
+
+  CSingleLock lock(spares.lock);
+  for (auto buffer : spares.buffers)
+    delete buffer;
+  spares.buffers.clear();
+  spares.bytes = 0;
+}
+
+void CActiveAEBufferArena::CountAllocation()
+{
+  GetSpares().allocations++;
+}
+
+unsigned int CActiveAEBufferArena::GetAllocations()
+{
+  return GetSpares().allocations;
+}
+
+unsigned int CActiveAEBufferArena::GetReused()
+{
+  return GetSpares().reused;
+}
+
+// ----------------------------------------------------------------------------------
+// Pool
+// ----------------------------------------------------------------------------------
+
 CActiveAEBufferPool::CActiveAEBufferPool(const AEAudioFormat& format)
 {
   m_format = format;
@@ -69,7 +231,7 @@ CActiveAEBufferPool::~CActiveAEBufferPool()
   {
     buffer = m_allSamples.front();
     m_allSamples.pop_front();
-    delete buffer;
+    CActiveAEBufferArena::RecycleBuffer(buffer);
   }
 }
 
@@ -94,6 +256,17 @@ void CActiveAEBufferPool::ReturnBuffer(CSampleBuffer *buffer)
   m_freeSamples.push_back(buffer);
 }
 
+void CActiveAEBufferPool::ReleaseFreeBuffers()
+{
+  while (!m_freeSamples.empty())
+  {
+    CSampleBuffer *buffer = m_freeSamples.front();
+    m_freeSamples.pop_front();
+    m_allSamples.erase(std::find(m_allSamples.begin(), m_allSamples.end(), buffer));
+    CActiveAEBufferArena::RecycleBuffer(buffer);
+  }
+}
+
 bool CActiveAEBufferPool::Create(unsigned int totaltime)
 {
   CSampleBuffer *buffer;
@@ -114,9 +287,8 @@ bool CActiveAEBufferPool::Create(unsigned int totaltime)
   unsigned int n = 0;
   while (time < totaltime || n < 5)
   {
-    buffer = new CSampleBuffer();
+    buffer = CActiveAEBufferArena::NewBuffer(config, m_format.m_frames);
     buffer->pool = this;
-    buffer->pkt = new CSoundPacket(config, m_format.m_frames);
 
     m_allSamples.push_back(buffer);
     m_freeSamples.push_back(buffer);
@@ -155,6 +327,8 @@ CActiveAEBufferPoolResample::~CActiveAEBufferPoolResample()
 bool CActiveAEBufferPoolResample::Create(unsigned int totaltime, bool remap, bool upmix, bool normalize)
 {
   CActiveAEBufferPool::Create(totaltime);
+  m_inputSamples.reserve(m_allSamples.size());
+  m_outputSamples.reserve(m_allSamples.size());
 
   m_remap = remap;
   m_stereoUpmix = upmix;
@@ -383,19 +557,18 @@ void CActiveAEBufferPoolResample::ConfigureResampler(bool normalizelevels, bool
 float CActiveAEBufferPoolResample::GetDelay()
 {
   float delay = 0;
-  std::deque<CSampleBuffer*>::iterator itBuf;
 
   if (m_procSample)
     delay += (float)m_procSample->pkt->nb_samples / m_procSample->pkt->config.sample_rate;
 
-  for(itBuf=m_inputSamples.begin(); itBuf!=m_inputSamples.end(); ++itBuf)
+  for (auto buf : m_inputSamples)
   {
-    delay += (float)(*itBuf)->pkt->nb_samples / (*itBuf)->pkt->config.sample_rate;
+    delay += (float)buf->pkt->nb_samples / buf->pkt->config.sample_rate;
   }
 
-  for(itBuf=m_outputSamples.begin(); itBuf!=m_outputSamples.end(); ++itBuf)
+  for (auto buf : m_outputSamples)
   {
-    delay += (float)(*itBuf)->pkt->nb_samples / (*itBuf)->pkt->config.sample_rate;
+    delay += (float)buf->pkt->nb_samples / buf->pkt->config.sample_rate;
   }
 
   if (m_resampler)
@@ -480,6 +653,8 @@ CActiveAEBufferPoolAtempo::~CActiveAEBufferPoolAtempo()
 bool CActiveAEBufferPoolAtempo::Create(unsigned int totaltime)
 {
   CActiveAEBufferPool::Create(totaltime);
+  m_inputSamples.reserve(m_allSamples.size());
+  m_outputSamples.reserve(m_allSamples.size());
 
   m_pTempoFilter.reset(new CActiveAEFilter());
   m_pTempoFilter->Init(CAEUtil::GetAVSampleFormat(m_format.m_dataFormat), m_format.m_sampleRate, CAEUtil::GetAVChannelLayout(m_format.m_channelLayout));
@@ -13,6 +13,7 @@
 #include <cmath>
 #include <deque>
 #include <memory>
+#include <vector>
 
 extern "C" {
 #include "libavutil/avutil.h"
@@ -38,6 +39,7 @@ public:
   int nb_samples;                        // number of frames used
   int max_nb_samples;                    // max number of frames this packet can hold
   int pause_burst_ms;
+  int buffer_size;                       // bytes allocated for all planes
 };
 
 class CActiveAEBufferPool;
@@ -57,6 +59,58 @@ public:
   double centerMixLevel;
 };
 
+/**
+ * fifo of sample buffers, storage grows on demand and is kept when the queue
+ * drains. once the engine ran for a while, the queues don't allocate anymore
+ */
+class CSampleBufferQueue
+{
+public:
+  class iterator
+  {
+  public:
+    iterator(const CSampleBufferQueue *queue, size_t pos) : m_queue(queue), m_pos(pos) {}
+    CSampleBuffer* const& operator*() const { return m_queue->m_ring[(m_queue->m_head + m_pos) % m_queue->m_ring.size()]; }
+    iterator& operator++() { m_pos++; return *this; }
+    bool operator==(const iterator &rhs) const { return m_pos == rhs.m_pos; }
+    bool operator!=(const iterator &rhs) const { return m_pos != rhs.m_pos; }
+  private:
+    const CSampleBufferQueue *m_queue;
+    size_t m_pos;
+  };
+
+  bool empty() const { return m_size == 0; }
+  size_t size() const { return m_size; }
+  CSampleBuffer* front() const { return m_ring[m_head]; }
+  CSampleBuffer* operator[](size_t i) const { return m_ring[(m_head + i) % m_ring.size()]; }
+  iterator begin() const { return iterator(this, 0); }
+  iterator end() const { return iterator(this, m_size); }
+  void push_back(CSampleBuffer *buffer);
+  void pop_front();
+  void reserve(size_t capacity);
+
+private:
+  std::vector<CSampleBuffer*> m_ring;
+  size_t m_head = 0;
+  size_t m_size = 0;
+};
+
+/**
+ * spare sample buffers of deleted pools, handed out again to pools of a
+ * format that fits into them. counts every allocation of buffer memory, the
+ * engine uses this to verify that it stopped allocating after warm-up
+ */
+class CActiveAEBufferArena
+{
+public:
+  static CSampleBuffer* NewBuffer(const SampleConfig &config, int samples);
+  static void RecycleBuffer(CSampleBuffer *buffer);
+  static void Clear();
+  static void CountAllocation();
+  static unsigned int GetAllocations();
+  static unsigned int GetReused();
+};
+
 class CActiveAEBufferPool
 {
 public:
@@ -65,9 +119,10 @@ public:
   virtual bool Create(unsigned int totaltime);
   CSampleBuffer *GetFreeBuffer();
   void ReturnBuffer(CSampleBuffer *buffer);
+  void ReleaseFreeBuffers();
   AEAudioFormat m_format;
   std::deque<CSampleBuffer*> m_allSamples;
-  std::deque<CSampleBuffer*> m_freeSamples;
+  CSampleBufferQueue m_freeSamples;
 };
 
 class IAEResample;
@@ -90,8 +145,8 @@ public:
   bool DoesNormalize() const;
   void ForceResampler(bool force);
   AEAudioFormat m_inputFormat;
-  std::deque<CSampleBuffer*> m_inputSamples;
-  std::deque<CSampleBuffer*> m_outputSamples;
+  CSampleBufferQueue m_inputSamples;
+  CSampleBufferQueue m_outputSamples;
 
 protected:
   void ChangeResampler();
@@ -128,8 +183,8 @@ public:
   float GetTempo() const;
   void FillBuffer();
   void SetDrain(bool drain);
-  std::deque<CSampleBuffer*> m_inputSamples;
-  std::deque<CSampleBuffer*> m_outputSamples;
+  CSampleBufferQueue m_inputSamples;
+  CSampleBufferQueue m_outputSamples;
 
 protected:
   void ChangeFilter();
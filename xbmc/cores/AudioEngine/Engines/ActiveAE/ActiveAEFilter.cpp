@@ -26,6 +26,7 @@ CActiveAEFilter::CActiveAEFilter()
   m_pFilterGraph = nullptr;
   m_pFilterCtxIn = nullptr;
   m_pFilterCtxOut = nullptr;
+  m_pInFrame = nullptr;
   m_pOutFrame = nullptr;
   m_pConvertCtx = nullptr;
   m_pConvertFrame = nullptr;
@@ -104,6 +105,7 @@ bool CActiveAEFilter::CreateFilterGraph()
     return false;
   }
 
+  m_pInFrame = av_frame_alloc();
   m_pOutFrame = av_frame_alloc();
 
   return true;
@@ -171,6 +173,9 @@ void CActiveAEFilter::CloseFilter()
     m_pFilterCtxOut = nullptr;
   }
 
+  if (m_pInFrame)
+    av_frame_free(&m_pInFrame);
+
   if (m_pOutFrame)
     av_frame_free(&m_pOutFrame);
 
@@ -200,7 +205,8 @@ int CActiveAEFilter::ProcessFilter(uint8_t **dst_buffer, int dst_samples, uint8_
 
   if (src_samples)
   {
-    AVFrame *frame = av_frame_alloc();
+    // the frame only describes the source buffer, reuse it for all packets
+    AVFrame *frame = m_pInFrame;
     if (!frame)
       return -1;
 
@@ -218,13 +224,13 @@ int CActiveAEFilter::ProcessFilter(uint8_t **dst_buffer, int dst_samples, uint8_
                              src_buffer[0], src_bufsize, 16);
     if (result < 0)
     {
-      av_frame_free(&frame);
+      av_frame_unref(frame);
       CLog::Log(LOGERROR, "CActiveAEFilter::ProcessFilter - avcodec_fill_audio_frame failed");
       return -1;
     }
 
     result = av_buffersrc_write_frame(m_pFilterCtxIn, frame);
-    av_frame_free(&frame);
+    av_frame_unref(frame);
     if (result < 0)
     {
       CLog::Log(LOGERROR, "CActiveAEFilter::ProcessFilter - av_buffersrc_add_frame failed");
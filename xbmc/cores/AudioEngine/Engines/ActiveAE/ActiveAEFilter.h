@@ -43,6 +43,7 @@ protected:
   AVFilterContext* m_pFilterCtxIn;
   AVFilterContext* m_pFilterCtxOut;
   AVFilterContext* m_pFilterCtxAtempo;
+  AVFrame* m_pInFrame;
   AVFrame* m_pOutFrame;
   SwrContext* m_pConvertCtx;
   AVFrame* m_pConvertFrame;
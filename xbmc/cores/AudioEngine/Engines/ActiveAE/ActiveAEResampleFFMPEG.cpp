@@ -6,6 +6,7 @@
  *  See LICENSES/README.md for more information.
  */
 
+#include "cores/AudioEngine/Utils/AEKernels.h"
 #include "cores/AudioEngine/Utils/AEUtil.h"
 #include "ActiveAEResampleFFMPEG.h"
 #include "utils/log.h"
@@ -18,6 +19,31 @@ extern "C" {
 
 using namespace ActiveAE;
 
+namespace
+{
+// the formats CAEKernels::Convert knows, swresample converts the others
+AEDataFormat GetKernelFormat(AVSampleFormat format)
+{
+  switch (format)
+  {
+    case AV_SAMPLE_FMT_S16:
+      return AE_FMT_S16NE;
+    case AV_SAMPLE_FMT_S16P:
+      return AE_FMT_S16NEP;
+    case AV_SAMPLE_FMT_S32:
+      return AE_FMT_S32NE;
+    case AV_SAMPLE_FMT_S32P:
+      return AE_FMT_S32NEP;
+    case AV_SAMPLE_FMT_FLT:
+      return AE_FMT_FLOAT;
+    case AV_SAMPLE_FMT_FLTP:
+      return AE_FMT_FLOATP;
+    default:
+      return AE_FMT_INVALID;
+  }
+}
+}
+
 CActiveAEResampleFFMPEG::CActiveAEResampleFFMPEG()
 {
   m_pContext = NULL;
@@ -53,6 +79,13 @@ bool CActiveAEResampleFFMPEG::Init(SampleConfig dstConfig, SampleConfig srcConfi
   if (m_src_chan_layout == 0)
     m_src_chan_layout = av_get_default_channel_layout(m_src_channels);
 
+  // without resampling and remixing only the sample format changes. A stream that
+  // is going to be resampled for sync uses swresample from the start.
+  m_direct_src_fmt = GetKernelFormat(m_src_fmt);
+  m_direct_dst_fmt = GetKernelFormat(m_dst_fmt);
+  m_direct = !m_doesResample && !force_resample && m_src_channels == m_dst_channels &&
+             CAEKernels::CanConvert(m_direct_dst_fmt, m_direct_src_fmt);
+
   m_pContext = swr_alloc_set_opts(NULL, m_dst_chan_layout, m_dst_fmt, m_dst_rate,
                                                         m_src_chan_layout, m_src_fmt, m_src_rate,
                                                         0, NULL);
@@ -111,6 +144,8 @@ bool CActiveAEResampleFFMPEG::Init(SampleConfig dstConfig, SampleConfig srcConfi
       {
         m_rematrix[out][idx] = 1.0;
       }
+      if (idx != static_cast<int>(out))
+        m_direct = false;
     }
 
     av_opt_set_int(m_pContext, "out_channel_count", m_dst_channels, 0);
@@ -125,6 +160,7 @@ bool CActiveAEResampleFFMPEG::Init(SampleConfig dstConfig, SampleConfig srcConfi
   // stereo upmix
   else if (upmix && m_src_channels == 2 && m_dst_channels > 2)
   {
+    m_direct = false;
     memset(m_rematrix, 0, sizeof(m_rematrix));
     for (int out=0; out<m_dst_channels; out++)
     {
@@ -161,6 +197,9 @@ bool CActiveAEResampleFFMPEG::Init(SampleConfig dstConfig, SampleConfig srcConfi
     }
   }
 
+  else if (m_src_chan_layout != m_dst_chan_layout)
+    m_direct = false;
+
   if(swr_init(m_pContext) < 0)
   {
     CLog::Log(LOGERROR, "CActiveAEResampleFFMPEG::Init - init resampler failed");
@@ -180,21 +219,35 @@ int CActiveAEResampleFFMPEG::Resample(uint8_t **dst_buffer, int dst_samples, uin
     m_doesResample = true;
   }
 
-  if (m_doesResample)
+  // swresample keeps what doesn't fit, once it holds samples it has to go on
+  if (m_direct && (m_doesResample || dst_samples < src_samples))
+    m_direct = false;
+
+  int ret;
+  if (m_direct)
   {
-    if (swr_set_compensation(m_pContext, delta, distance) < 0)
+    if (src_samples > 0)
+      CAEKernels::Convert(dst_buffer, m_direct_dst_fmt, src_buffer, m_direct_src_fmt, m_src_channels, src_samples, m_scratch);
+    ret = src_samples;
+  }
+  else
+  {
+    if (m_doesResample)
     {
-      CLog::Log(LOGERROR, "CActiveAEResampleFFMPEG::Resample - set compensation failed");
-      return -1;
+      if (swr_set_compensation(m_pContext, delta, distance) < 0)
+      {
+        CLog::Log(LOGERROR, "CActiveAEResampleFFMPEG::Resample - set compensation failed");
+        return -1;
+      }
     }
-  }
 
-  //! @bug libavresample isn't const correct
-  int ret = swr_convert(m_pContext, dst_buffer, dst_samples, const_cast<const uint8_t**>(src_buffer), src_samples);
-  if (ret < 0)
-  {
-    CLog::Log(LOGERROR, "CActiveAEResampleFFMPEG::Resample - resample failed");
-    return -1;
+    //! @bug libavresample isn't const correct
+    ret = swr_convert(m_pContext, dst_buffer, dst_samples, const_cast<const uint8_t**>(src_buffer), src_samples);
+    if (ret < 0)
+    {
+      CLog::Log(LOGERROR, "CActiveAEResampleFFMPEG::Resample - resample failed");
+      return -1;
+    }
   }
 
   // special handling for S24 formats which are carried in S32
@@ -205,22 +258,9 @@ int CActiveAEResampleFFMPEG::Resample(uint8_t **dst_buffer, int dst_samples, uin
     {
       int planes = av_sample_fmt_is_planar(m_dst_fmt) ? m_dst_channels : 1;
       int samples = ret * m_dst_channels / planes;
-      uint8_t *src, *dst;
       for (int i=0; i<planes; i++)
       {
-        src = dst = dst_buffer[i];
-        for (int j=0; j<samples; j++)
-        {
-#ifndef WORDS_BIGENDIAN
-          src++;
-#endif
-          *dst++ = *src++;
-          *dst++ = *src++;
-          *dst++ = *src++;
-#ifdef WORDS_BIGENDIAN
-          src++;
-#endif
-        }
+        CAEKernels::S32ToS24NE3(dst_buffer[i], reinterpret_cast<int32_t*>(dst_buffer[i]), samples);
       }
     }
     // shift bits if destination format requires it, swr_resamples aligns to the left
@@ -238,12 +278,7 @@ int CActiveAEResampleFFMPEG::Resample(uint8_t **dst_buffer, int dst_samples, uin
       int samples = ret * m_dst_channels / planes;
       for (int i=0; i<planes; i++)
       {
-        uint32_t* buf = (uint32_t*)dst_buffer[i];
-        for (int j=0; j<samples; j++)
-        {
-          *buf = *buf >> (32 - m_dst_bits - m_dst_dither_bits);
-          buf++;
-        }
+        CAEKernels::S32ToS24NE4(reinterpret_cast<uint32_t*>(dst_buffer[i]), 32 - m_dst_bits - m_dst_dither_bits, samples);
       }
     }
   }
@@ -12,6 +12,8 @@
 #include "cores/AudioEngine/Interfaces/AE.h"
 #include "cores/AudioEngine/Interfaces/AEResample.h"
 
+#include <vector>
+
 extern "C" {
 #include "libavutil/samplefmt.h"
 }
@@ -48,6 +50,12 @@ protected:
   int m_src_dither_bits, m_dst_dither_bits;
   SwrContext *m_pContext;
   double m_rematrix[AE_CH_MAX][AE_CH_MAX];
+
+  // only the sample format changes, converted by CAEKernels until swresample is needed
+  bool m_direct = false;
+  AEDataFormat m_direct_src_fmt = AE_FMT_INVALID;
+  AEDataFormat m_direct_dst_fmt = AE_FMT_INVALID;
+  std::vector<float> m_scratch;
 };
 
 }
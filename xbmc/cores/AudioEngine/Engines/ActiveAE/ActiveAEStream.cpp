@@ -40,6 +40,7 @@ CActiveAEStream::CActiveAEStream(AEAudioFormat *format, unsigned int streamid, C
   m_leftoverBuffer = new uint8_t[m_format.m_frameSize];
   m_leftoverBytes = 0;
   m_forceResampler = false;
+  m_lowLatency = false;
   m_remapper = NULL;
   m_remapBuffer = NULL;
   m_streamResampleRatio = 1.0;
@@ -372,12 +373,12 @@ double CActiveAEStream::GetCacheTime()
 
 double CActiveAEStream::GetCacheTotal()
 {
-  return m_activeAE->GetCacheTotal();
+  return m_activeAE->GetCacheTotal(this);
 }
 
 double CActiveAEStream::GetMaxDelay()
 {
-  return m_activeAE->GetMaxDelay();
+  return m_activeAE->GetMaxDelay(this);
 }
 
 void CActiveAEStream::Pause()
@@ -587,6 +588,7 @@ CActiveAEStreamBuffers::CActiveAEStreamBuffers(const AEAudioFormat& inputFormat,
   m_inputFormat = inputFormat;
   m_resampleBuffers = new CActiveAEBufferPoolResample(inputFormat, outputFormat, quality);
   m_atempoBuffers = new CActiveAEBufferPoolAtempo(outputFormat);
+  m_bypassAtempo = false;
 }
 
 CActiveAEStreamBuffers::~CActiveAEStreamBuffers()
@@ -612,6 +614,9 @@ bool CActiveAEStreamBuffers::Create(unsigned int totaltime, bool remap, bool upm
   if (!m_atempoBuffers->Create(totaltime))
     return false;
 
+  m_inputSamples.reserve(m_resampleBuffers->m_allSamples.size());
+  m_outputSamples.reserve(m_atempoBuffers->m_allSamples.size());
+
   return true;
 }
 
@@ -635,11 +640,13 @@ bool CActiveAEStreamBuffers::ProcessBuffers()
 
   busy |= m_resampleBuffers->ResampleBuffers();
 
+  // low latency streams skip the filter graph of atempo, its queue adds delay
+  CSampleBufferQueue &resampled = m_bypassAtempo ? m_outputSamples : m_atempoBuffers->m_inputSamples;
   while (!m_resampleBuffers->m_outputSamples.empty())
   {
     buf = m_resampleBuffers->m_outputSamples.front();
     m_resampleBuffers->m_outputSamples.pop_front();
-    m_atempoBuffers->m_inputSamples.push_back(buf);
+    resampled.push_back(buf);
     busy = true;
   }
 
@@ -719,7 +726,7 @@ bool CActiveAEStreamBuffers::IsDrained()
 
 void CActiveAEStreamBuffers::SetRR(double rr, double atempoThreshold)
 {
-  if (fabs(rr - 1.0) < atempoThreshold)
+  if (m_bypassAtempo || fabs(rr - 1.0) < atempoThreshold)
   {
     m_resampleBuffers->SetRR(rr);
     m_atempoBuffers->SetTempo(1.0);
@@ -754,6 +761,11 @@ void CActiveAEStreamBuffers::ForceResampler(bool force)
   m_resampleBuffers->ForceResampler(force);
 }
 
+void CActiveAEStreamBuffers::BypassAtempo(bool bypass)
+{
+  m_bypassAtempo = bypass;
+}
+
 CActiveAEBufferPool* CActiveAEStreamBuffers::GetResampleBuffers()
 {
   CActiveAEBufferPool *ret = m_resampleBuffers;
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include "cores/AudioEngine/Engines/ActiveAE/ActiveAEBuffer.h"
 #include "cores/AudioEngine/Interfaces/AEStream.h"
 #include "cores/AudioEngine/Utils/AEAudioFormat.h"
 #include "cores/AudioEngine/Utils/AELimiter.h"
@@ -105,17 +106,19 @@ public:
   void FillBuffer();
   bool DoesNormalize();
   void ForceResampler(bool force);
+  void BypassAtempo(bool bypass);
   bool HasWork();
   CActiveAEBufferPool *GetResampleBuffers();
   CActiveAEBufferPool *GetAtempoBuffers();
 
   AEAudioFormat m_inputFormat;
-  std::deque<CSampleBuffer*> m_outputSamples;
-  std::deque<CSampleBuffer*> m_inputSamples;
+  CSampleBufferQueue m_outputSamples;
+  CSampleBufferQueue m_inputSamples;
 
 protected:
   CActiveAEBufferPoolResample *m_resampleBuffers;
   CActiveAEBufferPoolAtempo *m_atempoBuffers;
+  bool m_bypassAtempo;
 
 private:
   CActiveAEStreamBuffers(const CActiveAEStreamBuffers&) = delete;
@@ -210,7 +213,7 @@ protected:
   // only accessed by engine
   CActiveAEBufferPool *m_inputBuffers;
   CActiveAEStreamBuffers *m_processingBuffers;
-  std::deque<CSampleBuffer*> m_processingSamples;
+  CSampleBufferQueue m_processingSamples;
   CActiveAEDataProtocol *m_streamPort;
   CEvent m_inMsgEvent;
   bool m_drain;
@@ -232,6 +235,7 @@ protected:
   enum AVMatrixEncoding m_matrixEncoding;
   enum AVAudioServiceType m_audioServiceType;
   bool m_forceResampler;
+  bool m_lowLatency;
   IAEClockCallback *m_pClock;
   CSyncError m_syncError;
   double m_lastSyncError;
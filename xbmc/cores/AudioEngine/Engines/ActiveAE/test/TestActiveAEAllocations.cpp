@@ -0,0 +1,112 @@
+/*
+ *  Copyright (C) 2019 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "ServiceBroker.h"
+#include "cores/AudioEngine/AESinkFactory.h"
+#include "cores/AudioEngine/Engines/ActiveAE/ActiveAE.h"
+#include "cores/AudioEngine/Interfaces/AEStream.h"
+#include "cores/AudioEngine/Sinks/AESinkNULL.h"
+#include "settings/Settings.h"
+#include "settings/SettingsComponent.h"
+#include "test/AllocationCounter.h"
+#include "threads/SystemClock.h"
+#include "threads/Thread.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace ActiveAE;
+
+namespace
+{
+const unsigned int SRC_RATE = 44100;
+const unsigned int DST_RATE = 48000;
+
+// keeps the stream filled with a tone for the given time
+void Feed(IAEStream* stream, const std::vector<float>& source, unsigned int& offset, unsigned int millis)
+{
+  const uint8_t* data = reinterpret_cast<const uint8_t*>(source.data());
+  const unsigned int frames = source.size() / 2;
+  XbmcThreads::EndTime timer(millis);
+  while (!timer.IsTimePast())
+  {
+    const unsigned int space = stream->GetSpace() / stream->GetFrameSize();
+    const unsigned int count = std::min(space, frames - offset);
+    if (count > 0)
+      offset = (offset + stream->AddData(&data, offset, count, nullptr)) % frames;
+    XbmcThreads::ThreadSleep(5);
+  }
+}
+}
+
+// A stream resampled to the clocked null sink: after warm-up the engine and
+// sink threads must not touch the heap anymore, whatever the feeding thread
+// and the rest of the process allocate.
+TEST(TestActiveAEAllocations, SteadyState)
+{
+  const std::shared_ptr<CSettings> settings = CServiceBroker::GetSettingsComponent()->GetSettings();
+  const std::string device = settings->GetString(CSettings::SETTING_AUDIOOUTPUT_AUDIODEVICE);
+  const int config = settings->GetInt(CSettings::SETTING_AUDIOOUTPUT_CONFIG);
+  const int sampleRate = settings->GetInt(CSettings::SETTING_AUDIOOUTPUT_SAMPLERATE);
+  const int channels = settings->GetInt(CSettings::SETTING_AUDIOOUTPUT_CHANNELS);
+  ASSERT_TRUE(settings->SetString(CSettings::SETTING_AUDIOOUTPUT_AUDIODEVICE, "NULL:default"));
+  ASSERT_TRUE(settings->SetInt(CSettings::SETTING_AUDIOOUTPUT_CONFIG, AE_CONFIG_FIXED));
+  ASSERT_TRUE(settings->SetInt(CSettings::SETTING_AUDIOOUTPUT_SAMPLERATE, DST_RATE));
+  ASSERT_TRUE(settings->SetInt(CSettings::SETTING_AUDIOOUTPUT_CHANNELS, AE_CH_LAYOUT_2_0));
+
+  const bool hadSinks = AE::CAESinkFactory::HasSinks();
+  CAESinkNULL::Register();
+
+  bool fed = false;
+  unsigned int allocations = 0;
+  {
+    CActiveAE engine;
+    engine.Start();
+
+    AEAudioFormat format;
+    format.m_dataFormat = AE_FMT_FLOAT;
+    format.m_sampleRate = SRC_RATE;
+    format.m_channelLayout = AE_CH_LAYOUT_2_0;
+    format.m_frames = SRC_RATE / 50;
+    format.m_frameSize = 2 * sizeof(float);
+    IAEStream* stream = engine.MakeStream(format);
+    EXPECT_NE(nullptr, stream);
+
+    std::vector<float> source(SRC_RATE * 2);
+    for (size_t i = 0; i < source.size(); i++)
+      source[i] = 0.25f * std::sin(6.2831853f * 440 * (i / 2) / SRC_RATE);
+    unsigned int offset = 0;
+
+    if (stream)
+    {
+      // the engine counts itself warm after 100 sink periods of 20 ms
+      Feed(stream, source, offset, 3000);
+      allocations = CAllocationCounter::CountThreads({ "ActiveAE", "AESink" }, [&]()
+      {
+        Feed(stream, source, offset, 2000);
+      });
+      fed = offset > 0;
+      engine.FreeStream(stream, true);
+    }
+    engine.Shutdown();
+  }
+
+  if (!hadSinks)
+    AE::CAESinkFactory::ClearSinks();
+  settings->SetString(CSettings::SETTING_AUDIOOUTPUT_AUDIODEVICE, device);
+  settings->SetInt(CSettings::SETTING_AUDIOOUTPUT_CONFIG, config);
+  settings->SetInt(CSettings::SETTING_AUDIOOUTPUT_SAMPLERATE, sampleRate);
+  settings->SetInt(CSettings::SETTING_AUDIOOUTPUT_CHANNELS, channels);
+
+  EXPECT_TRUE(fed);
+  EXPECT_EQ(0u, allocations);
+}
@@ -0,0 +1,149 @@
+/*
+ *  Copyright (C) 2019 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/AudioEngine/Engines/ActiveAE/ActiveAEBuffer.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace ActiveAE;
+
+namespace
+{
+AEAudioFormat Format(AEDataFormat dataFormat, const CAEChannelInfo& layout, unsigned int frames)
+{
+  AEAudioFormat format;
+  format.m_dataFormat = dataFormat;
+  format.m_sampleRate = 48000;
+  format.m_channelLayout = layout;
+  format.m_frames = frames;
+  format.m_frameSize = layout.Count() * 4;
+  return format;
+}
+}
+
+TEST(TestActiveAEBuffer, Queue)
+{
+  std::vector<CSampleBuffer> buffers(100);
+  CSampleBufferQueue queue;
+  EXPECT_TRUE(queue.empty());
+
+  // wrap around a few times while growing
+  unsigned int in = 0;
+  unsigned int out = 0;
+  for (int round = 0; round < 10; round++)
+  {
+    for (int i = 0; i < 7 * round + 3; i++)
+      queue.push_back(&buffers[in++ % buffers.size()]);
+    for (int i = 0; i < 5 * round + 2; i++)
+    {
+      ASSERT_EQ(&buffers[out++ % buffers.size()], queue.front());
+      queue.pop_front();
+    }
+    ASSERT_EQ(in - out, queue.size());
+
+    unsigned int pos = out;
+    for (auto buffer : queue)
+      EXPECT_EQ(&buffers[pos++ % buffers.size()], buffer);
+    EXPECT_EQ(in, pos);
+  }
+}
+
+TEST(TestActiveAEBuffer, SteadyState)
+{
+  CActiveAEBufferPool pool(Format(AE_FMT_FLOAT, AE_CH_LAYOUT_2_0, 960));
+  ASSERT_TRUE(pool.Create(200));
+  ASSERT_GE(pool.m_allSamples.size(), 10u);
+
+  CSampleBufferQueue processing;
+  processing.reserve(pool.m_allSamples.size());
+
+  // hand out and return buffers like the engine does once it runs
+  const unsigned int allocations = CActiveAEBufferArena::GetAllocations();
+  for (int i = 0; i < 10000; i++)
+  {
+    while (!pool.m_freeSamples.empty())
+      processing.push_back(pool.GetFreeBuffer());
+    while (processing.size() > static_cast<size_t>(i % 3))
+    {
+      processing.front()->Return();
+      processing.pop_front();
+    }
+  }
+  EXPECT_EQ(allocations, CActiveAEBufferArena::GetAllocations());
+
+  while (!processing.empty())
+  {
+    processing.front()->Return();
+    processing.pop_front();
+  }
+  EXPECT_EQ(pool.m_allSamples.size(), pool.m_freeSamples.size());
+}
+
+TEST(TestActiveAEBuffer, ReuseAcrossReconfigure)
+{
+  CActiveAEBufferArena::Clear();
+  const AEAudioFormat stereo = Format(AE_FMT_FLOAT, AE_CH_LAYOUT_2_0, 960);
+  size_t count;
+  {
+    CActiveAEBufferPool pool(stereo);
+    pool.Create(200);
+    count = pool.m_allSamples.size();
+  }
+
+  // same and smaller packed formats fit into the spares of the old pool
+  unsigned int reused = CActiveAEBufferArena::GetReused();
+  {
+    CActiveAEBufferPool pool(stereo);
+    pool.Create(200);
+    EXPECT_EQ(count, pool.m_allSamples.size());
+  }
+  {
+    CActiveAEBufferPool pool(Format(AE_FMT_S16NE, AE_CH_LAYOUT_2_0, 960));
+    pool.Create(200);
+    CSampleBuffer* buffer = pool.GetFreeBuffer();
+    ASSERT_NE(nullptr, buffer);
+    EXPECT_EQ(2, buffer->pkt->bytes_per_sample);
+    EXPECT_EQ(960, buffer->pkt->max_nb_samples);
+    EXPECT_EQ(0, buffer->pkt->nb_samples);
+    buffer->Return();
+  }
+  EXPECT_EQ(reused + 2 * count, CActiveAEBufferArena::GetReused());
+
+  // planar buffers need their own planes
+  reused = CActiveAEBufferArena::GetReused();
+  {
+    CActiveAEBufferPool pool(Format(AE_FMT_FLOATP, AE_CH_LAYOUT_2_0, 960));
+    pool.Create(200);
+    CSampleBuffer* buffer = pool.GetFreeBuffer();
+    ASSERT_NE(nullptr, buffer);
+    EXPECT_EQ(2, buffer->pkt->planes);
+    EXPECT_EQ(buffer->pkt->data[0] + buffer->pkt->linesize, buffer->pkt->data[1]);
+    buffer->Return();
+  }
+  EXPECT_EQ(reused, CActiveAEBufferArena::GetReused());
+
+  // free buffers of a discarded pool serve the next one right away
+  CActiveAEBufferPool discarded(stereo);
+  discarded.Create(200);
+  CSampleBuffer* busy = discarded.GetFreeBuffer();
+  discarded.ReleaseFreeBuffers();
+  EXPECT_EQ(1u, discarded.m_allSamples.size());
+  EXPECT_TRUE(discarded.m_freeSamples.empty());
+
+  reused = CActiveAEBufferArena::GetReused();
+  {
+    CActiveAEBufferPool pool(stereo);
+    pool.Create(200);
+  }
+  EXPECT_EQ(reused + count - 1, CActiveAEBufferArena::GetReused());
+  busy->Return();
+  EXPECT_EQ(discarded.m_allSamples.size(), discarded.m_freeSamples.size());
+  CActiveAEBufferArena::Clear();
+}
@@ -0,0 +1,169 @@
+/*
+ *  Copyright (C) 2019 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "AESinkNULL.h"
+#include "cores/AudioEngine/AESinkFactory.h"
+#include "utils/TimeUtils.h"
+#include "utils/log.h"
+
+#include <chrono>
+#include <thread>
+
+namespace
+{
+// period and buffer of the simulated device
+const unsigned int PERIOD_MS = 20;
+const unsigned int PERIODS = 4;
+}
+
+void CAESinkNULL::Register()
+{
+  AE::AESinkRegEntry entry;
+  entry.sinkName = "NULL";
+  entry.createFunc = CAESinkNULL::Create;
+  entry.enumerateFunc = CAESinkNULL::EnumerateDevicesEx;
+  AE::CAESinkFactory::RegisterSink(entry);
+}
+
+IAESink* CAESinkNULL::Create(std::string &device, AEAudioFormat &desiredFormat)
+{
+  IAESink* sink = new CAESinkNULL();
+  if (sink->Initialize(desiredFormat, device))
+    return sink;
+
+  delete sink;
+  return nullptr;
+}
+
+void CAESinkNULL::EnumerateDevicesEx(AEDeviceInfoList &list, bool force)
+{
+  AddDevices(list, "Null", { AE_FMT_FLOAT, AE_FMT_S32NE, AE_FMT_S24NE4, AE_FMT_S24NE3, AE_FMT_S16NE, AE_FMT_U8 });
+}
+
+void CAESinkNULL::AddDevices(AEDeviceInfoList &list, const std::string &displayName, const AEDataFormatList &formats)
+{
+  CAEDeviceInfo info;
+  info.m_displayName = displayName;
+  info.m_deviceType = AE_DEVTYPE_PCM;
+  info.m_channels = AE_CH_LAYOUT_7_1;
+  info.m_sampleRates = { 32000, 44100, 48000, 88200, 96000, 176400, 192000 };
+  info.m_dataFormats = formats;
+  info.m_wantsIECPassthrough = false;
+
+  info.m_deviceName = "default";
+  info.m_displayNameExtra = "clocked";
+  list.push_back(info);
+
+  info.m_deviceName = "unthrottled";
+  info.m_displayNameExtra = "unthrottled";
+  list.push_back(info);
+}
+
+bool CAESinkNULL::Initialize(AEAudioFormat &format, std::string &device)
+{
+  if (format.m_dataFormat == AE_FMT_RAW)
+  {
+    CLog::Log(LOGERROR, "CAESinkNULL::Initialize - passthrough is not supported");
+    return false;
+  }
+
+  // like real devices only packed formats are accepted
+  if (format.m_dataFormat == AE_FMT_INVALID || AE_IS_PLANAR(format.m_dataFormat))
+    format.m_dataFormat = AE_FMT_FLOAT;
+  if (format.m_sampleRate == 0)
+    format.m_sampleRate = 48000;
+  if (format.m_channelLayout.Count() == 0)
+    format.m_channelLayout = AE_CH_LAYOUT_2_0;
+
+  // a shorter period requested by the engine is used like a real device would
+  unsigned int frames = format.m_sampleRate * PERIOD_MS / 1000;
+  if (format.m_frames > 0 && format.m_frames < frames)
+    frames = format.m_frames;
+
+  format.m_frameSize = format.m_channelLayout.Count() * (CAEUtil::DataFormatToBits(format.m_dataFormat) >> 3);
+  format.m_frames = frames;
+
+  m_format = format;
+  m_throttled = device != "unthrottled";
+  m_bufferFrames = format.m_frames * PERIODS;
+  m_written = 0;
+
+  CLog::Log(LOGDEBUG, "CAESinkNULL::Initialize - %s, %u Hz, %u channels, %s",
+            CAEUtil::DataFormatToStr(format.m_dataFormat), format.m_sampleRate,
+            format.m_channelLayout.Count(), m_throttled ? "clocked" : "unthrottled");
+  return true;
+}
+
+void CAESinkNULL::Deinitialize()
+{
+  m_written = 0;
+}
+
+double CAESinkNULL::GetCacheTotal()
+{
+  return m_throttled ? static_cast<double>(m_bufferFrames) / m_format.m_sampleRate : 0.0;
+}
+
+unsigned int CAESinkNULL::AddPackets(uint8_t **data, unsigned int frames, unsigned int offset)
+{
+  Consume(frames);
+  Write(data[0] + offset * m_format.m_frameSize, frames);
+  return frames;
+}
+
+void CAESinkNULL::AddPause(unsigned int millis)
+{
+  Consume(millis * m_format.m_sampleRate / 1000);
+}
+
+void CAESinkNULL::GetDelay(AEDelayStatus& status)
+{
+  status.SetDelay(static_cast<double>(GetBufferedFrames()) / m_format.m_sampleRate);
+}
+
+void CAESinkNULL::Drain()
+{
+  const int64_t buffered = GetBufferedFrames();
+  if (buffered > 0)
+    std::this_thread::sleep_for(std::chrono::microseconds(buffered * 1000000 / m_format.m_sampleRate));
+  m_written = 0;
+}
+
+void CAESinkNULL::Consume(unsigned int frames)
+{
+  if (!m_throttled)
+    return;
+
+  int64_t buffered = GetBufferedFrames();
+  while (buffered > 0 && buffered + frames > m_bufferFrames)
+  {
+    const int64_t wait = (buffered + frames - m_bufferFrames) * 1000000 / m_format.m_sampleRate;
+    std::this_thread::sleep_for(std::chrono::microseconds(wait));
+    buffered = GetBufferedFrames();
+  }
+
+  if (m_written == 0)
+    m_clockStart = CurrentHostCounter();
+  m_written += frames;
+}
+
+int64_t CAESinkNULL::GetBufferedFrames()
+{
+  if (!m_throttled || m_written == 0)
+    return 0;
+
+  const double elapsed = static_cast<double>(CurrentHostCounter() - m_clockStart) / CurrentHostFrequency();
+  const int64_t buffered = m_written - static_cast<int64_t>(elapsed * m_format.m_sampleRate);
+  if (buffered <= 0)
+  {
+    // underrun, the clock starts again with the next frames
+    m_written = 0;
+    return 0;
+  }
+  return buffered;
+}
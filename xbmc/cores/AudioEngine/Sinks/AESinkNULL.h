@@ -0,0 +1,63 @@
+/*
+ *  Copyright (C) 2019 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "cores/AudioEngine/Interfaces/AESink.h"
+#include "cores/AudioEngine/Utils/AEDeviceInfo.h"
+
+#include <stdint.h>
+
+/*!
+ * \brief Sink without an audio device, selected with KODI_AE_SINK=NULL.
+ *
+ * The device "default" consumes audio at the rate of the requested format
+ * like a real device with a small buffer, "unthrottled" consumes everything
+ * at once. Any packed PCM format is accepted as requested.
+ */
+class CAESinkNULL : public IAESink
+{
+public:
+  const char *GetName() override { return "NULL"; }
+
+  CAESinkNULL() = default;
+  ~CAESinkNULL() override = default;
+
+  static void Register();
+  static IAESink* Create(std::string &device, AEAudioFormat &desiredFormat);
+  static void EnumerateDevicesEx(AEDeviceInfoList &list, bool force = false);
+
+  bool Initialize(AEAudioFormat &format, std::string &device) override;
+  void Deinitialize() override;
+
+  double GetCacheTotal() override;
+  unsigned int AddPackets(uint8_t **data, unsigned int frames, unsigned int offset) override;
+  void AddPause(unsigned int millis) override;
+  void GetDelay(AEDelayStatus& status) override;
+  void Drain() override;
+
+protected:
+  static void AddDevices(AEDeviceInfoList &list, const std::string &displayName, const AEDataFormatList &formats);
+
+  /*!
+   * \brief Called with the frames the sink consumed, the null sink drops them
+   */
+  virtual void Write(const uint8_t *data, unsigned int frames) {}
+
+  /*!
+   * \brief Wait until the device buffer has room for frames and queue them
+   */
+  void Consume(unsigned int frames);
+  int64_t GetBufferedFrames();
+
+  AEAudioFormat m_format;
+  bool m_throttled = true;
+  unsigned int m_bufferFrames = 0; // size of the simulated device buffer
+  int64_t m_clockStart = 0; // host counter when the first buffered frame started playing
+  int64_t m_written = 0; // frames written since m_clockStart
+};
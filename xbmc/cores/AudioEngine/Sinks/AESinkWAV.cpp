@@ -0,0 +1,233 @@
+/*
+ *  Copyright (C) 2019 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "AESinkWAV.h"
+#include "cores/AudioEngine/AESinkFactory.h"
+#include "utils/EndianSwap.h"
+#include "utils/log.h"
+
+#include <cstring>
+
+namespace
+{
+const char* DEFAULT_PATH = "special://temp/kodi-audio.wav";
+const uint32_t HEADER_SIZE = 44;
+const uint32_t EXTENSIBLE_HEADER_SIZE = 68;
+
+const uint16_t WAVE_FORMAT_PCM = 1;
+const uint16_t WAVE_FORMAT_IEEE_FLOAT = 3;
+const uint16_t WAVE_FORMAT_EXTENSIBLE = 0xFFFE;
+
+// the rest of the KSDATAFORMAT_SUBTYPE guids after the format tag
+const uint8_t SUBTYPE_GUID_TAIL[] = { 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x80, 0x00,
+                                      0x00, 0xAA, 0x00, 0x38, 0x9B, 0x71 };
+
+// speaker positions of WAVE_FORMAT_EXTENSIBLE, samples of a frame are stored
+// in this order
+const struct
+{
+  AEChannel channel;
+  uint32_t mask;
+} WAVE_SPEAKERS[] =
+{
+  { AE_CH_FL, 0x1 }, { AE_CH_FR, 0x2 }, { AE_CH_FC, 0x4 }, { AE_CH_LFE, 0x8 },
+  { AE_CH_BL, 0x10 }, { AE_CH_BR, 0x20 }, { AE_CH_FLOC, 0x40 }, { AE_CH_FROC, 0x80 },
+  { AE_CH_BC, 0x100 }, { AE_CH_SL, 0x200 }, { AE_CH_SR, 0x400 }, { AE_CH_TC, 0x800 },
+  { AE_CH_TFL, 0x1000 }, { AE_CH_TFC, 0x2000 }, { AE_CH_TFR, 0x4000 }, { AE_CH_TBL, 0x8000 },
+  { AE_CH_TBC, 0x10000 }, { AE_CH_TBR, 0x20000 }
+};
+
+void PutLE16(uint8_t* out, uint16_t value)
+{
+  value = Endian_SwapLE16(value);
+  memcpy(out, &value, sizeof(value));
+}
+
+void PutLE32(uint8_t* out, uint32_t value)
+{
+  value = Endian_SwapLE32(value);
+  memcpy(out, &value, sizeof(value));
+}
+}
+
+CAESinkWAV::~CAESinkWAV()
+{
+  Deinitialize();
+}
+
+void CAESinkWAV::Register()
+{
+  AE::AESinkRegEntry entry;
+  entry.sinkName = "WAV";
+  entry.createFunc = CAESinkWAV::Create;
+  entry.enumerateFunc = CAESinkWAV::EnumerateDevicesEx;
+  AE::CAESinkFactory::RegisterSink(entry);
+}
+
+IAESink* CAESinkWAV::Create(std::string &device, AEAudioFormat &desiredFormat)
+{
+  IAESink* sink = new CAESinkWAV();
+  if (sink->Initialize(desiredFormat, device))
+    return sink;
+
+  delete sink;
+  return nullptr;
+}
+
+void CAESinkWAV::EnumerateDevicesEx(AEDeviceInfoList &list, bool force)
+{
+#ifndef WORDS_BIGENDIAN
+  AddDevices(list, "Wav file", { AE_FMT_FLOAT, AE_FMT_S32LE, AE_FMT_S16LE });
+#else
+  AddDevices(list, "Wav file", { AE_FMT_S32LE, AE_FMT_S16LE });
+#endif
+}
+
+bool CAESinkWAV::Initialize(AEAudioFormat &format, std::string &device)
+{
+  Deinitialize();
+
+  // samples are stored little endian, float only where that is native
+  switch (format.m_dataFormat)
+  {
+    case AE_FMT_S16LE:
+    case AE_FMT_S32LE:
+      break;
+    case AE_FMT_U8:
+    case AE_FMT_U8P:
+    case AE_FMT_S16BE:
+    case AE_FMT_S16NE:
+    case AE_FMT_S16NEP:
+      format.m_dataFormat = AE_FMT_S16LE;
+      break;
+#ifndef WORDS_BIGENDIAN
+    case AE_FMT_INVALID:
+    case AE_FMT_DOUBLE:
+    case AE_FMT_DOUBLEP:
+    case AE_FMT_FLOAT:
+    case AE_FMT_FLOATP:
+      format.m_dataFormat = AE_FMT_FLOAT;
+      break;
+#endif
+    case AE_FMT_RAW:
+      CLog::Log(LOGERROR, "CAESinkWAV::Initialize - passthrough is not supported");
+      return false;
+    default:
+      format.m_dataFormat = AE_FMT_S32LE;
+      break;
+  }
+
+  // more than two channels need a speaker mask, the engine remaps to its
+  // order and drops channels without a speaker position
+  if (format.m_channelLayout.Count() > 2)
+  {
+    CAEChannelInfo layout;
+    for (const auto& speaker : WAVE_SPEAKERS)
+    {
+      if (format.m_channelLayout.HasChannel(speaker.channel))
+        layout += speaker.channel;
+    }
+    format.m_channelLayout = layout;
+  }
+
+  std::string clock = device == "unthrottled" ? device : "default";
+  if (!CAESinkNULL::Initialize(format, clock))
+    return false;
+
+  const std::string path = device == "default" || device == "unthrottled" || device.empty() ? DEFAULT_PATH : device;
+  if (!m_file.OpenForWrite(path, true))
+  {
+    CLog::Log(LOGERROR, "CAESinkWAV::Initialize - failed to open %s", path.c_str());
+    return false;
+  }
+
+  m_open = true;
+  m_dataSize = 0;
+  if (!WriteHeader())
+  {
+    Deinitialize();
+    return false;
+  }
+
+  CLog::Log(LOGNOTICE, "CAESinkWAV::Initialize - writing to %s", path.c_str());
+  return true;
+}
+
+void CAESinkWAV::Deinitialize()
+{
+  if (m_open)
+  {
+    // the sizes are known now
+    if (m_file.Seek(0, SEEK_SET) == 0)
+      WriteHeader();
+    m_file.Close();
+    m_open = false;
+  }
+  CAESinkNULL::Deinitialize();
+}
+
+void CAESinkWAV::Write(const uint8_t *data, unsigned int frames)
+{
+  if (!m_open)
+    return;
+
+  const uint32_t size = frames * m_format.m_frameSize;
+  if (m_file.Write(data, size) != static_cast<ssize_t>(size))
+  {
+    CLog::Log(LOGERROR, "CAESinkWAV::Write - write failed, closing file");
+    m_file.Close();
+    m_open = false;
+    return;
+  }
+  m_dataSize += size;
+}
+
+bool CAESinkWAV::WriteHeader()
+{
+  const uint16_t channels = m_format.m_channelLayout.Count();
+  const uint16_t bits = CAEUtil::DataFormatToBits(m_format.m_dataFormat);
+  const uint16_t blockAlign = channels * bits / 8;
+  const uint16_t formatTag = m_format.m_dataFormat == AE_FMT_FLOAT ? WAVE_FORMAT_IEEE_FLOAT : WAVE_FORMAT_PCM;
+  const bool extensible = channels > 2;
+  const uint32_t headerSize = extensible ? EXTENSIBLE_HEADER_SIZE : HEADER_SIZE;
+
+  uint8_t header[EXTENSIBLE_HEADER_SIZE];
+  memcpy(header, "RIFF", 4);
+  PutLE32(header + 4, headerSize - 8 + m_dataSize);
+  memcpy(header + 8, "WAVE", 4);
+  memcpy(header + 12, "fmt ", 4);
+  PutLE32(header + 16, headerSize - 28);
+  PutLE16(header + 20, extensible ? WAVE_FORMAT_EXTENSIBLE : formatTag);
+  PutLE16(header + 22, channels);
+  PutLE32(header + 24, m_format.m_sampleRate);
+  PutLE32(header + 28, m_format.m_sampleRate * blockAlign);
+  PutLE16(header + 32, blockAlign);
+  PutLE16(header + 34, bits);
+
+  uint8_t* data = header + 36;
+  if (extensible)
+  {
+    uint32_t mask = 0;
+    for (const auto& speaker : WAVE_SPEAKERS)
+    {
+      if (m_format.m_channelLayout.HasChannel(speaker.channel))
+        mask |= speaker.mask;
+    }
+
+    PutLE16(header + 36, 22);
+    PutLE16(header + 38, bits);
+    PutLE32(header + 40, mask);
+    PutLE16(header + 44, formatTag);
+    memcpy(header + 46, SUBTYPE_GUID_TAIL, sizeof(SUBTYPE_GUID_TAIL));
+    data = header + 60;
+  }
+  memcpy(data, "data", 4);
+  PutLE32(data + 4, m_dataSize);
+
+  return m_file.Write(header, headerSize) == static_cast<ssize_t>(headerSize);
+}
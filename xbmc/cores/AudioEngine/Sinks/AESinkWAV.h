@@ -0,0 +1,46 @@
+/*
+ *  Copyright (C) 2019 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "AESinkNULL.h"
+#include "filesystem/File.h"
+
+/*!
+ * \brief Sink writing the output of the engine to a wav file, selected with
+ * KODI_AE_SINK=WAV.
+ *
+ * Clocked like the null sink. The devices "default" and "unthrottled" write to
+ * special://temp/kodi-audio.wav, any other device is used as path of the file.
+ * More than two channels are written as WAVE_FORMAT_EXTENSIBLE.
+ */
+class CAESinkWAV : public CAESinkNULL
+{
+public:
+  const char *GetName() override { return "WAV"; }
+
+  CAESinkWAV() = default;
+  ~CAESinkWAV() override;
+
+  static void Register();
+  static IAESink* Create(std::string &device, AEAudioFormat &desiredFormat);
+  static void EnumerateDevicesEx(AEDeviceInfoList &list, bool force = false);
+
+  bool Initialize(AEAudioFormat &format, std::string &device) override;
+  void Deinitialize() override;
+
+protected:
+  void Write(const uint8_t *data, unsigned int frames) override;
+
+private:
+  bool WriteHeader();
+
+  XFILE::CFile m_file;
+  bool m_open = false;
+  uint32_t m_dataSize = 0;
+};
@@ -0,0 +1,366 @@
+/*
+ *  Copyright (C) 2019 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "ServiceBroker.h"
+#include "cores/AudioEngine/AESinkFactory.h"
+#include "cores/AudioEngine/Engines/ActiveAE/ActiveAE.h"
+#include "cores/AudioEngine/Interfaces/AESound.h"
+#include "cores/AudioEngine/Interfaces/AEStream.h"
+#include "cores/AudioEngine/Sinks/AESinkNULL.h"
+#include "cores/AudioEngine/Sinks/AESinkWAV.h"
+#include "filesystem/File.h"
+#include "settings/Settings.h"
+#include "settings/SettingsComponent.h"
+#include "test/TestUtils.h"
+#include "threads/Thread.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <ctime>
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace ActiveAE;
+
+namespace
+{
+AEAudioFormat StereoFloat(unsigned int sampleRate)
+{
+  AEAudioFormat format;
+  format.m_dataFormat = AE_FMT_FLOAT;
+  format.m_sampleRate = sampleRate;
+  format.m_channelLayout = AE_CH_LAYOUT_2_0;
+  return format;
+}
+
+// feed frames of silence in periods, returns the wall clock time it took
+double Feed(IAESink& sink, const AEAudioFormat& format, unsigned int frames)
+{
+  std::vector<uint8_t> buffer(format.m_frames * format.m_frameSize);
+  uint8_t* data = buffer.data();
+
+  auto start = std::chrono::steady_clock::now();
+  for (unsigned int done = 0; done < frames; )
+  {
+    unsigned int added = sink.AddPackets(&data, std::min(format.m_frames, frames - done), 0);
+    EXPECT_GT(added, 0u);
+    if (added == 0)
+      break;
+    done += added;
+  }
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+}
+
+TEST(TestAESinkNULL, Clocked)
+{
+  CAESinkNULL sink;
+  AEAudioFormat format = StereoFloat(48000);
+  std::string device = "default";
+  ASSERT_TRUE(sink.Initialize(format, device));
+  EXPECT_EQ(8u, format.m_frameSize);
+  EXPECT_GT(format.m_frames, 0u);
+
+  // half a second only fits the buffer after most of it was played
+  const double elapsed = Feed(sink, format, 24000);
+  EXPECT_GE(elapsed + sink.GetCacheTotal(), 0.45);
+
+  AEDelayStatus status;
+  sink.GetDelay(status);
+  EXPECT_GT(status.delay, 0.0);
+  EXPECT_LE(status.delay, sink.GetCacheTotal() + 0.001);
+
+  sink.Drain();
+  sink.GetDelay(status);
+  EXPECT_EQ(0.0, status.delay);
+  sink.Deinitialize();
+}
+
+TEST(TestAESinkNULL, ShortPeriod)
+{
+  CAESinkNULL sink;
+  AEAudioFormat format = StereoFloat(48000);
+  std::string device = "default";
+
+  // low latency streams ask for 10 ms periods, the buffer keeps 4 of them
+  format.m_frames = 480;
+  ASSERT_TRUE(sink.Initialize(format, device));
+  EXPECT_EQ(480u, format.m_frames);
+  EXPECT_NEAR(0.04, sink.GetCacheTotal(), 0.001);
+
+  // longer periods than the default are not handed out
+  format = StereoFloat(48000);
+  format.m_frames = 48000;
+  ASSERT_TRUE(sink.Initialize(format, device));
+  EXPECT_EQ(960u, format.m_frames);
+  sink.Deinitialize();
+}
+
+TEST(TestAESinkNULL, Unthrottled)
+{
+  CAESinkNULL sink;
+  AEAudioFormat format = StereoFloat(48000);
+  std::string device = "unthrottled";
+  ASSERT_TRUE(sink.Initialize(format, device));
+
+  EXPECT_LT(Feed(sink, format, 48000 * 10), 1.0);
+  AEDelayStatus status;
+  sink.GetDelay(status);
+  EXPECT_EQ(0.0, status.delay);
+  sink.Deinitialize();
+}
+
+TEST(TestAESinkNULL, RejectsPassthrough)
+{
+  CAESinkNULL sink;
+  AEAudioFormat format = StereoFloat(48000);
+  format.m_dataFormat = AE_FMT_RAW;
+  std::string device = "default";
+  EXPECT_FALSE(sink.Initialize(format, device));
+
+  // planar formats are handed out packed
+  format.m_dataFormat = AE_FMT_S16NEP;
+  EXPECT_TRUE(sink.Initialize(format, device));
+  EXPECT_EQ(AE_FMT_FLOAT, format.m_dataFormat);
+}
+
+TEST(TestAESinkNULL, WavHeader)
+{
+  XFILE::CFile* tmp = XBMC_CREATETEMPFILE(".wav");
+  ASSERT_NE(nullptr, tmp);
+  std::string path = XBMC_TEMPFILEPATH(tmp);
+  tmp->Close();
+
+  {
+    CAESinkWAV sink;
+    AEAudioFormat format = StereoFloat(44100);
+    format.m_dataFormat = AE_FMT_S16NE;
+    ASSERT_TRUE(sink.Initialize(format, path));
+    EXPECT_EQ(AE_FMT_S16LE, format.m_dataFormat);
+    EXPECT_EQ(4u, format.m_frameSize);
+    Feed(sink, format, 1000);
+    sink.Deinitialize();
+  }
+
+  XFILE::CFile file;
+  ASSERT_TRUE(file.Open(path));
+  uint8_t header[44];
+  ASSERT_EQ(44, file.Read(header, sizeof(header)));
+  EXPECT_EQ(44 + 4000, file.GetLength());
+  file.Close();
+
+  auto le16 = [&header](int offset) { return header[offset] | header[offset + 1] << 8; };
+  auto le32 = [&le16](int offset) { return le16(offset) | le16(offset + 2) << 16; };
+  EXPECT_EQ(0, memcmp(header, "RIFF", 4));
+  EXPECT_EQ(36 + 4000, le32(4));
+  EXPECT_EQ(1, le16(20));
+  EXPECT_EQ(2, le16(22));
+  EXPECT_EQ(44100, le32(24));
+  EXPECT_EQ(16, le16(34));
+  EXPECT_EQ(0, memcmp(header + 36, "data", 4));
+  EXPECT_EQ(4000, le32(40));
+
+  EXPECT_TRUE(XBMC_DELETETEMPFILE(tmp));
+}
+
+TEST(TestAESinkNULL, WavHeaderExtensible)
+{
+  XFILE::CFile* tmp = XBMC_CREATETEMPFILE(".wav");
+  ASSERT_NE(nullptr, tmp);
+  std::string path = XBMC_TEMPFILEPATH(tmp);
+  tmp->Close();
+
+  {
+    CAESinkWAV sink;
+    AEAudioFormat format = StereoFloat(48000);
+    format.m_dataFormat = AE_FMT_S32NE;
+    format.m_channelLayout = AE_CH_LAYOUT_5_1;
+    ASSERT_TRUE(sink.Initialize(format, path));
+    EXPECT_EQ(6u, format.m_channelLayout.Count());
+    EXPECT_EQ(24u, format.m_frameSize);
+
+    // samples are stored in the order of the speaker mask
+    const AEChannel order[] = { AE_CH_FL, AE_CH_FR, AE_CH_FC, AE_CH_LFE, AE_CH_BL, AE_CH_BR };
+    for (unsigned int i = 0; i < 6; i++)
+      EXPECT_EQ(order[i], format.m_channelLayout[i]);
+
+    Feed(sink, format, 100);
+    sink.Deinitialize();
+  }
+
+  XFILE::CFile file;
+  ASSERT_TRUE(file.Open(path));
+  uint8_t header[68];
+  ASSERT_EQ(68, file.Read(header, sizeof(header)));
+  EXPECT_EQ(68 + 2400, file.GetLength());
+  file.Close();
+
+  auto le16 = [&header](int offset) { return header[offset] | header[offset + 1] << 8; };
+  auto le32 = [&le16](int offset) { return le16(offset) | le16(offset + 2) << 16; };
+  const uint8_t subtypePCM[] = { 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00,
+                                 0x80, 0x00, 0x00, 0xAA, 0x00, 0x38, 0x9B, 0x71 };
+  EXPECT_EQ(0, memcmp(header, "RIFF", 4));
+  EXPECT_EQ(60 + 2400, le32(4));
+  EXPECT_EQ(40, le32(16));
+  EXPECT_EQ(0xFFFE, le16(20));
+  EXPECT_EQ(6, le16(22));
+  EXPECT_EQ(48000, le32(24));
+  EXPECT_EQ(48000 * 24, le32(28));
+  EXPECT_EQ(24, le16(32));
+  EXPECT_EQ(32, le16(34));
+  EXPECT_EQ(22, le16(36));
+  EXPECT_EQ(32, le16(38));
+  EXPECT_EQ(0x3F, le32(40));
+  EXPECT_EQ(0, memcmp(header + 44, subtypePCM, sizeof(subtypePCM)));
+  EXPECT_EQ(0, memcmp(header + 60, "data", 4));
+  EXPECT_EQ(2400, le32(64));
+
+  EXPECT_TRUE(XBMC_DELETETEMPFILE(tmp));
+}
+
+// The engine mixing streams into the unthrottled null sink: the stream
+// buffers resample to the fixed sink rate, CActiveAE mixes and clamps the
+// streams, mixes a gui sound in and deamplifies for the lowered volume.
+// Measured as process cpu time per second of audio.
+TEST(TestAESinkNULL, MixBenchmark)
+{
+  const int STREAMS = 4;
+  const int SECONDS = 4;
+  const unsigned int SRC_RATE = 44100;
+  const unsigned int DST_RATE = 48000;
+
+  XFILE::CFile* tmp = XBMC_CREATETEMPFILE(".wav");
+  ASSERT_NE(nullptr, tmp);
+  std::string soundPath = XBMC_TEMPFILEPATH(tmp);
+  tmp->Close();
+
+  // a tenth of a second of a tone as gui sound
+  {
+    CAESinkWAV sink;
+    AEAudioFormat format = StereoFloat(DST_RATE);
+    format.m_dataFormat = AE_FMT_S16LE;
+    std::string device = soundPath;
+    ASSERT_TRUE(sink.Initialize(format, device));
+    std::vector<int16_t> tone(DST_RATE / 10 * 2);
+    for (size_t i = 0; i < tone.size(); i++)
+      tone[i] = static_cast<int16_t>(8000 * std::sin(6.2831853f * 880 * (i / 2) / DST_RATE));
+    uint8_t* data = reinterpret_cast<uint8_t*>(tone.data());
+    for (unsigned int done = 0; done < tone.size() / 2; )
+    {
+      uint8_t* period = data + done * format.m_frameSize;
+      unsigned int added = sink.AddPackets(&period, std::min<unsigned int>(format.m_frames, tone.size() / 2 - done), 0);
+      ASSERT_GT(added, 0u);
+      done += added;
+    }
+    sink.Deinitialize();
+  }
+
+  const std::shared_ptr<CSettings> settings = CServiceBroker::GetSettingsComponent()->GetSettings();
+  const std::string device = settings->GetString(CSettings::SETTING_AUDIOOUTPUT_AUDIODEVICE);
+  const int config = settings->GetInt(CSettings::SETTING_AUDIOOUTPUT_CONFIG);
+  const int sampleRate = settings->GetInt(CSettings::SETTING_AUDIOOUTPUT_SAMPLERATE);
+  const int channels = settings->GetInt(CSettings::SETTING_AUDIOOUTPUT_CHANNELS);
+  const int guiSoundMode = settings->GetInt(CSettings::SETTING_AUDIOOUTPUT_GUISOUNDMODE);
+  ASSERT_TRUE(settings->SetString(CSettings::SETTING_AUDIOOUTPUT_AUDIODEVICE, "NULL:unthrottled"));
+  ASSERT_TRUE(settings->SetInt(CSettings::SETTING_AUDIOOUTPUT_CONFIG, AE_CONFIG_FIXED));
+  ASSERT_TRUE(settings->SetInt(CSettings::SETTING_AUDIOOUTPUT_SAMPLERATE, DST_RATE));
+  ASSERT_TRUE(settings->SetInt(CSettings::SETTING_AUDIOOUTPUT_CHANNELS, AE_CH_LAYOUT_2_0));
+  ASSERT_TRUE(settings->SetInt(CSettings::SETTING_AUDIOOUTPUT_GUISOUNDMODE, AE_SOUND_ALWAYS));
+
+  const bool hadSinks = AE::CAESinkFactory::HasSinks();
+  CAESinkNULL::Register();
+
+  int64_t fed = 0;
+  bool drained = true;
+  double cpu = 0.0;
+  {
+    CActiveAE engine;
+    engine.Start();
+    engine.SetVolume(0.5f);
+
+    std::vector<IAEStream*> streams;
+    for (int i = 0; i < STREAMS; i++)
+    {
+      AEAudioFormat format = StereoFloat(SRC_RATE);
+      IAEStream* stream = engine.MakeStream(format);
+      if (stream)
+        streams.push_back(stream);
+    }
+    EXPECT_EQ(STREAMS, static_cast<int>(streams.size()));
+    IAESound* sound = engine.MakeSound(soundPath);
+    EXPECT_NE(nullptr, sound);
+
+    // one second of a tone per stream, added as often as needed
+    std::vector<float> source(SRC_RATE * 2);
+    for (size_t i = 0; i < source.size(); i++)
+      source[i] = 0.25f * std::sin(6.2831853f * (200 + 100 * (i % 2)) * (i / 2) / SRC_RATE);
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(source.data());
+
+    std::vector<unsigned int> added(streams.size(), 0);
+    const std::clock_t start = std::clock();
+    for (bool busy = !streams.empty(); busy; )
+    {
+      busy = false;
+      bool progress = false;
+      for (size_t i = 0; i < streams.size(); i++)
+      {
+        if (added[i] >= SECONDS * SRC_RATE)
+          continue;
+        busy = true;
+
+        const unsigned int offset = added[i] % SRC_RATE;
+        const unsigned int space = streams[i]->GetSpace() / streams[i]->GetFrameSize();
+        const unsigned int frames = std::min({ space, SRC_RATE - offset, SECONDS * SRC_RATE - added[i] });
+        if (frames == 0)
+          continue;
+        const unsigned int done = streams[i]->AddData(&data, offset, frames, nullptr);
+        added[i] += done;
+        progress |= done > 0;
+      }
+      // a gui sound every quarter of a second of the first stream
+      if (sound && !streams.empty() && added[0] % (SRC_RATE / 4) < SRC_RATE / 50 && !sound->IsPlaying())
+        sound->Play();
+      if (busy && !progress)
+        XbmcThreads::ThreadSleep(1);
+    }
+    for (auto stream : streams)
+    {
+      stream->Drain(true);
+      drained &= stream->IsDrained();
+    }
+    cpu = static_cast<double>(std::clock() - start) / CLOCKS_PER_SEC;
+
+    for (size_t i = 0; i < streams.size(); i++)
+    {
+      fed += added[i];
+      engine.FreeStream(streams[i], false);
+    }
+    if (sound)
+      engine.FreeSound(sound);
+    engine.Shutdown();
+  }
+
+  if (!hadSinks)
+    AE::CAESinkFactory::ClearSinks();
+  settings->SetString(CSettings::SETTING_AUDIOOUTPUT_AUDIODEVICE, device);
+  settings->SetInt(CSettings::SETTING_AUDIOOUTPUT_CONFIG, config);
+  settings->SetInt(CSettings::SETTING_AUDIOOUTPUT_SAMPLERATE, sampleRate);
+  settings->SetInt(CSettings::SETTING_AUDIOOUTPUT_CHANNELS, channels);
+  settings->SetInt(CSettings::SETTING_AUDIOOUTPUT_GUISOUNDMODE, guiSoundMode);
+  EXPECT_TRUE(XBMC_DELETETEMPFILE(tmp));
+
+  EXPECT_EQ(static_cast<int64_t>(STREAMS) * SECONDS * SRC_RATE, fed);
+  EXPECT_TRUE(drained);
+
+  RecordProperty("Streams", STREAMS);
+  RecordProperty("CpuMicrosecondsPerAudioSecond", static_cast<int>(cpu * 1000000 / SECONDS));
+}
@@ -0,0 +1,864 @@
+/*
+ *  Copyright (C) 2019 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "AEKernels.h"
+#include "AEAudioFormat.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define AE_KERNELS_SSE2
+#include <emmintrin.h>
+#endif
+
+// avx2 functions are built for the target of the function only and called
+// if the cpu has avx2, that needs gcc or clang
+#if defined(AE_KERNELS_SSE2) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define AE_KERNELS_AVX2
+#define AE_TARGET_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#endif
+
+#if (defined(__ARM_NEON) || defined(__ARM_NEON__)) && !defined(WORDS_BIGENDIAN)
+#define AE_KERNELS_NEON
+#include <arm_neon.h>
+#endif
+
+namespace
+{
+const float S16_SCALE = 32768.0f;
+const float S32_SCALE = 2147483648.0f;
+const float S32_MAX = 2147483520.0f; // highest float below 2^31
+
+//-----------------------------------------------------------------------------
+// Scalar, the reference for all others and used for their remainders
+//-----------------------------------------------------------------------------
+
+inline float SoftClampSample(float x)
+{
+  // rational function to approximate a tanh-like soft clipper, it is based on
+  // the pade-approximation of tanh with tweaked coefficients and reaches
+  // +-1 at +-3, see: http://www.musicdsp.org/showone.php?id=238
+  x = std::min(std::max(x, -3.0f), 3.0f);
+  const float y = x * x;
+  return x * (27.0f + y) / (27.0f + 9.0f * y);
+}
+
+void MulScalar(float *data, float mul, unsigned int count)
+{
+  for (unsigned int i = 0; i < count; i++)
+    data[i] *= mul;
+}
+
+void MulAddScalar(float *dst, const float *src, float mul, unsigned int count)
+{
+  for (unsigned int i = 0; i < count; i++)
+    dst[i] += src[i] * mul;
+}
+
+float MaxAbsScalar(const float *data, unsigned int count)
+{
+  float highest = 0.0f;
+  for (unsigned int i = 0; i < count; i++)
+    highest = std::max(highest, std::fabs(data[i]));
+  return highest;
+}
+
+void SoftClampScalar(float *data, unsigned int count)
+{
+  for (unsigned int i = 0; i < count; i++)
+    data[i] = SoftClampSample(data[i]);
+}
+
+void InterleaveFrom(float *dst, const float* const *src, unsigned int channels, unsigned int start, unsigned int frames)
+{
+  for (unsigned int i = start; i < frames; i++)
+    for (unsigned int j = 0; j < channels; j++)
+      dst[i * channels + j] = src[j][i];
+}
+
+void InterleaveScalar(float *dst, const float* const *src, unsigned int channels, unsigned int frames)
+{
+  InterleaveFrom(dst, src, channels, 0, frames);
+}
+
+void DeinterleaveFrom(float* const *dst, const float *src, unsigned int channels, unsigned int start, unsigned int frames)
+{
+  for (unsigned int i = start; i < frames; i++)
+    for (unsigned int j = 0; j < channels; j++)
+      dst[j][i] = src[i * channels + j];
+}
+
+void DeinterleaveScalar(float* const *dst, const float *src, unsigned int channels, unsigned int frames)
+{
+  DeinterleaveFrom(dst, src, channels, 0, frames);
+}
+
+void S16ToFloatScalar(float *dst, const int16_t *src, unsigned int count)
+{
+  for (unsigned int i = 0; i < count; i++)
+    dst[i] = src[i] * (1.0f / S16_SCALE);
+}
+
+void FloatToS16Scalar(int16_t *dst, const float *src, unsigned int count)
+{
+  for (unsigned int i = 0; i < count; i++)
+  {
+    const float sample = std::min(std::max(src[i] * S16_SCALE, -S16_SCALE), S16_SCALE - 1.0f);
+    dst[i] = static_cast<int16_t>(std::lrint(sample));
+  }
+}
+
+void S32ToFloatScalar(float *dst, const int32_t *src, unsigned int count)
+{
+  for (unsigned int i = 0; i < count; i++)
+    dst[i] = static_cast<float>(src[i]) * (1.0f / S32_SCALE);
+}
+
+void FloatToS32Scalar(int32_t *dst, const float *src, unsigned int count)
+{
+  for (unsigned int i = 0; i < count; i++)
+  {
+    const float sample = std::min(std::max(src[i] * S32_SCALE, -S32_SCALE), S32_MAX);
+    dst[i] = static_cast<int32_t>(std::lrint(sample));
+  }
+}
+
+void S32ToS24NE4Scalar(uint32_t *data, unsigned int shift, unsigned int count)
+{
+  for (unsigned int i = 0; i < count; i++)
+    data[i] >>= shift;
+}
+
+void S32ToS24NE3Scalar(uint8_t *dst, const int32_t *src, unsigned int count)
+{
+  // front to back, a sample is read before its bytes are overwritten
+  for (unsigned int i = 0; i < count; i++)
+  {
+    const uint32_t sample = static_cast<uint32_t>(src[i]);
+#ifndef WORDS_BIGENDIAN
+    dst[0] = sample >> 8;
+    dst[1] = sample >> 16;
+    dst[2] = sample >> 24;
+#else
+    dst[0] = sample >> 24;
+    dst[1] = sample >> 16;
+    dst[2] = sample >> 8;
+#endif
+    dst += 3;
+  }
+}
+
+const AEKernelTable scalarKernels =
+{
+  "scalar",
+  MulScalar,
+  MulAddScalar,
+  MaxAbsScalar,
+  SoftClampScalar,
+  InterleaveScalar,
+  DeinterleaveScalar,
+  S16ToFloatScalar,
+  FloatToS16Scalar,
+  S32ToFloatScalar,
+  FloatToS32Scalar,
+  S32ToS24NE4Scalar,
+  S32ToS24NE3Scalar
+};
+
+//-----------------------------------------------------------------------------
+// SSE2
+//-----------------------------------------------------------------------------
+
+#if defined(AE_KERNELS_SSE2)
+void MulSSE2(float *data, float mul, unsigned int count)
+{
+  const __m128 m = _mm_set1_ps(mul);
+  unsigned int i = 0;
+  for (; i + 4 <= count; i += 4)
+    _mm_storeu_ps(data + i, _mm_mul_ps(_mm_loadu_ps(data + i), m));
+  MulScalar(data + i, mul, count - i);
+}
+
+void MulAddSSE2(float *dst, const float *src, float mul, unsigned int count)
+{
+  const __m128 m = _mm_set1_ps(mul);
+  unsigned int i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    const __m128 add = _mm_mul_ps(_mm_loadu_ps(src + i), m);
+    _mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), add));
+  }
+  MulAddScalar(dst + i, src + i, mul, count - i);
+}
+
+float MaxAbsSSE2(const float *data, unsigned int count)
+{
+  const __m128 abs = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+  __m128 highest = _mm_setzero_ps();
+  unsigned int i = 0;
+  for (; i + 4 <= count; i += 4)
+    highest = _mm_max_ps(highest, _mm_and_ps(_mm_loadu_ps(data + i), abs));
+
+  float lanes[4];
+  _mm_storeu_ps(lanes, highest);
+  const float tail = MaxAbsScalar(data + i, count - i);
+  return std::max(std::max(std::max(lanes[0], lanes[1]), std::max(lanes[2], lanes[3])), tail);
+}
+
+void SoftClampSSE2(float *data, unsigned int count)
+{
+  const __m128 low = _mm_set1_ps(-3.0f);
+  const __m128 high = _mm_set1_ps(3.0f);
+  const __m128 c1 = _mm_set1_ps(27.0f);
+  const __m128 c2 = _mm_set1_ps(9.0f);
+  unsigned int i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    const __m128 x = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(data + i), low), high);
+    const __m128 y = _mm_mul_ps(x, x);
+    const __m128 num = _mm_mul_ps(x, _mm_add_ps(c1, y));
+    const __m128 den = _mm_add_ps(c1, _mm_mul_ps(c2, y));
+    _mm_storeu_ps(data + i, _mm_div_ps(num, den));
+  }
+  SoftClampScalar(data + i, count - i);
+}
+
+void InterleaveSSE2(float *dst, const float* const *src, unsigned int channels, unsigned int frames)
+{
+  unsigned int i = 0;
+  if (channels == 2)
+  {
+    for (; i + 4 <= frames; i += 4)
+    {
+      const __m128 left = _mm_loadu_ps(src[0] + i);
+      const __m128 right = _mm_loadu_ps(src[1] + i);
+      _mm_storeu_ps(dst + i * 2, _mm_unpacklo_ps(left, right));
+      _mm_storeu_ps(dst + i * 2 + 4, _mm_unpackhi_ps(left, right));
+    }
+  }
+  InterleaveFrom(dst, src, channels, i, frames);
+}
+
+void DeinterleaveSSE2(float* const *dst, const float *src, unsigned int channels, unsigned int frames)
+{
+  unsigned int i = 0;
+  if (channels == 2)
+  {
+    for (; i + 4 <= frames; i += 4)
+    {
+      const __m128 a = _mm_loadu_ps(src + i * 2);
+      const __m128 b = _mm_loadu_ps(src + i * 2 + 4);
+      _mm_storeu_ps(dst[0] + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+      _mm_storeu_ps(dst[1] + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+    }
+  }
+  DeinterleaveFrom(dst, src, channels, i, frames);
+}
+
+void S16ToFloatSSE2(float *dst, const int16_t *src, unsigned int count)
+{
+  const __m128 scale = _mm_set1_ps(1.0f / S16_SCALE);
+  unsigned int i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    const __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    // sign extend by moving the samples to the upper half first
+    const __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(in, in), 16);
+    const __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(in, in), 16);
+    _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+    _mm_storeu_ps(dst + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+  }
+  S16ToFloatScalar(dst + i, src + i, count - i);
+}
+
+void FloatToS16SSE2(int16_t *dst, const float *src, unsigned int count)
+{
+  const __m128 scale = _mm_set1_ps(S16_SCALE);
+  const __m128 low = _mm_set1_ps(-S16_SCALE);
+  const __m128 high = _mm_set1_ps(S16_SCALE - 1.0f);
+  unsigned int i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    const __m128 a = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(src + i), scale), low), high);
+    const __m128 b = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(src + i + 4), scale), low), high);
+    const __m128i out = _mm_packs_epi32(_mm_cvtps_epi32(a), _mm_cvtps_epi32(b));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), out);
+  }
+  FloatToS16Scalar(dst + i, src + i, count - i);
+}
+
+void S32ToFloatSSE2(float *dst, const int32_t *src, unsigned int count)
+{
+  const __m128 scale = _mm_set1_ps(1.0f / S32_SCALE);
+  unsigned int i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    const __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(in), scale));
+  }
+  S32ToFloatScalar(dst + i, src + i, count - i);
+}
+
+void FloatToS32SSE2(int32_t *dst, const float *src, unsigned int count)
+{
+  const __m128 scale = _mm_set1_ps(S32_SCALE);
+  const __m128 low = _mm_set1_ps(-S32_SCALE);
+  const __m128 high = _mm_set1_ps(S32_MAX);
+  unsigned int i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    const __m128 in = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(src + i), scale), low), high);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_cvtps_epi32(in));
+  }
+  FloatToS32Scalar(dst + i, src + i, count - i);
+}
+
+void S32ToS24NE4SSE2(uint32_t *data, unsigned int shift, unsigned int count)
+{
+  const __m128i bits = _mm_cvtsi32_si128(shift);
+  unsigned int i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    __m128i* ptr = reinterpret_cast<__m128i*>(data + i);
+    _mm_storeu_si128(ptr, _mm_srl_epi32(_mm_loadu_si128(ptr), bits));
+  }
+  S32ToS24NE4Scalar(data + i, shift, count - i);
+}
+
+const AEKernelTable sse2Kernels =
+{
+  "SSE2",
+  MulSSE2,
+  MulAddSSE2,
+  MaxAbsSSE2,
+  SoftClampSSE2,
+  InterleaveSSE2,
+  DeinterleaveSSE2,
+  S16ToFloatSSE2,
+  FloatToS16SSE2,
+  S32ToFloatSSE2,
+  FloatToS32SSE2,
+  S32ToS24NE4SSE2,
+  S32ToS24NE3Scalar // needs a byte shuffle
+};
+#endif
+
+//-----------------------------------------------------------------------------
+// AVX2
+//-----------------------------------------------------------------------------
+
+#if defined(AE_KERNELS_AVX2)
+AE_TARGET_AVX2 void MulAVX2(float *data, float mul, unsigned int count)
+{
+  const __m256 m = _mm256_set1_ps(mul);
+  unsigned int i = 0;
+  for (; i + 8 <= count; i += 8)
+    _mm256_storeu_ps(data + i, _mm256_mul_ps(_mm256_loadu_ps(data + i), m));
+  MulScalar(data + i, mul, count - i);
+}
+
+AE_TARGET_AVX2 void MulAddAVX2(float *dst, const float *src, float mul, unsigned int count)
+{
+  const __m256 m = _mm256_set1_ps(mul);
+  unsigned int i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    // no fma, results stay identical to the other implementations
+    const __m256 add = _mm256_mul_ps(_mm256_loadu_ps(src + i), m);
+    _mm256_storeu_ps(dst + i, _mm256_add_ps(_mm256_loadu_ps(dst + i), add));
+  }
+  MulAddScalar(dst + i, src + i, mul, count - i);
+}
+
+AE_TARGET_AVX2 float MaxAbsAVX2(const float *data, unsigned int count)
+{
+  const __m256 abs = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+  __m256 highest = _mm256_setzero_ps();
+  unsigned int i = 0;
+  for (; i + 8 <= count; i += 8)
+    highest = _mm256_max_ps(highest, _mm256_and_ps(_mm256_loadu_ps(data + i), abs));
+
+  float lanes[8];
+  _mm256_storeu_ps(lanes, highest);
+  float result = MaxAbsScalar(data + i, count - i);
+  for (float lane : lanes)
+    result = std::max(result, lane);
+  return result;
+}
+
+AE_TARGET_AVX2 void SoftClampAVX2(float *data, unsigned int count)
+{
+  const __m256 low = _mm256_set1_ps(-3.0f);
+  const __m256 high = _mm256_set1_ps(3.0f);
+  const __m256 c1 = _mm256_set1_ps(27.0f);
+  const __m256 c2 = _mm256_set1_ps(9.0f);
+  unsigned int i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    const __m256 x = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(data + i), low), high);
+    const __m256 y = _mm256_mul_ps(x, x);
+    const __m256 num = _mm256_mul_ps(x, _mm256_add_ps(c1, y));
+    const __m256 den = _mm256_add_ps(c1, _mm256_mul_ps(c2, y));
+    _mm256_storeu_ps(data + i, _mm256_div_ps(num, den));
+  }
+  SoftClampScalar(data + i, count - i);
+}
+
+AE_TARGET_AVX2 void S16ToFloatAVX2(float *dst, const int16_t *src, unsigned int count)
+{
+  const __m256 scale = _mm256_set1_ps(1.0f / S16_SCALE);
+  unsigned int i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    const __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(in)), scale));
+  }
+  S16ToFloatScalar(dst + i, src + i, count - i);
+}
+
+AE_TARGET_AVX2 void FloatToS16AVX2(int16_t *dst, const float *src, unsigned int count)
+{
+  const __m256 scale = _mm256_set1_ps(S16_SCALE);
+  const __m256 low = _mm256_set1_ps(-S16_SCALE);
+  const __m256 high = _mm256_set1_ps(S16_SCALE - 1.0f);
+  unsigned int i = 0;
+  for (; i + 16 <= count; i += 16)
+  {
+    const __m256 a = _mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(_mm256_loadu_ps(src + i), scale), low), high);
+    const __m256 b = _mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(_mm256_loadu_ps(src + i + 8), scale), low), high);
+    // packing works per 128 bit lane, put the quarters back in order
+    const __m256i out = _mm256_packs_epi32(_mm256_cvtps_epi32(a), _mm256_cvtps_epi32(b));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_permute4x64_epi64(out, 0xd8));
+  }
+  FloatToS16Scalar(dst + i, src + i, count - i);
+}
+
+AE_TARGET_AVX2 void S32ToFloatAVX2(float *dst, const int32_t *src, unsigned int count)
+{
+  const __m256 scale = _mm256_set1_ps(1.0f / S32_SCALE);
+  unsigned int i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    const __m256i in = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+    _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_cvtepi32_ps(in), scale));
+  }
+  S32ToFloatScalar(dst + i, src + i, count - i);
+}
+
+AE_TARGET_AVX2 void FloatToS32AVX2(int32_t *dst, const float *src, unsigned int count)
+{
+  const __m256 scale = _mm256_set1_ps(S32_SCALE);
+  const __m256 low = _mm256_set1_ps(-S32_SCALE);
+  const __m256 high = _mm256_set1_ps(S32_MAX);
+  unsigned int i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    const __m256 in = _mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(_mm256_loadu_ps(src + i), scale), low), high);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_cvtps_epi32(in));
+  }
+  FloatToS32Scalar(dst + i, src + i, count - i);
+}
+
+AE_TARGET_AVX2 void S32ToS24NE4AVX2(uint32_t *data, unsigned int shift, unsigned int count)
+{
+  const __m128i bits = _mm_cvtsi32_si128(shift);
+  unsigned int i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    __m256i* ptr = reinterpret_cast<__m256i*>(data + i);
+    _mm256_storeu_si256(ptr, _mm256_srl_epi32(_mm256_loadu_si256(ptr), bits));
+  }
+  S32ToS24NE4Scalar(data + i, shift, count - i);
+}
+
+AE_TARGET_AVX2 void S32ToS24NE3AVX2(uint8_t *dst, const int32_t *src, unsigned int count)
+{
+  // drop the lowest byte of each sample, the last 4 bytes are unused
+  const __m128i shuffle = _mm_setr_epi8(1, 2, 3, 5, 6, 7, 9, 10, 11, 13, 14, 15, -1, -1, -1, -1);
+  unsigned int i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    // 12 bytes are stored behind the 16 just loaded, dst may be src
+    const __m128i out = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)), shuffle);
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(dst), out);
+    const int32_t high = _mm_cvtsi128_si32(_mm_srli_si128(out, 8));
+    std::copy(reinterpret_cast<const uint8_t*>(&high), reinterpret_cast<const uint8_t*>(&high) + 4, dst + 8);
+    dst += 12;
+  }
+  S32ToS24NE3Scalar(dst, src + i, count - i);
+}
+
+const AEKernelTable avx2Kernels =
+{
+  "AVX2",
+  MulAVX2,
+  MulAddAVX2,
+  MaxAbsAVX2,
+  SoftClampAVX2,
+  InterleaveSSE2, // bound by memory, lane crossing shuffles don't pay off
+  DeinterleaveSSE2,
+  S16ToFloatAVX2,
+  FloatToS16AVX2,
+  S32ToFloatAVX2,
+  FloatToS32AVX2,
+  S32ToS24NE4AVX2,
+  S32ToS24NE3AVX2
+};
+#endif
+
+//-----------------------------------------------------------------------------
+// NEON
+//-----------------------------------------------------------------------------
+
+#if defined(AE_KERNELS_NEON)
+void MulNEON(float *data, float mul, unsigned int count)
+{
+  unsigned int i = 0;
+  for (; i + 4 <= count; i += 4)
+    vst1q_f32(data + i, vmulq_n_f32(vld1q_f32(data + i), mul));
+  MulScalar(data + i, mul, count - i);
+}
+
+void MulAddNEON(float *dst, const float *src, float mul, unsigned int count)
+{
+  unsigned int i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    const float32x4_t add = vmulq_n_f32(vld1q_f32(src + i), mul);
+    vst1q_f32(dst + i, vaddq_f32(vld1q_f32(dst + i), add));
+  }
+  MulAddScalar(dst + i, src + i, mul, count - i);
+}
+
+float MaxAbsNEON(const float *data, unsigned int count)
+{
+  float32x4_t highest = vdupq_n_f32(0.0f);
+  unsigned int i = 0;
+  for (; i + 4 <= count; i += 4)
+    highest = vmaxq_f32(highest, vabsq_f32(vld1q_f32(data + i)));
+
+  float32x2_t pair = vmax_f32(vget_low_f32(highest), vget_high_f32(highest));
+  pair = vpmax_f32(pair, pair);
+  return std::max(vget_lane_f32(pair, 0), MaxAbsScalar(data + i, count - i));
+}
+
+void SoftClampNEON(float *data, unsigned int count)
+{
+  const float32x4_t low = vdupq_n_f32(-3.0f);
+  const float32x4_t high = vdupq_n_f32(3.0f);
+  const float32x4_t c1 = vdupq_n_f32(27.0f);
+  unsigned int i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    const float32x4_t x = vminq_f32(vmaxq_f32(vld1q_f32(data + i), low), high);
+    const float32x4_t y = vmulq_f32(x, x);
+    const float32x4_t num = vmulq_f32(x, vaddq_f32(c1, y));
+    const float32x4_t den = vaddq_f32(c1, vmulq_n_f32(y, 9.0f));
+#if defined(__aarch64__)
+    vst1q_f32(data + i, vdivq_f32(num, den));
+#else
+    // no division, refine the reciprocal estimate twice
+    float32x4_t recip = vrecpeq_f32(den);
+    recip = vmulq_f32(vrecpsq_f32(den, recip), recip);
+    recip = vmulq_f32(vrecpsq_f32(den, recip), recip);
+    vst1q_f32(data + i, vmulq_f32(num, recip));
+#endif
+  }
+  SoftClampScalar(data + i, count - i);
+}
+
+void InterleaveNEON(float *dst, const float* const *src, unsigned int channels, unsigned int frames)
+{
+  unsigned int i = 0;
+  if (channels == 2)
+  {
+    for (; i + 4 <= frames; i += 4)
+    {
+      float32x4x2_t frame;
+      frame.val[0] = vld1q_f32(src[0] + i);
+      frame.val[1] = vld1q_f32(src[1] + i);
+      vst2q_f32(dst + i * 2, frame);
+    }
+  }
+  InterleaveFrom(dst, src, channels, i, frames);
+}
+
+void DeinterleaveNEON(float* const *dst, const float *src, unsigned int channels, unsigned int frames)
+{
+  unsigned int i = 0;
+  if (channels == 2)
+  {
+    for (; i + 4 <= frames; i += 4)
+    {
+      const float32x4x2_t frame = vld2q_f32(src + i * 2);
+      vst1q_f32(dst[0] + i, frame.val[0]);
+      vst1q_f32(dst[1] + i, frame.val[1]);
+    }
+  }
+  DeinterleaveFrom(dst, src, channels, i, frames);
+}
+
+void S16ToFloatNEON(float *dst, const int16_t *src, unsigned int count)
+{
+  const float scale = 1.0f / S16_SCALE;
+  unsigned int i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    const int16x8_t in = vld1q_s16(src + i);
+    vst1q_f32(dst + i, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(in))), scale));
+    vst1q_f32(dst + i + 4, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(in))), scale));
+  }
+  S16ToFloatScalar(dst + i, src + i, count - i);
+}
+
+void S32ToFloatNEON(float *dst, const int32_t *src, unsigned int count)
+{
+  const float scale = 1.0f / S32_SCALE;
+  unsigned int i = 0;
+  for (; i + 4 <= count; i += 4)
+    vst1q_f32(dst + i, vmulq_n_f32(vcvtq_f32_s32(vld1q_s32(src + i)), scale));
+  S32ToFloatScalar(dst + i, src + i, count - i);
+}
+
+#if defined(__aarch64__)
+void FloatToS16NEON(int16_t *dst, const float *src, unsigned int count)
+{
+  const float32x4_t low = vdupq_n_f32(-S16_SCALE);
+  const float32x4_t high = vdupq_n_f32(S16_SCALE - 1.0f);
+  unsigned int i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    const float32x4_t a = vminq_f32(vmaxq_f32(vmulq_n_f32(vld1q_f32(src + i), S16_SCALE), low), high);
+    const float32x4_t b = vminq_f32(vmaxq_f32(vmulq_n_f32(vld1q_f32(src + i + 4), S16_SCALE), low), high);
+    vst1q_s16(dst + i, vcombine_s16(vqmovn_s32(vcvtnq_s32_f32(a)), vqmovn_s32(vcvtnq_s32_f32(b))));
+  }
+  FloatToS16Scalar(dst + i, src + i, count - i);
+}
+
+void FloatToS32NEON(int32_t *dst, const float *src, unsigned int count)
+{
+  const float32x4_t low = vdupq_n_f32(-S32_SCALE);
+  const float32x4_t high = vdupq_n_f32(S32_MAX);
+  unsigned int i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    const float32x4_t in = vminq_f32(vmaxq_f32(vmulq_n_f32(vld1q_f32(src + i), S32_SCALE), low), high);
+    vst1q_s32(dst + i, vcvtnq_s32_f32(in));
+  }
+  FloatToS32Scalar(dst + i, src + i, count - i);
+}
+#endif
+
+void S32ToS24NE4NEON(uint32_t *data, unsigned int shift, unsigned int count)
+{
+  const int32x4_t bits = vdupq_n_s32(-static_cast<int32_t>(shift));
+  unsigned int i = 0;
+  for (; i + 4 <= count; i += 4)
+    vst1q_u32(data + i, vshlq_u32(vld1q_u32(data + i), bits));
+  S32ToS24NE4Scalar(data + i, shift, count - i);
+}
+
+void S32ToS24NE3NEON(uint8_t *dst, const int32_t *src, unsigned int count)
+{
+  unsigned int i = 0;
+  for (; i + 16 <= count; i += 16)
+  {
+    // byte planes of 16 samples, store all but the lowest
+    // 48 bytes are stored behind the 64 just loaded, dst may be src
+    const uint8x16x4_t in = vld4q_u8(reinterpret_cast<const uint8_t*>(src + i));
+    uint8x16x3_t out;
+    out.val[0] = in.val[1];
+    out.val[1] = in.val[2];
+    out.val[2] = in.val[3];
+    vst3q_u8(dst, out);
+    dst += 48;
+  }
+  S32ToS24NE3Scalar(dst, src + i, count - i);
+}
+
+const AEKernelTable neonKernels =
+{
+  "NEON",
+  MulNEON,
+  MulAddNEON,
+  MaxAbsNEON,
+  SoftClampNEON,
+  InterleaveNEON,
+  DeinterleaveNEON,
+#if defined(__aarch64__)
+  S16ToFloatNEON,
+  FloatToS16NEON,
+  S32ToFloatNEON,
+  FloatToS32NEON,
+#else
+  // armv7 only converts towards zero, not to nearest like the others
+  S16ToFloatNEON,
+  FloatToS16Scalar,
+  S32ToFloatNEON,
+  FloatToS32Scalar,
+#endif
+  S32ToS24NE4NEON,
+  S32ToS24NE3NEON
+};
+#endif
+}
+
+const AEKernelTable* CAEKernels::Get(Impl impl)
+{
+  switch (impl)
+  {
+    case IMPL_SCALAR:
+      return &scalarKernels;
+#if defined(AE_KERNELS_SSE2)
+    case IMPL_SSE2:
+      return &sse2Kernels;
+#endif
+#if defined(AE_KERNELS_AVX2)
+    case IMPL_AVX2:
+      return __builtin_cpu_supports("avx2") ? &avx2Kernels : nullptr;
+#endif
+#if defined(AE_KERNELS_NEON)
+    case IMPL_NEON:
+      return &neonKernels;
+#endif
+    default:
+      return nullptr;
+  }
+}
+
+const AEKernelTable& CAEKernels::Get()
+{
+  static const AEKernelTable* kernels = []()
+  {
+    const AEKernelTable* best = &scalarKernels;
+    for (int impl = IMPL_SCALAR + 1; impl < IMPL_MAX; impl++)
+    {
+      const AEKernelTable* table = Get(static_cast<Impl>(impl));
+      if (table)
+        best = table;
+    }
+    CLog::Log(LOGNOTICE, "CAEKernels - using %s sample kernels", best->name);
+    return best;
+  }();
+  return *kernels;
+}
+
+namespace
+{
+bool IsFloat(AEDataFormat format)
+{
+  return format == AE_FMT_FLOAT || format == AE_FMT_FLOATP;
+}
+
+void ToFloat(float *dst, const uint8_t *src, AEDataFormat format, unsigned int count)
+{
+  if (format == AE_FMT_S16NE || format == AE_FMT_S16NEP)
+    CAEKernels::S16ToFloat(dst, reinterpret_cast<const int16_t*>(src), count);
+  else if (format == AE_FMT_S32NE || format == AE_FMT_S32NEP)
+    CAEKernels::S32ToFloat(dst, reinterpret_cast<const int32_t*>(src), count);
+  else
+    memcpy(dst, src, count * sizeof(float));
+}
+
+void FromFloat(uint8_t *dst, const float *src, AEDataFormat format, unsigned int count)
+{
+  if (format == AE_FMT_S16NE || format == AE_FMT_S16NEP)
+    CAEKernels::FloatToS16(reinterpret_cast<int16_t*>(dst), src, count);
+  else if (format == AE_FMT_S32NE || format == AE_FMT_S32NEP)
+    CAEKernels::FloatToS32(reinterpret_cast<int32_t*>(dst), src, count);
+  else
+    memcpy(dst, src, count * sizeof(float));
+}
+}
+
+bool CAEKernels::CanConvert(AEDataFormat dstFormat, AEDataFormat srcFormat)
+{
+  auto supported = [](AEDataFormat format) {
+    return IsFloat(format) ||
+           format == AE_FMT_S16NE || format == AE_FMT_S16NEP ||
+           format == AE_FMT_S32NE || format == AE_FMT_S32NEP;
+  };
+  return supported(dstFormat) && supported(srcFormat) && (IsFloat(dstFormat) || IsFloat(srcFormat));
+}
+
+bool CAEKernels::Convert(uint8_t* const *dst, AEDataFormat dstFormat,
+                         const uint8_t* const *src, AEDataFormat srcFormat,
+                         unsigned int channels, unsigned int frames, std::vector<float> &scratch)
+{
+  if (!CanConvert(dstFormat, srcFormat) || channels > AE_CH_MAX)
+    return false;
+
+  const bool srcPlanar = AE_IS_PLANAR(srcFormat);
+  const bool dstPlanar = AE_IS_PLANAR(dstFormat);
+  const unsigned int planes = srcPlanar ? channels : 1;
+  const unsigned int count = srcPlanar ? frames : frames * channels;
+
+  // same layout, only the sample format changes
+  if (srcPlanar == dstPlanar)
+  {
+    for (unsigned int i = 0; i < planes; i++)
+    {
+      if (IsFloat(dstFormat))
+        ToFloat(reinterpret_cast<float*>(dst[i]), src[i], srcFormat, count);
+      else
+        FromFloat(dst[i], reinterpret_cast<const float*>(src[i]), dstFormat, count);
+    }
+    return true;
+  }
+
+  // the layout changes on float samples, integers go through scratch on the way
+  if (scratch.size() < static_cast<size_t>(frames) * channels)
+    scratch.resize(static_cast<size_t>(frames) * channels);
+
+  float* scratchPlanes[AE_CH_MAX];
+  for (unsigned int i = 0; i < channels; i++)
+    scratchPlanes[i] = scratch.data() + i * frames;
+
+  // one pointer for interleaved samples
+  const float* floatPlanes[AE_CH_MAX];
+  if (IsFloat(srcFormat))
+  {
+    for (unsigned int i = 0; i < planes; i++)
+      floatPlanes[i] = reinterpret_cast<const float*>(src[i]);
+  }
+  else
+  {
+    for (unsigned int i = 0; i < planes; i++)
+    {
+      float* plane = srcPlanar ? scratchPlanes[i] : scratch.data();
+      ToFloat(plane, src[i], srcFormat, count);
+      floatPlanes[i] = plane;
+    }
+  }
+
+  if (IsFloat(dstFormat))
+  {
+    if (dstPlanar)
+      Deinterleave(reinterpret_cast<float* const*>(dst), floatPlanes[0], channels, frames);
+    else
+      Interleave(reinterpret_cast<float*>(dst[0]), floatPlanes, channels, frames);
+    return true;
+  }
+
+  if (dstPlanar)
+  {
+    Deinterleave(scratchPlanes, floatPlanes[0], channels, frames);
+    for (unsigned int i = 0; i < channels; i++)
+      FromFloat(dst[i], scratchPlanes[i], dstFormat, frames);
+  }
+  else
+  {
+    Interleave(scratch.data(), floatPlanes, channels, frames);
+    FromFloat(dst[0], scratch.data(), dstFormat, frames * channels);
+  }
+  return true;
+}
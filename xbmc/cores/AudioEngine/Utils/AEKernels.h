@@ -0,0 +1,104 @@
+/*
+ *  Copyright (C) 2019 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "AEChannelData.h"
+
+#include <stdint.h>
+#include <vector>
+
+/*!
+ * \brief Sample processing kernels of one instruction set
+ *
+ * Counts are in samples, channels are interleaved unless noted. Buffers need
+ * no particular alignment.
+ */
+struct AEKernelTable
+{
+  const char *name;
+
+  //! data *= mul
+  void (*Mul)(float *data, float mul, unsigned int count);
+  //! dst += src * mul
+  void (*MulAdd)(float *dst, const float *src, float mul, unsigned int count);
+  //! highest absolute value, 0 for an empty buffer
+  float (*MaxAbs)(const float *data, unsigned int count);
+  //! tanh like soft clipping into [-1, 1]
+  void (*SoftClamp)(float *data, unsigned int count);
+
+  //! planes of frames samples each into one interleaved buffer
+  void (*Interleave)(float *dst, const float* const *src, unsigned int channels, unsigned int frames);
+  //! interleaved buffer into planes of frames samples each
+  void (*Deinterleave)(float* const *dst, const float *src, unsigned int channels, unsigned int frames);
+
+  // conversion of full scale integers, float input is saturated
+  void (*S16ToFloat)(float *dst, const int16_t *src, unsigned int count);
+  void (*FloatToS16)(int16_t *dst, const float *src, unsigned int count);
+  void (*S32ToFloat)(float *dst, const int32_t *src, unsigned int count);
+  void (*FloatToS32)(int32_t *dst, const float *src, unsigned int count);
+
+  //! move the msb aligned 24 bit samples of S32 to the lower 3 bytes (S24NE4)
+  void (*S32ToS24NE4)(uint32_t *data, unsigned int shift, unsigned int count);
+  //! pack the msb aligned 24 bit samples of S32 into 3 bytes (S24NE3), dst may be src
+  void (*S32ToS24NE3)(uint8_t *dst, const int32_t *src, unsigned int count);
+};
+
+/*!
+ * \brief Runtime selected sample processing kernels of ActiveAE
+ *
+ * The fastest table the cpu supports is picked on first use: AVX2 or SSE2 on
+ * x86, NEON on ARM, plain C++ everywhere else.
+ */
+class CAEKernels
+{
+public:
+  enum Impl
+  {
+    IMPL_SCALAR,
+    IMPL_SSE2,
+    IMPL_AVX2,
+    IMPL_NEON,
+    IMPL_MAX
+  };
+
+  /*!
+   * \brief Kernels of impl, nullptr if the build or cpu doesn't support it
+   */
+  static const AEKernelTable* Get(Impl impl);
+  static const AEKernelTable& Get();
+
+  static void Mul(float *data, float mul, unsigned int count) { Get().Mul(data, mul, count); }
+  static void MulAdd(float *dst, const float *src, float mul, unsigned int count) { Get().MulAdd(dst, src, mul, count); }
+  static float MaxAbs(const float *data, unsigned int count) { return Get().MaxAbs(data, count); }
+  static void SoftClamp(float *data, unsigned int count) { Get().SoftClamp(data, count); }
+  static void Interleave(float *dst, const float* const *src, unsigned int channels, unsigned int frames) { Get().Interleave(dst, src, channels, frames); }
+  static void Deinterleave(float* const *dst, const float *src, unsigned int channels, unsigned int frames) { Get().Deinterleave(dst, src, channels, frames); }
+  static void S16ToFloat(float *dst, const int16_t *src, unsigned int count) { Get().S16ToFloat(dst, src, count); }
+  static void FloatToS16(int16_t *dst, const float *src, unsigned int count) { Get().FloatToS16(dst, src, count); }
+  static void S32ToFloat(float *dst, const int32_t *src, unsigned int count) { Get().S32ToFloat(dst, src, count); }
+  static void FloatToS32(int32_t *dst, const float *src, unsigned int count) { Get().FloatToS32(dst, src, count); }
+  static void S32ToS24NE4(uint32_t *data, unsigned int shift, unsigned int count) { Get().S32ToS24NE4(data, shift, count); }
+  static void S32ToS24NE3(uint8_t *dst, const int32_t *src, unsigned int count) { Get().S32ToS24NE3(dst, src, count); }
+
+  /*!
+   * \brief Whether Convert() handles the formats: float to float, S16 or S32 and
+   * back, planar or interleaved
+   */
+  static bool CanConvert(AEDataFormat dstFormat, AEDataFormat srcFormat);
+
+  /*!
+   * \brief Converts frames of samples between formats CanConvert() accepts
+   * \param dst, src one buffer per channel for planar formats, one for interleaved
+   * \param scratch used to change format and layout at once, only grows
+   * \return false if the formats aren't supported
+   */
+  static bool Convert(uint8_t* const *dst, AEDataFormat dstFormat,
+                      const uint8_t* const *src, AEDataFormat srcFormat,
+                      unsigned int channels, unsigned int frames, std::vector<float> &scratch);
+};
@@ -7,6 +7,7 @@
  */
 
 #include "AELimiter.h"
+#include "AEKernels.h"
 #include "ServiceBroker.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/SettingsComponent.h"
@@ -28,10 +29,7 @@ float CAELimiter::Run(float* frame[AE_CH_MAX], int channels, int offset /*= 0*/,
   float highest = 0.0f;
   if (!planar)
   {
-    for(int i=0; i<channels; i++)
-    {
-      highest = std::max(highest, fabsf(*(frame[0]+offset+i)));
-    }
+    highest = CAEKernels::MaxAbs(frame[0]+offset, channels);
   }
   else
   {
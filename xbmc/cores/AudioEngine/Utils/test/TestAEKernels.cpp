@@ -0,0 +1,295 @@
+/*
+ *  Copyright (C) 2019 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/AudioEngine/Utils/AEAudioFormat.h"
+#include "cores/AudioEngine/Utils/AEKernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace
+{
+// odd sizes exercise the remainders of the vector loops
+const unsigned int SIZES[] = { 0, 1, 3, 4, 7, 8, 15, 16, 17, 33, 100, 1027 };
+
+// samples slightly beyond full scale, the buffers start unaligned
+std::vector<float> Samples(unsigned int count, unsigned int seed)
+{
+  std::mt19937 gen(seed);
+  std::uniform_real_distribution<float> dist(-1.5f, 1.5f);
+  std::vector<float> samples(count + 1);
+  for (auto& sample : samples)
+    sample = dist(gen);
+  return samples;
+}
+
+// buffers of a format, written with the scalar kernels sample by sample
+struct SBuffers
+{
+  std::vector<std::vector<uint8_t>> planes;
+  std::vector<uint8_t*> data;
+};
+
+SBuffers MakeBuffers(AEDataFormat format, const std::vector<std::vector<float>>& channels, unsigned int frames)
+{
+  const AEKernelTable* ref = CAEKernels::Get(CAEKernels::IMPL_SCALAR);
+  const bool planar = AE_IS_PLANAR(format);
+  const size_t bytes = (format == AE_FMT_S16NE || format == AE_FMT_S16NEP) ? 2 : 4;
+
+  SBuffers buffers;
+  buffers.planes.resize(planar ? channels.size() : 1);
+  for (auto& plane : buffers.planes)
+  {
+    plane.resize(bytes * frames * (planar ? 1 : channels.size()));
+    buffers.data.push_back(plane.data());
+  }
+
+  for (size_t c = 0; c < channels.size(); c++)
+  {
+    for (unsigned int f = 0; f < frames; f++)
+    {
+      const size_t index = planar ? f : f * channels.size() + c;
+      uint8_t* sample = buffers.planes[planar ? c : 0].data() + index * bytes;
+      if (bytes == 2)
+        ref->FloatToS16(reinterpret_cast<int16_t*>(sample), &channels[c][f], 1);
+      else if (format == AE_FMT_S32NE || format == AE_FMT_S32NEP)
+        ref->FloatToS32(reinterpret_cast<int32_t*>(sample), &channels[c][f], 1);
+      else
+        *reinterpret_cast<float*>(sample) = channels[c][f];
+    }
+  }
+  return buffers;
+}
+
+// what is left of the samples in an integer format
+float Quantize(AEDataFormat format, float sample)
+{
+  const AEKernelTable* ref = CAEKernels::Get(CAEKernels::IMPL_SCALAR);
+  float result = sample;
+  if (format == AE_FMT_S16NE || format == AE_FMT_S16NEP)
+  {
+    int16_t value;
+    ref->FloatToS16(&value, &sample, 1);
+    ref->S16ToFloat(&result, &value, 1);
+  }
+  else if (format == AE_FMT_S32NE || format == AE_FMT_S32NEP)
+  {
+    int32_t value;
+    ref->FloatToS32(&value, &sample, 1);
+    ref->S32ToFloat(&result, &value, 1);
+  }
+  return result;
+}
+
+class TestAEKernels : public ::testing::TestWithParam<CAEKernels::Impl>
+{
+protected:
+  void SetUp() override
+  {
+    m_ref = CAEKernels::Get(CAEKernels::IMPL_SCALAR);
+    m_impl = CAEKernels::Get(GetParam());
+  }
+
+  const AEKernelTable* m_ref = nullptr;
+  const AEKernelTable* m_impl = nullptr;
+};
+}
+
+TEST(TestAEKernelsDispatch, Selected)
+{
+  ASSERT_NE(nullptr, CAEKernels::Get(CAEKernels::IMPL_SCALAR));
+
+  // the selected table is the last one available
+  const AEKernelTable* best = nullptr;
+  for (int impl = CAEKernels::IMPL_SCALAR; impl < CAEKernels::IMPL_MAX; impl++)
+  {
+    if (CAEKernels::Get(static_cast<CAEKernels::Impl>(impl)))
+      best = CAEKernels::Get(static_cast<CAEKernels::Impl>(impl));
+  }
+  EXPECT_EQ(best, &CAEKernels::Get());
+  RecordProperty("Kernels", CAEKernels::Get().name);
+}
+
+TEST_P(TestAEKernels, Float)
+{
+  if (!m_impl)
+    return;
+
+  for (unsigned int size : SIZES)
+  {
+    const std::vector<float> src = Samples(size, size);
+    std::vector<float> ref = Samples(size, size + 1);
+    std::vector<float> out = ref;
+
+    m_ref->Mul(ref.data() + 1, 0.7f, size);
+    m_impl->Mul(out.data() + 1, 0.7f, size);
+    EXPECT_EQ(ref, out) << "Mul " << size;
+
+    m_ref->MulAdd(ref.data() + 1, src.data() + 1, 0.3f, size);
+    m_impl->MulAdd(out.data() + 1, src.data() + 1, 0.3f, size);
+    for (unsigned int i = 0; i <= size; i++)
+      EXPECT_NEAR(ref[i], out[i], 1e-6f) << "MulAdd " << size;
+
+    EXPECT_EQ(m_ref->MaxAbs(ref.data() + 1, size), m_impl->MaxAbs(ref.data() + 1, size)) << "MaxAbs " << size;
+
+    m_ref->SoftClamp(ref.data() + 1, size);
+    m_impl->SoftClamp(out.data() + 1, size);
+    for (unsigned int i = 0; i <= size; i++)
+    {
+      EXPECT_NEAR(ref[i], out[i], 1e-6f) << "SoftClamp " << size;
+      if (i > 0)
+        EXPECT_LE(std::fabs(out[i]), 1.0f);
+    }
+  }
+}
+
+TEST_P(TestAEKernels, Interleave)
+{
+  if (!m_impl)
+    return;
+
+  for (unsigned int channels : { 1u, 2u, 6u })
+  {
+    for (unsigned int frames : SIZES)
+    {
+      std::vector<std::vector<float>> planes;
+      std::vector<const float*> src;
+      for (unsigned int i = 0; i < channels; i++)
+      {
+        planes.push_back(Samples(frames, i));
+        src.push_back(planes.back().data() + 1);
+      }
+
+      std::vector<float> ref(frames * channels);
+      std::vector<float> out(frames * channels);
+      m_ref->Interleave(ref.data(), src.data(), channels, frames);
+      m_impl->Interleave(out.data(), src.data(), channels, frames);
+      EXPECT_EQ(ref, out) << "Interleave " << channels << " " << frames;
+
+      std::vector<std::vector<float>> back(channels, std::vector<float>(frames));
+      std::vector<float*> dst;
+      for (auto& plane : back)
+        dst.push_back(plane.data());
+      m_impl->Deinterleave(dst.data(), out.data(), channels, frames);
+      for (unsigned int i = 0; i < channels; i++)
+        EXPECT_TRUE(std::equal(back[i].begin(), back[i].end(), src[i])) << "Deinterleave " << channels << " " << frames;
+    }
+  }
+}
+
+TEST_P(TestAEKernels, Convert)
+{
+  if (!m_impl)
+    return;
+
+  for (unsigned int size : SIZES)
+  {
+    const std::vector<float> src = Samples(size, size);
+
+    std::vector<int16_t> s16Ref(size);
+    std::vector<int16_t> s16(size);
+    m_ref->FloatToS16(s16Ref.data(), src.data() + 1, size);
+    m_impl->FloatToS16(s16.data(), src.data() + 1, size);
+    EXPECT_EQ(s16Ref, s16) << "FloatToS16 " << size;
+
+    std::vector<float> floatRef(size);
+    std::vector<float> floats(size);
+    m_ref->S16ToFloat(floatRef.data(), s16Ref.data(), size);
+    m_impl->S16ToFloat(floats.data(), s16Ref.data(), size);
+    EXPECT_EQ(floatRef, floats) << "S16ToFloat " << size;
+
+    std::vector<int32_t> s32Ref(size);
+    std::vector<int32_t> s32(size);
+    m_ref->FloatToS32(s32Ref.data(), src.data() + 1, size);
+    m_impl->FloatToS32(s32.data(), src.data() + 1, size);
+    EXPECT_EQ(s32Ref, s32) << "FloatToS32 " << size;
+
+    m_ref->S32ToFloat(floatRef.data(), s32Ref.data(), size);
+    m_impl->S32ToFloat(floats.data(), s32Ref.data(), size);
+    EXPECT_EQ(floatRef, floats) << "S32ToFloat " << size;
+
+    std::vector<uint32_t> s24Ref(s32Ref.begin(), s32Ref.end());
+    std::vector<uint32_t> s24(s32Ref.begin(), s32Ref.end());
+    m_ref->S32ToS24NE4(s24Ref.data(), 8, size);
+    m_impl->S32ToS24NE4(s24.data(), 8, size);
+    EXPECT_EQ(s24Ref, s24) << "S32ToS24NE4 " << size;
+
+    // packed in place like the resampler does
+    std::vector<int32_t> packedRef = s32Ref;
+    std::vector<int32_t> packed = s32Ref;
+    m_ref->S32ToS24NE3(reinterpret_cast<uint8_t*>(packedRef.data()), packedRef.data(), size);
+    m_impl->S32ToS24NE3(reinterpret_cast<uint8_t*>(packed.data()), packed.data(), size);
+    const uint8_t* bytesRef = reinterpret_cast<const uint8_t*>(packedRef.data());
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(packed.data());
+    EXPECT_TRUE(std::equal(bytesRef, bytesRef + size * 3, bytes)) << "S32ToS24NE3 " << size;
+  }
+
+  // full scale and beyond saturates
+  const float limits[] = { -2.0f, -1.0f, 1.0f, 2.0f, 1.0f, 1.0f, 1.0f, 1.0f };
+  int16_t s16[8];
+  int32_t s32[8];
+  m_impl->FloatToS16(s16, limits, 8);
+  m_impl->FloatToS32(s32, limits, 8);
+  EXPECT_EQ(INT16_MIN, s16[0]);
+  EXPECT_EQ(INT16_MIN, s16[1]);
+  EXPECT_EQ(INT16_MAX, s16[2]);
+  EXPECT_EQ(INT16_MAX, s16[3]);
+  EXPECT_EQ(INT32_MIN, s32[0]);
+  EXPECT_EQ(INT32_MIN, s32[1]);
+  EXPECT_EQ(2147483520, s32[2]);
+  EXPECT_EQ(2147483520, s32[3]);
+}
+
+TEST(TestAEKernelsConvert, Formats)
+{
+  const AEDataFormat formats[] = { AE_FMT_FLOAT, AE_FMT_FLOATP, AE_FMT_S16NE, AE_FMT_S16NEP,
+                                   AE_FMT_S32NE, AE_FMT_S32NEP };
+  const unsigned int frames = 37;
+  std::vector<std::vector<float>> channels;
+  for (unsigned int c = 0; c < 6; c++)
+  {
+    channels.push_back(Samples(frames, c));
+    channels.back().pop_back();
+  }
+
+  std::vector<float> scratch;
+  for (AEDataFormat src : formats)
+  {
+    std::vector<std::vector<float>> quantized(channels);
+    for (auto& channel : quantized)
+      for (auto& sample : channel)
+        sample = Quantize(src, sample);
+    const SBuffers in = MakeBuffers(src, channels, frames);
+
+    for (AEDataFormat dst : formats)
+    {
+      const bool floats = src == AE_FMT_FLOAT || src == AE_FMT_FLOATP ||
+                          dst == AE_FMT_FLOAT || dst == AE_FMT_FLOATP;
+      EXPECT_EQ(floats, CAEKernels::CanConvert(dst, src));
+
+      SBuffers out = MakeBuffers(dst, std::vector<std::vector<float>>(channels.size(), std::vector<float>(frames)), frames);
+      ASSERT_EQ(floats, CAEKernels::Convert(out.data.data(), dst, in.data.data(), src, channels.size(), frames, scratch));
+      if (floats)
+        EXPECT_EQ(MakeBuffers(dst, quantized, frames).planes, out.planes) << src << " to " << dst;
+    }
+  }
+
+  // formats swresample handles
+  EXPECT_FALSE(CAEKernels::CanConvert(AE_FMT_S24NE3, AE_FMT_FLOAT));
+  EXPECT_FALSE(CAEKernels::CanConvert(AE_FMT_FLOAT, AE_FMT_DOUBLE));
+  EXPECT_FALSE(CAEKernels::CanConvert(AE_FMT_S16NE, AE_FMT_S32NE));
+}
+
+INSTANTIATE_TEST_CASE_P(AllImpls, TestAEKernels,
+                        ::testing::Values(CAEKernels::IMPL_SSE2,
+                                          CAEKernels::IMPL_AVX2,
+                                          CAEKernels::IMPL_NEON));
@@ -14,6 +14,7 @@ CDataCacheCore::CDataCacheCore() :
   m_playerVideoInfo {},
   m_playerAudioInfo {},
   m_renderInfo {},
+  m_demuxInfo {},
   m_stateInfo {}
 {
   m_hasAVInfoChanges = false;
@@ -33,6 +34,7 @@ void CDataCacheCore::Reset()
   m_stateInfo.m_stateSeeking = false;
   m_stateInfo.m_renderGuiLayer = false;
   m_stateInfo.m_renderVideoLayer = false;
+  m_stateInfo.m_timeToFirstFrame = 0;
   m_playerStateChanged = false;
 }
 
@@ -173,6 +175,52 @@ float CDataCacheCore::GetVideoDAR()
   return m_playerVideoInfo.dar;
 }
 
+// video decoder stats
+int SVideoDecoderStats::GetDecodeTimeBucket(int64_t usec)
+{
+  int bucket = 0;
+  for (int64_t limit = 2000; usec >= limit && bucket < DECODE_TIME_BUCKETS - 1; limit *= 2)
+    bucket++;
+  return bucket;
+}
+
+void CDataCacheCore::ResetVideoDecoderStats()
+{
+  CSingleLock lock(m_videoPlayerSection);
+
+  m_videoDecoderStats = SVideoDecoderStats();
+}
+
+void CDataCacheCore::SetVideoDecoderThreads(std::string type, int count)
+{
+  CSingleLock lock(m_videoPlayerSection);
+
+  m_videoDecoderStats.threadType = type;
+  m_videoDecoderStats.threadCount = count;
+}
+
+void CDataCacheCore::AddVideoDecodeTimes(const uint64_t (&frames)[SVideoDecoderStats::DECODE_TIME_BUCKETS])
+{
+  CSingleLock lock(m_videoPlayerSection);
+
+  for (int i = 0; i < SVideoDecoderStats::DECODE_TIME_BUCKETS; i++)
+    m_videoDecoderStats.decodeTimes[i] += frames[i];
+}
+
+void CDataCacheCore::AddVideoDroppedFrames(VideoDropCause cause, int frames)
+{
+  CSingleLock lock(m_videoPlayerSection);
+
+  m_videoDecoderStats.droppedFrames[static_cast<int>(cause)] += frames;
+}
+
+SVideoDecoderStats CDataCacheCore::GetVideoDecoderStats()
+{
+  CSingleLock lock(m_videoPlayerSection);
+
+  return m_videoDecoderStats;
+}
+
 // player audio info
 void CDataCacheCore::SetAudioDecoderName(std::string name)
 {
@@ -244,6 +292,25 @@ bool CDataCacheCore::IsRenderClockSync()
   return m_renderInfo.m_isClockSync;
 }
 
+// demuxer info
+void CDataCacheCore::SetDemuxPacketPoolStats(uint64_t hits, uint64_t misses, uint64_t bytesResident)
+{
+  CSingleLock lock(m_demuxSection);
+
+  m_demuxInfo.m_packetPoolHits = hits;
+  m_demuxInfo.m_packetPoolMisses = misses;
+  m_demuxInfo.m_packetPoolBytesResident = bytesResident;
+}
+
+void CDataCacheCore::GetDemuxPacketPoolStats(uint64_t &hits, uint64_t &misses, uint64_t &bytesResident)
+{
+  CSingleLock lock(m_demuxSection);
+
+  hits = m_demuxInfo.m_packetPoolHits;
+  misses = m_demuxInfo.m_packetPoolMisses;
+  bytesResident = m_demuxInfo.m_packetPoolBytesResident;
+}
+
 // player states
 void CDataCacheCore::SetStateSeeking(bool active)
 {
@@ -306,6 +373,20 @@ bool CDataCacheCore::IsPlayerStateChanged()
   return ret;
 }
 
+void CDataCacheCore::SetTimeToFirstFrame(int ms)
+{
+  CSingleLock lock(m_stateSection);
+
+  m_stateInfo.m_timeToFirstFrame = ms;
+}
+
+int CDataCacheCore::GetTimeToFirstFrame()
+{
+  CSingleLock lock(m_stateSection);
+
+  return m_stateInfo.m_timeToFirstFrame;
+}
+
 void CDataCacheCore::SetGuiRender(bool gui)
 {
   CSingleLock lock(m_stateSection);
@@ -12,6 +12,28 @@
 #include <string>
 #include "threads/CriticalSection.h"
 
+enum class VideoDropCause
+{
+  DECODER = 0, // late, skipped by the decoder
+  DEINTERLACER, // late, field skipped by the deinterlacer
+  OUTPUT, // decoded but not handed to the renderer
+  RENDERER, // late, skipped by the renderer
+  MAX
+};
+
+struct SVideoDecoderStats
+{
+  static const int DECODE_TIME_BUCKETS = 8;
+
+  //! bucket n counts frames that took less than 2^(n+1) ms, the last one all slower frames
+  static int GetDecodeTimeBucket(int64_t usec);
+
+  std::string threadType;
+  int threadCount = 0;
+  uint64_t decodeTimes[DECODE_TIME_BUCKETS] = {};
+  uint64_t droppedFrames[static_cast<int>(VideoDropCause::MAX)] = {};
+};
+
 class CDataCacheCore
 {
 public:
@@ -41,6 +63,13 @@ public:
   void SetVideoDAR(float dar);
   float GetVideoDAR();
 
+  // video decoder stats
+  void ResetVideoDecoderStats();
+  void SetVideoDecoderThreads(std::string type, int count);
+  void AddVideoDecodeTimes(const uint64_t (&frames)[SVideoDecoderStats::DECODE_TIME_BUCKETS]);
+  void AddVideoDroppedFrames(VideoDropCause cause, int frames);
+  SVideoDecoderStats GetVideoDecoderStats();
+
   // player audio info
   void SetAudioDecoderName(std::string name);
   std::string GetAudioDecoderName();
@@ -55,6 +84,10 @@ public:
   void SetRenderClockSync(bool enabled);
   bool IsRenderClockSync();
 
+  // demuxer info
+  void SetDemuxPacketPoolStats(uint64_t hits, uint64_t misses, uint64_t bytesResident);
+  void GetDemuxPacketPoolStats(uint64_t &hits, uint64_t &misses, uint64_t &bytesResident);
+
   // player states
   void SetStateSeeking(bool active);
   bool IsSeeking();
@@ -64,6 +97,8 @@ public:
   void SetFrameAdvance(bool fa);
   bool IsFrameAdvance();
   bool IsPlayerStateChanged();
+  void SetTimeToFirstFrame(int ms);
+  int GetTimeToFirstFrame();
   void SetGuiRender(bool gui);
   bool GetGuiRender();
   void SetVideoRender(bool video);
@@ -128,6 +163,7 @@ protected:
     float fps;
     float dar;
   } m_playerVideoInfo;
+  SVideoDecoderStats m_videoDecoderStats;
 
   CCriticalSection m_audioPlayerSection;
   struct SPlayerAudioInfo
@@ -144,6 +180,14 @@ protected:
     bool m_isClockSync;
   } m_renderInfo;
 
+  CCriticalSection m_demuxSection;
+  struct SDemuxInfo
+  {
+    uint64_t m_packetPoolHits;
+    uint64_t m_packetPoolMisses;
+    uint64_t m_packetPoolBytesResident;
+  } m_demuxInfo;
+
   CCriticalSection m_stateSection;
   bool m_playerStateChanged = false;
   struct SStateInfo
@@ -154,6 +198,7 @@ protected:
     float m_tempo;
     float m_speed;
     bool m_frameAdvance;
+    int m_timeToFirstFrame;
   } m_stateInfo;
 
   struct STimeInfo
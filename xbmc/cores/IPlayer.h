@@ -26,6 +26,7 @@ class TiXmlElement;
 class CStreamDetails;
 class CAction;
 class IPlayerCallback;
+class ICaptureStreamCallback;
 
 class CPlayerOptions
 {
@@ -218,10 +219,12 @@ public:
   virtual bool Supports(ESCALINGMETHOD method) { return false; };
   virtual bool Supports(ERENDERFEATURE feature) { return false; };
 
+  // capture ids start at 1, 0 means the player can't capture
   virtual unsigned int RenderCaptureAlloc() { return 0; };
   virtual void RenderCaptureRelease(unsigned int captureId) {};
   virtual void RenderCapture(unsigned int captureId, unsigned int width, unsigned int height, int flags) {};
   virtual bool RenderCaptureGetPixels(unsigned int captureId, unsigned int millis, uint8_t *buffer, unsigned int size) { return false; };
+  virtual unsigned int RenderCaptureStream(ICaptureStreamCallback *callback, unsigned int width, unsigned int height, unsigned int interval, const std::string &format) { return 0; };
 
   // video and audio settings
   virtual CVideoSettings GetVideoSettings() { return CVideoSettings(); };
@@ -39,7 +39,7 @@ CAudioSinkAE::~CAudioSinkAE()
     CServiceBroker::GetActiveAE()->FreeStream(m_pAudioStream, true);
 }
 
-bool CAudioSinkAE::Create(const DVDAudioFrame &audioframe, AVCodecID codec, bool needresampler)
+bool CAudioSinkAE::Create(const DVDAudioFrame &audioframe, AVCodecID codec, bool needresampler, bool lowlatency)
 {
   CLog::Log(LOGNOTICE,
     "Creating audio stream (codec id: %i, channels: %i, sample rate: %i, %s)",
@@ -53,6 +53,8 @@ bool CAudioSinkAE::Create(const DVDAudioFrame &audioframe, AVCodecID codec, bool
   CSingleLock lock(m_critSection);
   unsigned int options = needresampler && !audioframe.passthrough ? AESTREAM_FORCE_RESAMPLE : 0;
   options |= AESTREAM_PAUSED;
+  if (lowlatency && !audioframe.passthrough)
+    options |= AESTREAM_LOW_LATENCY;
 
   AEAudioFormat format = audioframe.format;
   m_pAudioStream = CServiceBroker::GetActiveAE()->MakeStream(
@@ -34,7 +34,7 @@ public:
   void SetDynamicRangeCompression(long drc);
   void Pause();
   void Resume();
-  bool Create(const DVDAudioFrame &audioframe, AVCodecID codec, bool needresampler);
+  bool Create(const DVDAudioFrame &audioframe, AVCodecID codec, bool needresampler, bool lowlatency = false);
   bool IsValidFormat(const DVDAudioFrame &audioframe);
   void Destroy(bool finish);
   unsigned int AddPackets(const DVDAudioFrame &audioframe);
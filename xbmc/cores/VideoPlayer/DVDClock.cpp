@@ -264,6 +264,19 @@ bool CDVDClock::GetClockInfo(int& MissedVblanks, double& ClockSpeed, double& Ref
   return m_videoRefClock->GetClockInfo(MissedVblanks, ClockSpeed, RefreshRate);
 }
 
+bool CDVDClock::GetNextVblank(int64_t& vblank, double& clock, double& interval)
+{
+  int64_t time;
+  double ticks;
+  if (!m_videoRefClock->GetNextVblank(vblank, time, ticks))
+    return false;
+
+  CSingleLock lock(m_critSection);
+  clock = SystemToPlaying(time);
+  interval = DVD_TIME_BASE * ticks / m_systemUsed;
+  return true;
+}
+
 double CDVDClock::SystemToAbsolute(int64_t system)
 {
   return DVD_TIME_BASE * (double)(system - m_systemOffset) / m_systemFrequency;
@@ -49,6 +49,9 @@ public:
   double GetFrequency() { return (double)m_systemFrequency ; }
 
   bool GetClockInfo(int& MissedVblanks, double& ClockSpeed, double& RefreshRate) const;
+  /* index, playing clock and interval of the next vblank as predicted  *
+   * by the video reference clock, false if it does not run on vblanks */
+  bool GetNextVblank(int64_t& vblank, double& clock, double& interval);
   void SetVsyncAdjust(double adjustment);
   double GetVsyncAdjust();
 
@@ -21,6 +21,9 @@
 #include "utils/log.h"
 #include "cores/VideoPlayer/VideoRenderers/RenderManager.h"
 #include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
+#include <algorithm>
+#include <iterator>
 #include <memory>
 
 extern "C" {
@@ -49,6 +52,26 @@ enum DecoderState
   STATE_SW_MULTI
 };
 
+namespace
+{
+// the override for the largest height the stream reaches, codec specific ones win
+const DecoderThreadsOverride* FindThreadsOverride(const std::string& codec, int height)
+{
+  const DecoderThreadsOverride* result = nullptr;
+  for (const auto& override : CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_videoDecoderThreads)
+  {
+    if ((!override.codec.empty() && !StringUtils::EqualsNoCase(override.codec, codec)) ||
+        height < override.minheight)
+      continue;
+
+    if (!result || override.minheight > result->minheight ||
+        (override.minheight == result->minheight && result->codec.empty()))
+      result = &override;
+  }
+  return result;
+}
+}
+
 enum EFilterFlags {
   FILTER_NONE                =  0x0,
   FILTER_DEINTERLACE_YADIF   =  0x1,  //< use first deinterlace mode
@@ -366,6 +389,18 @@ bool CDVDVideoCodecFFmpeg::Open(CDVDStreamInfo &hints, CDVDCodecOptions &options
     {
       int num_threads = g_cpuInfo.getCPUCount() * 3 / 2;
       num_threads = std::max(1, std::min(num_threads, 16));
+      const DecoderThreadsOverride* threads = FindThreadsOverride(pCodec->name, hints.height);
+      if (threads)
+      {
+        if (threads->threads >= 0)
+          num_threads = threads->threads;
+        if (threads->type == "frame")
+          m_pCodecContext->thread_type = FF_THREAD_FRAME;
+        else if (threads->type == "slice")
+          m_pCodecContext->thread_type = FF_THREAD_SLICE;
+        CLog::Log(LOGDEBUG, "CDVDVideoCodecFFmpeg - threads override for %s, height %d: %d threads, type %s",
+                  pCodec->name, hints.height, num_threads, threads->type.empty() ? "any" : threads->type.c_str());
+      }
       m_pCodecContext->thread_count = num_threads;
       m_pCodecContext->thread_safe_callbacks = 1;
       m_decoderState = STATE_SW_MULTI;
@@ -437,6 +472,15 @@ bool CDVDVideoCodecFFmpeg::Open(CDVDStreamInfo &hints, CDVDCodecOptions &options
   m_processInfo.SetVideoDimensions(m_pCodecContext->coded_width, m_pCodecContext->coded_height);
   m_processInfo.SetVideoPixelFormat(pixFmtName ? pixFmtName : "");
 
+  // ffmpeg may fall back to fewer threads or another type than requested
+  std::string threadType = "none";
+  if (m_pCodecContext->active_thread_type & FF_THREAD_FRAME)
+    threadType = "frame";
+  else if (m_pCodecContext->active_thread_type & FF_THREAD_SLICE)
+    threadType = "slice";
+  m_processInfo.SetVideoDecoderThreads(threadType, m_pCodecContext->active_thread_type ? m_pCodecContext->thread_count : 1);
+
+  m_decodeTime = 0;
   m_dropCtrl.Reset(true);
   m_eof = false;
   return true;
@@ -444,6 +488,8 @@ bool CDVDVideoCodecFFmpeg::Open(CDVDStreamInfo &hints, CDVDCodecOptions &options
 
 void CDVDVideoCodecFFmpeg::Dispose()
 {
+  UpdateDecodeTimes();
+
   av_frame_free(&m_pFrame);
   av_frame_free(&m_pDecodedFrame);
   av_frame_free(&m_pFilterFrame);
@@ -565,7 +611,9 @@ bool CDVDVideoCodecFFmpeg::AddData(const DemuxPacket &packet)
   avpkt.side_data = static_cast<AVPacketSideData*>(packet.pSideData);
   avpkt.side_data_elems = packet.iSideDataElems;
 
+  int64_t start = CurrentHostCounter();
   int ret = avcodec_send_packet(m_pCodecContext, &avpkt);
+  m_decodeTime += CurrentHostCounter() - start;
 
   // try again
   if (ret == AVERROR(EAGAIN))
@@ -653,7 +701,9 @@ CDVDVideoCodec::VCReturn CDVDVideoCodecFFmpeg::GetPicture(VideoPicture* pVideoPi
     avcodec_send_packet(m_pCodecContext, &avpkt);
   }
 
+  int64_t start = CurrentHostCounter();
   int ret = avcodec_receive_frame(m_pCodecContext, m_pDecodedFrame);
+  m_decodeTime += CurrentHostCounter() - start;
 
   if (m_decoderState == STATE_HW_FAILED && !m_pHardware)
     return VC_REOPEN;
@@ -721,6 +771,13 @@ CDVDVideoCodec::VCReturn CDVDVideoCodecFFmpeg::GetPicture(VideoPicture* pVideoPi
   // here we got a frame
   int64_t framePTS = m_pDecodedFrame->best_effort_timestamp;
 
+  // time the player waited for the decoder, with threads that keep up it
+  // stays well below the frame duration
+  m_decodeTimes[SVideoDecoderStats::GetDecodeTimeBucket(m_decodeTime * 1000000 / CurrentHostFrequency())]++;
+  m_decodeTime = 0;
+  if (++m_decodeTimeFrames >= 100)
+    UpdateDecodeTimes();
+
   if (m_pCodecContext->skip_frame > AVDISCARD_DEFAULT)
   {
     if (m_dropCtrl.m_state == CDropControl::VALID &&
@@ -887,6 +944,18 @@ void CDVDVideoCodecFFmpeg::Reset()
   m_filters = "";
   FilterClose();
   m_dropCtrl.Reset(false);
+  m_decodeTime = 0;
+  UpdateDecodeTimes();
+}
+
+void CDVDVideoCodecFFmpeg::UpdateDecodeTimes()
+{
+  if (m_decodeTimeFrames == 0)
+    return;
+
+  m_processInfo.AddVideoDecodeTimes(m_decodeTimes);
+  std::fill(std::begin(m_decodeTimes), std::end(m_decodeTimes), 0);
+  m_decodeTimeFrames = 0;
 }
 
 void CDVDVideoCodecFFmpeg::Reopen()
@@ -55,6 +55,7 @@ protected:
   void SetFilters();
   void UpdateName();
   bool SetPictureParams(VideoPicture* pVideoPicture);
+  void UpdateDecodeTimes();
 
   bool HasHardware() { return m_pHardware != nullptr; };
   void SetHardware(IHardwareDecoder *hardware);
@@ -97,6 +98,9 @@ protected:
   bool m_interlaced = false;
   double m_DAR = 1.0;
   CDVDStreamInfo m_hints;
+  int64_t m_decodeTime = 0; // host ticks spent in ffmpeg since the last frame
+  uint64_t m_decodeTimes[SVideoDecoderStats::DECODE_TIME_BUCKETS] = {};
+  int m_decodeTimeFrames = 0;
   CDVDCodecOptions m_options;
 
   struct CDropControl
@@ -41,6 +41,7 @@
 #include <deque>
 #include <list>
 #include <map>
+#include <queue>
 #include <vector>
 
 extern "C" {
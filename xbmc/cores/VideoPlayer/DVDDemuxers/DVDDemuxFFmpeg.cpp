@@ -14,6 +14,7 @@
 #include "commons/Exception.h"
 #include "cores/FFmpeg.h"
 #include "cores/VideoPlayer/Interface/Addon/TimingConstants.h" // for DVD_TIME_BASE
+#include "DemuxProbeCache.h"
 #include "DVDDemuxUtils.h"
 #include "DVDInputStreams/DVDInputStream.h"
 #include "DVDInputStreams/DVDInputStreamFFmpeg.h"
@@ -134,8 +135,7 @@ static int dvd_file_read(void *h, uint8_t* buf, int size)
   if(interrupt_cb(h))
     return AVERROR_EXIT;
 
-  std::shared_ptr<CDVDInputStream> pInputStream = static_cast<CDVDDemuxFFmpeg*>(h)->m_pInput;
-  int len = pInputStream->Read(buf, size);
+  int len = static_cast<CDVDDemuxFFmpeg*>(h)->ReadInput(buf, size);
   if (len == 0)
     return AVERROR_EOF;
   else
@@ -191,6 +191,10 @@ bool CDVDDemuxFFmpeg::Aborted()
   if(m_timeout.IsTimePast())
     return true;
 
+  // ends avformat_find_stream_info early, see Open
+  if (m_fastStart && HasPrimaryStreams())
+    return true;
+
   std::shared_ptr<CDVDInputStreamFFmpeg> input = std::dynamic_pointer_cast<CDVDInputStreamFFmpeg>(m_pInput);
   if(input && input->Aborted())
     return true;
@@ -198,6 +202,33 @@ bool CDVDDemuxFFmpeg::Aborted()
   return false;
 }
 
+int CDVDDemuxFFmpeg::ReadInput(uint8_t* buf, int size)
+{
+  int len;
+  if (m_lendInput)
+  {
+    // copy straight out of the input's cache instead of going through
+    // the intermediate buffers of the file layer
+    const uint8_t* data = nullptr;
+    len = m_pInput->LendBuffer(&data, size);
+    if (len > 0)
+    {
+      memcpy(buf, data, len);
+      m_pInput->ReturnBuffer(len);
+    }
+  }
+  else
+    len = m_pInput->Read(buf, size);
+
+  if (len > 0)
+  {
+    m_bytesRead += len;
+    if (m_ioContext && buf >= m_ioContext->buffer && buf < m_ioContext->buffer + m_ioContext->buffer_size)
+      m_bytesBuffered += len;
+  }
+  return len;
+}
+
 bool CDVDDemuxFFmpeg::Open(std::shared_ptr<CDVDInputStream> pInput, bool streaminfo, bool fileinfo)
 {
   AVInputFormat* iformat = NULL;
@@ -278,6 +309,11 @@ bool CDVDDemuxFFmpeg::Open(std::shared_ptr<CDVDInputStream> pInput, bool streami
     int bufferSize = 4096;
     int blockSize = m_pInput->GetBlockSize();
 
+    m_lendInput = seekable && m_pInput->CanLendBuffer();
+    m_bytesRead = 0;
+    m_bytesBuffered = 0;
+    m_readStart = XbmcThreads::SystemClockMillis();
+
     if (blockSize > 1 && seekable) // non seakable input streams are not supposed to set block size
       bufferSize = blockSize;
 
@@ -425,6 +461,12 @@ bool CDVDDemuxFFmpeg::Open(std::shared_ptr<CDVDInputStream> pInput, bool streami
       return false;
     }
     av_dict_free(&options);
+
+    // reading from a lent buffer is cheap, so payload can bypass the avio
+    // buffer and go straight into the packets. mpegts parses in place from
+    // the avio buffer and would only get more callbacks.
+    if (m_lendInput && strcmp(m_pFormatContext->iformat->name, "mpegts") != 0)
+      m_ioContext->direct = 1;
   }
 
   // Avoid detecting framerate if advancedsettings.xml says so
@@ -459,14 +501,70 @@ bool CDVDDemuxFFmpeg::Open(std::shared_ptr<CDVDInputStream> pInput, bool streami
   m_bAVI = strcmp(m_pFormatContext->iformat->name, "avi") == 0;
   m_bSup = strcmp(m_pFormatContext->iformat->name, "sup") == 0;
 
+  // identifies an unchanged file for the probe cache and the keyframe index,
+  // the stat of the open file saves another request to its source
+  const std::shared_ptr<CAdvancedSettings> advancedSettings = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings();
+  std::string cacheKey;
+  struct __stat64 st;
+  if (m_streaminfo && m_ioContext && m_ioContext->seekable && !m_pInput->IsRealtime() &&
+      !m_pInput->IsStreamType(DVDSTREAM_TYPE_DVD) && !isBluray &&
+      (advancedSettings->m_videoProbeCache || advancedSettings->m_videoKeyframeIndex) &&
+      m_pInput->GetFileStat(&st))
+    cacheKey = CDemuxProbeCache::GetKey(strFile, st);
+
   if (m_streaminfo)
   {
     /* to speed up dvd switches, only analyse very short */
     if(m_pInput->IsStreamType(DVDSTREAM_TYPE_DVD))
       av_opt_set_int(m_pFormatContext, "analyzeduration", 500000, 0);
 
-    CLog::Log(LOGDEBUG, "%s - avformat_find_stream_info starting", __FUNCTION__);
-    int iErr = avformat_find_stream_info(m_pFormatContext, NULL);
+    // an unchanged file that was probed before doesn't need to be probed again
+    CDemuxProbeCache probeCache;
+    probeCache.SetMaxSize(static_cast<uint64_t>(advancedSettings->m_videoProbeCacheSize) * 1024 * 1024);
+    std::string probeKey;
+    std::string probeLayout;
+    bool probed = false;
+    if (advancedSettings->m_videoProbeCache && !cacheKey.empty() && !m_checkvideo)
+    {
+      probeKey = cacheKey;
+      probeLayout = CDemuxProbeCache::GetLayout(m_pFormatContext);
+      probed = probeCache.Apply(probeKey, probeLayout, m_pFormatContext);
+      if (probed)
+        CLog::Log(LOGDEBUG, "%s - using cached stream info", __FUNCTION__);
+    }
+
+    // for live streams in fast start mode probing stops as soon as the video
+    // and an audio stream have been seen, streams still lacking parameters
+    // are completed from their packets while playing
+    m_fastStart = m_checkvideo &&
+                  CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_videoFastStart &&
+                  (m_pInput->IsRealtime() || m_pInput->IsStreamType(DVDSTREAM_TYPE_PVRMANAGER) ||
+                   URIUtils::IsInternetStream(strFile));
+
+    int iErr = 0;
+    if (!probed)
+    {
+      CLog::Log(LOGDEBUG, "%s - avformat_find_stream_info starting", __FUNCTION__);
+      iErr = avformat_find_stream_info(m_pFormatContext, NULL);
+      if (iErr >= 0)
+        probeCache.Store(probeKey, probeLayout, m_pFormatContext);
+    }
+    if (m_fastStart)
+    {
+      m_probeIncomplete = HasPrimaryStreams();
+      m_fastStart = false;
+      if (m_probeIncomplete)
+      {
+        CLog::Log(LOGDEBUG, "%s - fast start, probing stopped after primary streams", __FUNCTION__);
+        iErr = 0;
+        // a read interrupted by the stop marks the byte context as ended
+        if (m_pFormatContext->pb)
+        {
+          m_pFormatContext->pb->eof_reached = 0;
+          m_pFormatContext->pb->error = 0;
+        }
+      }
+    }
     if (iErr < 0)
     {
       CLog::Log(LOGWARNING,"could not find codec parameters for %s", CURL::GetRedacted(strFile).c_str());
@@ -569,6 +667,10 @@ bool CDVDDemuxFFmpeg::Open(std::shared_ptr<CDVDInputStream> pInput, bool streami
   m_dtsAtDisplayTime = DVD_NOPTS_VALUE;
   m_startTime = 0;
 
+  // keyframes seen while playing are kept to seek straight to them next time
+  if (advancedSettings->m_videoKeyframeIndex && !cacheKey.empty())
+    OpenKeyframeIndex(cacheKey);
+
   // seems to be a bug in ffmpeg, hls jumps back to start after a couple of seconds
   // this cures the issue
   if (m_pFormatContext->iformat && strcmp(m_pFormatContext->iformat->name, "hls,applehttp") == 0)
@@ -594,6 +696,31 @@ void CDVDDemuxFFmpeg::Dispose()
     avformat_close_input(&m_pFormatContext);
   }
 
+  if (m_bytesRead > 0)
+  {
+    const unsigned int elapsed = XbmcThreads::SystemClockMillis() - m_readStart;
+    CLog::Log(LOGDEBUG, "CDVDDemuxFFmpeg::Dispose - read %" PRIu64 " bytes%s, %" PRIu64 " copied through the avio buffer, %" PRIu64 " bytes copied per second",
+              m_bytesRead, m_lendInput ? " from lent buffers" : "", m_bytesBuffered,
+              elapsed > 0 ? (m_bytesRead + m_bytesBuffered) * 1000 / elapsed : 0);
+    m_bytesRead = 0;
+    m_bytesBuffered = 0;
+  }
+  m_lendInput = false;
+  m_fastStart = false;
+  m_probeIncomplete = false;
+
+  if (!m_keyframeIndexPath.empty() && m_keyframeIndex.IsChanged())
+  {
+    CLog::Log(LOGDEBUG, "CDVDDemuxFFmpeg::Dispose - storing %u keyframes",
+              static_cast<unsigned int>(m_keyframeIndex.Size()));
+    // every playback adds to the index, the oldest write is the least recent use
+    if (m_keyframeIndex.Save(m_keyframeIndexPath, m_keyframeStream))
+      CDemuxProbeCache().PruneKeyframeIndexes(static_cast<uint64_t>(CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_videoKeyframeIndexSize) * 1024 * 1024);
+  }
+  m_keyframeIndex.Clear();
+  m_keyframeIndexPath.clear();
+  m_keyframeStream = -1;
+
   if(m_ioContext)
   {
     av_free(m_ioContext->buffer);
@@ -633,6 +760,7 @@ void CDVDDemuxFFmpeg::Flush()
   m_displayTime = 0;
   m_dtsAtDisplayTime = DVD_NOPTS_VALUE;
   m_seekToKeyFrame = false;
+  m_keyframeIndex.Discontinuity();
 }
 
 void CDVDDemuxFFmpeg::Abort()
@@ -957,6 +1085,9 @@ DemuxPacket* CDVDDemuxFFmpeg::Read()
 
       AVStream *stream = m_pFormatContext->streams[m_pkt.pkt.stream_index];
 
+      if (m_pkt.pkt.stream_index == m_keyframeStream)
+        AddKeyframe(&m_pkt.pkt);
+
       if (IsVideoReady())
       {
         if (m_program != UINT_MAX)
@@ -1134,7 +1265,17 @@ bool CDVDDemuxFFmpeg::SeekTime(double time, bool backwards, double *startpts)
   int ret;
   {
     CSingleLock lock(m_critSection);
-    ret = av_seek_frame(m_pFormatContext, -1, seek_pts, backwards ? AVSEEK_FLAG_BACKWARD : 0);
+    SKeyframe keyframe;
+    if (m_keyframeIndex.Find(static_cast<int64_t>(time), backwards, keyframe) &&
+        SeekKeyframe(keyframe) >= 0)
+    {
+      CLog::Log(LOGDEBUG, "%s - seeking to indexed keyframe at byte %" PRId64, __FUNCTION__, keyframe.pos);
+      m_seekToKeyFrame = true;
+      ret = 0;
+    }
+    else
+      ret = av_seek_frame(m_pFormatContext, -1, seek_pts, backwards ? AVSEEK_FLAG_BACKWARD : 0);
+    m_keyframeIndex.Discontinuity();
 
     if (ret < 0)
     {
@@ -1190,6 +1331,7 @@ bool CDVDDemuxFFmpeg::SeekByte(int64_t pos)
 {
   CSingleLock lock(m_critSection);
   int ret = av_seek_frame(m_pFormatContext, -1, pos, AVSEEK_FLAG_BYTE);
+  m_keyframeIndex.Discontinuity();
 
   if(ret >= 0)
     UpdateCurrentPTS();
@@ -1200,6 +1342,49 @@ bool CDVDDemuxFFmpeg::SeekByte(int64_t pos)
   return (ret >= 0);
 }
 
+void CDVDDemuxFFmpeg::OpenKeyframeIndex(const std::string& key)
+{
+  int stream = av_find_best_stream(m_pFormatContext, AVMEDIA_TYPE_VIDEO, -1, -1, nullptr, 0);
+  if (stream < 0 || (m_pFormatContext->streams[stream]->disposition & AV_DISPOSITION_ATTACHED_PIC))
+    return;
+
+  m_keyframeStream = stream;
+  m_keyframeIndexPath = CDemuxProbeCache().GetKeyframeIndexPath(key);
+  if (m_keyframeIndex.Load(m_keyframeIndexPath, m_keyframeStream))
+    CLog::Log(LOGDEBUG, "%s - loaded %u keyframes", __FUNCTION__,
+              static_cast<unsigned int>(m_keyframeIndex.Size()));
+}
+
+void CDVDDemuxFFmpeg::AddKeyframe(const AVPacket* pkt)
+{
+  if (!(pkt->flags & AV_PKT_FLAG_KEY))
+    return;
+
+  // same as for the packets, pts of avi are unusable
+  AVStream* stream = m_pFormatContext->streams[pkt->stream_index];
+  int64_t pts = m_bAVI ? pkt->dts : pkt->pts;
+  double time = ConvertTimestamp(pts, stream->time_base.den, stream->time_base.num);
+  if (time == DVD_NOPTS_VALUE || pkt->pos < 0)
+  {
+    // a keyframe we can't seek to, the next one doesn't follow the last indexed one
+    m_keyframeIndex.Discontinuity();
+    return;
+  }
+
+  m_keyframeIndex.Add(static_cast<int64_t>(time * 1000 / DVD_TIME_BASE), pts, pkt->pos);
+}
+
+int CDVDDemuxFFmpeg::SeekKeyframe(const SKeyframe& keyframe)
+{
+  // formats without a seek function of their own search for the timestamp by
+  // reading the file, the byte position of the keyframe is known already
+  const AVInputFormat* format = m_pFormatContext->iformat;
+  if (!format->read_seek && !format->read_seek2 && !(format->flags & AVFMT_NO_BYTE_SEEK))
+    return av_seek_frame(m_pFormatContext, -1, keyframe.pos, AVSEEK_FLAG_BYTE);
+
+  return av_seek_frame(m_pFormatContext, m_keyframeStream, keyframe.pts, AVSEEK_FLAG_BACKWARD);
+}
+
 void CDVDDemuxFFmpeg::UpdateCurrentPTS()
 {
   m_currentPts = DVD_NOPTS_VALUE;
@@ -1979,7 +2164,11 @@ void CDVDDemuxFFmpeg::ParsePacket(AVPacket *pkt)
 {
   AVStream *st = m_pFormatContext->streams[pkt->stream_index];
 
-  if (st && st->codecpar->codec_type == AVMEDIA_TYPE_VIDEO)
+  if (st && m_probeIncomplete && st->codecpar->codec_type == AVMEDIA_TYPE_AUDIO)
+  {
+    ParseAudioPacket(st, pkt);
+  }
+  else if (st && st->codecpar->codec_type == AVMEDIA_TYPE_VIDEO)
   {
     auto parser = m_parsers.find(st->index);
     if (parser == m_parsers.end())
@@ -2050,6 +2239,77 @@ void CDVDDemuxFFmpeg::ParsePacket(AVPacket *pkt)
   }
 }
 
+void CDVDDemuxFFmpeg::ParseAudioPacket(AVStream* st, AVPacket* pkt)
+{
+  // fast start didn't wait for all audio streams, complete their
+  // parameters from the stream. A change is picked up by Read.
+  if (st->codecpar->sample_rate > 0 && st->codecpar->channels > 0)
+  {
+    m_parsers.erase(st->index);
+    return;
+  }
+
+  auto parser = m_parsers.find(st->index);
+  if (parser == m_parsers.end())
+  {
+    // an entry without parser remembers codecs that can't be completed
+    parser = m_parsers.insert(std::make_pair(st->index,
+                                             std::unique_ptr<CDemuxParserFFmpeg>(new CDemuxParserFFmpeg()))).first;
+    parser->second->m_parserCtx = av_parser_init(st->codecpar->codec_id);
+    AVCodec *codec = avcodec_find_decoder(st->codecpar->codec_id);
+    if (codec)
+      parser->second->m_codecCtx = avcodec_alloc_context3(codec);
+  }
+
+  if (!parser->second->m_parserCtx || !parser->second->m_codecCtx)
+    return;
+
+  uint8_t *outbuf;
+  int outSize;
+  av_parser_parse2(parser->second->m_parserCtx, parser->second->m_codecCtx, &outbuf, &outSize,
+                   pkt->data, pkt->size, AV_NOPTS_VALUE, AV_NOPTS_VALUE, 0);
+
+  const AVCodecContext* codecCtx = parser->second->m_codecCtx;
+  if (codecCtx->sample_rate > 0 && codecCtx->channels > 0)
+  {
+    CLog::Log(LOGDEBUG, "CDVDDemuxFFmpeg::ParseAudioPacket() stream %d completed, %d channels, %d Hz",
+              st->index, codecCtx->channels, codecCtx->sample_rate);
+    st->codecpar->sample_rate = codecCtx->sample_rate;
+    st->codecpar->channels = codecCtx->channels;
+    st->codecpar->channel_layout = codecCtx->channel_layout;
+    if (codecCtx->bit_rate > 0)
+      st->codecpar->bit_rate = codecCtx->bit_rate;
+    m_parsers.erase(parser);
+  }
+}
+
+bool CDVDDemuxFFmpeg::HasPrimaryStreams()
+{
+  bool hasVideo = false;
+  bool hasAudio = false;
+  bool video = false;
+  bool audio = false;
+
+  for (unsigned int i = 0; i < m_pFormatContext->nb_streams; i++)
+  {
+    const AVStream *st = m_pFormatContext->streams[i];
+    if (st->codecpar->codec_type == AVMEDIA_TYPE_VIDEO &&
+        !(st->disposition & AV_DISPOSITION_ATTACHED_PIC))
+    {
+      hasVideo = true;
+      video |= st->codec_info_nb_frames > 0;
+    }
+    else if (st->codecpar->codec_type == AVMEDIA_TYPE_AUDIO)
+    {
+      hasAudio = true;
+      audio |= st->codec_info_nb_frames > 0;
+    }
+  }
+
+  // one audio stream is enough to start with, video is checked by IsVideoReady
+  return (hasVideo || hasAudio) && (!hasVideo || video) && (!hasAudio || audio);
+}
+
 bool CDVDDemuxFFmpeg::IsVideoReady()
 {
   AVStream *st;
@@ -9,6 +9,7 @@
 #pragma once
 
 #include "DVDDemux.h"
+#include "DemuxKeyframeIndex.h"
 #include "threads/CriticalSection.h"
 #include "threads/SystemClock.h"
 #include <map>
@@ -103,6 +104,7 @@ public:
   std::string GetStreamCodecName(int iStreamId) override;
 
   bool Aborted();
+  int ReadInput(uint8_t* buf, int size);
 
   AVFormatContext* m_pFormatContext;
   std::shared_ptr<CDVDInputStream> m_pInput;
@@ -117,12 +119,17 @@ protected:
   void CreateStreams(unsigned int program = UINT_MAX);
   void DisposeStreams();
   void ParsePacket(AVPacket *pkt);
+  void ParseAudioPacket(AVStream* st, AVPacket* pkt);
+  bool HasPrimaryStreams();
   bool IsVideoReady();
   void ResetVideoStreams();
   AVDictionary *GetFFMpegOptionsFromInput();
   double ConvertTimestamp(int64_t pts, int den, int num);
   void UpdateCurrentPTS();
   bool IsProgramChange();
+  void OpenKeyframeIndex(const std::string& key);
+  void AddKeyframe(const AVPacket* pkt);
+  int SeekKeyframe(const SKeyframe& keyframe);
   unsigned int HLSSelectProgram();
 
   std::string GetStereoModeFromMetadata(AVDictionary *pMetadata);
@@ -163,5 +170,16 @@ protected:
   double m_dtsAtDisplayTime;
   bool m_seekToKeyFrame = false;
   double m_startTime = 0;
+
+  bool m_fastStart = false; // stop probing once the primary streams are known
+  bool m_probeIncomplete = false; // probing was stopped early, complete streams while reading
+  bool m_lendInput = false; // read by borrowing the input's buffer
+  uint64_t m_bytesRead = 0; // bytes handed to avio
+  uint64_t m_bytesBuffered = 0; // part of m_bytesRead that went through the avio buffer
+  unsigned int m_readStart = 0;
+
+  CDemuxKeyframeIndex m_keyframeIndex;
+  std::string m_keyframeIndexPath; // empty if the file isn't indexed
+  int m_keyframeStream = -1; // stream index of the indexed video stream
 };
 
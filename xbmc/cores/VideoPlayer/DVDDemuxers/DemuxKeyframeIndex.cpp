@@ -0,0 +1,177 @@
+/*
+ *  Copyright (C) 2019 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "DemuxKeyframeIndex.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "utils/URIUtils.h"
+#include "utils/auto_buffer.h"
+#include "utils/log.h"
+
+#include <cstring>
+#include <iterator>
+#include <vector>
+
+namespace
+{
+const int32_t INDEX_MAGIC = 0x4b465831; // "KFX1"
+const int32_t INDEX_VERSION = 1;
+
+struct SHeader
+{
+  int32_t magic;
+  int32_t version;
+  int32_t stream;
+  int32_t count;
+};
+
+struct SEntry
+{
+  int64_t time;
+  int64_t pts;
+  int64_t pos;
+  int64_t hasNext;
+};
+}
+
+void CDemuxKeyframeIndex::Add(int64_t time, int64_t pts, int64_t pos)
+{
+  auto it = m_keyframes.find(time);
+  if (it == m_keyframes.end())
+  {
+    it = m_keyframes.insert({time, SKeyframe()}).first;
+    // the interval it was inserted into wasn't complete after all
+    if (it != m_keyframes.begin())
+      std::prev(it)->second.hasNext = false;
+  }
+  it->second.pts = pts;
+  it->second.pos = pos;
+
+  if (m_hasLast && m_lastTime < time)
+  {
+    auto last = m_keyframes.find(m_lastTime);
+    if (last != m_keyframes.end())
+    {
+      // anything in between was stored for a different version of the file
+      m_keyframes.erase(std::next(last), it);
+      last->second.hasNext = true;
+    }
+  }
+
+  m_lastTime = time;
+  m_hasLast = true;
+  m_changed = true;
+}
+
+void CDemuxKeyframeIndex::Discontinuity()
+{
+  m_hasLast = false;
+}
+
+bool CDemuxKeyframeIndex::Find(int64_t time, bool backwards, SKeyframe& keyframe) const
+{
+  auto next = m_keyframes.upper_bound(time);
+  if (next == m_keyframes.begin())
+    return false;
+
+  auto prev = std::prev(next);
+  if (prev->first == time)
+  {
+    keyframe = prev->second;
+    return true;
+  }
+
+  if (!prev->second.hasNext || next == m_keyframes.end())
+    return false;
+
+  keyframe = backwards ? prev->second : next->second;
+  return true;
+}
+
+bool CDemuxKeyframeIndex::Load(const std::string& path, int stream)
+{
+  Clear();
+
+  XFILE::CFile file;
+  XUTILS::auto_buffer buffer;
+  if (!XFILE::CFile::Exists(path) || file.LoadFile(path, buffer) < static_cast<ssize_t>(sizeof(SHeader)))
+    return false;
+
+  SHeader header;
+  memcpy(&header, buffer.get(), sizeof(header));
+  if (header.magic != INDEX_MAGIC || header.version != INDEX_VERSION || header.stream != stream ||
+      header.count < 0 || buffer.size() != sizeof(header) + header.count * sizeof(SEntry))
+  {
+    CLog::Log(LOGDEBUG, "CDemuxKeyframeIndex::Load - discarding unusable index %s", path.c_str());
+    return false;
+  }
+
+  const char* data = buffer.get() + sizeof(header);
+  auto hint = m_keyframes.end();
+  for (int32_t i = 0; i < header.count; i++)
+  {
+    SEntry entry;
+    memcpy(&entry, data + i * sizeof(SEntry), sizeof(entry));
+
+    SKeyframe keyframe;
+    keyframe.pts = entry.pts;
+    keyframe.pos = entry.pos;
+    keyframe.hasNext = entry.hasNext != 0;
+    hint = m_keyframes.insert(hint, {entry.time, keyframe});
+  }
+
+  return true;
+}
+
+bool CDemuxKeyframeIndex::Save(const std::string& path, int stream)
+{
+  SHeader header;
+  header.magic = INDEX_MAGIC;
+  header.version = INDEX_VERSION;
+  header.stream = stream;
+  header.count = static_cast<int32_t>(m_keyframes.size());
+
+  std::vector<char> data(sizeof(header) + m_keyframes.size() * sizeof(SEntry));
+  memcpy(data.data(), &header, sizeof(header));
+
+  char* out = data.data() + sizeof(header);
+  for (const auto& it : m_keyframes)
+  {
+    SEntry entry;
+    entry.time = it.first;
+    entry.pts = it.second.pts;
+    entry.pos = it.second.pos;
+    entry.hasNext = it.second.hasNext ? 1 : 0;
+    memcpy(out, &entry, sizeof(entry));
+    out += sizeof(entry);
+  }
+
+  const std::string directory = URIUtils::GetDirectory(path);
+  if (!XFILE::CDirectory::Exists(directory))
+    XFILE::CDirectory::Create(directory);
+
+  XFILE::CFile file;
+  if (!file.OpenForWrite(path, true) ||
+      file.Write(data.data(), data.size()) != static_cast<ssize_t>(data.size()))
+  {
+    CLog::Log(LOGWARNING, "CDemuxKeyframeIndex::Save - failed to write %s", path.c_str());
+    file.Close();
+    XFILE::CFile::Delete(path);
+    return false;
+  }
+
+  m_changed = false;
+  return true;
+}
+
+void CDemuxKeyframeIndex::Clear()
+{
+  m_keyframes.clear();
+  m_hasLast = false;
+  m_changed = false;
+}
@@ -0,0 +1,68 @@
+/*
+ *  Copyright (C) 2019 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <map>
+#include <stdint.h>
+#include <string>
+
+struct SKeyframe
+{
+  int64_t pts = 0; // in the time base of the indexed stream
+  int64_t pos = -1; // byte offset of the packet
+  bool hasNext = false; // the following entry is the next keyframe of the stream
+};
+
+/*!
+ * \brief Keyframes of the video stream of a file, collected while playing.
+ *
+ * Entries are keyed by the player time in ms. As keyframes are only seen in
+ * the parts of the file that were played, an entry knows whether the next
+ * entry is also the next keyframe of the stream. Lookups only succeed inside
+ * such a known interval, everywhere else the demuxer has to seek as usual.
+ */
+class CDemuxKeyframeIndex
+{
+public:
+  /*!
+   * \brief Add a keyframe, it directly follows the one added before unless
+   * Discontinuity was called in between
+   */
+  void Add(int64_t time, int64_t pts, int64_t pos);
+
+  /*!
+   * \brief The next keyframe added doesn't follow the previous one, e.g.
+   * after a seek
+   */
+  void Discontinuity();
+
+  /*!
+   * \brief Find the keyframe at or before time if backwards is set, at or
+   * after time otherwise
+   * \return false if the keyframes around time are not known
+   */
+  bool Find(int64_t time, bool backwards, SKeyframe& keyframe) const;
+
+  /*!
+   * \brief Load the index of stream from path
+   * \return false if nothing usable is stored, the index is empty then
+   */
+  bool Load(const std::string& path, int stream);
+  bool Save(const std::string& path, int stream);
+
+  void Clear();
+  bool IsChanged() const { return m_changed; }
+  size_t Size() const { return m_keyframes.size(); }
+
+private:
+  std::map<int64_t, SKeyframe> m_keyframes;
+  int64_t m_lastTime = 0;
+  bool m_hasLast = false;
+  bool m_changed = false;
+};
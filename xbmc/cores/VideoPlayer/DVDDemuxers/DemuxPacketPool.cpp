@@ -0,0 +1,225 @@
+/*
+ *  Copyright (C) 2019 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "DemuxPacketPool.h"
+#include "threads/SingleLock.h"
+
+#ifdef TARGET_POSIX
+#include "platform/linux/XMemUtils.h"
+#endif
+
+#include <cstring>
+
+extern "C" {
+#include "libavcodec/avcodec.h"
+}
+
+CDemuxPacketPool& CDemuxPacketPool::GetInstance()
+{
+  static CDemuxPacketPool pool;
+  return pool;
+}
+
+CDemuxPacketPool::~CDemuxPacketPool()
+{
+  Clear();
+}
+
+DemuxPacket* CDemuxPacketPool::Allocate(unsigned int dataSize)
+{
+  CPooledPacket* packet = nullptr;
+
+  if (dataSize == 0)
+  {
+    {
+      CSingleLock lock(m_critSection);
+      if (!m_emptyPackets.empty())
+      {
+        packet = m_emptyPackets.back();
+        m_emptyPackets.pop_back();
+        m_residentBytes -= GetResidentSize(packet);
+      }
+    }
+
+    if (packet)
+    {
+      m_hits++;
+      return packet;
+    }
+
+    m_misses++;
+    return new CPooledPacket();
+  }
+
+  // need to allocate a few bytes more.
+  // From avcodec.h (ffmpeg)
+  /**
+   * Required number of additionally allocated bytes at the end of the input bitstream for decoding.
+   * this is mainly needed because some optimized bitstream readers read
+   * 32 or 64 bit at once and could read over the end<br>
+   * Note, if the first 23 bits of the additional bytes are not 0 then damaged
+   * MPEG bitstreams could cause overread and segfault
+   */
+  size_t allocSize = static_cast<size_t>(dataSize) + AV_INPUT_BUFFER_PADDING_SIZE;
+  int sizeClass = GetSizeClass(allocSize);
+
+  if (sizeClass != UNPOOLED)
+  {
+    CSingleLock lock(m_critSection);
+    std::vector<CPooledPacket*>& freeList = m_freeLists[sizeClass];
+    if (!freeList.empty())
+    {
+      packet = freeList.back();
+      freeList.pop_back();
+    }
+    else if (!m_emptyPackets.empty())
+    {
+      packet = m_emptyPackets.back();
+      m_emptyPackets.pop_back();
+    }
+
+    if (packet)
+      m_residentBytes -= GetResidentSize(packet);
+  }
+
+  if (packet && packet->pData)
+  {
+    m_hits++;
+  }
+  else
+  {
+    m_misses++;
+
+    if (!packet)
+      packet = new CPooledPacket();
+
+    size_t capacity = sizeClass == UNPOOLED ? allocSize : GetClassCapacity(sizeClass);
+    packet->pData = static_cast<uint8_t*>(_aligned_malloc(capacity, 16));
+    if (!packet->pData)
+    {
+      Destroy(packet);
+      return nullptr;
+    }
+    packet->sizeClass = sizeClass;
+  }
+
+  // reset the padding bytes to 0
+  memset(packet->pData + dataSize, 0, AV_INPUT_BUFFER_PADDING_SIZE);
+
+  return packet;
+}
+
+void CDemuxPacketPool::Release(DemuxPacket* packet)
+{
+  if (!packet)
+    return;
+
+  CPooledPacket* pooled = static_cast<CPooledPacket*>(packet);
+  if (pooled->sizeClass == UNPOOLED)
+  {
+    Destroy(pooled);
+    return;
+  }
+
+  Reset(pooled);
+  size_t size = GetResidentSize(pooled);
+
+  {
+    CSingleLock lock(m_critSection);
+    if (m_residentBytes + size <= m_maxResidentBytes)
+    {
+      if (pooled->sizeClass == NO_PAYLOAD)
+        m_emptyPackets.push_back(pooled);
+      else
+        m_freeLists[pooled->sizeClass].push_back(pooled);
+      m_residentBytes += size;
+      return;
+    }
+  }
+
+  Destroy(pooled);
+}
+
+void CDemuxPacketPool::Clear()
+{
+  std::vector<CPooledPacket*> packets;
+
+  {
+    CSingleLock lock(m_critSection);
+    packets.swap(m_emptyPackets);
+    for (auto& freeList : m_freeLists)
+    {
+      packets.insert(packets.end(), freeList.begin(), freeList.end());
+      freeList.clear();
+      freeList.shrink_to_fit();
+    }
+    m_residentBytes = 0;
+  }
+
+  for (auto packet : packets)
+    Destroy(packet);
+}
+
+void CDemuxPacketPool::SetMaxResidentBytes(size_t bytes)
+{
+  CSingleLock lock(m_critSection);
+  m_maxResidentBytes = bytes;
+}
+
+SDemuxPacketPoolStats CDemuxPacketPool::GetStats() const
+{
+  SDemuxPacketPoolStats stats;
+  stats.hits = m_hits;
+  stats.misses = m_misses;
+
+  CSingleLock lock(m_critSection);
+  stats.bytesResident = m_residentBytes;
+  return stats;
+}
+
+int CDemuxPacketPool::GetSizeClass(size_t allocSize)
+{
+  int sizeClass = 0;
+  size_t capacity = static_cast<size_t>(1) << MIN_CLASS_SHIFT;
+  while (capacity < allocSize)
+  {
+    capacity <<= 1;
+    sizeClass++;
+  }
+
+  if (sizeClass >= static_cast<int>(NUM_CLASSES))
+    return UNPOOLED;
+  return sizeClass;
+}
+
+size_t CDemuxPacketPool::GetClassCapacity(int sizeClass)
+{
+  return static_cast<size_t>(1) << (MIN_CLASS_SHIFT + sizeClass);
+}
+
+size_t CDemuxPacketPool::GetResidentSize(const CPooledPacket* packet)
+{
+  size_t size = sizeof(CPooledPacket);
+  if (packet->sizeClass >= 0)
+    size += GetClassCapacity(packet->sizeClass);
+  return size;
+}
+
+void CDemuxPacketPool::Destroy(CPooledPacket* packet)
+{
+  if (packet->pData)
+    _aligned_free(packet->pData);
+  delete packet;
+}
+
+void CDemuxPacketPool::Reset(CPooledPacket* packet)
+{
+  uint8_t* data = packet->pData;
+  static_cast<DemuxPacket&>(*packet) = DemuxPacket();
+  packet->pData = data;
+}
@@ -0,0 +1,96 @@
+/*
+ *  Copyright (C) 2019 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "cores/VideoPlayer/Interface/Addon/DemuxPacket.h"
+#include "threads/CriticalSection.h"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct SDemuxPacketPoolStats
+{
+  uint64_t hits = 0;
+  uint64_t misses = 0;
+  uint64_t bytesResident = 0;
+};
+
+/*!
+ * \brief Recycles DemuxPacket objects and their payload buffers.
+ *
+ * Payloads are rounded up to a power of two size class and returned to a
+ * per class free list on release, so steady state demuxing does not hit the
+ * heap. The amount of memory parked in the free lists is capped, packets
+ * released above the cap are freed immediately.
+ * All methods are thread safe, packets are typically allocated by the demux
+ * thread and released by the audio/video player threads.
+ */
+class CDemuxPacketPool
+{
+public:
+  static CDemuxPacketPool& GetInstance();
+
+  CDemuxPacketPool() = default;
+  ~CDemuxPacketPool();
+  CDemuxPacketPool(const CDemuxPacketPool&) = delete;
+  CDemuxPacketPool& operator=(const CDemuxPacketPool&) = delete;
+
+  /*!
+   * \brief Get a packet with a payload of at least dataSize bytes plus
+   * AV_INPUT_BUFFER_PADDING_SIZE zeroed padding bytes.
+   * \return the packet or nullptr if the payload could not be allocated
+   */
+  DemuxPacket* Allocate(unsigned int dataSize);
+
+  /*!
+   * \brief Return a packet to the pool. Side data must have been released
+   * by the caller.
+   */
+  void Release(DemuxPacket* packet);
+
+  /*!
+   * \brief Free all parked packets
+   */
+  void Clear();
+
+  void SetMaxResidentBytes(size_t bytes);
+  SDemuxPacketPoolStats GetStats() const;
+
+  static constexpr unsigned int MIN_CLASS_SHIFT = 8; // 256 bytes
+  static constexpr unsigned int MAX_CLASS_SHIFT = 23; // 8 MiB
+  static constexpr size_t DEFAULT_MAX_RESIDENT_BYTES = 32 * 1024 * 1024;
+
+protected:
+  struct CPooledPacket : public DemuxPacket
+  {
+    int sizeClass = NO_PAYLOAD;
+  };
+
+  static constexpr int NO_PAYLOAD = -1;
+  static constexpr int UNPOOLED = -2;
+  static constexpr unsigned int NUM_CLASSES = MAX_CLASS_SHIFT - MIN_CLASS_SHIFT + 1;
+
+  static int GetSizeClass(size_t allocSize);
+  static size_t GetClassCapacity(int sizeClass);
+  static size_t GetResidentSize(const CPooledPacket* packet);
+  static void Destroy(CPooledPacket* packet);
+  static void Reset(CPooledPacket* packet);
+
+  mutable CCriticalSection m_critSection;
+  std::vector<CPooledPacket*> m_emptyPackets;
+  std::array<std::vector<CPooledPacket*>, NUM_CLASSES> m_freeLists;
+  size_t m_maxResidentBytes = DEFAULT_MAX_RESIDENT_BYTES;
+  size_t m_residentBytes = 0;
+
+  std::atomic<uint64_t> m_hits{0};
+  std::atomic<uint64_t> m_misses{0};
+};
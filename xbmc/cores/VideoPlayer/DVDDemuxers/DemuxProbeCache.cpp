@@ -0,0 +1,338 @@
+/*
+ *  Copyright (C) 2019 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "DemuxProbeCache.h"
+#include "FileItem.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "utils/Base64.h"
+#include "utils/Digest.h"
+#include "utils/JSONVariantParser.h"
+#include "utils/JSONVariantWriter.h"
+#include "utils/StringUtils.h"
+#include "utils/Variant.h"
+#include "utils/auto_buffer.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <cstring>
+
+extern "C" {
+#include "libavcodec/avcodec.h"
+}
+
+using KODI::UTILITY::CDigest;
+
+namespace
+{
+CVariant RationalToVariant(const AVRational& value)
+{
+  CVariant result(CVariant::VariantTypeArray);
+  result.push_back(value.num);
+  result.push_back(value.den);
+  return result;
+}
+
+AVRational VariantToRational(const CVariant& value)
+{
+  AVRational result = { 0, 1 };
+  if (value.isArray() && value.size() == 2)
+  {
+    result.num = value[0].asInteger32();
+    result.den = value[1].asInteger32(1);
+  }
+  return result;
+}
+}
+
+CDemuxProbeCache::CDemuxProbeCache(const std::string& path)
+  : m_path(path)
+{
+}
+
+std::string CDemuxProbeCache::GetKey(const std::string& fileName, const struct __stat64& st)
+{
+  if (st.st_size <= 0)
+    return "";
+
+  // results of another libavformat version may differ
+  return CDigest::Calculate(CDigest::Type::SHA256,
+                            StringUtils::Format("%s|%" PRId64 "|%" PRId64 "|%u", fileName.c_str(),
+                                                static_cast<int64_t>(st.st_size),
+                                                static_cast<int64_t>(st.st_mtime),
+                                                LIBAVFORMAT_VERSION_INT));
+}
+
+std::string CDemuxProbeCache::GetLayout(const AVFormatContext* context)
+{
+  std::string layout = StringUtils::Format("%s;%u;%u", context->iformat ? context->iformat->name : "",
+                                           context->nb_streams, context->nb_chapters);
+  for (unsigned int i = 0; i < context->nb_streams; i++)
+  {
+    const AVStream* stream = context->streams[i];
+    layout += StringUtils::Format(";%d:%d:%d:%d/%d", stream->id, stream->codecpar->codec_type,
+                                  stream->codecpar->codec_id, stream->time_base.num,
+                                  stream->time_base.den);
+  }
+  return layout;
+}
+
+bool CDemuxProbeCache::Apply(const std::string& key, const std::string& layout, AVFormatContext* context) const
+{
+  if (key.empty())
+    return false;
+
+  XFILE::CFile file;
+  XUTILS::auto_buffer buffer;
+  if (!XFILE::CFile::Exists(GetEntryPath(key)) || file.LoadFile(GetEntryPath(key), buffer) <= 0)
+    return false;
+
+  const std::string json(buffer.get(), buffer.size());
+  CVariant entry;
+  if (!CJSONVariantParser::Parse(json, entry))
+  {
+    Remove(key);
+    return false;
+  }
+
+  const CVariant& streams = entry["streams"];
+  if (entry["layout"].asString() != layout || !streams.isArray() ||
+      streams.size() != context->nb_streams)
+  {
+    CLog::Log(LOGDEBUG, "CDemuxProbeCache::Apply - stream layout changed, probing");
+    return false;
+  }
+
+  // everything that can fail is done before the context is changed
+  std::vector<std::string> extradata(context->nb_streams);
+  for (unsigned int i = 0; i < context->nb_streams; i++)
+  {
+    if (!streams[i].isObject())
+      return false;
+    extradata[i] = Base64::Decode(streams[i]["extradata"].asString());
+  }
+
+  std::vector<uint8_t*> buffers(context->nb_streams, nullptr);
+  for (unsigned int i = 0; i < context->nb_streams; i++)
+  {
+    const AVCodecParameters* par = context->streams[i]->codecpar;
+    if (extradata[i].empty() ||
+        (extradata[i].size() == static_cast<size_t>(par->extradata_size) &&
+         memcmp(extradata[i].data(), par->extradata, extradata[i].size()) == 0))
+      continue;
+
+    buffers[i] = static_cast<uint8_t*>(av_mallocz(extradata[i].size() + AV_INPUT_BUFFER_PADDING_SIZE));
+    if (!buffers[i])
+    {
+      for (uint8_t* buffer : buffers)
+        av_free(buffer);
+      return false;
+    }
+    memcpy(buffers[i], extradata[i].data(), extradata[i].size());
+  }
+
+  for (unsigned int i = 0; i < context->nb_streams; i++)
+    ApplyStream(streams[i], context->streams[i], buffers[i], static_cast<int>(extradata[i].size()));
+
+  context->duration = entry["duration"].asInteger(AV_NOPTS_VALUE);
+  context->start_time = entry["starttime"].asInteger(AV_NOPTS_VALUE);
+  context->bit_rate = entry["bitrate"].asInteger();
+
+  // rewriting the entry marks it as used recently for Prune
+  Write(GetEntryPath(key), json);
+
+  return true;
+}
+
+void CDemuxProbeCache::Store(const std::string& key, const std::string& layout, const AVFormatContext* context) const
+{
+  if (key.empty())
+    return;
+
+  CVariant entry(CVariant::VariantTypeObject);
+  entry["layout"] = layout;
+  entry["duration"] = context->duration;
+  entry["starttime"] = context->start_time;
+  entry["bitrate"] = context->bit_rate;
+
+  CVariant streams(CVariant::VariantTypeArray);
+  for (unsigned int i = 0; i < context->nb_streams; i++)
+  {
+    CVariant stream(CVariant::VariantTypeObject);
+    StoreStream(context->streams[i], stream);
+    streams.push_back(stream);
+  }
+  entry["streams"] = streams;
+
+  std::string json;
+  if (!CJSONVariantWriter::Write(entry, json, true))
+    return;
+
+  if (Write(GetEntryPath(key), json))
+    Prune(".json", m_maxSize);
+}
+
+void CDemuxProbeCache::Remove(const std::string& key) const
+{
+  if (!key.empty())
+    XFILE::CFile::Delete(GetEntryPath(key));
+}
+
+std::string CDemuxProbeCache::GetKeyframeIndexPath(const std::string& key) const
+{
+  return m_path + key + ".keyframes";
+}
+
+void CDemuxProbeCache::PruneKeyframeIndexes(uint64_t maxSize) const
+{
+  Prune(".keyframes", maxSize);
+}
+
+std::string CDemuxProbeCache::GetEntryPath(const std::string& key) const
+{
+  return m_path + key + ".json";
+}
+
+bool CDemuxProbeCache::Write(const std::string& path, const std::string& data) const
+{
+  if (!XFILE::CDirectory::Exists(m_path))
+    XFILE::CDirectory::Create(m_path);
+
+  XFILE::CFile file;
+  if (!file.OpenForWrite(path, true) ||
+      file.Write(data.c_str(), data.size()) != static_cast<ssize_t>(data.size()))
+  {
+    CLog::Log(LOGWARNING, "CDemuxProbeCache::Write - failed to write %s", path.c_str());
+    file.Close();
+    XFILE::CFile::Delete(path);
+    return false;
+  }
+  return true;
+}
+
+void CDemuxProbeCache::Prune(const std::string& extension, uint64_t maxSize) const
+{
+  CFileItemList items;
+  if (!XFILE::CDirectory::GetDirectory(m_path, items, extension,
+                                       XFILE::DIR_FLAG_NO_FILE_DIRS | XFILE::DIR_FLAG_BYPASS_CACHE))
+    return;
+
+  std::vector<CFileItemPtr> entries;
+  uint64_t size = 0;
+  for (int i = 0; i < items.Size(); i++)
+  {
+    if (items[i]->m_bIsFolder)
+      continue;
+    entries.push_back(items[i]);
+    size += items[i]->m_dwSize;
+  }
+  if (size <= maxSize)
+    return;
+
+  // entries are rewritten when used, the oldest write is the least recent use
+  std::sort(entries.begin(), entries.end(), [](const CFileItemPtr& a, const CFileItemPtr& b)
+  {
+    return a->m_dateTime < b->m_dateTime;
+  });
+
+  unsigned int removed = 0;
+  for (const auto& item : entries)
+  {
+    if (size <= maxSize)
+      break;
+    XFILE::CFile::Delete(item->GetPath());
+    size -= item->m_dwSize;
+    removed++;
+  }
+  CLog::Log(LOGDEBUG, "CDemuxProbeCache::Prune - removed %u %s files", removed, extension.c_str());
+}
+
+void CDemuxProbeCache::StoreStream(const AVStream* stream, CVariant& entry)
+{
+  const AVCodecParameters* par = stream->codecpar;
+
+  entry["codectag"] = par->codec_tag;
+  entry["format"] = par->format;
+  entry["bitrate"] = par->bit_rate;
+  entry["bitspercodedsample"] = par->bits_per_coded_sample;
+  entry["bitsperrawsample"] = par->bits_per_raw_sample;
+  entry["profile"] = par->profile;
+  entry["level"] = par->level;
+  entry["width"] = par->width;
+  entry["height"] = par->height;
+  entry["codecaspect"] = RationalToVariant(par->sample_aspect_ratio);
+  entry["fieldorder"] = par->field_order;
+  entry["colorrange"] = par->color_range;
+  entry["colorprimaries"] = par->color_primaries;
+  entry["colortrc"] = par->color_trc;
+  entry["colorspace"] = par->color_space;
+  entry["chromalocation"] = par->chroma_location;
+  entry["videodelay"] = par->video_delay;
+  entry["channellayout"] = par->channel_layout;
+  entry["channels"] = par->channels;
+  entry["samplerate"] = par->sample_rate;
+  entry["blockalign"] = par->block_align;
+  entry["framesize"] = par->frame_size;
+  entry["initialpadding"] = par->initial_padding;
+  entry["trailingpadding"] = par->trailing_padding;
+  entry["seekpreroll"] = par->seek_preroll;
+  entry["extradata"] = Base64::Encode(reinterpret_cast<const char*>(par->extradata), par->extradata_size);
+
+  entry["avgframerate"] = RationalToVariant(stream->avg_frame_rate);
+  entry["rframerate"] = RationalToVariant(stream->r_frame_rate);
+  entry["aspect"] = RationalToVariant(stream->sample_aspect_ratio);
+  entry["starttime"] = stream->start_time;
+  entry["duration"] = stream->duration;
+  entry["infoframes"] = stream->codec_info_nb_frames;
+}
+
+void CDemuxProbeCache::ApplyStream(const CVariant& entry, AVStream* stream, uint8_t* extradata, int extradataSize)
+{
+  AVCodecParameters* par = stream->codecpar;
+
+  // extradata is the replacement of differing extradata, nullptr if it is unchanged
+  if (extradata || extradataSize == 0)
+  {
+    av_freep(&par->extradata);
+    par->extradata = extradata;
+    par->extradata_size = extradataSize;
+  }
+
+  par->codec_tag = static_cast<uint32_t>(entry["codectag"].asUnsignedInteger());
+  par->format = entry["format"].asInteger32(-1);
+  par->bit_rate = entry["bitrate"].asInteger();
+  par->bits_per_coded_sample = entry["bitspercodedsample"].asInteger32();
+  par->bits_per_raw_sample = entry["bitsperrawsample"].asInteger32();
+  par->profile = entry["profile"].asInteger32(FF_PROFILE_UNKNOWN);
+  par->level = entry["level"].asInteger32(FF_LEVEL_UNKNOWN);
+  par->width = entry["width"].asInteger32();
+  par->height = entry["height"].asInteger32();
+  par->sample_aspect_ratio = VariantToRational(entry["codecaspect"]);
+  par->field_order = static_cast<AVFieldOrder>(entry["fieldorder"].asInteger32());
+  par->color_range = static_cast<AVColorRange>(entry["colorrange"].asInteger32());
+  par->color_primaries = static_cast<AVColorPrimaries>(entry["colorprimaries"].asInteger32());
+  par->color_trc = static_cast<AVColorTransferCharacteristic>(entry["colortrc"].asInteger32());
+  par->color_space = static_cast<AVColorSpace>(entry["colorspace"].asInteger32());
+  par->chroma_location = static_cast<AVChromaLocation>(entry["chromalocation"].asInteger32());
+  par->video_delay = entry["videodelay"].asInteger32();
+  par->channel_layout = entry["channellayout"].asUnsignedInteger();
+  par->channels = entry["channels"].asInteger32();
+  par->sample_rate = entry["samplerate"].asInteger32();
+  par->block_align = entry["blockalign"].asInteger32();
+  par->frame_size = entry["framesize"].asInteger32();
+  par->initial_padding = entry["initialpadding"].asInteger32();
+  par->trailing_padding = entry["trailingpadding"].asInteger32();
+  par->seek_preroll = entry["seekpreroll"].asInteger32();
+
+  stream->avg_frame_rate = VariantToRational(entry["avgframerate"]);
+  stream->r_frame_rate = VariantToRational(entry["rframerate"]);
+  stream->sample_aspect_ratio = VariantToRational(entry["aspect"]);
+  stream->start_time = entry["starttime"].asInteger(AV_NOPTS_VALUE);
+  stream->duration = entry["duration"].asInteger(AV_NOPTS_VALUE);
+  stream->codec_info_nb_frames = entry["infoframes"].asInteger32();
+}
@@ -0,0 +1,90 @@
+/*
+ *  Copyright (C) 2019 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "PlatformDefs.h" // for __stat64
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+extern "C" {
+#include "libavformat/avformat.h"
+}
+
+class CVariant;
+
+/*!
+ * \brief Persists the results of avformat_find_stream_info.
+ *
+ * After a full probe the codec parameters, timing and duration of all
+ * streams are stored under a key built from path, size and modification time
+ * of the file. When the same file is opened again and the stream layout
+ * found by avformat_open_input still matches the stored one, the stored
+ * results are applied to the format context and the probe can be skipped.
+ * Entries live in a directory next to the video database, one file per key.
+ * Once they exceed the maximum size, the entries used least recently are
+ * deleted.
+ */
+class CDemuxProbeCache
+{
+public:
+  explicit CDemuxProbeCache(const std::string& path = "special://database/ProbeCache/");
+
+  static const uint64_t DEFAULT_MAX_SIZE = 4 * 1024 * 1024;
+
+  void SetMaxSize(uint64_t bytes) { m_maxSize = bytes; }
+
+  /*!
+   * \brief Build the key of a file from the stat of the open file
+   * \return the key or an empty string if the file can't be identified
+   */
+  static std::string GetKey(const std::string& fileName, const struct __stat64& st);
+
+  /*!
+   * \brief Describe the streams found by avformat_open_input, must be taken
+   * before avformat_find_stream_info
+   */
+  static std::string GetLayout(const AVFormatContext* context);
+
+  /*!
+   * \brief Apply the stored probe results of key to context
+   * \return false if nothing is stored, the layout doesn't match or the
+   * results can't be applied, context is left untouched in these cases
+   */
+  bool Apply(const std::string& key, const std::string& layout, AVFormatContext* context) const;
+
+  /*!
+   * \brief Store the probe results of context, then delete the entries used
+   * least recently above the maximum size
+   */
+  void Store(const std::string& key, const std::string& layout, const AVFormatContext* context) const;
+
+  void Remove(const std::string& key) const;
+
+  /*!
+   * \brief Path of the keyframe index stored next to the probe results of key
+   */
+  std::string GetKeyframeIndexPath(const std::string& key) const;
+
+  /*!
+   * \brief Delete the keyframe indexes stored longest ago above maxSize bytes
+   */
+  void PruneKeyframeIndexes(uint64_t maxSize) const;
+
+private:
+  std::string GetEntryPath(const std::string& key) const;
+  bool Write(const std::string& path, const std::string& data) const;
+  void Prune(const std::string& extension, uint64_t maxSize) const;
+  static void StoreStream(const AVStream* stream, CVariant& entry);
+  static void ApplyStream(const CVariant& entry, AVStream* stream, uint8_t* extradata, int extradataSize);
+
+  std::string m_path;
+  uint64_t m_maxSize = DEFAULT_MAX_SIZE;
+};
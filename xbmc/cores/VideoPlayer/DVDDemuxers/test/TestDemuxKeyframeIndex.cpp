@@ -0,0 +1,155 @@
+/*
+ *  Copyright (C) 2019 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "FileItem.h"
+#include "cores/VideoPlayer/DVDDemuxers/DemuxKeyframeIndex.h"
+#include "cores/VideoPlayer/DVDDemuxers/DemuxProbeCache.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+
+#include "gtest/gtest.h"
+
+using namespace XFILE;
+
+namespace
+{
+// keyframes every 2 s from 10 s to 20 s, pts in 90 kHz
+void AddKeyframes(CDemuxKeyframeIndex& index, int64_t from, int64_t to)
+{
+  for (int64_t time = from; time <= to; time += 2000)
+    index.Add(time, time * 90, time * 1000);
+}
+}
+
+class TestDemuxKeyframeIndex : public testing::Test
+{
+protected:
+  TestDemuxKeyframeIndex()
+  {
+    m_path = URIUtils::AddFileToFolder(CSpecialProtocol::TranslatePath("special://temp/"), "TestDemuxKeyframeIndex");
+    URIUtils::AddSlashAtEnd(m_path);
+    CDirectory::RemoveRecursive(m_path);
+  }
+
+  ~TestDemuxKeyframeIndex() override
+  {
+    CDirectory::RemoveRecursive(m_path);
+  }
+
+  std::string m_path;
+};
+
+TEST_F(TestDemuxKeyframeIndex, AddFind)
+{
+  CDemuxKeyframeIndex index;
+  AddKeyframes(index, 10000, 20000);
+  EXPECT_EQ(6u, index.Size());
+  EXPECT_TRUE(index.IsChanged());
+
+  SKeyframe keyframe;
+  ASSERT_TRUE(index.Find(12000, true, keyframe));
+  EXPECT_EQ(12000 * 90, keyframe.pts);
+  EXPECT_EQ(12000 * 1000, keyframe.pos);
+
+  ASSERT_TRUE(index.Find(13000, true, keyframe));
+  EXPECT_EQ(12000 * 90, keyframe.pts);
+  ASSERT_TRUE(index.Find(13000, false, keyframe));
+  EXPECT_EQ(14000 * 90, keyframe.pts);
+
+  // outside of the played part
+  EXPECT_FALSE(index.Find(5000, true, keyframe));
+  EXPECT_FALSE(index.Find(21000, false, keyframe));
+  ASSERT_TRUE(index.Find(20000, false, keyframe));
+  EXPECT_EQ(20000 * 90, keyframe.pts);
+}
+
+TEST_F(TestDemuxKeyframeIndex, Discontinuity)
+{
+  CDemuxKeyframeIndex index;
+  AddKeyframes(index, 10000, 14000);
+  index.Discontinuity();
+  AddKeyframes(index, 30000, 34000);
+
+  SKeyframe keyframe;
+  EXPECT_TRUE(index.Find(11000, true, keyframe));
+  EXPECT_TRUE(index.Find(31000, true, keyframe));
+  // the keyframes between 14 s and 30 s were never seen
+  EXPECT_FALSE(index.Find(20000, true, keyframe));
+  EXPECT_FALSE(index.Find(20000, false, keyframe));
+
+  // playing the gap connects both parts
+  index.Discontinuity();
+  AddKeyframes(index, 14000, 30000);
+  ASSERT_TRUE(index.Find(21000, true, keyframe));
+  EXPECT_EQ(20000 * 90, keyframe.pts);
+}
+
+TEST_F(TestDemuxKeyframeIndex, Insert)
+{
+  CDemuxKeyframeIndex index;
+  AddKeyframes(index, 10000, 14000);
+
+  // a keyframe inside a known interval, the interval wasn't complete
+  index.Discontinuity();
+  index.Add(11000, 11000 * 90, 11000 * 1000);
+
+  SKeyframe keyframe;
+  EXPECT_FALSE(index.Find(10500, false, keyframe));
+  EXPECT_FALSE(index.Find(11500, false, keyframe));
+  EXPECT_TRUE(index.Find(11000, false, keyframe));
+  EXPECT_TRUE(index.Find(13000, false, keyframe));
+}
+
+TEST_F(TestDemuxKeyframeIndex, SaveLoad)
+{
+  const std::string path = m_path + "movie.keyframes";
+
+  CDemuxKeyframeIndex index;
+  AddKeyframes(index, 10000, 20000);
+  ASSERT_TRUE(index.Save(path, 1));
+  EXPECT_FALSE(index.IsChanged());
+
+  CDemuxKeyframeIndex loaded;
+  ASSERT_TRUE(loaded.Load(path, 1));
+  EXPECT_EQ(index.Size(), loaded.Size());
+  EXPECT_FALSE(loaded.IsChanged());
+
+  SKeyframe keyframe;
+  ASSERT_TRUE(loaded.Find(15000, true, keyframe));
+  EXPECT_EQ(14000 * 90, keyframe.pts);
+  EXPECT_EQ(14000 * 1000, keyframe.pos);
+
+  // stored for another stream
+  EXPECT_FALSE(loaded.Load(path, 0));
+  EXPECT_EQ(0u, loaded.Size());
+  EXPECT_FALSE(loaded.Load(m_path + "missing.keyframes", 1));
+}
+
+TEST_F(TestDemuxKeyframeIndex, Prune)
+{
+  CDemuxKeyframeIndex index;
+  AddKeyframes(index, 10000, 20000);
+
+  CDemuxProbeCache cache(m_path);
+  for (int i = 0; i < 10; i++)
+    ASSERT_TRUE(index.Save(cache.GetKeyframeIndexPath(StringUtils::Format("movie%d", i)), 1));
+
+  struct __stat64 st;
+  ASSERT_EQ(0, CFile::Stat(cache.GetKeyframeIndexPath("movie0"), &st));
+  const uint64_t indexSize = st.st_size;
+
+  // room for three indexes
+  cache.PruneKeyframeIndexes(indexSize * 3 + indexSize / 2);
+
+  CFileItemList items;
+  ASSERT_TRUE(CDirectory::GetDirectory(m_path, items, ".keyframes", DIR_FLAG_NO_FILE_DIRS | DIR_FLAG_BYPASS_CACHE));
+  EXPECT_EQ(3, items.Size());
+}
@@ -0,0 +1,138 @@
+/*
+ *  Copyright (C) 2019 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/VideoPlayer/DVDDemuxers/DemuxPacketPool.h"
+
+#include <cstring>
+#include <set>
+#include <vector>
+
+extern "C" {
+#include "libavcodec/avcodec.h"
+}
+
+#include "gtest/gtest.h"
+
+TEST(TestDemuxPacketPool, Recycles)
+{
+  CDemuxPacketPool pool;
+
+  DemuxPacket* packet = pool.Allocate(1000);
+  ASSERT_TRUE(packet != nullptr);
+  ASSERT_TRUE(packet->pData != nullptr);
+  uint8_t* data = packet->pData;
+  packet->iSize = 1000;
+  packet->iStreamId = 3;
+  packet->pts = 1.0;
+  memset(packet->pData, 0xff, 1024);
+  pool.Release(packet);
+
+  SDemuxPacketPoolStats stats = pool.GetStats();
+  EXPECT_EQ(0u, stats.hits);
+  EXPECT_EQ(1u, stats.misses);
+  EXPECT_GT(stats.bytesResident, 1000u);
+
+  // a larger packet of the same size class gets the parked one, reset
+  DemuxPacket* reused = pool.Allocate(1500);
+  EXPECT_EQ(packet, reused);
+  EXPECT_EQ(data, reused->pData);
+  EXPECT_EQ(0, reused->iSize);
+  EXPECT_EQ(-1, reused->iStreamId);
+  EXPECT_EQ(DVD_NOPTS_VALUE, reused->pts);
+  for (unsigned int i = 1500; i < 1500 + AV_INPUT_BUFFER_PADDING_SIZE; i++)
+    ASSERT_EQ(0, reused->pData[i]) << "padding byte " << i;
+
+  stats = pool.GetStats();
+  EXPECT_EQ(1u, stats.hits);
+  EXPECT_EQ(0u, stats.bytesResident);
+  pool.Release(reused);
+}
+
+TEST(TestDemuxPacketPool, SizeClasses)
+{
+  CDemuxPacketPool pool;
+
+  DemuxPacket* small = pool.Allocate(100);
+  DemuxPacket* large = pool.Allocate(100000);
+  pool.Release(small);
+  pool.Release(large);
+
+  // a payload doesn't fit the smaller class, it's served from its own
+  DemuxPacket* packet = pool.Allocate(90000);
+  EXPECT_EQ(large, packet);
+  pool.Release(packet);
+  packet = pool.Allocate(200 - AV_INPUT_BUFFER_PADDING_SIZE);
+  EXPECT_EQ(small, packet);
+  pool.Release(packet);
+
+  // a class without parked payloads gets a new one
+  SDemuxPacketPoolStats before = pool.GetStats();
+  packet = pool.Allocate(5000);
+  EXPECT_NE(small, packet);
+  EXPECT_NE(large, packet);
+  EXPECT_EQ(before.misses + 1, pool.GetStats().misses);
+  pool.Release(packet);
+}
+
+TEST(TestDemuxPacketPool, EmptyPackets)
+{
+  CDemuxPacketPool pool;
+
+  DemuxPacket* packet = pool.Allocate(0);
+  ASSERT_TRUE(packet != nullptr);
+  EXPECT_TRUE(packet->pData == nullptr);
+  pool.Release(packet);
+
+  // packets without payload get one when reused for data
+  DemuxPacket* reused = pool.Allocate(64);
+  EXPECT_EQ(packet, reused);
+  EXPECT_TRUE(reused->pData != nullptr);
+  pool.Release(reused);
+}
+
+TEST(TestDemuxPacketPool, ResidentCap)
+{
+  CDemuxPacketPool pool;
+  pool.SetMaxResidentBytes(64 * 1024);
+
+  std::vector<DemuxPacket*> packets;
+  for (int i = 0; i < 8; i++)
+    packets.push_back(pool.Allocate(16000));
+  for (auto packet : packets)
+    pool.Release(packet);
+
+  // 16000 bytes round up to 16 KiB, three of them fit below the cap with their packets
+  SDemuxPacketPoolStats stats = pool.GetStats();
+  EXPECT_LE(stats.bytesResident, 64u * 1024);
+  EXPECT_GT(stats.bytesResident, 2u * 16 * 1024);
+
+  std::set<DemuxPacket*> parked;
+  for (int i = 0; i < 8; i++)
+    parked.insert(pool.Allocate(16000));
+  stats = pool.GetStats();
+  EXPECT_EQ(3u, stats.hits);
+  EXPECT_EQ(0u, stats.bytesResident);
+  for (auto packet : parked)
+    pool.Release(packet);
+
+  pool.Clear();
+  EXPECT_EQ(0u, pool.GetStats().bytesResident);
+}
+
+TEST(TestDemuxPacketPool, Unpooled)
+{
+  CDemuxPacketPool pool;
+
+  // payloads above the largest class are freed on release
+  size_t maxClass = static_cast<size_t>(1) << CDemuxPacketPool::MAX_CLASS_SHIFT;
+  DemuxPacket* packet = pool.Allocate(maxClass);
+  ASSERT_TRUE(packet != nullptr);
+  packet->pData[maxClass - 1] = 1;
+  pool.Release(packet);
+  EXPECT_EQ(0u, pool.GetStats().bytesResident);
+}
@@ -0,0 +1,237 @@
+/*
+ *  Copyright (C) 2019 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "FileItem.h"
+#include "cores/VideoPlayer/DVDDemuxers/DemuxProbeCache.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "utils/JSONVariantParser.h"
+#include "utils/JSONVariantWriter.h"
+#include "utils/URIUtils.h"
+#include "utils/Variant.h"
+#include "utils/auto_buffer.h"
+
+#include <cstring>
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "libavutil/mem.h"
+}
+
+using namespace XFILE;
+
+namespace
+{
+const uint8_t EXTRADATA[] = { 1, 100, 0, 31, 255 };
+
+AVFormatContext* CreateContext(unsigned int streams)
+{
+  AVFormatContext* context = avformat_alloc_context();
+  for (unsigned int i = 0; i < streams; i++)
+  {
+    AVStream* stream = avformat_new_stream(context, nullptr);
+    stream->id = i + 1;
+    stream->time_base = { 1, 90000 };
+    stream->codecpar->codec_type = i == 0 ? AVMEDIA_TYPE_VIDEO : AVMEDIA_TYPE_AUDIO;
+    stream->codecpar->codec_id = i == 0 ? AV_CODEC_ID_H264 : AV_CODEC_ID_AAC;
+  }
+  return context;
+}
+
+// what avformat_find_stream_info would find
+void Probe(AVFormatContext* context)
+{
+  context->duration = 5400000000;
+  context->start_time = 0;
+  context->bit_rate = 8000000;
+
+  AVCodecParameters* video = context->streams[0]->codecpar;
+  video->width = 1920;
+  video->height = 1080;
+  video->profile = 100;
+  video->level = 41;
+  video->extradata = static_cast<uint8_t*>(av_mallocz(sizeof(EXTRADATA) + AV_INPUT_BUFFER_PADDING_SIZE));
+  memcpy(video->extradata, EXTRADATA, sizeof(EXTRADATA));
+  video->extradata_size = sizeof(EXTRADATA);
+  context->streams[0]->avg_frame_rate = { 24000, 1001 };
+
+  for (unsigned int i = 1; i < context->nb_streams; i++)
+  {
+    context->streams[i]->codecpar->channels = 6;
+    context->streams[i]->codecpar->sample_rate = 48000;
+  }
+}
+
+struct __stat64 MakeStat(int64_t size, int64_t mtime)
+{
+  struct __stat64 st;
+  memset(&st, 0, sizeof(st));
+  st.st_size = size;
+  st.st_mtime = mtime;
+  return st;
+}
+}
+
+class TestDemuxProbeCache : public testing::Test
+{
+protected:
+  TestDemuxProbeCache()
+  {
+    m_path = URIUtils::AddFileToFolder(CSpecialProtocol::TranslatePath("special://temp/"), "TestDemuxProbeCache");
+    URIUtils::AddSlashAtEnd(m_path);
+    CDirectory::RemoveRecursive(m_path);
+    m_key = CDemuxProbeCache::GetKey("/movies/movie.mkv", MakeStat(4000000000, 1546300800));
+  }
+
+  ~TestDemuxProbeCache() override
+  {
+    CDirectory::RemoveRecursive(m_path);
+  }
+
+  std::string GetEntryPath(const std::string& key) const { return m_path + key + ".json"; }
+
+  std::string m_path;
+  std::string m_key;
+};
+
+TEST_F(TestDemuxProbeCache, Key)
+{
+  EXPECT_FALSE(m_key.empty());
+  EXPECT_EQ(m_key, CDemuxProbeCache::GetKey("/movies/movie.mkv", MakeStat(4000000000, 1546300800)));
+  EXPECT_NE(m_key, CDemuxProbeCache::GetKey("/movies/movie.mkv", MakeStat(4000000001, 1546300800)));
+  EXPECT_NE(m_key, CDemuxProbeCache::GetKey("/movies/movie.mkv", MakeStat(4000000000, 1546300801)));
+  EXPECT_NE(m_key, CDemuxProbeCache::GetKey("/movies/other.mkv", MakeStat(4000000000, 1546300800)));
+  EXPECT_TRUE(CDemuxProbeCache::GetKey("/movies/movie.mkv", MakeStat(0, 1546300800)).empty());
+}
+
+TEST_F(TestDemuxProbeCache, StoreApply)
+{
+  CDemuxProbeCache cache(m_path);
+
+  AVFormatContext* probed = CreateContext(2);
+  const std::string layout = CDemuxProbeCache::GetLayout(probed);
+  Probe(probed);
+  cache.Store(m_key, layout, probed);
+  avformat_free_context(probed);
+  EXPECT_TRUE(CFile::Exists(GetEntryPath(m_key)));
+
+  AVFormatContext* context = CreateContext(2);
+  ASSERT_EQ(layout, CDemuxProbeCache::GetLayout(context));
+  ASSERT_TRUE(cache.Apply(m_key, layout, context));
+
+  EXPECT_EQ(5400000000, context->duration);
+  EXPECT_EQ(8000000, context->bit_rate);
+  const AVCodecParameters* video = context->streams[0]->codecpar;
+  EXPECT_EQ(1920, video->width);
+  EXPECT_EQ(1080, video->height);
+  EXPECT_EQ(41, video->level);
+  ASSERT_EQ(static_cast<int>(sizeof(EXTRADATA)), video->extradata_size);
+  EXPECT_EQ(0, memcmp(EXTRADATA, video->extradata, sizeof(EXTRADATA)));
+  EXPECT_EQ(24000, context->streams[0]->avg_frame_rate.num);
+  EXPECT_EQ(1001, context->streams[0]->avg_frame_rate.den);
+  EXPECT_EQ(6, context->streams[1]->codecpar->channels);
+  EXPECT_EQ(48000, context->streams[1]->codecpar->sample_rate);
+  avformat_free_context(context);
+}
+
+TEST_F(TestDemuxProbeCache, LayoutChanged)
+{
+  CDemuxProbeCache cache(m_path);
+
+  AVFormatContext* probed = CreateContext(2);
+  const std::string layout = CDemuxProbeCache::GetLayout(probed);
+  Probe(probed);
+  cache.Store(m_key, layout, probed);
+  avformat_free_context(probed);
+
+  AVFormatContext* context = CreateContext(3);
+  const std::string otherLayout = CDemuxProbeCache::GetLayout(context);
+  EXPECT_NE(layout, otherLayout);
+  EXPECT_FALSE(cache.Apply(m_key, otherLayout, context));
+  EXPECT_EQ(0, context->streams[0]->codecpar->width);
+
+  EXPECT_FALSE(cache.Apply(CDemuxProbeCache::GetKey("/movies/other.mkv", MakeStat(1, 1)), otherLayout, context));
+  avformat_free_context(context);
+}
+
+TEST_F(TestDemuxProbeCache, AllOrNothing)
+{
+  CDemuxProbeCache cache(m_path);
+
+  AVFormatContext* probed = CreateContext(2);
+  const std::string layout = CDemuxProbeCache::GetLayout(probed);
+  Probe(probed);
+  cache.Store(m_key, layout, probed);
+  avformat_free_context(probed);
+
+  // the entry of the second stream is damaged
+  CFile file;
+  XUTILS::auto_buffer buffer;
+  ASSERT_GT(file.LoadFile(GetEntryPath(m_key), buffer), 0);
+  CVariant entry;
+  ASSERT_TRUE(CJSONVariantParser::Parse(std::string(buffer.get(), buffer.size()), entry));
+  entry["streams"][1] = 0;
+  std::string json;
+  ASSERT_TRUE(CJSONVariantWriter::Write(entry, json, true));
+  ASSERT_TRUE(file.OpenForWrite(GetEntryPath(m_key), true));
+  file.Write(json.c_str(), json.size());
+  file.Close();
+
+  AVFormatContext* context = CreateContext(2);
+  EXPECT_FALSE(cache.Apply(m_key, layout, context));
+  EXPECT_EQ(0, context->streams[0]->codecpar->width);
+  EXPECT_EQ(0, context->streams[0]->codecpar->extradata_size);
+  EXPECT_EQ(0, context->bit_rate);
+  avformat_free_context(context);
+}
+
+TEST_F(TestDemuxProbeCache, CorruptEntry)
+{
+  CDemuxProbeCache cache(m_path);
+  ASSERT_TRUE(CDirectory::Create(m_path));
+
+  CFile file;
+  ASSERT_TRUE(file.OpenForWrite(GetEntryPath(m_key), true));
+  file.Write("{ not json", 10);
+  file.Close();
+
+  AVFormatContext* context = CreateContext(1);
+  EXPECT_FALSE(cache.Apply(m_key, CDemuxProbeCache::GetLayout(context), context));
+  EXPECT_FALSE(CFile::Exists(GetEntryPath(m_key)));
+  avformat_free_context(context);
+}
+
+TEST_F(TestDemuxProbeCache, MaxSize)
+{
+  CDemuxProbeCache cache(m_path);
+
+  AVFormatContext* probed = CreateContext(2);
+  const std::string layout = CDemuxProbeCache::GetLayout(probed);
+  Probe(probed);
+  cache.Store(m_key, layout, probed);
+
+  struct __stat64 st;
+  ASSERT_EQ(0, CFile::Stat(GetEntryPath(m_key), &st));
+  const uint64_t entrySize = st.st_size;
+
+  // room for three entries
+  cache.SetMaxSize(entrySize * 3 + entrySize / 2);
+  for (int i = 0; i < 10; i++)
+    cache.Store(CDemuxProbeCache::GetKey("/movies/movie.mkv", MakeStat(1000 + i, 1546300800)), layout, probed);
+  avformat_free_context(probed);
+
+  CFileItemList items;
+  ASSERT_TRUE(CDirectory::GetDirectory(m_path, items, ".json", DIR_FLAG_NO_FILE_DIRS | DIR_FLAG_BYPASS_CACHE));
+  uint64_t size = 0;
+  for (int i = 0; i < items.Size(); i++)
+    size += items[i]->m_dwSize;
+  EXPECT_EQ(3, items.Size());
+  EXPECT_LE(size, entrySize * 3 + entrySize / 2);
+}
@@ -32,6 +32,7 @@
 #include "DVDCodecs/Video/DVDVideoCodecFFmpeg.h"
 #include "DVDDemuxers/DVDDemuxVobsub.h"
 #include "Process/ProcessInfo.h"
+#include "VideoRenderers/SeparableScaler.h"
 
 #include "libavcodec/avcodec.h"
 #include "libswscale/swscale.h"
@@ -43,6 +44,7 @@
 
 #include <cstdlib>
 #include <memory>
+#include <vector>
 
 extern "C" {
 #include "libavformat/avformat.h"
@@ -251,8 +253,8 @@ bool CDVDFileInfo::ExtractThumb(const CFileItem& fileItem,
             unsigned int nHeight = (unsigned int)((double)nWidth / aspect);
 
             uint8_t *pOutBuf = (uint8_t*)av_malloc(nWidth * nHeight * 4);
-            struct SwsContext *context = sws_getContext(picture.iWidth, picture.iHeight,
-                  AV_PIX_FMT_YUV420P, nWidth, nHeight, AV_PIX_FMT_BGRA, SWS_FAST_BILINEAR, NULL, NULL, NULL);
+            struct SwsContext *context = sws_getContext(nWidth, nHeight,
+                  AV_PIX_FMT_YUV420P, nWidth, nHeight, AV_PIX_FMT_BGRA, SWS_POINT, NULL, NULL, NULL);
 
             if (context)
             {
@@ -260,12 +262,27 @@ bool CDVDFileInfo::ExtractThumb(const CFileItem& fileItem,
               int stride[YuvImage::MAX_PLANES];
               picture.videoBuffer->GetPlanes(planes);
               picture.videoBuffer->GetStrides(stride);
-              uint8_t *src[4]= { planes[0], planes[1], planes[2], 0 };
-              int srcStride[] = { stride[0], stride[1], stride[2], 0 };
+
+              // downscale the planes with a proper kernel, swscale only converts
+              int width[] = { (int)nWidth, (int)(nWidth + 1) / 2, (int)(nWidth + 1) / 2 };
+              int height[] = { (int)nHeight, (int)(nHeight + 1) / 2, (int)(nHeight + 1) / 2 };
+              int srcWidth[] = { picture.iWidth, (picture.iWidth + 1) / 2, (picture.iWidth + 1) / 2 };
+              int srcHeight[] = { picture.iHeight, (picture.iHeight + 1) / 2, (picture.iHeight + 1) / 2 };
+              std::vector<uint8_t> scaled[3];
+              CSeparableScaler scaler(VS_SCALINGMETHOD_LANCZOS3, 1);
+              for (int i = 0; i < 3; i++)
+              {
+                scaled[i].resize(width[i] * height[i]);
+                scaler.Scale(planes[i], stride[i], srcWidth[i], srcHeight[i],
+                             scaled[i].data(), width[i], width[i], height[i]);
+              }
+
+              uint8_t *src[4]= { scaled[0].data(), scaled[1].data(), scaled[2].data(), 0 };
+              int srcStride[] = { width[0], width[1], width[2], 0 };
               uint8_t *dst[] = { pOutBuf, 0, 0, 0 };
               int dstStride[] = { (int)nWidth*4, 0, 0, 0 };
               int orientation = DegreeToOrientation(hint.orientation);
-              sws_scale(context, src, srcStride, 0, picture.iHeight, dst, dstStride);
+              sws_scale(context, src, srcStride, 0, nHeight, dst, dstStride);
               sws_freeContext(context);
 
               details.width = nWidth;
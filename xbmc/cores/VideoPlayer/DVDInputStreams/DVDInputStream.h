@@ -169,6 +169,25 @@ public:
    */
   virtual bool GetCacheStatus(XFILE::SCacheStatus *status) { return false; }
 
+  /*! \brief Stat of the open input, without another request to its source
+   \return true when the stat was successfully obtained
+   */
+  virtual bool GetFileStat(struct __stat64 *buffer) { return false; }
+
+  /*! \brief Whether buffered input can be borrowed with LendBuffer
+   */
+  virtual bool CanLendBuffer() { return false; }
+
+  /*! \brief Borrow buffered input at the read position instead of copying it
+   \param data receives a pointer to the data, valid until ReturnBuffer
+   \return number of bytes at data, 0 at end of stream, -1 on error
+   */
+  virtual int LendBuffer(const uint8_t** data, int size) { return -1; }
+
+  /*! \brief Give back borrowed input, the read position moves by used bytes
+   */
+  virtual void ReturnBuffer(int used) {}
+
   bool IsStreamType(DVDStreamType type) const { return m_streamType == type; }
   virtual bool IsEOF() = 0;
   virtual BitstreamStats GetBitstreamStats() const { return m_stats; }
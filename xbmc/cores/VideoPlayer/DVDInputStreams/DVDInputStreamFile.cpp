@@ -156,6 +156,44 @@ bool CDVDInputStreamFile::GetCacheStatus(XFILE::SCacheStatus *status)
     return false;
 }
 
+bool CDVDInputStreamFile::GetFileStat(struct __stat64 *buffer)
+{
+  return m_pFile && m_pFile->Stat(buffer) == 0;
+}
+
+bool CDVDInputStreamFile::CanLendBuffer()
+{
+  return m_pFile && m_pFile->IoControl(IOCTRL_CACHE_LEND, NULL) == 0;
+}
+
+int CDVDInputStreamFile::LendBuffer(const uint8_t** data, int size)
+{
+  if(!m_pFile) return -1;
+
+  SCacheLend lend = { nullptr, static_cast<size_t>(size) };
+  if (m_pFile->IoControl(IOCTRL_CACHE_LEND, &lend) < 0)
+    return -1;
+
+  if (lend.size == 0)
+    m_eof = true;
+
+  *data = lend.data;
+  return static_cast<int>(lend.size);
+}
+
+void CDVDInputStreamFile::ReturnBuffer(int used)
+{
+  if (!m_pFile || used <= 0)
+    return;
+
+  SCacheLend lend = { nullptr, static_cast<size_t>(used) };
+  m_pFile->IoControl(IOCTRL_CACHE_RETURN, &lend);
+
+  // CFile only counts what passes through its Read
+  if (m_pFile->GetBitstreamStats())
+    m_pFile->GetBitstreamStats()->AddSampleBytes(used);
+}
+
 BitstreamStats CDVDInputStreamFile::GetBitstreamStats() const
 {
   if (!m_pFile)
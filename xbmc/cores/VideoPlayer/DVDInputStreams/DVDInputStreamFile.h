@@ -26,6 +26,10 @@ public:
   int GetBlockSize() override;
   void SetReadRate(unsigned rate) override;
   bool GetCacheStatus(XFILE::SCacheStatus *status) override;
+  bool GetFileStat(struct __stat64 *buffer) override;
+  bool CanLendBuffer() override;
+  int LendBuffer(const uint8_t** data, int size) override;
+  void ReturnBuffer(int used) override;
 
 protected:
   XFILE::CFile* m_pFile = nullptr;
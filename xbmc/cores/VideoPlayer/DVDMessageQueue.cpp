@@ -41,6 +41,23 @@ void CDVDMessageQueue::Init()
   m_drain = false;
 }
 
+void CDVDMessageQueue::SetLockFree(bool lockFree)
+{
+  CSingleLock lock(m_section);
+
+  if (m_bInitialized)
+  {
+    CLog::Log(LOGERROR, "CDVDMessageQueue(%s)::SetLockFree - queue already initialized", m_owner.c_str());
+    return;
+  }
+
+  // ~20 seconds of video at 120fps, overflow goes to a locked list
+  if (lockFree)
+    m_ring.reset(new XbmcThreads::CSPSCQueue<DVDMessageRingItem>(4096));
+  else
+    m_ring.reset();
+}
+
 void CDVDMessageQueue::Flush(CDVDMsg::Message type)
 {
   CSingleLock lock(m_section);
@@ -53,6 +70,28 @@ void CDVDMessageQueue::Flush(CDVDMsg::Message type)
     return type == CDVDMsg::NONE || item.message->IsType(type);
   });
 
+  if (m_ring)
+  {
+    // we hold the lock, so the consumer can't pop concurrently. Messages which
+    // survive go to m_messages which is served before the ring.
+    DVDMessageRingItem item;
+    while (m_ring->TryPop(item))
+    {
+      if (type != CDVDMsg::NONE && !item.message->IsType(type))
+        m_messages.emplace_front(item.message, 0);
+      item.message->Release();
+    }
+
+    while (!m_overflow.empty())
+    {
+      DVDMessageListItem &overflowItem = m_overflow.back();
+      if (type != CDVDMsg::NONE && !overflowItem.message->IsType(type))
+        m_messages.emplace_front(overflowItem.message, 0);
+      m_overflow.pop_back();
+    }
+    m_overflowSize = 0;
+  }
+
   if (type == CDVDMsg::DEMUXER_PACKET ||  type == CDVDMsg::NONE)
   {
     m_iDataSize = 0;
@@ -94,20 +133,22 @@ MsgQueueReturnCode CDVDMessageQueue::PutBack(CDVDMsg* pMsg, int priority)
 
 MsgQueueReturnCode CDVDMessageQueue::Put(CDVDMsg* pMsg, int priority, bool front)
 {
-  CSingleLock lock(m_section);
-
-  if (!m_bInitialized)
-  {
-    CLog::Log(LOGWARNING, "CDVDMessageQueue(%s)::Put MSGQ_NOT_INITIALIZED", m_owner.c_str());
-    pMsg->Release();
-    return MSGQ_NOT_INITIALIZED;
-  }
-  if (!pMsg)
+  // m_ring only changes while the queue isn't initialized and m_bInitialized is
+  // atomic, so the lock free producer never touches the lock
+  if (m_ring && priority == 0 && front)
   {
-    CLog::Log(LOGFATAL, "CDVDMessageQueue(%s)::Put MSGQ_INVALID_MSG", m_owner.c_str());
-    return MSGQ_INVALID_MSG;
+    MsgQueueReturnCode ret = CheckPut(pMsg);
+    if (ret != MSGQ_OK)
+      return ret;
+    return PutLockFree(pMsg);
   }
 
+  CSingleLock lock(m_section);
+
+  MsgQueueReturnCode ret = CheckPut(pMsg);
+  if (ret != MSGQ_OK)
+    return ret;
+
   if (priority > 0)
   {
     int prio = priority;
@@ -122,7 +163,7 @@ MsgQueueReturnCode CDVDMessageQueue::Put(CDVDMsg* pMsg, int priority, bool front
   }
   else
   {
-    if (m_messages.empty())
+    if (m_messages.empty() && !m_ring)
     {
       m_iDataSize = 0;
       m_TimeBack = DVD_NOPTS_VALUE;
@@ -156,6 +197,92 @@ MsgQueueReturnCode CDVDMessageQueue::Put(CDVDMsg* pMsg, int priority, bool front
   return MSGQ_OK;
 }
 
+MsgQueueReturnCode CDVDMessageQueue::CheckPut(CDVDMsg* pMsg)
+{
+  if (!m_bInitialized)
+  {
+    CLog::Log(LOGWARNING, "CDVDMessageQueue(%s)::Put MSGQ_NOT_INITIALIZED", m_owner.c_str());
+    pMsg->Release();
+    return MSGQ_NOT_INITIALIZED;
+  }
+  if (!pMsg)
+  {
+    CLog::Log(LOGFATAL, "CDVDMessageQueue(%s)::Put MSGQ_INVALID_MSG", m_owner.c_str());
+    return MSGQ_INVALID_MSG;
+  }
+  return MSGQ_OK;
+}
+
+MsgQueueReturnCode CDVDMessageQueue::PutLockFree(CDVDMsg* pMsg)
+{
+  DVDMessageRingItem item;
+  item.message = pMsg;
+  item.time = DVD_NOPTS_VALUE;
+
+  if (pMsg->IsType(CDVDMsg::DEMUXER_PACKET))
+  {
+    DemuxPacket* packet = static_cast<CDVDMsgDemuxerPacket*>(pMsg)->GetPacket();
+    if (packet)
+    {
+      item.size = packet->iSize;
+      item.time = GetPacketTime(pMsg);
+    }
+  }
+
+  // account before publishing, the consumer subtracts once it has the message
+  m_iDataSize += item.size;
+  if (item.time != DVD_NOPTS_VALUE)
+  {
+    m_TimeFront = item.time;
+    double noPts = DVD_NOPTS_VALUE;
+    m_TimeBack.compare_exchange_strong(noPts, item.time);
+  }
+
+  // only the producer increments m_overflowSize, so if it reads 0 the consumer
+  // has drained the overflow list and the ring holds the newest messages
+  if (m_overflowSize > 0 || !m_ring->TryPush(item))
+  {
+    CSingleLock lock(m_section);
+    m_overflow.emplace_front(pMsg, 0);
+    m_overflowSize++;
+    pMsg->Release();
+  }
+
+  // the consumer announces that it is about to sleep, skip the event otherwise
+  if (m_consumerWaiting)
+    m_hEvent.Set();
+
+  return MSGQ_OK;
+}
+
+bool CDVDMessageQueue::GetLockFree(CDVDMsg** pMsg)
+{
+  DVDMessageRingItem item;
+  if (m_ring->TryPop(item))
+  {
+    m_iDataSize -= item.size;
+    *pMsg = item.message;
+  }
+  else if (!m_overflow.empty())
+  {
+    DVDMessageListItem &overflowItem = m_overflow.back();
+    if (overflowItem.message->IsType(CDVDMsg::DEMUXER_PACKET))
+    {
+      DemuxPacket* packet = static_cast<CDVDMsgDemuxerPacket*>(overflowItem.message)->GetPacket();
+      if (packet)
+        m_iDataSize -= packet->iSize;
+    }
+    *pMsg = overflowItem.message->Acquire();
+    m_overflow.pop_back();
+    m_overflowSize--;
+  }
+  else
+    return false;
+
+  UpdateTimeBack();
+  return true;
+}
+
 MsgQueueReturnCode CDVDMessageQueue::Get(CDVDMsg** pMsg, unsigned int iTimeoutInMilliSeconds, int &priority)
 {
   CSingleLock lock(m_section);
@@ -172,7 +299,8 @@ MsgQueueReturnCode CDVDMessageQueue::Get(CDVDMsg** pMsg, unsigned int iTimeoutIn
 
   while (!m_bAbortRequest)
   {
-    std::list<DVDMessageListItem> &msgs = (priority > 0 || !m_prioMessages.empty()) ? m_prioMessages : m_messages;
+    // while draining, consumers waiting for priority messages get the others too
+    std::list<DVDMessageListItem> &msgs = ((priority > 0 && !m_drain) || !m_prioMessages.empty()) ? m_prioMessages : m_messages;
 
     if (!msgs.empty() && (msgs.back().priority >= priority || m_drain))
     {
@@ -194,6 +322,12 @@ MsgQueueReturnCode CDVDMessageQueue::Get(CDVDMsg** pMsg, unsigned int iTimeoutIn
       ret = MSGQ_OK;
       break;
     }
+    else if (m_ring && (priority == 0 || m_drain) && m_prioMessages.empty() && GetLockFree(pMsg))
+    {
+      priority = 0;
+      ret = MSGQ_OK;
+      break;
+    }
     else if (!iTimeoutInMilliSeconds)
     {
       ret = MSGQ_TIMEOUT;
@@ -202,10 +336,22 @@ MsgQueueReturnCode CDVDMessageQueue::Get(CDVDMsg** pMsg, unsigned int iTimeoutIn
     else
     {
       m_hEvent.Reset();
+
+      // the lock free producer only signals if we announce that we wait, check
+      // the ring again after announcing to not miss a message pushed meanwhile
+      m_consumerWaiting = true;
+      if (m_ring && (priority == 0 || m_drain) && !m_ring->Empty())
+      {
+        m_consumerWaiting = false;
+        continue;
+      }
+
       lock.Leave();
 
       // wait for a new message
-      if (!m_hEvent.WaitMSec(iTimeoutInMilliSeconds))
+      bool signaled = m_hEvent.WaitMSec(iTimeoutInMilliSeconds);
+      m_consumerWaiting = false;
+      if (!signaled)
         return MSGQ_TIMEOUT;
 
       lock.Enter();
@@ -222,44 +368,53 @@ void CDVDMessageQueue::UpdateTimeFront()
 {
   if (!m_messages.empty())
   {
-    auto &item = m_messages.front();
-    if (item.message->IsType(CDVDMsg::DEMUXER_PACKET))
+    double time = GetPacketTime(m_messages.front().message);
+    if (time != DVD_NOPTS_VALUE)
     {
-      DemuxPacket* packet = static_cast<CDVDMsgDemuxerPacket*>(item.message)->GetPacket();
-      if (packet)
-      {
-        if (packet->dts != DVD_NOPTS_VALUE)
-          m_TimeFront = packet->dts;
-        else if (packet->pts != DVD_NOPTS_VALUE)
-          m_TimeFront = packet->pts;
-
-        if (m_TimeBack == DVD_NOPTS_VALUE)
-          m_TimeBack = m_TimeFront;
-      }
+      m_TimeFront = time;
+      double noPts = DVD_NOPTS_VALUE;
+      m_TimeBack.compare_exchange_strong(noPts, time);
     }
   }
 }
 
 void CDVDMessageQueue::UpdateTimeBack()
 {
+  double time = DVD_NOPTS_VALUE;
+
   if (!m_messages.empty())
+    time = GetPacketTime(m_messages.back().message);
+  else if (m_ring)
   {
-    auto &item = m_messages.back();
-    if (item.message->IsType(CDVDMsg::DEMUXER_PACKET))
-    {
-      DemuxPacket* packet = static_cast<CDVDMsgDemuxerPacket*>(item.message)->GetPacket();
-      if (packet)
-      {
-        if (packet->dts != DVD_NOPTS_VALUE)
-          m_TimeBack = packet->dts;
-        else if (packet->pts != DVD_NOPTS_VALUE)
-          m_TimeBack = packet->pts;
+    DVDMessageRingItem* item = m_ring->Peek();
+    if (item)
+      time = item->time;
+    else if (!m_overflow.empty())
+      time = GetPacketTime(m_overflow.back().message);
+  }
 
-        if (m_TimeFront == DVD_NOPTS_VALUE)
-          m_TimeFront = m_TimeBack;
-      }
+  if (time != DVD_NOPTS_VALUE)
+  {
+    m_TimeBack = time;
+    double noPts = DVD_NOPTS_VALUE;
+    m_TimeFront.compare_exchange_strong(noPts, time);
+  }
+}
+
+double CDVDMessageQueue::GetPacketTime(CDVDMsg* pMsg)
+{
+  if (pMsg->IsType(CDVDMsg::DEMUXER_PACKET))
+  {
+    DemuxPacket* packet = static_cast<CDVDMsgDemuxerPacket*>(pMsg)->GetPacket();
+    if (packet)
+    {
+      if (packet->dts != DVD_NOPTS_VALUE)
+        return packet->dts;
+      else if (packet->pts != DVD_NOPTS_VALUE)
+        return packet->pts;
     }
   }
+  return DVD_NOPTS_VALUE;
 }
 
 unsigned CDVDMessageQueue::GetPacketCount(CDVDMsg::Message type)
@@ -280,6 +435,19 @@ unsigned CDVDMessageQueue::GetPacketCount(CDVDMsg::Message type)
     if(item.message->IsType(type))
       count++;
   }
+  if (m_ring)
+  {
+    // the consumer pops under the lock we are holding
+    m_ring->Visit([type, &count](const DVDMessageRingItem &item){
+      if (item.message->IsType(type))
+        count++;
+    });
+    for (const auto &item : m_overflow)
+    {
+      if(item.message->IsType(type))
+        count++;
+    }
+  }
 
   return count;
 }
@@ -305,22 +473,33 @@ void CDVDMessageQueue::WaitUntilEmpty()
 
 int CDVDMessageQueue::GetLevel() const
 {
+  // size and times are atomics, the producer must not contend with the
+  // consumer in lock free mode
+  if (m_ring)
+    return GetLevelUnlocked();
+
   CSingleLock lock(m_section);
+  return GetLevelUnlocked();
+}
+
+int CDVDMessageQueue::GetLevelUnlocked() const
+{
+  int dataSize = m_iDataSize;
 
-  if (m_iDataSize > m_iMaxDataSize)
+  if (dataSize > m_iMaxDataSize)
     return 100;
-  if (m_iDataSize == 0)
+  if (dataSize == 0)
     return 0;
 
   if (IsDataBased())
   {
-    return std::min(100, 100 * m_iDataSize / m_iMaxDataSize);
+    return std::min(100, 100 * dataSize / m_iMaxDataSize);
   }
 
   int level = std::min(100.0, ceil(100.0 * m_TimeSize * (m_TimeFront - m_TimeBack) / DVD_TIME_BASE ));
 
   // if we added lots of packets with NOPTS, make sure that the queue is not signalled empty
-  if (level == 0 && m_iDataSize != 0)
+  if (level == 0 && dataSize != 0)
   {
     CLog::Log(LOGDEBUG, "CDVDMessageQueue::GetLevel() - can't determine level");
     return 1;
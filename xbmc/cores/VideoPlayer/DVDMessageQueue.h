@@ -13,8 +13,10 @@
 #include <string>
 #include <list>
 #include <algorithm>
+#include <memory>
 #include "threads/CriticalSection.h"
 #include "threads/Event.h"
+#include "threads/SPSCQueue.h"
 
 struct DVDMessageListItem
 {
@@ -41,6 +43,13 @@ struct DVDMessageListItem
   int priority;
 };
 
+struct DVDMessageRingItem
+{
+  CDVDMsg* message = nullptr; // owns one reference
+  int size = 0;
+  double time = 0.0;
+};
+
 enum MsgQueueReturnCode
 {
   MSGQ_OK = 1,
@@ -60,6 +69,16 @@ public:
   virtual ~CDVDMessageQueue();
 
   void Init();
+
+  /**
+   * Pass normal priority messages from Put through a bounded lock free ring
+   * instead of the locked list. Only valid if Put with priority 0 is called
+   * from a single thread and Get from a single other thread. Must be set
+   * before Init.
+   */
+  void SetLockFree(bool lockFree);
+  bool IsLockFree() const { return m_ring != nullptr; }
+
   void Flush(CDVDMsg::Message message = CDVDMsg::DEMUXER_PACKET);
   void Abort();
   void End();
@@ -99,19 +118,24 @@ public:
 private:
 
   MsgQueueReturnCode Put(CDVDMsg* pMsg, int priority, bool front);
+  MsgQueueReturnCode CheckPut(CDVDMsg* pMsg);
+  MsgQueueReturnCode PutLockFree(CDVDMsg* pMsg);
+  bool GetLockFree(CDVDMsg** pMsg);
   void UpdateTimeFront();
   void UpdateTimeBack();
+  static double GetPacketTime(CDVDMsg* pMsg);
+  int GetLevelUnlocked() const;
 
   CEvent m_hEvent;
   mutable CCriticalSection m_section;
 
   std::atomic<bool> m_bAbortRequest;
-  bool m_bInitialized;
+  std::atomic<bool> m_bInitialized;
   bool m_drain = false;
 
-  int m_iDataSize;
-  double m_TimeFront;
-  double m_TimeBack;
+  std::atomic<int> m_iDataSize;
+  std::atomic<double> m_TimeFront;
+  std::atomic<double> m_TimeBack;
   double m_TimeSize;
 
   int m_iMaxDataSize;
@@ -119,5 +143,13 @@ private:
 
   std::list<DVDMessageListItem> m_messages;
   std::list<DVDMessageListItem> m_prioMessages;
+
+  // lock free mode: the producer pushes to m_ring, m_messages only holds
+  // messages put back by the consumer. If the ring is full, messages go to
+  // m_overflow until the consumer has drained it.
+  std::unique_ptr<XbmcThreads::CSPSCQueue<DVDMessageRingItem>> m_ring;
+  std::list<DVDMessageListItem> m_overflow;
+  std::atomic<int> m_overflowSize{0};
+  std::atomic<bool> m_consumerWaiting{false};
 };
 
@@ -86,6 +86,7 @@ void CProcessInfo::ResetVideoCodecInfo()
     m_dataCache->SetVideoDAR(m_videoDAR);
     m_dataCache->SetStateSeeking(m_stateSeeking);
     m_dataCache->SetVideoStereoMode(m_videoStereoMode);
+    m_dataCache->ResetVideoDecoderStats();
   }
 }
 
@@ -312,6 +313,24 @@ void CProcessInfo::SetPixFormats(std::vector<AVPixelFormat> &formats)
   m_pixFormats = formats;
 }
 
+void CProcessInfo::SetVideoDecoderThreads(const std::string &type, int count)
+{
+  if (m_dataCache)
+    m_dataCache->SetVideoDecoderThreads(type, count);
+}
+
+void CProcessInfo::AddVideoDecodeTimes(const uint64_t (&frames)[SVideoDecoderStats::DECODE_TIME_BUCKETS])
+{
+  if (m_dataCache)
+    m_dataCache->AddVideoDecodeTimes(frames);
+}
+
+void CProcessInfo::AddVideoDroppedFrames(VideoDropCause cause, int frames)
+{
+  if (m_dataCache)
+    m_dataCache->AddVideoDroppedFrames(cause, frames);
+}
+
 //******************************************************************************
 // player audio info
 //******************************************************************************
@@ -459,6 +478,15 @@ std::vector<AVPixelFormat> CProcessInfo::GetRenderFormats()
   return formats;
 }
 
+//******************************************************************************
+// demuxer info
+//******************************************************************************
+void CProcessInfo::SetDemuxPacketPoolStats(uint64_t hits, uint64_t misses, uint64_t bytesResident)
+{
+  if (m_dataCache)
+    m_dataCache->SetDemuxPacketPoolStats(hits, misses, bytesResident);
+}
+
 //******************************************************************************
 // player states
 //******************************************************************************
@@ -538,6 +566,12 @@ bool CProcessInfo::IsFrameAdvance()
   return m_frameAdvance;
 }
 
+void CProcessInfo::SetTimeToFirstFrame(int ms)
+{
+  if (m_dataCache)
+    m_dataCache->SetTimeToFirstFrame(ms);
+}
+
 void CProcessInfo::SetTempo(float tempo)
 {
   CSingleLock lock(m_stateSection);
@@ -10,6 +10,7 @@
 
 #include "VideoBuffer.h"
 #include "cores/VideoSettings.h"
+#include "cores/DataCacheCore.h"
 #include "cores/VideoPlayer/VideoRenderers/RenderInfo.h"
 #include "threads/CriticalSection.h"
 #include <atomic>
@@ -18,7 +19,6 @@
 #include <string>
 
 class CProcessInfo;
-class CDataCacheCore;
 
 using CreateProcessControl = CProcessInfo* (*)();
 
@@ -58,6 +58,9 @@ public:
   CVideoBufferManager& GetVideoBufferManager();
   std::vector<AVPixelFormat> GetPixFormats();
   void SetPixFormats(std::vector<AVPixelFormat> &formats);
+  void SetVideoDecoderThreads(const std::string &type, int count);
+  void AddVideoDecodeTimes(const uint64_t (&frames)[SVideoDecoderStats::DECODE_TIME_BUCKETS]);
+  void AddVideoDroppedFrames(VideoDropCause cause, int frames);
 
   // player audio info
   void ResetAudioCodecInfo();
@@ -79,6 +82,9 @@ public:
   void GetRenderBuffers(int &queued, int &discard, int &free);
   virtual std::vector<AVPixelFormat> GetRenderFormats();
 
+  // demuxer info
+  void SetDemuxPacketPoolStats(uint64_t hits, uint64_t misses, uint64_t bytesResident);
+
   // player states
   void SetStateSeeking(bool active);
   bool IsSeeking();
@@ -89,6 +95,7 @@ public:
   float GetNewSpeed();
   void SetFrameAdvance(bool fa);
   bool IsFrameAdvance();
+  void SetTimeToFirstFrame(int ms);
   void SetTempo(float tempo);
   void SetNewTempo(float tempo);
   float GetNewTempo();
@@ -1225,6 +1225,7 @@ void CVideoPlayer::CheckBetterStream(CCurrentStream& current, CDemuxStream* stre
 
 void CVideoPlayer::Prepare()
 {
+  m_openTime = XbmcThreads::SystemClockMillis();
   CFFmpegLog::SetLogLevel(1);
   SetPlaySpeed(DVD_PLAYSPEED_NORMAL);
   m_processInfo->SetSpeed(1.0);
@@ -2081,6 +2082,10 @@ void CVideoPlayer::HandlePlaySpeed()
 
       if (!m_State.streamsReady)
       {
+        const int timeToFirstFrame = XbmcThreads::SystemClockMillis() - m_openTime;
+        CLog::Log(LOGDEBUG, "CVideoPlayer::Sync - playback started %d ms after open", timeToFirstFrame);
+        m_processInfo->SetTimeToFirstFrame(timeToFirstFrame);
+
         if (m_playerOptions.fullscreen)
         {
           CApplicationMessenger::GetInstance().PostMsg(TMSG_SWITCHTOFULLSCREEN);
@@ -2536,6 +2541,9 @@ void CVideoPlayer::OnExit()
   // clean up all selection streams
   m_SelectionStreams.Clear(STREAM_NONE, STREAM_SOURCE_NONE);
 
+  // release parked packets, the next file may have a different bitrate profile
+  CDemuxPacketPool::GetInstance().Clear();
+
   m_messenger.End();
 
   if (m_omxplayer_mode)
@@ -4848,6 +4856,9 @@ void CVideoPlayer::UpdatePlayState(double timeout)
 
   m_processInfo->SetPlayTimes(state.startTime, state.time, state.timeMin, state.timeMax);
 
+  SDemuxPacketPoolStats poolStats = CDemuxPacketPool::GetInstance().GetStats();
+  m_processInfo->SetDemuxPacketPoolStats(poolStats.hits, poolStats.misses, poolStats.bytesResident);
+
   CSingleLock lock(m_StateSection);
   m_State = state;
 }
@@ -4972,6 +4983,11 @@ bool CVideoPlayer::RenderCaptureGetPixels(unsigned int captureId, unsigned int m
   return m_renderManager.RenderCaptureGetPixels(captureId, millis, buffer, size);
 }
 
+unsigned int CVideoPlayer::RenderCaptureStream(ICaptureStreamCallback *callback, unsigned int width, unsigned int height, unsigned int interval, const std::string &format)
+{
+  return m_renderManager.AllocRenderCaptureStream(callback, width, height, interval, format);
+}
+
 void CVideoPlayer::VideoParamsChange()
 {
   m_messenger.Put(new CDVDMsg(CDVDMsg::PLAYER_AVCHANGE));
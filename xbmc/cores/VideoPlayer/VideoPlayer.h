@@ -367,6 +367,7 @@ public:
   void RenderCapture(unsigned int captureId, unsigned int width, unsigned int height, int flags) override;
   void RenderCaptureRelease(unsigned int captureId) override;
   bool RenderCaptureGetPixels(unsigned int captureId, unsigned int millis, uint8_t *buffer, unsigned int size) override;
+  unsigned int RenderCaptureStream(ICaptureStreamCallback *callback, unsigned int width, unsigned int height, unsigned int interval, const std::string &format) override;
 
   // IDispResource interface
   void OnLostDisplay() override;
@@ -571,6 +572,7 @@ protected:
   SPlayerState m_State;
   mutable CCriticalSection m_StateSection;
   XbmcThreads::EndTime m_syncTimer;
+  unsigned int m_openTime = 0; // time in ticks when Prepare started opening the item
 
   CEdl m_Edl;
   bool m_SkipCommercials;
@@ -11,6 +11,7 @@
 #include "settings/AdvancedSettings.h"
 #include "settings/SettingsComponent.h"
 #include "utils/MathUtils.h"
+#include "utils/TimeUtils.h"
 #include "VideoPlayerVideo.h"
 #include "DVDCodecs/DVDFactoryCodec.h"
 #include "DVDCodecs/DVDCodecUtils.h"
@@ -67,6 +68,7 @@ CVideoPlayerVideo::CVideoPlayerVideo(CDVDClock* pClock
   m_fForcedAspectRatio = 0;
   m_messageQueue.SetMaxDataSize(40 * 1024 * 1024);
   m_messageQueue.SetMaxTimeSize(8.0);
+  m_messageQueue.SetLockFree(CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_videoLockFreeMessageQueue);
 
   m_iDroppedFrames = 0;
   m_fFrameRate = 25;
@@ -308,6 +310,7 @@ void CVideoPlayerVideo::Process()
   m_videoStats.Start();
   m_droppingStats.Reset();
   m_iDroppedFrames = 0;
+  m_iSkippedFrames = m_renderManager.GetSkippedFrames();
   m_rewindStalled = false;
   m_outputSate = OUTPUT_NORMAL;
 
@@ -655,6 +658,8 @@ bool CVideoPlayerVideo::ProcessDecoderOutput(double &frametime, double &pts)
   {
     bool hasTimestamp = true;
 
+    m_pictureDecoded = CurrentHostCounter();
+
     m_picture.iDuration = frametime;
 
     // validate picture timing,
@@ -736,6 +741,7 @@ bool CVideoPlayerVideo::ProcessDecoderOutput(double &frametime, double &pts)
     else if ((m_outputSate == OUTPUT_DROPPED) && !(m_picture.iFlags & DVP_FLAG_DROPPED))
     {
       m_iDroppedFrames++;
+      m_processInfo.AddVideoDroppedFrames(VideoDropCause::OUTPUT, 1);
       m_ptsTracker.Flush();
     }
 
@@ -919,7 +925,7 @@ CVideoPlayerVideo::EOutputState CVideoPlayerVideo::OutputPicture(const VideoPict
   if (!m_processInfo.Supports(deintMethod))
     deintMethod = m_processInfo.GetDeinterlacingMethodDefault();
 
-  if (!m_renderManager.AddVideoPicture(*pPicture, m_bAbortOutput, deintMethod, (m_syncState == ESyncState::SYNC_STARTING)))
+  if (!m_renderManager.AddVideoPicture(*pPicture, m_bAbortOutput, deintMethod, (m_syncState == ESyncState::SYNC_STARTING), m_pictureDecoded))
   {
     m_droppingStats.AddOutputDropGain(pPicture->pts, 1);
     return OUTPUT_DROPPED;
@@ -1079,6 +1085,11 @@ int CVideoPlayerVideo::CalcDropRequirement(double pts)
   m_renderManager.GetStats(lateframes, iRenderPts, queued, discard);
   iBufferLevel = queued + discard;
 
+  int skippedFrames = m_renderManager.GetSkippedFrames();
+  if (skippedFrames > m_iSkippedFrames)
+    m_processInfo.AddVideoDroppedFrames(VideoDropCause::RENDERER, skippedFrames - m_iSkippedFrames);
+  m_iSkippedFrames = skippedFrames;
+
   if (iBufferLevel < 0)
     result |= DROP_BUFFER_LEVEL;
   else if (iBufferLevel < 2)
@@ -1097,6 +1108,7 @@ int CVideoPlayerVideo::CalcDropRequirement(double pts)
       m_droppingStats.m_gain.push_back(gain);
       m_droppingStats.m_totalGain += gain.frames;
       result |= DROP_DROPPED;
+      m_processInfo.AddVideoDroppedFrames(VideoDropCause::DEINTERLACER, iSkippedPicture);
       CLog::Log(LOGDEBUG, LOGVIDEO, "CVideoPlayerVideo::CalcDropRequirement - dropped pictures, lateframes: %d, Bufferlevel: %d, dropped: %d", lateframes, iBufferLevel, iSkippedPicture);
     }
     if (iDroppedFrames > 0)
@@ -1107,6 +1119,7 @@ int CVideoPlayerVideo::CalcDropRequirement(double pts)
       m_droppingStats.m_gain.push_back(gain);
       m_droppingStats.m_totalGain += iDroppedFrames;
       result |= DROP_DROPPED;
+      m_processInfo.AddVideoDroppedFrames(VideoDropCause::DECODER, iDroppedFrames);
       CLog::Log(LOGDEBUG, LOGVIDEO, "CVideoPlayerVideo::CalcDropRequirement - dropped in decoder, lateframes: %d, Bufferlevel: %d, dropped: %d", lateframes, iBufferLevel, iDroppedFrames);
     }
   }
@@ -105,6 +105,7 @@ protected:
 
   int m_iLateFrames;
   int m_iDroppedFrames;
+  int m_iSkippedFrames = 0; // last seen count of frames skipped by the renderer
   int m_iDroppedRequest;
 
   double m_fFrameRate;       //framerate of the video currently playing
@@ -136,6 +137,7 @@ protected:
   CDroppingStats m_droppingStats;
   CRenderManager& m_renderManager;
   VideoPicture m_picture;
+  int64_t m_pictureDecoded = 0; // host counter when m_picture was returned by the decoder
 
   EOutputState m_outputSate;
 };
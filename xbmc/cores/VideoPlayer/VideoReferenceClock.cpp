@@ -30,6 +30,7 @@ CVideoReferenceClock::CVideoReferenceClock() : CThread("RefClock")
   m_RefreshRate = 0.0;
   m_MissedVblanks = 0;
   m_VblankTime = 0;
+  m_VblankCount = 0;
 
   Start();
 }
@@ -133,6 +134,8 @@ void CVideoReferenceClock::UpdateClock(int NrVBlanks, bool CheckMissed)
 
   if (NrVBlanks > 0) //update the clock with the adjusted frequency if we have any vblanks
   {
+    m_VblankCount += NrVBlanks;
+
     double increment = UpdateInterval() * NrVBlanks;
     double integer   = floor(increment);
     m_CurrTime      += static_cast<int64_t>(integer + 0.5); //make sure it gets correctly converted to int
@@ -254,6 +257,26 @@ int64_t CVideoReferenceClock::TimeOfNextVblank() const
   return m_VblankTime + (m_SystemFrequency / MathUtils::round_int(m_RefreshRate) * MAXVBLANKDELAY / 10LL);
 }
 
+//predict the vblank the next flip lands on, for frame pacing in the render manager
+//Time is the clock value at that vblank, Interval the clock ticks between vblanks
+bool CVideoReferenceClock::GetNextVblank(int64_t& Vblank, int64_t& Time, double& Interval)
+{
+  CSingleLock SingleLock(m_CritSection);
+
+  if (!m_UseVblank || m_RefreshRate <= 0.0)
+    return false;
+
+  GetTime(false); //catch up with vblanks the run function missed
+
+  double period = static_cast<double>(m_SystemFrequency) / m_RefreshRate;
+  int64_t next = static_cast<int64_t>(static_cast<double>(CurrentHostCounter() - m_VblankTime) / period) + 1;
+
+  Interval = UpdateInterval();
+  Vblank = m_VblankCount + next;
+  Time = m_CurrTime + static_cast<int64_t>(Interval * next + m_CurrTimeFract);
+  return true;
+}
+
 //for the codec information screen
 bool CVideoReferenceClock::GetClockInfo(int& MissedVblanks, double& ClockSpeed, double& RefreshRate) const
 {
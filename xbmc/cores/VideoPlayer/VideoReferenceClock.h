@@ -26,6 +26,7 @@ class CVideoReferenceClock : CThread
     double  GetSpeed();
     double  GetRefreshRate(double* interval = nullptr);
     bool    GetClockInfo(int& MissedVblanks, double& ClockSpeed, double& RefreshRate) const;
+    bool    GetNextVblank(int64_t& Vblank, int64_t& Time, double& Interval);
 
   private:
     void    Process() override;
@@ -47,6 +48,7 @@ class CVideoReferenceClock : CThread
     int     m_MissedVblanks;     //number of clock updates missed by the vblank clock
     int     m_TotalMissedVblanks;//total number of clock updates missed, used by codec information screen
     int64_t m_VblankTime;        //last time the clock was updated when using vblank as clock
+    int64_t m_VblankCount;       //number of vblanks the clock was updated with, including missed ones
 
     CEvent m_vsyncStopEvent;
 
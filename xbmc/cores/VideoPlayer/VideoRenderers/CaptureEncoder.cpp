@@ -0,0 +1,181 @@
+/*
+ *  Copyright (C) 2019 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "CaptureEncoder.h"
+#include "pictures/Picture.h"
+#include "threads/SingleLock.h"
+#include "utils/JobManager.h"
+#include "utils/log.h"
+
+#include <cstring>
+
+CCaptureEncoder::~CCaptureEncoder()
+{
+  RemoveStreams();
+}
+
+void CCaptureEncoder::AddStream(unsigned int captureId, ICaptureStreamCallback *callback,
+                                unsigned int interval, const std::string &format)
+{
+  std::shared_ptr<Stream> stream = std::make_shared<Stream>();
+  stream->callback = callback;
+  stream->interval = interval;
+  stream->format = format.empty() ? CAPTURE_FORMAT_RAW : format;
+  stream->next.SetExpired();
+
+  CLog::Log(LOGDEBUG, "CCaptureEncoder::AddStream - capture %u, every %u ms as %s",
+            captureId, interval, stream->format.c_str());
+
+  CSingleLock lock(m_section);
+  m_streams[captureId] = stream;
+}
+
+void CCaptureEncoder::RemoveStream(unsigned int captureId)
+{
+  std::shared_ptr<Stream> stream;
+  {
+    CSingleLock lock(m_section);
+    auto it = m_streams.find(captureId);
+    if (it == m_streams.end())
+      return;
+    stream = it->second;
+    stream->removed = true;
+    m_streams.erase(it);
+  }
+  Remove(captureId, stream);
+}
+
+void CCaptureEncoder::RemoveStreams()
+{
+  std::map<unsigned int, std::shared_ptr<Stream>> streams;
+  {
+    CSingleLock lock(m_section);
+    streams.swap(m_streams);
+    for (auto &entry : streams)
+      entry.second->removed = true;
+  }
+  for (auto &entry : streams)
+    Remove(entry.first, entry.second);
+}
+
+void CCaptureEncoder::Remove(unsigned int captureId, std::shared_ptr<Stream> stream)
+{
+  stream->idle.Wait();
+
+  CLog::Log(LOGDEBUG, "CCaptureEncoder::RemoveStream - capture %u, %u frames, %u dropped",
+            captureId, stream->encoded, stream->dropped);
+}
+
+bool CCaptureEncoder::HasStream(unsigned int captureId)
+{
+  CSingleLock lock(m_section);
+  return m_streams.find(captureId) != m_streams.end();
+}
+
+bool CCaptureEncoder::StartCapture(unsigned int captureId)
+{
+  CSingleLock lock(m_section);
+  auto it = m_streams.find(captureId);
+  if (it == m_streams.end())
+    return false;
+
+  Stream &stream = *it->second;
+  if (!stream.next.IsTimePast())
+    return false;
+
+  // all buffers are busy, don't render a capture that can't be encoded.
+  // the sequence still moves on so the consumer sees the gap
+  if (stream.pending >= MAX_PENDING)
+  {
+    stream.sequence++;
+    stream.dropped++;
+    return false;
+  }
+
+  stream.next.Set(stream.interval);
+  return true;
+}
+
+void CCaptureEncoder::Submit(unsigned int captureId, const uint8_t *pixels, unsigned int width, unsigned int height)
+{
+  std::shared_ptr<Stream> stream;
+  std::shared_ptr<SCaptureFrame> frame = std::make_shared<SCaptureFrame>();
+  {
+    CSingleLock lock(m_section);
+    auto it = m_streams.find(captureId);
+    if (it == m_streams.end())
+      return;
+
+    stream = it->second;
+    frame->sequence = stream->sequence++;
+    // StartCapture already refused while busy, pending can only drop
+    // until the capture gets here, so this is a safety net
+    if (stream->pending >= MAX_PENDING)
+    {
+      stream->dropped++;
+      return;
+    }
+
+    if (!stream->buffers.empty())
+    {
+      frame->data.swap(stream->buffers.back());
+      stream->buffers.pop_back();
+    }
+    if (stream->pending++ == 0)
+      stream->idle.Reset();
+  }
+
+  frame->width = width;
+  frame->height = height;
+  frame->format = stream->format;
+  frame->data.resize(width * height * 4);
+  memcpy(frame->data.data(), pixels, frame->data.size());
+
+  CJobManager::GetInstance().Submit([this, captureId, stream, frame]() {
+    Encode(captureId, stream, *frame);
+  }, CJob::PRIORITY_NORMAL);
+}
+
+void CCaptureEncoder::Encode(unsigned int captureId, std::shared_ptr<Stream> stream, SCaptureFrame &frame)
+{
+  std::vector<uint8_t> pixels;
+  if (frame.format != CAPTURE_FORMAT_RAW)
+  {
+    uint8_t *result = nullptr;
+    size_t size = 0;
+    pixels.swap(frame.data);
+    if (CPicture::GetThumbnailFromSurface(pixels.data(), frame.width, frame.height, frame.width * 4,
+                                          "capture." + frame.format, result, size))
+    {
+      frame.data.assign(result, result + size);
+      delete[] result;
+    }
+    else
+      CLog::Log(LOGERROR, "CCaptureEncoder::Encode - failed to encode capture %u as %s",
+                captureId, frame.format.c_str());
+  }
+
+  bool removed;
+  {
+    CSingleLock lock(m_section);
+    removed = stream->removed;
+  }
+
+  // RemoveStream waits for this, so the callback is still valid
+  if (!removed && !frame.data.empty())
+    stream->callback->OnCaptureFrame(captureId, frame);
+
+  if (frame.format == CAPTURE_FORMAT_RAW)
+    pixels.swap(frame.data);
+
+  CSingleLock lock(m_section);
+  stream->buffers.push_back(std::move(pixels));
+  stream->encoded++;
+  if (--stream->pending == 0)
+    stream->idle.Set();
+}
@@ -0,0 +1,108 @@
+/*
+ *  Copyright (C) 2019 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+#include "threads/SystemClock.h"
+
+#include <map>
+#include <memory>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#define CAPTURE_FORMAT_RAW "bgra"
+
+/*!
+ * \brief A frame of a capture stream
+ */
+struct SCaptureFrame
+{
+  uint64_t sequence = 0;   // number of the capture, gaps are dropped captures
+  unsigned int width = 0;
+  unsigned int height = 0;
+  std::string format;      // CAPTURE_FORMAT_RAW or the image type, "jpg" or "png"
+  std::vector<uint8_t> data;
+};
+
+class ICaptureStreamCallback
+{
+public:
+  virtual ~ICaptureStreamCallback() = default;
+
+  /*!
+   * \brief Called on a job worker, frames of a stream may complete out of order
+   */
+  virtual void OnCaptureFrame(unsigned int captureId, const SCaptureFrame &frame) = 0;
+};
+
+/*!
+ * \brief Hands render captures of subscribed streams to the job manager
+ *
+ * The render thread only copies the pixels of a finished capture into a free
+ * buffer of the stream, encoding and the callback run on job workers. While
+ * all MAX_PENDING buffers of a stream are busy no capture is started, so no
+ * frame is rendered for nothing, and a stream isn't captured more often than
+ * its interval.
+ */
+class CCaptureEncoder
+{
+public:
+  static const int MAX_PENDING = 3;
+
+  ~CCaptureEncoder();
+
+  void AddStream(unsigned int captureId, ICaptureStreamCallback *callback, unsigned int interval,
+                 const std::string &format);
+
+  /*!
+   * \brief Waits for the frames of the stream in progress, the callback isn't
+   * called anymore when this returns. Must not be called from the callback.
+   */
+  void RemoveStream(unsigned int captureId);
+  void RemoveStreams();
+
+  bool HasStream(unsigned int captureId);
+
+  /*!
+   * \brief Whether the stream should be captured now, restarts its interval if so
+   *
+   * Refuses while MAX_PENDING frames of the stream are being encoded, the
+   * refused capture counts as dropped and leaves a gap in the sequence.
+   */
+  bool StartCapture(unsigned int captureId);
+
+  /*!
+   * \brief Called on the render thread with the BGRA pixels of a finished capture
+   */
+  void Submit(unsigned int captureId, const uint8_t *pixels, unsigned int width, unsigned int height);
+
+private:
+  struct Stream
+  {
+    ICaptureStreamCallback *callback = nullptr;
+    unsigned int interval = 0;
+    std::string format;
+    XbmcThreads::EndTime next;
+    uint64_t sequence = 0;
+    int pending = 0;
+    unsigned int encoded = 0;
+    unsigned int dropped = 0;
+    bool removed = false;
+    std::vector<std::vector<uint8_t>> buffers;
+    CEvent idle{true, true};
+  };
+
+  void Encode(unsigned int captureId, std::shared_ptr<Stream> stream, SCaptureFrame &frame);
+  void Remove(unsigned int captureId, std::shared_ptr<Stream> stream);
+
+  CCriticalSection m_section;
+  std::map<unsigned int, std::shared_ptr<Stream>> m_streams;
+};
@@ -18,7 +18,7 @@ class CDebugRenderer
 public:
   CDebugRenderer();
   virtual ~CDebugRenderer();
-  void SetInfo(std::string &info1, std::string &info2, std::string &info3, std::string &info4);
+  void SetInfo(std::string &info1, std::string &info2, std::string &info3, std::string &info4, std::string &info5);
   void Render(CRect &src, CRect &dst, CRect &view);
   void Flush();
 
@@ -31,7 +31,8 @@ protected:
     void Render(int idx) override;
   };
 
-  std::string m_strDebug[4];
-  CDVDOverlayText *m_overlay[4];
+  static const int DEBUG_LINES = 5;
+  std::string m_strDebug[DEBUG_LINES];
+  CDVDOverlayText *m_overlay[DEBUG_LINES];
   CRenderer m_overlayRenderer;
 };
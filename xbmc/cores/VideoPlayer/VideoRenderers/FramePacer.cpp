@@ -0,0 +1,188 @@
+/*
+ *  Copyright (C) 2019 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "FramePacer.h"
+#include "cores/VideoPlayer/Interface/Addon/TimingConstants.h"
+#include "utils/StringUtils.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+// how far the refreshes of a pattern may be off from the ratio, the
+// difference shows up as a cadence error every 1 / tolerance refreshes
+const double PATTERN_TOLERANCE = 0.005;
+}
+
+void CFramePacer::Reset()
+{
+  m_locked = false;
+  m_pos = 0;
+  m_lastVblank = -1;
+  m_history.clear();
+}
+
+bool CFramePacer::SetRates(double frametime, double interval)
+{
+  if (frametime <= 0.0 || interval <= 0.0)
+    return false;
+
+  m_interval = interval;
+
+  double ratio = frametime / interval;
+  if (std::abs(ratio - m_ratio) < ratio * 0.0001)
+    return false;
+
+  m_ratio = ratio;
+  std::vector<int> pattern = FindPattern(ratio);
+  if (pattern == m_pattern)
+    return false;
+
+  m_pattern = pattern;
+  Reset();
+  return true;
+}
+
+std::vector<int> CFramePacer::FindPattern(double ratio, int maxFrames)
+{
+  std::vector<int> pattern;
+  if (ratio < 1.0 - PATTERN_TOLERANCE)
+    return pattern;
+
+  for (int frames = 1; frames <= maxFrames; frames++)
+  {
+    int refreshes = static_cast<int>(std::round(frames * ratio));
+    if (std::abs(frames * ratio - refreshes) > frames * ratio * PATTERN_TOLERANCE)
+      continue;
+
+    // spread the refreshes evenly, longer entries first: 5 over 2 is 3:2
+    for (int i = 0; i < frames; i++)
+      pattern.push_back(((i + 1) * refreshes + frames - 1) / frames - (i * refreshes + frames - 1) / frames);
+    break;
+  }
+  return pattern;
+}
+
+bool CFramePacer::IsDue(int64_t vblank, double vblankPts, double nextFramePts) const
+{
+  double diff = vblankPts - nextFramePts;
+
+  if (!m_locked || m_lastVblank < 0)
+    return diff >= -m_interval / 2;
+
+  int shown = static_cast<int>(vblank - m_lastVblank);
+  if (shown >= m_pattern[m_pos])
+  {
+    // the pattern does not move a frame by more than a refresh
+    return diff >= -m_interval;
+  }
+  return diff > m_interval;
+}
+
+void CFramePacer::FrameShown(int64_t vblank)
+{
+  if (m_lastVblank >= 0)
+  {
+    int shown = static_cast<int>(vblank - m_lastVblank);
+    if (shown <= 0)
+    {
+      // the previous frame never made it to the screen
+      if (!m_pattern.empty())
+        Error(vblank);
+      m_locked = false;
+      m_history.clear();
+    }
+    else
+    {
+      if (m_locked)
+      {
+        if (shown == m_pattern[m_pos])
+          m_pos = (m_pos + 1) % m_pattern.size();
+        else
+        {
+          Error(vblank);
+          m_locked = false;
+          m_history.clear();
+        }
+      }
+      else if (!m_pattern.empty() &&
+               std::find(m_pattern.begin(), m_pattern.end(), shown) == m_pattern.end())
+        Error(vblank);
+
+      m_history.push_back(shown);
+      if (m_history.size() > 2 * MAX_PATTERN)
+        m_history.pop_front();
+
+      if (!m_locked)
+        m_locked = TryLock();
+    }
+  }
+  m_lastVblank = vblank;
+}
+
+bool CFramePacer::TryLock()
+{
+  size_t size = m_pattern.size();
+  if (!size || m_history.size() < std::max<size_t>(size, 2))
+    return false;
+
+  // find the rotation of the pattern the last frames were shown with
+  for (size_t start = 0; start < size; start++)
+  {
+    bool match = true;
+    for (size_t i = 0; i < size && match; i++)
+      match = m_history[m_history.size() - size + i] == m_pattern[(start + i) % size];
+
+    if (match)
+    {
+      m_pos = start;
+      return true;
+    }
+  }
+  return false;
+}
+
+void CFramePacer::Error(int64_t vblank)
+{
+  m_errors++;
+  m_errorVblanks.push_back(vblank);
+
+  if (m_interval > 0.0)
+  {
+    int64_t minute = static_cast<int64_t>(60.0 * DVD_TIME_BASE / m_interval);
+    while (!m_errorVblanks.empty() && m_errorVblanks.front() <= vblank - minute)
+      m_errorVblanks.pop_front();
+  }
+}
+
+int CFramePacer::GetErrorsPerMinute(int64_t vblank) const
+{
+  if (m_interval <= 0.0)
+    return 0;
+
+  int64_t minute = static_cast<int64_t>(60.0 * DVD_TIME_BASE / m_interval);
+  return std::count_if(m_errorVblanks.begin(), m_errorVblanks.end(),
+                       [vblank, minute](int64_t error) { return error > vblank - minute; });
+}
+
+std::string CFramePacer::GetPatternString() const
+{
+  if (m_pattern.empty())
+    return "none";
+
+  std::vector<std::string> entries;
+  for (int entry : m_pattern)
+    entries.push_back(StringUtils::Format("%d", entry));
+
+  // a single entry is written like 5:5
+  if (entries.size() == 1)
+    entries.push_back(entries.front());
+
+  return StringUtils::Join(entries, ":");
+}
@@ -0,0 +1,89 @@
+/*
+ *  Copyright (C) 2019 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <deque>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/*!
+ * \brief Decides on which refresh of the display a frame is shown
+ *
+ * The render manager asks at every refresh slot, given by the index and
+ * predicted clock of the next vblank, whether the next queued frame is due.
+ * Without a cadence the frame is shown at the slot nearest to its pts.
+ * For frame rates that do not divide the refresh rate the pacer computes
+ * the cadence (3:2 for 24 fps on 60 Hz, 5:5 on 120 Hz) and locks to it once
+ * the frames shown match the pattern, so the choice no longer depends on
+ * which side of a slot boundary a pts falls. It unlocks when the pts drift
+ * more than a refresh away from the pattern.
+ *
+ * A frame shown for a different number of refreshes than the cadence
+ * expects counts as a cadence error.
+ */
+class CFramePacer
+{
+public:
+  /*!
+   * \brief Longest cadence looked for, in frames
+   */
+  static const int MAX_PATTERN = 10;
+
+  void Reset();
+
+  /*!
+   * \brief Compute the cadence for frames of frametime on a display with
+   * vblanks every interval, both in the same unit
+   * \return true if the cadence changed
+   */
+  bool SetRates(double frametime, double interval);
+
+  /*!
+   * \brief Whether the frame with pts should replace the current one at
+   * the refresh slot vblank, which shows at clock vblankPts
+   */
+  bool IsDue(int64_t vblank, double vblankPts, double nextFramePts) const;
+
+  /*!
+   * \brief A new frame is shown from refresh slot vblank on
+   */
+  void FrameShown(int64_t vblank);
+
+  const std::vector<int>& GetPattern() const { return m_pattern; }
+  std::string GetPatternString() const;
+  bool IsLocked() const { return m_locked; }
+
+  int GetCadenceErrors() const { return m_errors; }
+
+  /*!
+   * \brief Cadence errors during the minute before vblank
+   */
+  int GetErrorsPerMinute(int64_t vblank) const;
+
+  /*!
+   * \brief Pattern of at most maxFrames frames that repeats every
+   * sum(pattern) refreshes, empty if there is none within tolerance
+   */
+  static std::vector<int> FindPattern(double ratio, int maxFrames = MAX_PATTERN);
+
+private:
+  void Error(int64_t vblank);
+  bool TryLock();
+
+  double m_interval = 0.0;
+  double m_ratio = 0.0;
+  std::vector<int> m_pattern;
+  bool m_locked = false;
+  unsigned int m_pos = 0;      // pattern entry of the frame on screen
+  int64_t m_lastVblank = -1;   // slot the frame on screen was shown at
+  std::deque<int> m_history;   // refreshes the last frames were shown for
+  int m_errors = 0;
+  std::deque<int64_t> m_errorVblanks;
+};
@@ -0,0 +1,175 @@
+/*
+ *  Copyright (C) 2019 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "FrameTiming.h"
+#include "filesystem/File.h"
+#include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
+#include "utils/log.h"
+
+#include <algorithm>
+
+const unsigned int CFrameTiming::RING_SIZE;
+
+void CFrameTiming::Reset()
+{
+  for (auto &slot : m_ring)
+    slot.id.store(0, std::memory_order_release);
+}
+
+uint64_t CFrameTiming::Queued(double pts, int64_t decoded)
+{
+  uint64_t id = m_next.fetch_add(1, std::memory_order_relaxed);
+  Slot &slot = m_ring[id % RING_SIZE];
+
+  // readers ignore the slot while it is rewritten
+  slot.id.store(0, std::memory_order_release);
+  slot.pts.store(pts, std::memory_order_relaxed);
+  slot.decoded.store(decoded, std::memory_order_relaxed);
+  slot.queued.store(CurrentHostCounter(), std::memory_order_relaxed);
+  slot.presented.store(0, std::memory_order_relaxed);
+  slot.flipped.store(0, std::memory_order_relaxed);
+  slot.skipped.store(false, std::memory_order_relaxed);
+  slot.id.store(id, std::memory_order_release);
+  return id;
+}
+
+CFrameTiming::Slot* CFrameTiming::Find(uint64_t id)
+{
+  if (!id)
+    return nullptr;
+  Slot &slot = m_ring[id % RING_SIZE];
+  if (slot.id.load(std::memory_order_acquire) != id)
+    return nullptr;
+  return &slot;
+}
+
+void CFrameTiming::Presented(uint64_t id)
+{
+  Slot *slot = Find(id);
+  if (slot)
+    slot->presented.store(CurrentHostCounter(), std::memory_order_relaxed);
+}
+
+void CFrameTiming::Flipped(uint64_t id)
+{
+  // bob renders a frame twice, the first one counts
+  Slot *slot = Find(id);
+  int64_t expected = 0;
+  if (slot)
+    slot->flipped.compare_exchange_strong(expected, CurrentHostCounter(), std::memory_order_relaxed);
+}
+
+void CFrameTiming::Skipped(uint64_t id)
+{
+  Slot *slot = Find(id);
+  if (slot)
+    slot->skipped.store(true, std::memory_order_relaxed);
+}
+
+std::vector<CFrameTiming::Frame> CFrameTiming::GetFrames() const
+{
+  std::vector<Frame> frames;
+  frames.reserve(RING_SIZE);
+
+  for (auto &slot : m_ring)
+  {
+    Frame frame;
+    frame.id = slot.id.load(std::memory_order_acquire);
+    if (!frame.id)
+      continue;
+    frame.pts = slot.pts.load(std::memory_order_relaxed);
+    frame.decoded = slot.decoded.load(std::memory_order_relaxed);
+    frame.queued = slot.queued.load(std::memory_order_relaxed);
+    frame.presented = slot.presented.load(std::memory_order_relaxed);
+    frame.flipped = slot.flipped.load(std::memory_order_relaxed);
+    frame.skipped = slot.skipped.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.id.load(std::memory_order_relaxed) != frame.id)
+      continue;
+    frames.push_back(frame);
+  }
+
+  std::sort(frames.begin(), frames.end(), [](const Frame &a, const Frame &b) { return a.id < b.id; });
+  return frames;
+}
+
+std::string CFrameTiming::GetSummary(unsigned int frames) const
+{
+  std::vector<Frame> ring = GetFrames();
+  if (ring.size() > frames)
+    ring.erase(ring.begin(), ring.end() - frames);
+
+  double toMs = 1000.0 / CurrentHostFrequency();
+  double decodeQueue = 0, queuePresent = 0, presentFlip = 0;
+  int decoded = 0, presented = 0, flipped = 0, skipped = 0;
+  for (auto &frame : ring)
+  {
+    if (frame.skipped)
+      skipped++;
+    if (frame.decoded)
+    {
+      decodeQueue += (frame.queued - frame.decoded) * toMs;
+      decoded++;
+    }
+    if (frame.presented)
+    {
+      queuePresent += (frame.presented - frame.queued) * toMs;
+      presented++;
+      if (frame.flipped)
+      {
+        presentFlip += (frame.flipped - frame.presented) * toMs;
+        flipped++;
+      }
+    }
+  }
+
+  return StringUtils::Format("decode>queue: %.1f queue>present: %.1f present>flip: %.1f ms skipped: %d/%d",
+                             decoded ? decodeQueue / decoded : 0.0,
+                             presented ? queuePresent / presented : 0.0,
+                             flipped ? presentFlip / flipped : 0.0,
+                             skipped, static_cast<int>(ring.size()));
+}
+
+bool CFrameTiming::WriteCSV(const std::string &path) const
+{
+  std::vector<Frame> frames = GetFrames();
+  if (frames.empty())
+    return false;
+
+  int64_t base = frames.front().decoded ? frames.front().decoded : frames.front().queued;
+  double toUs = 1000000.0 / CurrentHostFrequency();
+  auto time = [base, toUs](int64_t t)
+  {
+    return t ? StringUtils::Format("%.0f", (t - base) * toUs) : std::string();
+  };
+
+  std::string csv = "frame,pts,decoded,queued,presented,flipped,skipped\n";
+  for (auto &frame : frames)
+  {
+    csv += StringUtils::Format("%llu,%.0f,%s,%s,%s,%s,%d\n",
+                               static_cast<unsigned long long>(frame.id),
+                               frame.pts,
+                               time(frame.decoded).c_str(),
+                               time(frame.queued).c_str(),
+                               time(frame.presented).c_str(),
+                               time(frame.flipped).c_str(),
+                               frame.skipped ? 1 : 0);
+  }
+
+  XFILE::CFile file;
+  if (!file.OpenForWrite(path, true) ||
+      file.Write(csv.data(), csv.size()) != static_cast<ssize_t>(csv.size()))
+  {
+    CLog::Log(LOGERROR, "CFrameTiming::WriteCSV - failed to write %s", path.c_str());
+    return false;
+  }
+
+  CLog::Log(LOGNOTICE, "CFrameTiming::WriteCSV - %d frames written to %s", static_cast<int>(frames.size()), path.c_str());
+  return true;
+}
@@ -0,0 +1,83 @@
+/*
+ *  Copyright (C) 2019 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/*!
+ * \brief Records when the frames of the render queue pass its stages
+ *
+ * The player thread adds a frame when it is queued, the render thread marks
+ * it presented (picked by PrepareNextRender), flipped (rendered to the back
+ * buffer) or skipped. The last RING_SIZE frames are kept in a ring that is
+ * written without locks, readers drop entries that were recycled while they
+ * copied them. Times are host counter values, 0 if a stage was not reached.
+ */
+class CFrameTiming
+{
+public:
+  static const unsigned int RING_SIZE = 512;
+
+  struct Frame
+  {
+    uint64_t id;
+    double pts;
+    int64_t decoded;
+    int64_t queued;
+    int64_t presented;
+    int64_t flipped;
+    bool skipped;
+  };
+
+  void Reset();
+
+  /*!
+   * \brief Add a frame entering the render queue
+   * \return id of the frame for the other stages
+   */
+  uint64_t Queued(double pts, int64_t decoded);
+  void Presented(uint64_t id);
+  void Flipped(uint64_t id);
+  void Skipped(uint64_t id);
+
+  /*!
+   * \brief Copy of the frames in the ring, oldest first
+   */
+  std::vector<Frame> GetFrames() const;
+
+  /*!
+   * \brief One line of average stage latencies over the last frames
+   */
+  std::string GetSummary(unsigned int frames = 120) const;
+
+  /*!
+   * \brief Write the ring as csv, times in us relative to the first frame
+   */
+  bool WriteCSV(const std::string &path) const;
+
+private:
+  struct Slot
+  {
+    std::atomic<uint64_t> id{0};
+    std::atomic<double> pts{0.0};
+    std::atomic<int64_t> decoded{0};
+    std::atomic<int64_t> queued{0};
+    std::atomic<int64_t> presented{0};
+    std::atomic<int64_t> flipped{0};
+    std::atomic_bool skipped{false};
+  };
+
+  Slot* Find(uint64_t id);
+
+  Slot m_ring[RING_SIZE];
+  std::atomic<uint64_t> m_next{1};
+};
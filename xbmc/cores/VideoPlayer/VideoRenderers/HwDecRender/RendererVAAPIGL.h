@@ -42,6 +42,7 @@ protected:
   bool LoadShadersHook() override;
   bool RenderHook(int idx) override;
   void AfterRenderHook(int idx) override;
+  bool CanCopyAhead() override { return false; };
 
   // textures
   bool UploadTexture(int index) override;
@@ -33,5 +33,6 @@ protected:
   virtual bool UploadTexture(int index) override;
   virtual void DeleteTexture(int index) override;
   virtual bool CreateTexture(int index) override;
+  virtual bool CanCopyAhead() override { return false; };
 };
 
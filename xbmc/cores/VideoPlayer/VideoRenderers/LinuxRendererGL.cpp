@@ -9,6 +9,7 @@
  *  See LICENSES/README.md for more information.
  */
 
+#include <algorithm>
 #include <locale.h>
 
 #include "LinuxRendererGL.h"
@@ -28,6 +29,7 @@
 #include "rendering/MatrixGL.h"
 #include "rendering/gl/RenderSystemGL.h"
 #include "threads/SingleLock.h"
+#include "utils/CPUInfo.h"
 #include "utils/log.h"
 #include "utils/GLUtils.h"
 #include "utils/StringUtils.h"
@@ -96,6 +98,7 @@ CLinuxRendererGL::CPictureBuffer::CPictureBuffer()
   memset(&pbo   , 0, sizeof(pbo));
   videoBuffer = nullptr;
   loaded = false;
+  copied = false;
 }
 
 CLinuxRendererGL::CPictureBuffer::~CPictureBuffer() = default;
@@ -244,6 +247,13 @@ bool CLinuxRendererGL::Configure(const VideoPicture &picture, float fps, unsigne
 
   m_pboSupported = CServiceBroker::GetRenderSystem()->IsExtSupported("GL_ARB_pixel_buffer_object");
 
+  if (!m_copyWorkers && CanCopyAhead())
+  {
+    int threads = std::max(1, std::min(g_cpuInfo.getCPUCount() / 2, 4));
+    m_copyWorkers.reset(new CPlaneCopyWorkers(threads));
+    CLog::Log(LOGDEBUG, "CLinuxRendererGL::Configure - copying planes on %d threads", threads);
+  }
+
   // setup the background colour
   m_clearColour = CServiceBroker::GetWinSystem()->UseLimitedColor() ? (16.0f / 0xff) : 0.0f;
 
@@ -285,6 +295,7 @@ void CLinuxRendererGL::AddVideoPicture(const VideoPicture &picture, int index)
   buf.videoBuffer = picture.videoBuffer;
   buf.videoBuffer->Acquire();
   buf.loaded = false;
+  buf.copied = false;
   buf.m_srcPrimaries = static_cast<AVColorPrimaries>(picture.color_primaries);
   buf.m_srcColSpace = static_cast<AVColorSpace>(picture.color_space);
   buf.m_srcFullRange = picture.color_range == 1;
@@ -295,11 +306,15 @@ void CLinuxRendererGL::AddVideoPicture(const VideoPicture &picture, int index)
   buf.lightMetadata = picture.lightMetadata;
   if (picture.hasLightMetadata && picture.lightMetadata.MaxCLL)
     buf.hasLightMetadata = picture.hasLightMetadata;
+
+  if (CanCopyAhead())
+    QueueCopy(index);
 }
 
 void CLinuxRendererGL::ReleaseBuffer(int idx)
 {
   CPictureBuffer &buf = m_buffers[idx];
+  WaitCopy(idx);
   if (buf.videoBuffer)
   {
     buf.videoBuffer->Release();
@@ -1759,6 +1774,9 @@ GLint CLinuxRendererGL::GetInternalFormat(GLint format, int bpp)
 
 bool CLinuxRendererGL::CreateTexture(int index)
 {
+  CSingleLock lock(m_copyLock);
+  WaitCopy(index);
+
   if (m_format == AV_PIX_FMT_NV12)
     return CreateNV12Texture(index);
   else if (m_format == AV_PIX_FMT_YUYV422 ||
@@ -1770,8 +1788,12 @@ bool CLinuxRendererGL::CreateTexture(int index)
 
 void CLinuxRendererGL::DeleteTexture(int index)
 {
+  CSingleLock lock(m_copyLock);
+  WaitCopy(index);
+
   CPictureBuffer& buf = m_buffers[index];
   buf.loaded = false;
+  buf.copied = false;
 
   if (m_format == AV_PIX_FMT_NV12)
     DeleteNV12Texture(index);
@@ -1793,6 +1815,9 @@ bool CLinuxRendererGL::UploadTexture(int index)
   {
     ret = false;
 
+    CSingleLock lock(m_copyLock);
+    WaitCopy(index);
+
     YuvImage &dst = m_buffers[index].image;
     YuvImage src;
     m_buffers[index].videoBuffer->GetPlanes(src.plane);
@@ -1800,26 +1825,38 @@ bool CLinuxRendererGL::UploadTexture(int index)
 
     UnBindPbo(m_buffers[index]);
 
+    // the workers are done with the planes unless the buffers were not mapped in time.
+    // The pbos are orphaned when they are mapped again, a failed upload copies again
+    bool copied = m_buffers[index].copied;
+    m_buffers[index].copied = false;
     if (m_format == AV_PIX_FMT_NV12)
     {
-      CVideoBuffer::CopyNV12Picture(&dst, &src);
+      if (!copied)
+        CVideoBuffer::CopyNV12Picture(&dst, &src);
       BindPbo(m_buffers[index]);
       ret = UploadNV12Texture(index);
     }
     else if (m_format == AV_PIX_FMT_YUYV422 ||
              m_format == AV_PIX_FMT_UYVY422)
     {
-      CVideoBuffer::CopyYUV422PackedPicture(&dst, &src);
+      if (!copied)
+        CVideoBuffer::CopyYUV422PackedPicture(&dst, &src);
       BindPbo(m_buffers[index]);
       ret = UploadYUV422PackedTexture(index);
     }
     else
     {
-      CVideoBuffer::CopyPicture(&dst, &src);
+      if (!copied)
+        CVideoBuffer::CopyPicture(&dst, &src);
       BindPbo(m_buffers[index]);
       ret = UploadYV12Texture(index);
     }
 
+    // map the pbos again right away, the next picture of this buffer is
+    // copied into them while this one is shown
+    if (CanCopyAhead())
+      UnBindPbo(m_buffers[index]);
+
     if (ret)
       m_buffers[index].loaded = true;
   }
@@ -2668,6 +2705,69 @@ void CLinuxRendererGL::UnBindPbo(CPictureBuffer& buff)
     glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, 0);
 }
 
+void CLinuxRendererGL::QueueCopy(int index)
+{
+  CSingleLock lock(m_copyLock);
+  CPictureBuffer& buf = m_buffers[index];
+  YuvImage &dst = buf.image;
+  if (!m_copyWorkers || !m_bValidated || !buf.videoBuffer)
+    return;
+
+  int planes = 3;
+  if (m_format == AV_PIX_FMT_NV12)
+    planes = 2;
+  else if (m_format == AV_PIX_FMT_YUYV422 ||
+           m_format == AV_PIX_FMT_UYVY422)
+    planes = 1;
+
+  // buffers that are unmapped or not created yet are copied on upload
+  for (int i = 0; i < planes; i++)
+  {
+    if (!dst.plane[i] || dst.plane[i] == (uint8_t*)PBO_OFFSET)
+      return;
+  }
+
+  YuvImage src;
+  buf.videoBuffer->GetPlanes(src.plane);
+  buf.videoBuffer->GetStrides(src.stride);
+
+  std::vector<CPlaneCopyWorkers::Plane> copies;
+  for (int i = 0; i < planes; i++)
+  {
+    CPlaneCopyWorkers::Plane plane;
+    plane.dst = dst.plane[i];
+    plane.src = src.plane[i];
+    plane.dstStride = dst.stride[i];
+    plane.srcStride = src.stride[i];
+    if (planes == 1)
+    {
+      plane.width = dst.width * 2;
+      plane.height = dst.height;
+    }
+    else if (i == 0)
+    {
+      plane.width = dst.width * dst.bpp;
+      plane.height = dst.height;
+    }
+    else
+    {
+      // the packed uv plane of nv12 is as wide as luma
+      plane.width = planes == 2 ? dst.width : (dst.width >> dst.cshift_x) * dst.bpp;
+      plane.height = planes == 2 ? dst.height >> 1 : dst.height >> dst.cshift_y;
+    }
+    copies.push_back(plane);
+  }
+
+  m_copyWorkers->Copy(index, copies);
+  buf.copied = true;
+}
+
+void CLinuxRendererGL::WaitCopy(int index)
+{
+  if (m_copyWorkers)
+    m_copyWorkers->Wait(index);
+}
+
 CRenderInfo CLinuxRendererGL::GetRenderInfo()
 {
   CRenderInfo info;
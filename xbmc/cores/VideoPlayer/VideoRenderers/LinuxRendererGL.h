@@ -8,6 +8,8 @@
 
 #pragma once
 
+#include <atomic>
+#include <memory>
 #include <vector>
 
 #include "system_gl.h"
@@ -20,6 +22,8 @@
 #include "windowing/GraphicContext.h"
 #include "BaseRenderer.h"
 #include "ColorManager.h"
+#include "PlaneCopyWorkers.h"
+#include "threads/CriticalSection.h"
 #include "threads/Event.h"
 #include "VideoShaders/ShaderFormats.h"
 #include "utils/Geometry.h"
@@ -136,6 +140,8 @@ protected:
 
   void BindPbo(CPictureBuffer& buff);
   void UnBindPbo(CPictureBuffer& buff);
+  void QueueCopy(int index);
+  void WaitCopy(int index);
   void LoadPlane(CYuvPlane& plane, int type,
                  unsigned width,  unsigned height,
                  int stride, int bpp, void* data);
@@ -147,6 +153,7 @@ protected:
   virtual bool RenderHook(int idx) { return false; };
   virtual void AfterRenderHook(int idx) {};
   virtual bool CanSaveBuffers() { return true; };
+  virtual bool CanCopyAhead() { return true; };
 
   struct
   {
@@ -158,7 +165,7 @@ protected:
   int m_NumYV12Buffers = 0;
 
   bool m_bConfigured = false;
-  bool m_bValidated = false;
+  std::atomic<bool> m_bValidated{false}; // also read by the player thread in QueueCopy
   GLenum m_textureTarget;
   int m_renderMethod = RENDER_GLSL;
   RenderQuality m_renderQuality = RQ_SINGLEPASS;
@@ -193,6 +200,7 @@ protected:
 
     CVideoBuffer *videoBuffer;
     bool loaded;
+    bool copied; // planes are copied into image by the workers
 
     AVColorPrimaries m_srcPrimaries;
     AVColorSpace m_srcColSpace;
@@ -227,6 +235,10 @@ protected:
   float m_pixelRatio = 0.0f;
   CRect m_viewRect;
 
+  // software pictures are copied into the mapped buffers ahead of the render thread
+  std::unique_ptr<CPlaneCopyWorkers> m_copyWorkers;
+  CCriticalSection m_copyLock;
+
   // color management
   std::unique_ptr<CColorManager> m_ColorManager;
   GLuint m_tCLUTTex;
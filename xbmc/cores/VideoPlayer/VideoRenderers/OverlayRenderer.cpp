@@ -22,6 +22,7 @@
 #include "settings/Settings.h"
 #include "settings/SettingsComponent.h"
 #include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
 #include "utils/ColorUtils.h"
 #include "OverlayRendererUtil.h"
 #include "OverlayRendererGUI.h"
@@ -53,6 +54,10 @@ COverlay::COverlay()
 COverlay::~COverlay() = default;
 
 unsigned int CRenderer::m_textureid = 1;
+std::atomic<uint64_t> CRenderer::m_uploaded(0);
+uint64_t CRenderer::m_uploadedLast = 0;
+unsigned int CRenderer::m_uploadTime = 0;
+unsigned int CRenderer::m_uploadRate = 0;
 
 CRenderer::CRenderer()
 {
@@ -65,6 +70,20 @@ CRenderer::~CRenderer()
   Flush();
 }
 
+unsigned int CRenderer::GetUploadRate()
+{
+  unsigned int now = XbmcThreads::SystemClockMillis();
+  unsigned int elapsed = now - m_uploadTime;
+  if (elapsed >= 1000)
+  {
+    uint64_t uploaded = m_uploaded;
+    m_uploadRate = static_cast<unsigned int>((uploaded - m_uploadedLast) * 1000 / elapsed);
+    m_uploadedLast = uploaded;
+    m_uploadTime = now;
+  }
+  return m_uploadRate;
+}
+
 void CRenderer::AddOverlay(CDVDOverlay* o, double pts, int index)
 {
   CSingleLock lock(m_section);
@@ -12,6 +12,7 @@
 #include "threads/CriticalSection.h"
 #include "BaseRenderer.h"
 
+#include <atomic>
 #include <vector>
 #include <map>
 
@@ -77,6 +78,12 @@ namespace OVERLAY {
     void SetVideoRect(CRect &source, CRect &dest, CRect &view);
     void SetStereoMode(const std::string &stereomode);
 
+    /*! \brief Called by the overlays for every texture upload */
+    static void AddUploaded(size_t bytes) { m_uploaded += bytes; }
+
+    /*! \brief Bytes uploaded to overlay textures per second, updated once a second */
+    static unsigned int GetUploadRate();
+
   protected:
 
     struct SElement
@@ -102,6 +109,10 @@ namespace OVERLAY {
     std::vector<SElement> m_buffers[NUM_BUFFERS];
     std::map<unsigned int, COverlay*> m_textureCache;
     static unsigned int m_textureid;
+    static std::atomic<uint64_t> m_uploaded;
+    static uint64_t m_uploadedLast;
+    static unsigned int m_uploadTime;
+    static unsigned int m_uploadRate;
     CRect m_rv, m_rs, m_rd;
     std::string m_font, m_fontBorder;
     std::string m_stereomode;
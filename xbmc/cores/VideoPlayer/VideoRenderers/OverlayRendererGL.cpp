@@ -28,6 +28,9 @@
 #include "utils/log.h"
 #include "utils/GLUtils.h"
 
+#include <algorithm>
+#include <cstring>
+
 #if HAS_GLES >= 2
 // GLES2.0 cant do CLAMP, but can do CLAMP_TO_EDGE.
 #define GL_CLAMP	GL_CLAMP_TO_EDGE
@@ -136,6 +139,7 @@ static void LoadTexture(GLenum target
                 , 0, 0, width, height
                 , externalFormat, GL_UNSIGNED_BYTE
                 , pixelData);
+  CRenderer::AddUploaded(bytesPerPixel * width * height);
 
   if(height < height2)
     glTexSubImage2D( target, 0
@@ -274,6 +278,70 @@ COverlayTextureGL::COverlayTextureGL(CDVDOverlaySpu* o)
   m_pma    = !!USE_PREMULTIPLIED_ALPHA;
 }
 
+std::shared_ptr<CGlyphAtlasGL> CGlyphAtlasGL::Get(bool renew)
+{
+  // overlays keep the atlas alive, it goes with the last of them
+  static std::weak_ptr<CGlyphAtlasGL> current;
+
+  std::shared_ptr<CGlyphAtlasGL> atlas = current.lock();
+  if (!atlas || renew)
+  {
+    atlas = std::make_shared<CGlyphAtlasGL>();
+    current = atlas;
+  }
+  return atlas;
+}
+
+CGlyphAtlasGL::CGlyphAtlasGL()
+  : m_glyphs(SIZE)
+{
+#ifdef HAS_GLES
+  GLenum format = GL_ALPHA;
+#else
+  GLenum format = GL_RED;
+#endif
+
+  std::vector<uint8_t> clear(SIZE * SIZE, 0);
+
+  glGenTextures(1, &m_texture);
+  glBindTexture(GL_TEXTURE_2D, m_texture);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+  glTexImage2D(GL_TEXTURE_2D, 0, format, SIZE, SIZE, 0, format, GL_UNSIGNED_BYTE, clear.data());
+  glBindTexture(GL_TEXTURE_2D, 0);
+  CRenderer::AddUploaded(clear.size());
+}
+
+CGlyphAtlasGL::~CGlyphAtlasGL()
+{
+  glDeleteTextures(1, &m_texture);
+}
+
+bool CGlyphAtlasGL::Insert(const ASS_Image* image, int &u, int &v)
+{
+  bool placed;
+  if (!m_glyphs.Insert(image->bitmap, image->w, image->h, image->stride, u, v, placed))
+    return false;
+  if (!placed)
+    return true;
+
+#ifdef HAS_GLES
+  GLenum format = GL_ALPHA;
+#else
+  GLenum format = GL_RED;
+#endif
+
+  m_upload.resize(image->w * image->h);
+  for (int y = 0; y < image->h; y++)
+    memcpy(m_upload.data() + y * image->w, image->bitmap + y * image->stride, image->w);
+
+  glBindTexture(GL_TEXTURE_2D, m_texture);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+  glTexSubImage2D(GL_TEXTURE_2D, 0, u, v, image->w, image->h, format, GL_UNSIGNED_BYTE, m_upload.data());
+  glBindTexture(GL_TEXTURE_2D, 0);
+  CRenderer::AddUploaded(m_upload.size());
+  return true;
+}
+
 COverlayGlyphGL::COverlayGlyphGL(ASS_Image* images, int width, int height)
 {
   m_vertex = NULL;
@@ -286,23 +354,33 @@ COverlayGlyphGL::COverlayGlyphGL(ASS_Image* images, int width, int height)
   m_texture = 0;
 
   SQuads quads;
-  if(!convert_quad(images, quads, width))
-    return;
-
-  glGenTextures(1, &m_texture);
-  glBindTexture(GL_TEXTURE_2D, m_texture);
-
-  LoadTexture(GL_TEXTURE_2D
-            , quads.size_x
-            , quads.size_y
-            , quads.size_x
-            , &m_u, &m_v
-            , true
-            , quads.data);
-
-
-  float scale_u = m_u / quads.size_x;
-  float scale_v = m_v / quads.size_y;
+  float scale_u;
+  float scale_v;
+  if (LoadAtlas(images, quads))
+  {
+    scale_u = 1.0f / CGlyphAtlasGL::SIZE;
+    scale_v = 1.0f / CGlyphAtlasGL::SIZE;
+  }
+  else
+  {
+    // bitmaps larger than the atlas, put all of them into a texture of their own
+    if(!convert_quad(images, quads, width))
+      return;
+
+    glGenTextures(1, &m_texture);
+    glBindTexture(GL_TEXTURE_2D, m_texture);
+
+    LoadTexture(GL_TEXTURE_2D
+              , quads.size_x
+              , quads.size_y
+              , quads.size_x
+              , &m_u, &m_v
+              , true
+              , quads.data);
+
+    scale_u = m_u / quads.size_x;
+    scale_v = m_v / quads.size_y;
+  }
 
   float scale_x = 1.0f / width;
   float scale_y = 1.0f / height;
@@ -356,6 +434,64 @@ COverlayGlyphGL::COverlayGlyphGL(ASS_Image* images, int width, int height)
   glBindTexture(GL_TEXTURE_2D, 0);
 }
 
+bool COverlayGlyphGL::LoadAtlas(ASS_Image* images, SQuads& quads)
+{
+  int count = 0;
+  for (ASS_Image* img = images; img; img = img->next)
+  {
+    // fully transparent or width or height is 0 -> not displayed
+    if ((img->color & 0xff) != 0xff && img->w > 0 && img->h > 0)
+      count++;
+  }
+  if (count == 0)
+    return false;
+
+  quads.quad = static_cast<SQuad*>(calloc(count, sizeof(SQuad)));
+
+  // start over with an empty atlas once, when that doesn't suffice either
+  // the bitmaps are just too large
+  for (int attempt = 0; attempt < 2; attempt++)
+  {
+    std::shared_ptr<CGlyphAtlasGL> atlas = CGlyphAtlasGL::Get(attempt > 0);
+    SQuad* v = quads.quad;
+    quads.count = 0;
+
+    ASS_Image* img;
+    for (img = images; img; img = img->next)
+    {
+      if ((img->color & 0xff) == 0xff || img->w == 0 || img->h == 0)
+        continue;
+
+      if (!atlas->Insert(img, v->u, v->v))
+        break;
+
+      unsigned int color = img->color;
+      v->a = 255 - (color & 0xff);
+      v->r = (color >> 24) & 0xff;
+      v->g = (color >> 16) & 0xff;
+      v->b = (color >> 8) & 0xff;
+      v->x = img->dst_x;
+      v->y = img->dst_y;
+      v->w = img->w;
+      v->h = img->h;
+
+      v++;
+      quads.count++;
+    }
+
+    if (!img)
+    {
+      m_atlas = atlas;
+      return true;
+    }
+  }
+
+  free(quads.quad);
+  quads.quad = NULL;
+  quads.count = 0;
+  return false;
+}
+
 COverlayGlyphGL::~COverlayGlyphGL()
 {
   glDeleteTextures(1, &m_texture);
@@ -364,12 +500,13 @@ COverlayGlyphGL::~COverlayGlyphGL()
 
 void COverlayGlyphGL::Render(SRenderState& state)
 {
-  if ((m_texture == 0) || (m_count == 0))
+  GLuint texture = m_atlas ? m_atlas->GetTexture() : m_texture;
+  if ((texture == 0) || (m_count == 0))
     return;
 
   glEnable(GL_BLEND);
 
-  glBindTexture(GL_TEXTURE_2D, m_texture);
+  glBindTexture(GL_TEXTURE_2D, texture);
   glBlendFunc(GL_SRC_ALPHA,GL_ONE_MINUS_SRC_ALPHA);
 
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
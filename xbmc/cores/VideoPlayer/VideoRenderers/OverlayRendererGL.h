@@ -11,6 +11,9 @@
 
 #include "system_gl.h"
 #include "OverlayRenderer.h"
+#include "OverlayRendererUtil.h"
+
+#include <memory>
 
 class CDVDOverlay;
 class CDVDOverlayImage;
@@ -20,6 +23,8 @@ typedef struct ass_image ASS_Image;
 
 namespace OVERLAY {
 
+  struct SQuads;
+
   class COverlayTextureGL : public COverlay
   {
   public:
@@ -35,6 +40,41 @@ namespace OVERLAY {
     bool   m_pma; /*< is alpha in texture premultiplied in the values */
   };
 
+  /*!
+   * \brief Texture with the libass bitmaps of recent subtitles
+   *
+   * Glyphs are packed into shelves and found again by their content, so
+   * subtitles that only move or change colour, like karaoke, don't upload
+   * anything. When it is full a new atlas replaces it for new overlays, the
+   * old one is kept by the overlays that still use it.
+   */
+  class CGlyphAtlasGL
+  {
+  public:
+    static const int SIZE = 1024;
+
+    /*!
+     * \brief The atlas for new overlays, a new one if renew is set
+     */
+    static std::shared_ptr<CGlyphAtlasGL> Get(bool renew);
+
+    CGlyphAtlasGL();
+    ~CGlyphAtlasGL();
+
+    /*!
+     * \brief Position of the bitmap in the atlas, it's uploaded if not there yet
+     * \return false if it doesn't fit anymore
+     */
+    bool Insert(const ASS_Image* image, int &u, int &v);
+
+    GLuint GetTexture() const { return m_texture; }
+
+  private:
+    GLuint m_texture = 0;
+    CGlyphAtlas m_glyphs;
+    std::vector<uint8_t> m_upload;
+  };
+
   class COverlayGlyphGL : public COverlay
   {
   public:
@@ -57,6 +97,10 @@ namespace OVERLAY {
    GLuint m_texture;
    float  m_u;
    float  m_v;
+   std::shared_ptr<CGlyphAtlasGL> m_atlas;
+
+  private:
+   bool LoadAtlas(ASS_Image* images, SQuads& quads);
   };
 
 }
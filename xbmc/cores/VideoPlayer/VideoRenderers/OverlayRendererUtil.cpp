@@ -15,8 +15,89 @@
 #include "settings/Settings.h"
 #include "settings/SettingsComponent.h"
 
+#include <algorithm>
+#include <cstring>
+
 namespace OVERLAY {
 
+CGlyphAtlas::CGlyphAtlas(int size)
+  : m_size(size),
+    m_pixels(size * size, 0)
+{
+}
+
+bool CGlyphAtlas::Insert(const uint8_t* bitmap, int width, int height, int stride, int &u, int &v, bool &placed)
+{
+  placed = false;
+
+  // libass reuses the buffers of its cache, equal bitmaps are found by content
+  uint64_t hash = Hash(bitmap, width, height, stride);
+  auto range = m_glyphs.equal_range(hash);
+  for (auto it = range.first; it != range.second; ++it)
+  {
+    if (Equals(it->second, bitmap, width, height, stride))
+    {
+      u = it->second.u;
+      v = it->second.v;
+      return true;
+    }
+  }
+
+  // one pixel apart so linear filtering doesn't pick up the neighbours
+  if (m_shelfX + width + 1 > m_size)
+  {
+    m_shelfY += m_shelfHeight;
+    m_shelfX = 0;
+    m_shelfHeight = 0;
+  }
+  if (m_shelfX + width + 1 > m_size || m_shelfY + height + 1 > m_size)
+    return false;
+
+  u = m_shelfX;
+  v = m_shelfY;
+  m_shelfX += width + 1;
+  m_shelfHeight = std::max(m_shelfHeight, height + 1);
+  m_glyphs.insert(std::make_pair(hash, Glyph{ u, v, width, height }));
+
+  for (int y = 0; y < height; y++)
+    memcpy(m_pixels.data() + (v + y) * m_size + u, bitmap + y * stride, width);
+
+  placed = true;
+  return true;
+}
+
+uint64_t CGlyphAtlas::Hash(const uint8_t* bitmap, int width, int height, int stride) const
+{
+  // fnv-1a
+  uint64_t hash = 14695981039346656037ULL;
+  auto mix = [&hash](uint8_t value) { hash = (hash ^ value) * 1099511628211ULL; };
+  for (int shift = 0; shift < 32; shift += 8)
+  {
+    mix(static_cast<uint8_t>(width >> shift));
+    mix(static_cast<uint8_t>(height >> shift));
+  }
+  for (int y = 0; y < height; y++)
+  {
+    const uint8_t *row = bitmap + y * stride;
+    for (int x = 0; x < width; x++)
+      mix(row[x]);
+  }
+  return hash;
+}
+
+bool CGlyphAtlas::Equals(const Glyph& glyph, const uint8_t* bitmap, int width, int height, int stride) const
+{
+  if (glyph.width != width || glyph.height != height)
+    return false;
+
+  for (int y = 0; y < height; y++)
+  {
+    if (memcmp(m_pixels.data() + (glyph.v + y) * m_size + glyph.u, bitmap + y * stride, width) != 0)
+      return false;
+  }
+  return true;
+}
+
 static uint32_t build_rgba(int a, int r, int g, int b, bool mergealpha)
 {
   if(mergealpha)
@@ -10,6 +10,8 @@
 
 #include <stdint.h>
 #include <stdlib.h>
+#include <unordered_map>
+#include <vector>
 
 class CDVDOverlayImage;
 class CDVDOverlaySpu;
@@ -48,6 +50,52 @@ namespace OVERLAY {
     SQuad*   quad;
   };
 
+  /*!
+   * \brief Packs 8 bit bitmaps into the shelves of a square atlas
+   *
+   * A bitmap equal to one placed before gets its position. Bitmaps are looked
+   * up by a hash of their content and compared with the copy of the atlas.
+   */
+  class CGlyphAtlas
+  {
+  public:
+    explicit CGlyphAtlas(int size);
+    virtual ~CGlyphAtlas() = default;
+
+    /*!
+     * \brief Finds or places a bitmap
+     * \param placed set if the bitmap is new, it has to be uploaded at u, v
+     * \return false if it doesn't fit anymore
+     */
+    bool Insert(const uint8_t* bitmap, int width, int height, int stride, int &u, int &v, bool &placed);
+
+    int GetSize() const { return m_size; }
+
+    /*!
+     * \brief Number of different bitmaps in the atlas
+     */
+    size_t GetCount() const { return m_glyphs.size(); }
+
+  protected:
+    virtual uint64_t Hash(const uint8_t* bitmap, int width, int height, int stride) const;
+
+  private:
+    struct Glyph
+    {
+      int u, v;
+      int width, height;
+    };
+
+    bool Equals(const Glyph& glyph, const uint8_t* bitmap, int width, int height, int stride) const;
+
+    int m_size;
+    int m_shelfX = 0;
+    int m_shelfY = 0;
+    int m_shelfHeight = 0;
+    std::unordered_multimap<uint64_t, Glyph> m_glyphs;
+    std::vector<uint8_t> m_pixels;
+  };
+
   uint32_t* convert_rgba(CDVDOverlayImage* o, bool mergealpha);
   uint32_t* convert_rgba(CDVDOverlaySpu*   o, bool mergealpha
                        , int& min_x, int& max_x
@@ -0,0 +1,122 @@
+/*
+ *  Copyright (C) 2019 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "PlaneCopyWorkers.h"
+#include "threads/SingleLock.h"
+#include "threads/Thread.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+// smaller slices cost more in wakeups than they save
+const int MIN_SLICE_ROWS = 32;
+}
+
+CPlaneCopyWorkers::CPlaneCopyWorkers(unsigned int threads)
+{
+  for (unsigned int i = 0; i < threads; i++)
+  {
+    m_threads.emplace_back(new CThread(this, "PlaneCopy"));
+    m_threads.back()->Create();
+  }
+}
+
+CPlaneCopyWorkers::~CPlaneCopyWorkers()
+{
+  {
+    CSingleLock lock(m_lock);
+    m_stop = true;
+    m_work.notifyAll();
+  }
+  for (auto &thread : m_threads)
+    thread->StopThread(true);
+}
+
+void CPlaneCopyWorkers::Copy(int id, const std::vector<Plane> &planes)
+{
+  if (m_threads.empty())
+  {
+    for (auto &plane : planes)
+      CopyPlane(plane);
+    return;
+  }
+
+  CSingleLock lock(m_lock);
+  for (auto &plane : planes)
+  {
+    int slices = std::max(1, std::min<int>(m_threads.size(), plane.height / MIN_SLICE_ROWS));
+    int rows = (plane.height + slices - 1) / slices;
+    for (int y = 0; y < plane.height; y += rows)
+    {
+      Plane slice = plane;
+      slice.dst += y * plane.dstStride;
+      slice.src += y * plane.srcStride;
+      slice.height = std::min(rows, plane.height - y);
+      m_slices.emplace_back(id, slice);
+      m_pending[id]++;
+    }
+  }
+  m_work.notifyAll();
+}
+
+void CPlaneCopyWorkers::Wait(int id)
+{
+  CSingleLock lock(m_lock);
+  auto it = m_pending.find(id);
+  while (it != m_pending.end() && it->second > 0)
+  {
+    m_done.wait(lock);
+    it = m_pending.find(id);
+  }
+}
+
+void CPlaneCopyWorkers::CopyPlane(const Plane &plane)
+{
+  if (plane.width == plane.srcStride && plane.srcStride == plane.dstStride)
+  {
+    memcpy(plane.dst, plane.src, plane.width * plane.height);
+    return;
+  }
+
+  uint8_t *d = plane.dst;
+  const uint8_t *s = plane.src;
+  for (int y = 0; y < plane.height; y++)
+  {
+    memcpy(d, s, plane.width);
+    s += plane.srcStride;
+    d += plane.dstStride;
+  }
+}
+
+void CPlaneCopyWorkers::Run()
+{
+  CSingleLock lock(m_lock);
+  while (!m_stop)
+  {
+    if (m_slices.empty())
+    {
+      m_work.wait(lock);
+      continue;
+    }
+
+    std::pair<int, Plane> slice = m_slices.front();
+    m_slices.pop_front();
+    {
+      CSingleExit exit(m_lock);
+      CopyPlane(slice.second);
+    }
+
+    if (--m_pending[slice.first] == 0)
+    {
+      m_pending.erase(slice.first);
+      m_done.notifyAll();
+    }
+  }
+}
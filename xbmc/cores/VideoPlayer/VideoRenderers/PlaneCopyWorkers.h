@@ -0,0 +1,73 @@
+/*
+ *  Copyright (C) 2019 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "threads/Condition.h"
+#include "threads/CriticalSection.h"
+#include "threads/IRunnable.h"
+
+#include <deque>
+#include <map>
+#include <memory>
+#include <stdint.h>
+#include <vector>
+
+class CThread;
+
+/*!
+ * \brief Copies the planes of pictures into render buffers on worker threads
+ *
+ * Planes are split into slices of rows, the slices of all queued pictures
+ * are copied in parallel. A renderer queues a picture when it enters the
+ * render queue and waits for it before the buffers are handed to the gpu.
+ */
+class CPlaneCopyWorkers : private IRunnable
+{
+public:
+  struct Plane
+  {
+    uint8_t *dst;
+    const uint8_t *src;
+    int dstStride;
+    int srcStride;
+    int width;   // bytes per row
+    int height;  // rows
+  };
+
+  explicit CPlaneCopyWorkers(unsigned int threads);
+  ~CPlaneCopyWorkers() override;
+
+  /*!
+   * \brief Queue the copy of planes, id identifies the picture for Wait
+   */
+  void Copy(int id, const std::vector<Plane> &planes);
+
+  /*!
+   * \brief Block until all copies queued for id are done
+   */
+  void Wait(int id);
+
+  unsigned int GetThreads() const { return m_threads.size(); }
+
+  /*!
+   * \brief Copy a plane row by row or in one go if the strides match
+   */
+  static void CopyPlane(const Plane &plane);
+
+private:
+  void Run() override;
+
+  CCriticalSection m_lock;
+  XbmcThreads::ConditionVariable m_work;
+  XbmcThreads::ConditionVariable m_done;
+  std::deque<std::pair<int, Plane>> m_slices;
+  std::map<int, int> m_pending;
+  bool m_stop = false;
+  std::vector<std::unique_ptr<CThread>> m_threads;
+};
@@ -15,6 +15,7 @@
 #include "threads/SingleLock.h"
 #include "utils/log.h"
 #include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
 #include "windowing/WinSystem.h"
 
 #include "Application.h"
@@ -45,7 +46,8 @@ void CRenderManager::CClockSync::Reset()
   m_enabled = false;
 }
 
-unsigned int CRenderManager::m_nextCaptureId = 0;
+// 0 is returned by the players when there is nothing to capture
+unsigned int CRenderManager::m_nextCaptureId = 1;
 
 CRenderManager::CRenderManager(CDVDClock &clock, IRenderMsg *player) :
   m_dvdClock(clock),
@@ -196,6 +198,17 @@ bool CRenderManager::Configure()
     if (m_NumberBuffers > 0)
       m_QueueSize = std::min(m_NumberBuffers, renderbuffers);
 
+    // a depth configured for this renderer overrides the player, the renderer still sets the limit
+    const std::map<std::string, int> &depths = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_videoRenderQueueDepth;
+    auto depth = depths.find(m_rendererId);
+    if (depth != depths.end())
+    {
+      m_QueueSize = std::min(depth->second, renderbuffers);
+      CLog::Log(LOGDEBUG, "CRenderManager::Configure - queue depth %d of renderer %s, requested %d, renderer max %d",
+                m_QueueSize, m_rendererId.c_str(), depth->second, renderbuffers);
+    }
+    m_QueueMax = renderbuffers;
+
     if(m_QueueSize < 2)
     {
       m_QueueSize = 2;
@@ -228,6 +241,9 @@ bool CRenderManager::Configure()
     m_clockSync.Reset();
     m_dvdClock.SetVsyncAdjust(0);
     m_overlays.SetStereoMode(m_stereomode);
+    m_framePacing = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_videoFramePacing;
+    m_framePacer = CFramePacer();
+    m_pacingVblank = -1;
 
     m_renderState = STATE_CONFIGURED;
 
@@ -377,6 +393,7 @@ void CRenderManager::PreInit()
   m_QueueSkip   = 0;
   m_presentstep = PRESENT_IDLE;
   m_bRenderGUI = true;
+  m_frameTiming.Reset();
 
   m_initEvent.Set();
 }
@@ -395,6 +412,9 @@ void CRenderManager::UnInit()
 
   CSingleLock lock(m_statelock);
 
+  if (CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_videoFrameTimingDump)
+    DumpFrameTiming("special://temp/kodi-frametiming.csv");
+
   m_overlays.Flush();
   m_debugRenderer.Flush();
 
@@ -440,6 +460,7 @@ bool CRenderManager::Flush(bool wait, bool saveBuffers)
         for (int i = 1; i < m_QueueSize; i++)
           m_free.push_back(i);
       }
+      m_framePacer.Reset();
 
       m_flushEvent.Set();
     }
@@ -479,10 +500,12 @@ void CRenderManager::CreateRenderer()
       m_pRenderer = VIDEOPLAYER::CRendererFactory::CreateRenderer(id, buffer);
       if (m_pRenderer)
       {
+        m_rendererId = id;
         return;
       }
     }
     m_pRenderer = VIDEOPLAYER::CRendererFactory::CreateRenderer("default", buffer);
+    m_rendererId = "default";
   }
 }
 
@@ -500,12 +523,42 @@ void CRenderManager::DeleteRenderer()
 unsigned int CRenderManager::AllocRenderCapture()
 {
   CRenderCapture *capture = new CRenderCapture;
-  m_captures[m_nextCaptureId] = capture;
+  unsigned int captureId = NextCaptureId();
+  m_captures[captureId] = capture;
+  return captureId;
+}
+
+unsigned int CRenderManager::AllocRenderCaptureStream(ICaptureStreamCallback *callback, unsigned int width, unsigned int height,
+                                                      unsigned int interval, const std::string &format)
+{
+  CSingleLock lock(m_captCritSect);
+
+  CRenderCapture *capture = new CRenderCapture;
+  capture->SetState(CAPTURESTATE_NEEDSRENDER);
+  capture->SetUserState(CAPTURESTATE_WORKING);
+  capture->SetWidth(width);
+  capture->SetHeight(height);
+  capture->SetFlags(CAPTUREFLAG_CONTINUOUS);
+
+  unsigned int captureId = NextCaptureId();
+  m_captureEncoder.AddStream(captureId, callback, interval, format);
+  m_captures[captureId] = capture;
+  m_hasCaptures = true;
+  return captureId;
+}
+
+unsigned int CRenderManager::NextCaptureId()
+{
+  if (m_nextCaptureId == 0)
+    m_nextCaptureId++;
   return m_nextCaptureId++;
 }
 
 void CRenderManager::ReleaseRenderCapture(unsigned int captureId)
 {
+  // wait for frames being encoded without blocking the render thread
+  m_captureEncoder.RemoveStream(captureId);
+
   CSingleLock lock(m_captCritSect);
 
   std::map<unsigned int, CRenderCapture*>::iterator it;
@@ -606,12 +659,25 @@ void CRenderManager::ManageCaptures()
       continue;
     }
 
+    bool stream = m_captureEncoder.HasStream(it->first);
+
     if (capture->GetState() == CAPTURESTATE_NEEDSRENDER)
-      RenderCapture(capture);
+    {
+      if (!stream || m_captureEncoder.StartCapture(it->first))
+        RenderCapture(capture);
+    }
     else if (capture->GetState() == CAPTURESTATE_NEEDSREADOUT)
       capture->ReadOut();
 
-    if (capture->GetState() == CAPTURESTATE_DONE || capture->GetState() == CAPTURESTATE_FAILED)
+    if (stream && (capture->GetState() == CAPTURESTATE_DONE || capture->GetState() == CAPTURESTATE_FAILED))
+    {
+      //hand the pixels to the encoder and wait for the next interval
+      if (capture->GetState() == CAPTURESTATE_DONE)
+        m_captureEncoder.Submit(it->first, capture->GetPixels(), capture->GetWidth(), capture->GetHeight());
+      capture->SetState(CAPTURESTATE_NEEDSRENDER);
+      ++it;
+    }
+    else if (capture->GetState() == CAPTURESTATE_DONE || capture->GetState() == CAPTURESTATE_FAILED)
     {
       //tell the thread that the capture is done or has failed
       capture->SetUserState(capture->GetState());
@@ -645,6 +711,8 @@ void CRenderManager::RenderCapture(CRenderCapture* capture)
 
 void CRenderManager::RemoveCaptures()
 {
+  m_captureEncoder.RemoveStreams();
+
   CSingleLock lock(m_captCritSect);
 
   while (m_captureWaitCounter > 0)
@@ -702,6 +770,7 @@ void CRenderManager::Render(bool clear, DWORD flags, DWORD alpha, bool gui)
   if (!gui || m_pRenderer->IsGuiLayer())
   {
     SPresent& m = m_Queue[m_presentsource];
+    int64_t start = CurrentHostCounter();
 
     if( m.presentmethod == PRESENT_METHOD_BOB )
       PresentFields(clear, flags, alpha);
@@ -709,6 +778,9 @@ void CRenderManager::Render(bool clear, DWORD flags, DWORD alpha, bool gui)
       PresentBlend(clear, flags, alpha);
     else
       PresentSingle(clear, flags, alpha);
+
+    double renderTime = (CurrentHostCounter() - start) * 1000.0 / CurrentHostFrequency();
+    m_renderTime += (renderTime - m_renderTime) * 0.1;
   }
 
   if (gui)
@@ -738,8 +810,25 @@ void CRenderManager::Render(bool clear, DWORD flags, DWORD alpha, bool gui)
                                      missedvblanks,
                                      clockspeed * 100);
       }
+      vsync += StringUtils::Format("  render: %.2f ms  subtitle upload: %.1f kB/s", m_renderTime,
+                                   OVERLAY::CRenderer::GetUploadRate() / 1024.0);
+
+      std::string timing;
+      {
+        CSingleLock lock(m_presentlock);
+        timing = StringUtils::Format("Queue: %d/%d(%d) skipped:%d  ", static_cast<int>(m_queued.size()), m_QueueSize, m_QueueMax, m_QueueSkip);
+      }
+      timing += m_frameTiming.GetSummary();
+      if (m_framePacing)
+      {
+        CSingleLock lock(m_presentlock);
+        timing += StringUtils::Format("  cadence: %s%s errors/min: %d",
+                                      m_framePacer.GetPatternString().c_str(),
+                                      m_framePacer.IsLocked() ? " locked" : "",
+                                      m_framePacer.GetErrorsPerMinute(m_pacingVblank));
+      }
 
-      m_debugRenderer.SetInfo(audio, video, player, vsync);
+      m_debugRenderer.SetInfo(audio, video, player, vsync, timing);
       m_debugRenderer.Render(src, dst, view);
 
       m_debugTimer.Set(1000);
@@ -754,6 +843,7 @@ void CRenderManager::Render(bool clear, DWORD flags, DWORD alpha, bool gui)
 
     if (m_presentstep == PRESENT_FRAME)
     {
+      m_frameTiming.Flipped(m.timingId);
       if (m.presentmethod == PRESENT_METHOD_BOB)
         m_presentstep = PRESENT_FRAME2;
       else
@@ -900,7 +990,12 @@ void CRenderManager::ToggleDebug()
   m_debugTimer.SetExpired();
 }
 
-bool CRenderManager::AddVideoPicture(const VideoPicture& picture, volatile std::atomic_bool& bStop, EINTERLACEMETHOD deintMethod, bool wait)
+bool CRenderManager::DumpFrameTiming(const std::string &path)
+{
+  return m_frameTiming.WriteCSV(path);
+}
+
+bool CRenderManager::AddVideoPicture(const VideoPicture& picture, volatile std::atomic_bool& bStop, EINTERLACEMETHOD deintMethod, bool wait, int64_t decodeTime)
 {
   CSingleLock lock(m_presentlock);
 
@@ -962,6 +1057,7 @@ bool CRenderManager::AddVideoPicture(const VideoPicture& picture, volatile std::
   m.presentfield = displayField;
   m.presentmethod = presentmethod;
   m.pts = picture.pts;
+  m.timingId = m_frameTiming.Queued(picture.pts, decodeTime);
   m_queued.push_back(m_free.front());
   m_free.pop_front();
   m_playerPort->UpdateRenderBuffers(m_queued.size(), m_discard.size(), m_free.size());
@@ -1090,6 +1186,23 @@ void CRenderManager::PrepareNextRender()
   double frameOnScreen = m_dvdClock.GetClock();
   double frametime = 1.0 / CServiceBroker::GetWinSystem()->GetGfxContext().GetFPS() * DVD_TIME_BASE;
 
+  // with pacing the decision is made for the vblank the next flip lands on
+  // instead of the time this happens to run
+  int64_t vblank = -1;
+  double vblankClock, interval;
+  bool pacing = m_framePacing && m_fps > 0.0f &&
+                m_dvdClock.GetClockSpeed() > 0 &&
+                m_dvdClock.GetNextVblank(vblank, vblankClock, interval);
+  if (pacing)
+  {
+    frameOnScreen = vblankClock;
+    frametime = interval;
+    m_pacingVblank = vblank;
+    if (m_framePacer.SetRates(DVD_TIME_BASE / m_fps, interval))
+      CLog::Log(LOGDEBUG, "CRenderManager::PrepareNextRender - cadence %s for %.3f fps",
+                m_framePacer.GetPatternString().c_str(), m_fps);
+  }
+
   m_displayLatency = DVD_MSEC_TO_TIME(m_latencyTweak + CServiceBroker::GetWinSystem()->GetGfxContext().GetDisplayLatency() - m_videoDelay - CServiceBroker::GetWinSystem()->GetFrameLatencyAdjustment());
 
   double renderPts = frameOnScreen + m_displayLatency;
@@ -1098,7 +1211,8 @@ void CRenderManager::PrepareNextRender()
   if (m_dvdClock.GetClockSpeed() < 0)
     nextFramePts = renderPts;
 
-  if (m_clockSync.m_enabled)
+  // the pacer aligns frames to vblanks itself
+  if (m_clockSync.m_enabled && !pacing)
   {
     double err = fmod(renderPts - nextFramePts, frametime);
     m_clockSync.m_error += err;
@@ -1129,7 +1243,11 @@ void CRenderManager::PrepareNextRender()
     combined = true;
   }
 
-  if (renderPts >= nextFramePts || m_forceNext)
+  bool due = renderPts >= nextFramePts;
+  if (pacing)
+    due = m_framePacer.IsDue(vblank, renderPts, nextFramePts);
+
+  if (due || m_forceNext)
   {
     // see if any future queued frames are already due
     auto iter = m_queued.begin();
@@ -1157,6 +1275,7 @@ void CRenderManager::PrepareNextRender()
         m_QueueSkip++;
       }
       m_presentsourcePast = m_queued.front();
+      m_frameTiming.Skipped(m_Queue[m_presentsourcePast].timingId);
       m_queued.pop_front();
     }
 
@@ -1170,18 +1289,22 @@ void CRenderManager::PrepareNextRender()
     m_discard.push_back(m_presentsource);
     m_presentsource = idx;
     m_queued.pop_front();
+    m_frameTiming.Presented(m_Queue[idx].timingId);
+    if (pacing)
+      m_framePacer.FrameShown(vblank);
     m_presentpts = m_Queue[idx].pts - m_displayLatency;
     m_presentevent.notifyAll();
 
     m_playerPort->UpdateRenderBuffers(m_queued.size(), m_discard.size(), m_free.size());
   }
-  else if (!combined && renderPts > (nextFramePts - frametime))
+  else if (!combined && !pacing && renderPts > (nextFramePts - frametime))
   {
     m_lateframes = 0;
     m_presentstep = PRESENT_FLIP;
     m_presentsourcePast = m_presentsource;
     m_presentsource = m_queued.front();
     m_queued.pop_front();
+    m_frameTiming.Presented(m_Queue[m_presentsource].timingId);
     m_presentpts = m_Queue[m_presentsource].pts - m_displayLatency - frametime / 2;
     m_presentevent.notifyAll();
   }
@@ -1199,6 +1322,7 @@ void CRenderManager::DiscardBuffer()
 
   if(m_presentstep == PRESENT_READY)
     m_presentstep = PRESENT_IDLE;
+  m_framePacer.Reset();
   m_presentevent.notifyAll();
 }
 
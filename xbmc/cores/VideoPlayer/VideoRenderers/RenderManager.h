@@ -16,7 +16,10 @@
 #include "windowing/Resolution.h"
 #include "threads/CriticalSection.h"
 #include "cores/VideoSettings.h"
+#include "CaptureEncoder.h"
 #include "DebugRenderer.h"
+#include "FramePacer.h"
+#include "FrameTiming.h"
 #include <deque>
 #include <map>
 #include <atomic>
@@ -78,6 +81,14 @@ public:
   void StartRenderCapture(unsigned int captureId, unsigned int width, unsigned int height, int flags);
   bool RenderCaptureGetPixels(unsigned int captureId, unsigned int millis, uint8_t *buffer, unsigned int size);
 
+  /**
+   * Captures the video to callback at most every interval ms, without blocking
+   * the render thread. Encoding to format runs on job workers, captures are
+   * dropped while the workers are busy. Stopped by ReleaseRenderCapture.
+   */
+  unsigned int AllocRenderCaptureStream(ICaptureStreamCallback *callback, unsigned int width, unsigned int height,
+                                        unsigned int interval, const std::string &format);
+
   // Functions called from GUI
   bool Supports(ERENDERFEATURE feature);
   bool Supports(ESCALINGMETHOD method);
@@ -85,7 +96,11 @@ public:
   int GetSkippedFrames()  { return m_QueueSkip; }
 
   bool Configure(const VideoPicture& picture, float fps, unsigned int orientation, int buffers = 0);
-  bool AddVideoPicture(const VideoPicture& picture, volatile std::atomic_bool& bStop, EINTERLACEMETHOD deintMethod, bool wait);
+  /**
+   * decodeTime is the host counter when the decoder returned the picture,
+   * 0 if unknown. It is only used for frame timing telemetry.
+   */
+  bool AddVideoPicture(const VideoPicture& picture, volatile std::atomic_bool& bStop, EINTERLACEMETHOD deintMethod, bool wait, int64_t decodeTime = 0);
   void AddOverlay(CDVDOverlay* o, double pts);
   void ShowVideo(bool enable);
 
@@ -113,6 +128,11 @@ public:
 
   void SetVideoSettings(CVideoSettings settings);
 
+  /**
+   * Write the timestamps of the last frames to a csv file
+   */
+  bool DumpFrameTiming(const std::string &path);
+
 protected:
 
   void PresentSingle(bool clear, DWORD flags, DWORD alpha);
@@ -132,6 +152,7 @@ protected:
   void CheckEnableClockSync();
 
   CBaseRenderer *m_pRenderer = nullptr;
+  std::string m_rendererId; // factory id of m_pRenderer, selects the configured queue depth
   OVERLAY::CRenderer m_overlays;
   CDebugRenderer m_debugRenderer;
   mutable CCriticalSection m_statelock;
@@ -142,6 +163,7 @@ protected:
   bool m_renderedOverlay = false;
   bool m_renderDebug = false;
   XbmcThreads::EndTime m_debugTimer;
+  double m_renderTime = 0.0; // smoothed time of the render thread for a frame in ms
   std::atomic_bool m_showVideo = {false};
 
   enum EPRESENTSTEP
@@ -178,12 +200,21 @@ protected:
 
   int m_QueueSize = 2;
   int m_QueueSkip = 0;
+  int m_QueueMax = 2; // buffers the renderer can hold
+
+  CFrameTiming m_frameTiming;
+
+  /// Pick refresh slots from the vblanks predicted by the video reference clock
+  bool m_framePacing = false;
+  CFramePacer m_framePacer;
+  int64_t m_pacingVblank = -1;
 
   struct SPresent
   {
     double         pts;
     EFIELDSYNC     presentfield;
     EPRESENTMETHOD presentmethod;
+    uint64_t       timingId = 0;
   } m_Queue[NUM_BUFFERS];
 
   std::deque<int> m_free;
@@ -225,6 +256,7 @@ protected:
 
   void RenderCapture(CRenderCapture* capture);
   void RemoveCaptures();
+  unsigned int NextCaptureId();
   CCriticalSection m_captCritSect;
   std::map<unsigned int, CRenderCapture*> m_captures;
   static unsigned int m_nextCaptureId;
@@ -232,4 +264,5 @@ protected:
   //set to true when adding something to m_captures, set to false when m_captures is made empty
   //std::list::empty() isn't thread safe, using an extra bool will save a lock per render when no captures are requested
   bool m_hasCaptures = false;
+  CCaptureEncoder m_captureEncoder;
 };
@@ -0,0 +1,256 @@
+/*
+ *  Copyright (C) 2019 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "SeparableScaler.h"
+#include "VideoShaders/ConvolutionKernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SCALER_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+// taps sum up to 1 << WEIGHT_BITS, the horizontal pass keeps BUFFER_BITS
+// fractional bits of the pixels for the vertical one
+const int WEIGHT_BITS = 14;
+const int BUFFER_BITS = 6;
+const int HORIZONTAL_SHIFT = WEIGHT_BITS - BUFFER_BITS;
+const int VERTICAL_SHIFT = WEIGHT_BITS + BUFFER_BITS;
+
+inline uint8_t Clamp(int value)
+{
+  return static_cast<uint8_t>(std::min(std::max(value, 0), 255));
+}
+
+void HorizontalScalar(const uint8_t *src, int16_t *dst, int channels, int dstWidth,
+                      const int *start, const int16_t *weights, int taps)
+{
+  for (int x = 0; x < dstWidth; x++)
+  {
+    const uint8_t *pixel = src + start[x] * channels;
+    const int16_t *weight = weights + x * taps;
+    for (int c = 0; c < channels; c++)
+    {
+      int sum = 0;
+      for (int j = 0; j < taps; j++)
+        sum += pixel[j * channels + c] * weight[j];
+      dst[x * channels + c] = static_cast<int16_t>((sum + (1 << (HORIZONTAL_SHIFT - 1))) >> HORIZONTAL_SHIFT);
+    }
+  }
+}
+
+void VerticalScalar(const int16_t* const *rows, uint8_t *dst, int start, int count,
+                    const int16_t *weights, int taps)
+{
+  for (int x = start; x < count; x++)
+  {
+    int sum = 0;
+    for (int j = 0; j < taps; j++)
+      sum += rows[j][x] * weights[j];
+    dst[x] = Clamp((sum + (1 << (VERTICAL_SHIFT - 1))) >> VERTICAL_SHIFT);
+  }
+}
+
+#if defined(SCALER_SSE2)
+inline __m128i WeightPair(int16_t a, int16_t b)
+{
+  return _mm_set1_epi32(static_cast<int>((static_cast<uint32_t>(static_cast<uint16_t>(b)) << 16) |
+                                         static_cast<uint16_t>(a)));
+}
+
+// 4 channels: two neighbouring pixels are interleaved by channel, so one
+// madd applies two taps to all channels
+void HorizontalSSE2(const uint8_t *src, int16_t *dst, int channels, int dstWidth,
+                    const int *start, const int16_t *weights, int taps)
+{
+  if (channels != 4)
+  {
+    HorizontalScalar(src, dst, channels, dstWidth, start, weights, taps);
+    return;
+  }
+
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i round = _mm_set1_epi32(1 << (HORIZONTAL_SHIFT - 1));
+  for (int x = 0; x < dstWidth; x++)
+  {
+    const uint8_t *pixel = src + start[x] * 4;
+    const int16_t *weight = weights + x * taps;
+    __m128i sum = zero;
+    int j = 0;
+    for (; j + 2 <= taps; j += 2)
+    {
+      __m128i two = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(pixel + j * 4)), zero);
+      two = _mm_unpacklo_epi16(two, _mm_srli_si128(two, 8));
+      sum = _mm_add_epi32(sum, _mm_madd_epi16(two, WeightPair(weight[j], weight[j + 1])));
+    }
+    if (j < taps)
+    {
+      int32_t last;
+      std::memcpy(&last, pixel + j * 4, 4);
+      __m128i one = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(last), zero), zero);
+      sum = _mm_add_epi32(sum, _mm_madd_epi16(one, WeightPair(weight[j], 0)));
+    }
+    sum = _mm_srai_epi32(_mm_add_epi32(sum, round), HORIZONTAL_SHIFT);
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + x * 4), _mm_packs_epi32(sum, sum));
+  }
+}
+
+// rows are interleaved in pairs, 8 values per iteration
+void VerticalSSE2(const int16_t* const *rows, uint8_t *dst, int start, int count,
+                  const int16_t *weights, int taps)
+{
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i round = _mm_set1_epi32(1 << (VERTICAL_SHIFT - 1));
+  int x = start;
+  for (; x + 8 <= count; x += 8)
+  {
+    __m128i low = zero;
+    __m128i high = zero;
+    int j = 0;
+    for (; j + 2 <= taps; j += 2)
+    {
+      const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows[j] + x));
+      const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows[j + 1] + x));
+      const __m128i weight = WeightPair(weights[j], weights[j + 1]);
+      low = _mm_add_epi32(low, _mm_madd_epi16(_mm_unpacklo_epi16(a, b), weight));
+      high = _mm_add_epi32(high, _mm_madd_epi16(_mm_unpackhi_epi16(a, b), weight));
+    }
+    if (j < taps)
+    {
+      const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows[j] + x));
+      const __m128i weight = WeightPair(weights[j], 0);
+      low = _mm_add_epi32(low, _mm_madd_epi16(_mm_unpacklo_epi16(a, zero), weight));
+      high = _mm_add_epi32(high, _mm_madd_epi16(_mm_unpackhi_epi16(a, zero), weight));
+    }
+    low = _mm_srai_epi32(_mm_add_epi32(low, round), VERTICAL_SHIFT);
+    high = _mm_srai_epi32(_mm_add_epi32(high, round), VERTICAL_SHIFT);
+    const __m128i words = _mm_packs_epi32(low, high);
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + x), _mm_packus_epi16(words, words));
+  }
+  VerticalScalar(rows, dst, x, count, weights, taps);
+}
+#endif
+}
+
+bool CSeparableScaler::IsSupported(Impl impl)
+{
+  switch (impl)
+  {
+    case IMPL_SCALAR:
+      return true;
+#if defined(SCALER_SSE2)
+    case IMPL_SSE2:
+      return true;
+#endif
+    default:
+      return false;
+  }
+}
+
+CSeparableScaler::CSeparableScaler(ESCALINGMETHOD method, unsigned int channels)
+  : m_method(method),
+    m_channels(channels),
+    m_impl(IsSupported(IMPL_SSE2) ? IMPL_SSE2 : IMPL_SCALAR)
+{
+}
+
+void CSeparableScaler::BuildFilter(Filter &filter, int srcSize, int dstSize) const
+{
+  if (filter.srcSize == srcSize && filter.dstSize == dstSize)
+    return;
+
+  // when downscaling the kernel covers all source pixels of an output pixel
+  double scale = static_cast<double>(srcSize) / dstSize;
+  double stretch = std::max(scale, 1.0);
+  double support = CConvolutionKernel::Radius(m_method) * stretch;
+  int taps = static_cast<int>(std::floor(support * 2.0)) + 1;
+  int used = std::min(taps, srcSize);
+
+  filter.srcSize = srcSize;
+  filter.dstSize = dstSize;
+  filter.taps = used;
+  filter.start.resize(dstSize);
+  filter.weights.assign(dstSize * used, 0);
+
+  std::vector<double> weights(used);
+  for (int i = 0; i < dstSize; i++)
+  {
+    double center = (i + 0.5) * scale - 0.5;
+    int first = static_cast<int>(std::ceil(center - support));
+
+    // taps beyond the edges are added to the edge pixels
+    int start = std::min(std::max(first, 0), srcSize - used);
+    std::fill(weights.begin(), weights.end(), 0.0);
+    double total = 0.0;
+    for (int k = first; k < first + taps; k++)
+    {
+      double weight = CConvolutionKernel::Weight(m_method, (k - center) / stretch);
+      weights[std::min(std::max(k, 0), srcSize - 1) - start] += weight;
+      total += weight;
+    }
+
+    // fixed point, rounding errors go to the largest tap
+    int16_t *fixed = filter.weights.data() + i * used;
+    int sum = 0;
+    int largest = 0;
+    for (int j = 0; j < used; j++)
+    {
+      fixed[j] = static_cast<int16_t>(std::lround(weights[j] / total * (1 << WEIGHT_BITS)));
+      sum += fixed[j];
+      if (fixed[j] > fixed[largest])
+        largest = j;
+    }
+    fixed[largest] += (1 << WEIGHT_BITS) - sum;
+    filter.start[i] = start;
+  }
+}
+
+void CSeparableScaler::Scale(const uint8_t *src, int srcStride, int srcWidth, int srcHeight,
+                             uint8_t *dst, int dstStride, int dstWidth, int dstHeight)
+{
+  if (srcWidth <= 0 || srcHeight <= 0 || dstWidth <= 0 || dstHeight <= 0)
+    return;
+
+  BuildFilter(m_horizontal, srcWidth, dstWidth);
+  BuildFilter(m_vertical, srcHeight, dstHeight);
+
+  auto horizontal = HorizontalScalar;
+  auto vertical = VerticalScalar;
+#if defined(SCALER_SSE2)
+  if (m_impl == IMPL_SSE2)
+  {
+    horizontal = HorizontalSSE2;
+    vertical = VerticalSSE2;
+  }
+#endif
+
+  int channels = static_cast<int>(m_channels);
+  int count = dstWidth * channels;
+  m_buffer.resize(static_cast<size_t>(count) * srcHeight);
+
+  // only the source rows the vertical taps reach
+  int firstRow = m_vertical.start.front();
+  int lastRow = m_vertical.start.back() + m_vertical.taps;
+  for (int y = firstRow; y < lastRow; y++)
+    horizontal(src + y * srcStride, m_buffer.data() + y * count, channels, dstWidth,
+               m_horizontal.start.data(), m_horizontal.weights.data(), m_horizontal.taps);
+
+  std::vector<const int16_t*> rows(m_vertical.taps);
+  for (int y = 0; y < dstHeight; y++)
+  {
+    for (int j = 0; j < m_vertical.taps; j++)
+      rows[j] = m_buffer.data() + (m_vertical.start[y] + j) * count;
+    vertical(rows.data(), dst + y * dstStride, 0, count,
+             m_vertical.weights.data() + y * m_vertical.taps, m_vertical.taps);
+  }
+}
@@ -0,0 +1,66 @@
+/*
+ *  Copyright (C) 2019 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "cores/VideoSettings.h"
+
+#include <stdint.h>
+#include <vector>
+
+/*!
+ * \brief Scales 8 bit planes on the cpu with the kernels of the gl scalers
+ *
+ * The image is filtered horizontally into a 16 bit buffer, then vertically.
+ * When downscaling the kernel is stretched over the source pixels covered by
+ * an output pixel, so lanczos or spline36 thumbnails don't alias like fast
+ * bilinear does. Pixels have 1 channel (planes of yuv) or 4 (BGRA as used by
+ * render capture and the texture cache). Filter taps are kept as long as the
+ * sizes don't change, an instance is not thread safe.
+ */
+class CSeparableScaler
+{
+public:
+  enum Impl
+  {
+    IMPL_SCALAR,
+    IMPL_SSE2,
+    IMPL_MAX
+  };
+
+  /*!
+   * \brief Whether the build supports impl, all give identical results
+   */
+  static bool IsSupported(Impl impl);
+
+  CSeparableScaler(ESCALINGMETHOD method, unsigned int channels);
+
+  void SetImpl(Impl impl) { m_impl = impl; }
+
+  void Scale(const uint8_t *src, int srcStride, int srcWidth, int srcHeight,
+             uint8_t *dst, int dstStride, int dstWidth, int dstHeight);
+
+private:
+  struct Filter
+  {
+    int srcSize = 0;
+    int dstSize = 0;
+    int taps = 0;
+    std::vector<int> start;        // first source pixel of each output pixel
+    std::vector<int16_t> weights;  // taps per output pixel, they sum up to 1 << 14
+  };
+
+  void BuildFilter(Filter &filter, int srcSize, int dstSize) const;
+
+  ESCALINGMETHOD m_method;
+  unsigned int m_channels;
+  Impl m_impl;
+  Filter m_horizontal;
+  Filter m_vertical;
+  std::vector<int16_t> m_buffer;
+};
@@ -11,8 +11,14 @@
 #endif
 
 #include "ConvolutionKernels.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
 #include "utils/MathUtils.h"
 
+#include <algorithm>
+#include <map>
+#include <utility>
+
 #ifndef M_PI
   #define M_PI       3.14159265358979323846
 #endif
@@ -48,6 +54,59 @@ CConvolutionKernel::~CConvolutionKernel()
   delete [] m_uint8pixels;
 }
 
+//shaders are recreated on every resolution and scaling method change,
+//the kernels they load only depend on method and size
+std::shared_ptr<const CConvolutionKernel> CConvolutionKernel::Get(ESCALINGMETHOD method, int size)
+{
+  static CCriticalSection lock;
+  static std::map<std::pair<ESCALINGMETHOD, int>, std::shared_ptr<const CConvolutionKernel>> kernels;
+
+  CSingleLock cacheLock(lock);
+  std::shared_ptr<const CConvolutionKernel>& kernel = kernels[std::make_pair(method, size)];
+  if (!kernel)
+    kernel = std::make_shared<CConvolutionKernel>(method, size);
+  return kernel;
+}
+
+double CConvolutionKernel::Weight(ESCALINGMETHOD method, double x)
+{
+  switch (method)
+  {
+    case VS_SCALINGMETHOD_NEAREST:
+      return fabs(x) < 0.5 ? 1.0 : 0.0;
+    case VS_SCALINGMETHOD_LINEAR:
+      return std::max(1.0 - fabs(x), 0.0);
+    case VS_SCALINGMETHOD_LANCZOS2:
+      return LanczosWeight(x, 2.0);
+    case VS_SCALINGMETHOD_LANCZOS3_FAST:
+    case VS_SCALINGMETHOD_LANCZOS3:
+      return LanczosWeight(x, 3.0);
+    case VS_SCALINGMETHOD_SPLINE36_FAST:
+    case VS_SCALINGMETHOD_SPLINE36:
+      return Spline36Weight(x);
+    default:
+      return BicubicWeight(x, 1.0 / 3.0, 1.0 / 3.0);
+  }
+}
+
+double CConvolutionKernel::Radius(ESCALINGMETHOD method)
+{
+  switch (method)
+  {
+    case VS_SCALINGMETHOD_NEAREST:
+      return 0.5;
+    case VS_SCALINGMETHOD_LINEAR:
+      return 1.0;
+    case VS_SCALINGMETHOD_LANCZOS3_FAST:
+    case VS_SCALINGMETHOD_LANCZOS3:
+    case VS_SCALINGMETHOD_SPLINE36_FAST:
+    case VS_SCALINGMETHOD_SPLINE36:
+      return 3.0;
+    default:
+      return 2.0;
+  }
+}
+
 //generate a lanczos2 kernel which can be loaded with RGBA format
 //each value of RGBA has one tap, so a shader can load 4 taps with a single pixel lookup
 void CConvolutionKernel::Lanczos2()
@@ -10,6 +10,7 @@
 
 #include "cores/VideoSettings.h"
 
+#include <memory>
 #include <stdint.h>
 
 class CConvolutionKernel
@@ -18,10 +19,26 @@ class CConvolutionKernel
     CConvolutionKernel(ESCALINGMETHOD method, int size);
     ~CConvolutionKernel();
 
-    int      GetSize()           { return m_size; }
-    float*   GetFloatPixels()    { return m_floatpixels; }
-    uint8_t* GetIntFractPixels() { return m_intfractpixels; }
-    uint8_t* GetUint8Pixels()    { return m_uint8pixels; }
+    /*!
+     \brief Kernel of method and size from a cache shared by all renderers,
+     it is built on first use and never changes after
+     */
+    static std::shared_ptr<const CConvolutionKernel> Get(ESCALINGMETHOD method, int size);
+
+    /*!
+     \brief Unnormalized weight of the kernel function of method at distance x
+     from the sample, for scalers that build their own taps
+     */
+    static double Weight(ESCALINGMETHOD method, double x);
+    /*!
+     \brief Distance beyond which the weight of method is 0
+     */
+    static double Radius(ESCALINGMETHOD method);
+
+    int            GetSize() const           { return m_size; }
+    const float*   GetFloatPixels() const    { return m_floatpixels; }
+    const uint8_t* GetIntFractPixels() const { return m_intfractpixels; }
+    const uint8_t* GetUint8Pixels() const    { return m_uint8pixels; }
 
   private:
     CConvolutionKernel(const CConvolutionKernel&) = delete;
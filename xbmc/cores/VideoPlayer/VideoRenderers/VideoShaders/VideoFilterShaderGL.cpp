@@ -124,7 +124,7 @@ void ConvolutionFilterShader::OnCompiledAndLinked()
   m_hVertex = glGetAttribLocation(ProgramHandle(), "m_attrpos");
   m_hCoord = glGetAttribLocation(ProgramHandle(), "m_attrcord");
 
-  CConvolutionKernel kernel(m_method, 256);
+  std::shared_ptr<const CConvolutionKernel> kernel = CConvolutionKernel::Get(m_method, 256);
 
   if (m_kernelTex1)
   {
@@ -156,15 +156,15 @@ void ConvolutionFilterShader::OnCompiledAndLinked()
   if (m_floattex)
   {
     format = GL_FLOAT;
-    data   = (GLvoid*)kernel.GetFloatPixels();
+    data   = (GLvoid*)kernel->GetFloatPixels();
   }
   else
   {
     format = GL_UNSIGNED_BYTE;
-    data   = (GLvoid*)kernel.GetUint8Pixels();
+    data   = (GLvoid*)kernel->GetUint8Pixels();
   }
 
-  glTexImage1D(TEXTARGET, 0, m_internalformat, kernel.GetSize(), 0, GL_RGBA, format, data);
+  glTexImage1D(TEXTARGET, 0, m_internalformat, kernel->GetSize(), 0, GL_RGBA, format, data);
 
   glActiveTexture(GL_TEXTURE0);
 
@@ -125,7 +125,7 @@ void ConvolutionFilterShader::OnCompiledAndLinked()
   m_hStepXY    = glGetUniformLocation(ProgramHandle(), "stepxy");
   m_hKernTex   = glGetUniformLocation(ProgramHandle(), "kernelTex");
 
-  CConvolutionKernel kernel(m_method, 256);
+  std::shared_ptr<const CConvolutionKernel> kernel = CConvolutionKernel::Get(m_method, 256);
 
   if (m_kernelTex1)
   {
@@ -156,16 +156,16 @@ void ConvolutionFilterShader::OnCompiledAndLinked()
   if (m_floattex)
   {
     format = GL_FLOAT;
-    data   = (GLvoid*)kernel.GetFloatPixels();
+    data   = (GLvoid*)kernel->GetFloatPixels();
   }
   else
   {
     format = GL_UNSIGNED_BYTE;
-    data   = (GLvoid*)kernel.GetUint8Pixels();
+    data   = (GLvoid*)kernel->GetUint8Pixels();
   }
 
   //upload as 2D texture with height of 1
-  glTexImage2D(GL_TEXTURE_2D, 0, m_internalformat, kernel.GetSize(), 1, 0, GL_RGBA, format, data);
+  glTexImage2D(GL_TEXTURE_2D, 0, m_internalformat, kernel->GetSize(), 1, 0, GL_RGBA, format, data);
 
   glActiveTexture(GL_TEXTURE0);
 
@@ -698,27 +698,27 @@ bool CConvolutionShader::ChooseKernelD3DFormat()
 
 bool CConvolutionShader::CreateHQKernel(ESCALINGMETHOD method)
 {
-  CConvolutionKernel kern(method, 256);
-  void *kernelVals;
+  std::shared_ptr<const CConvolutionKernel> kern = CConvolutionKernel::Get(method, 256);
+  const void *kernelVals;
   int kernelValsSize;
 
   if (m_floattex)
   {
-    float *rawVals = kern.GetFloatPixels();
-    HALF* float16Vals = new HALF[kern.GetSize() * 4];
+    const float *rawVals = kern->GetFloatPixels();
+    HALF* float16Vals = new HALF[kern->GetSize() * 4];
 
-    XMConvertFloatToHalfStream(float16Vals, sizeof(HALF), rawVals, sizeof(float), kern.GetSize()*4);
+    XMConvertFloatToHalfStream(float16Vals, sizeof(HALF), rawVals, sizeof(float), kern->GetSize()*4);
 
     kernelVals = float16Vals;
-    kernelValsSize = sizeof(HALF)*kern.GetSize() * 4;
+    kernelValsSize = sizeof(HALF)*kern->GetSize() * 4;
   }
   else
   {
-    kernelVals = kern.GetUint8Pixels();
-    kernelValsSize = sizeof(uint8_t)*kern.GetSize() * 4;
+    kernelVals = kern->GetUint8Pixels();
+    kernelValsSize = sizeof(uint8_t)*kern->GetSize() * 4;
   }
 
-  if (!m_HQKernelTexture.Create(kern.GetSize(), 1, 1, D3D11_USAGE_IMMUTABLE, m_KernelFormat, kernelVals, kernelValsSize))
+  if (!m_HQKernelTexture.Create(kern->GetSize(), 1, 1, D3D11_USAGE_IMMUTABLE, m_KernelFormat, kernelVals, kernelValsSize))
   {
     CLog::LogF(LOGERROR, "Failed to create kernel texture.");
     return false;
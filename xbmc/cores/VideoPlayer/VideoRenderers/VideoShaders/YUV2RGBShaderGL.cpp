@@ -272,7 +272,7 @@ void YUV2RGBFilterShader4::OnCompiledAndLinked()
     m_scaling = VS_SCALINGMETHOD_LANCZOS3_FAST;
   }
 
-  CConvolutionKernel kernel(m_scaling, 256);
+  std::shared_ptr<const CConvolutionKernel> kernel = CConvolutionKernel::Get(m_scaling, 256);
 
   if (m_kernelTex)
   {
@@ -288,8 +288,8 @@ void YUV2RGBFilterShader4::OnCompiledAndLinked()
   glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
   glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 
-  GLvoid* data = (GLvoid*)kernel.GetFloatPixels();
-  glTexImage1D(GL_TEXTURE_1D, 0, GL_RGBA32F, kernel.GetSize(), 0, GL_RGBA, GL_FLOAT, data);
+  GLvoid* data = (GLvoid*)kernel->GetFloatPixels();
+  glTexImage1D(GL_TEXTURE_1D, 0, GL_RGBA32F, kernel->GetSize(), 0, GL_RGBA, GL_FLOAT, data);
   glActiveTexture(GL_TEXTURE0);
   VerifyGLState();
 }
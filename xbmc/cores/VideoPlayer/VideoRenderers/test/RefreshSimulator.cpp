@@ -0,0 +1,72 @@
+/*
+ *  Copyright (C) 2019 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "RefreshSimulator.h"
+#include "cores/VideoPlayer/Interface/Addon/TimingConstants.h"
+#include "cores/VideoPlayer/VideoRenderers/FramePacer.h"
+
+CRefreshSimulator::CRefreshSimulator(double refresh, double fps, double jitter, unsigned int seed)
+  : m_interval(DVD_TIME_BASE / refresh),
+    m_frametime(DVD_TIME_BASE / fps),
+    m_jitter(jitter),
+    m_random(seed)
+{
+}
+
+void CRefreshSimulator::Stall(int64_t vblank, int count)
+{
+  m_stallStart = vblank;
+  m_stallCount = count;
+}
+
+CRefreshSimulator::Result CRefreshSimulator::Run(double seconds, CFramePacer &pacer, bool paced)
+{
+  std::uniform_real_distribution<double> early(0.0, m_jitter);
+  Result result;
+
+  pacer.Reset();
+  pacer.SetRates(m_frametime, m_interval);
+
+  int64_t vblanks = static_cast<int64_t>(seconds * DVD_TIME_BASE / m_interval);
+  int64_t frame = 0;
+  int64_t available = 2; // frames the decoder has delivered
+  int64_t lastShown = 0;
+  pacer.FrameShown(0);
+
+  for (int64_t vblank = 1; vblank < vblanks; vblank++)
+  {
+    double vblankClock = vblank * m_interval;
+
+    // the decoder runs two frames ahead unless it stalls
+    if (vblank < m_stallStart || vblank >= m_stallStart + m_stallCount)
+      available = static_cast<int64_t>(vblankClock / m_frametime) + 2;
+
+    if (frame + 1 >= available)
+      continue;
+
+    double pts = (frame + 1) * m_frametime;
+    bool due;
+    if (paced)
+      due = pacer.IsDue(vblank, vblankClock, pts);
+    else
+      due = vblankClock - early(m_random) * m_interval >= pts;
+
+    if (!due)
+      continue;
+
+    result.shown.push_back(static_cast<int>(vblank - lastShown));
+    lastShown = vblank;
+    frame++;
+    pacer.FrameShown(vblank);
+  }
+
+  result.errors = pacer.GetCadenceErrors();
+  result.errorsPerMinute = pacer.GetErrorsPerMinute(vblanks);
+  result.locked = pacer.IsLocked();
+  return result;
+}
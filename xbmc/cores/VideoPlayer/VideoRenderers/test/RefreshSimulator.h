@@ -0,0 +1,58 @@
+/*
+ *  Copyright (C) 2019 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <random>
+#include <stdint.h>
+#include <vector>
+
+class CFramePacer;
+
+/*!
+ * \brief Plays a stream of frames on a simulated display
+ *
+ * Every refresh the render loop runs at a random point before the vblank,
+ * like the render thread of a real display, and decides whether the next
+ * frame is shown. It decides either like the render manager without pacing,
+ * on the clock sampled when it runs, or with a CFramePacer on the predicted
+ * vblank. All times are in DVD time units.
+ */
+class CRefreshSimulator
+{
+public:
+  struct Result
+  {
+    std::vector<int> shown; // refreshes each frame was on screen
+    int errors;             // cadence errors counted by the pacer
+    int errorsPerMinute;
+    bool locked;
+  };
+
+  /*!
+   * \param refresh rate of the display in Hz
+   * \param fps frame rate of the video
+   * \param jitter how far before the vblank the render loop may run, in refreshes
+   */
+  CRefreshSimulator(double refresh, double fps, double jitter, unsigned int seed = 1);
+
+  /*!
+   * \brief No new frames are available for count refreshes from vblank on
+   */
+  void Stall(int64_t vblank, int count);
+
+  Result Run(double seconds, CFramePacer &pacer, bool paced);
+
+private:
+  double m_interval;
+  double m_frametime;
+  double m_jitter;
+  std::mt19937 m_random;
+  int64_t m_stallStart = -1;
+  int m_stallCount = 0;
+};
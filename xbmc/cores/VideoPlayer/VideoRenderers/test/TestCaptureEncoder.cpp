@@ -0,0 +1,222 @@
+/*
+ *  Copyright (C) 2019 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/VideoPlayer/VideoRenderers/CaptureEncoder.h"
+#include "threads/Event.h"
+#include "threads/SingleLock.h"
+#include "threads/Thread.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace
+{
+const unsigned int WIDTH = 8;
+const unsigned int HEIGHT = 4;
+
+// blocks the job workers until released, so frames stay pending
+class CBlockingCallback : public ICaptureStreamCallback
+{
+public:
+  CBlockingCallback() : m_release(true, false) {}
+
+  void OnCaptureFrame(unsigned int captureId, const SCaptureFrame &frame) override
+  {
+    m_entered.Set();
+    m_release.Wait();
+    CSingleLock lock(m_section);
+    m_frames.push_back(frame);
+    m_received.Set();
+  }
+
+  void Release() { m_release.Set(); }
+  bool WaitEntered() { return m_entered.WaitMSec(5000); }
+
+  bool WaitFrames(size_t count)
+  {
+    while (Frames().size() < count)
+    {
+      if (!m_received.WaitMSec(5000))
+        return false;
+    }
+    return true;
+  }
+
+  std::vector<SCaptureFrame> Frames()
+  {
+    CSingleLock lock(m_section);
+    return m_frames;
+  }
+
+private:
+  CEvent m_release;
+  CEvent m_entered;
+  CEvent m_received;
+  CCriticalSection m_section;
+  std::vector<SCaptureFrame> m_frames;
+};
+
+std::vector<uint8_t> Pixels(uint8_t seed)
+{
+  std::vector<uint8_t> pixels(WIDTH * HEIGHT * 4);
+  for (size_t i = 0; i < pixels.size(); i++)
+    pixels[i] = static_cast<uint8_t>(i + seed);
+  return pixels;
+}
+
+// what the render manager does for a stream capture
+bool Capture(CCaptureEncoder &encoder, unsigned int captureId, uint8_t seed)
+{
+  if (!encoder.StartCapture(captureId))
+    return false;
+  std::vector<uint8_t> pixels = Pixels(seed);
+  encoder.Submit(captureId, pixels.data(), WIDTH, HEIGHT);
+  return true;
+}
+}
+
+TEST(TestCaptureEncoder, Interval)
+{
+  CBlockingCallback callback;
+  callback.Release();
+
+  CCaptureEncoder encoder;
+  EXPECT_FALSE(encoder.StartCapture(1));
+  encoder.AddStream(1, &callback, 60000, "");
+  EXPECT_TRUE(encoder.HasStream(1));
+
+  // the first capture is due at once, the next one after the interval
+  EXPECT_TRUE(Capture(encoder, 1, 0));
+  EXPECT_FALSE(encoder.StartCapture(1));
+
+  ASSERT_TRUE(callback.WaitFrames(1));
+  encoder.RemoveStream(1);
+  EXPECT_FALSE(encoder.HasStream(1));
+}
+
+TEST(TestCaptureEncoder, RawFrame)
+{
+  CBlockingCallback callback;
+  callback.Release();
+
+  CCaptureEncoder encoder;
+  encoder.AddStream(1, &callback, 0, "");
+  ASSERT_TRUE(Capture(encoder, 1, 5));
+  ASSERT_TRUE(callback.WaitFrames(1));
+  encoder.RemoveStream(1);
+
+  std::vector<SCaptureFrame> frames = callback.Frames();
+  ASSERT_EQ(1u, frames.size());
+  EXPECT_EQ(0u, frames[0].sequence);
+  EXPECT_EQ(WIDTH, frames[0].width);
+  EXPECT_EQ(HEIGHT, frames[0].height);
+  EXPECT_EQ(CAPTURE_FORMAT_RAW, frames[0].format);
+  EXPECT_EQ(Pixels(5), frames[0].data);
+}
+
+TEST(TestCaptureEncoder, RefuseWhileBusy)
+{
+  CBlockingCallback callback;
+
+  CCaptureEncoder encoder;
+  encoder.AddStream(1, &callback, 0, "");
+  for (int i = 0; i < CCaptureEncoder::MAX_PENDING; i++)
+    ASSERT_TRUE(Capture(encoder, 1, static_cast<uint8_t>(i)));
+
+  // all buffers are busy, nothing is rendered for the stream
+  EXPECT_FALSE(encoder.StartCapture(1));
+  EXPECT_FALSE(encoder.StartCapture(1));
+
+  callback.Release();
+  ASSERT_TRUE(callback.WaitFrames(CCaptureEncoder::MAX_PENDING));
+
+  encoder.RemoveStream(1);
+
+  std::vector<SCaptureFrame> frames = callback.Frames();
+  ASSERT_EQ(static_cast<size_t>(CCaptureEncoder::MAX_PENDING), frames.size());
+  std::vector<bool> seen(CCaptureEncoder::MAX_PENDING, false);
+  for (const SCaptureFrame &frame : frames)
+  {
+    ASSERT_LT(frame.sequence, seen.size());
+    seen[frame.sequence] = true;
+  }
+  for (bool sequence : seen)
+    EXPECT_TRUE(sequence);
+}
+
+TEST(TestCaptureEncoder, SequenceGap)
+{
+  CBlockingCallback callback;
+
+  CCaptureEncoder encoder;
+  encoder.AddStream(1, &callback, 0, "");
+  for (int i = 0; i < CCaptureEncoder::MAX_PENDING; i++)
+    ASSERT_TRUE(Capture(encoder, 1, 0));
+  EXPECT_FALSE(encoder.StartCapture(1));
+
+  callback.Release();
+  ASSERT_TRUE(callback.WaitFrames(CCaptureEncoder::MAX_PENDING));
+
+  // a buffer is free again once the callback returned
+  bool captured = false;
+  for (int i = 0; i < 500 && !captured; i++)
+  {
+    captured = Capture(encoder, 1, 0);
+    if (!captured)
+      XbmcThreads::ThreadSleep(10);
+  }
+  ASSERT_TRUE(captured);
+  ASSERT_TRUE(callback.WaitFrames(CCaptureEncoder::MAX_PENDING + 1));
+  encoder.RemoveStream(1);
+
+  uint64_t last = 0;
+  for (const SCaptureFrame &frame : callback.Frames())
+    last = std::max(last, frame.sequence);
+  // at least the capture refused above was skipped
+  EXPECT_GT(last, static_cast<uint64_t>(CCaptureEncoder::MAX_PENDING));
+}
+
+TEST(TestCaptureEncoder, RemoveWaits)
+{
+  CBlockingCallback callback;
+
+  CCaptureEncoder encoder;
+  encoder.AddStream(1, &callback, 0, "");
+  ASSERT_TRUE(Capture(encoder, 1, 0));
+  ASSERT_TRUE(Capture(encoder, 1, 1));
+  ASSERT_TRUE(callback.WaitEntered());
+
+  std::atomic<bool> removed(false);
+  CEvent started;
+  std::thread remover([&]() {
+    started.Set();
+    encoder.RemoveStream(1);
+    removed = true;
+  });
+  started.Wait();
+  XbmcThreads::ThreadSleep(50);
+  // a callback is still running
+  EXPECT_FALSE(removed);
+
+  callback.Release();
+  remover.join();
+  EXPECT_TRUE(removed);
+  EXPECT_FALSE(encoder.HasStream(1));
+
+  // nothing is captured or delivered after the stream was removed
+  size_t frames = callback.Frames().size();
+  EXPECT_FALSE(encoder.StartCapture(1));
+  std::vector<uint8_t> pixels = Pixels(0);
+  encoder.Submit(1, pixels.data(), WIDTH, HEIGHT);
+  XbmcThreads::ThreadSleep(50);
+  EXPECT_EQ(frames, callback.Frames().size());
+}
@@ -0,0 +1,84 @@
+/*
+ *  Copyright (C) 2019 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "RefreshSimulator.h"
+#include "cores/VideoPlayer/VideoRenderers/FramePacer.h"
+
+#include <algorithm>
+
+#include "gtest/gtest.h"
+
+TEST(TestFramePacer, Patterns)
+{
+  EXPECT_EQ(std::vector<int>({3, 2}), CFramePacer::FindPattern(59.94 / 23.976));
+  EXPECT_EQ(std::vector<int>({3, 2}), CFramePacer::FindPattern(60.0 / 23.976));
+  EXPECT_EQ(std::vector<int>({5}), CFramePacer::FindPattern(120.0 / 24.0));
+  EXPECT_EQ(std::vector<int>({2}), CFramePacer::FindPattern(50.0 / 25.0));
+  EXPECT_EQ(std::vector<int>({1}), CFramePacer::FindPattern(60.0 / 60.0));
+  EXPECT_EQ(std::vector<int>({3, 2, 3, 2, 2}), CFramePacer::FindPattern(60.0 / 25.0));
+  EXPECT_EQ(std::vector<int>({2, 1, 1, 1, 1}), CFramePacer::FindPattern(60.0 / 50.0));
+  EXPECT_TRUE(CFramePacer::FindPattern(30.0 / 60.0).empty());
+
+  CFramePacer pacer;
+  pacer.SetRates(1000000.0 / 23.976, 1000000.0 / 59.94);
+  EXPECT_EQ("3:2", pacer.GetPatternString());
+  pacer.SetRates(1000000.0 / 24.0, 1000000.0 / 120.0);
+  EXPECT_EQ("5:5", pacer.GetPatternString());
+}
+
+TEST(TestFramePacer, TelecineWithJitter)
+{
+  // the render loop runs anywhere within the refresh before the vblank
+  CFramePacer unpaced;
+  CRefreshSimulator clocked(59.94, 23.976, 1.0);
+  CRefreshSimulator::Result naive = clocked.Run(60, unpaced, false);
+
+  CFramePacer pacer;
+  CRefreshSimulator predicted(59.94, 23.976, 1.0);
+  CRefreshSimulator::Result paced = predicted.Run(60, pacer, true);
+
+  EXPECT_GT(naive.errors, 10);
+  EXPECT_TRUE(paced.locked);
+  EXPECT_EQ(0, paced.errors);
+  EXPECT_EQ(0, paced.errorsPerMinute);
+
+  for (size_t i = 2; i < paced.shown.size(); i++)
+    ASSERT_EQ(5, paced.shown[i - 1] + paced.shown[i]) << "frame " << i;
+}
+
+TEST(TestFramePacer, Drift)
+{
+  // 23.976 on 60 Hz without adjusting the clock slips a refresh about
+  // every 400 frames, the pacer follows with a single error each time
+  CFramePacer pacer;
+  CRefreshSimulator display(60.0, 23.976, 1.0);
+  CRefreshSimulator::Result result = display.Run(60, pacer, true);
+
+  EXPECT_GT(result.errorsPerMinute, 0);
+  EXPECT_LE(result.errorsPerMinute, 8);
+
+  int min = *std::min_element(result.shown.begin(), result.shown.end());
+  int max = *std::max_element(result.shown.begin(), result.shown.end());
+  EXPECT_GE(min, 2);
+  EXPECT_LE(max, 4);
+}
+
+TEST(TestFramePacer, RelockAfterStall)
+{
+  CFramePacer pacer;
+  CRefreshSimulator display(120.0, 24.0, 1.0);
+  display.Stall(1000, 30);
+  CRefreshSimulator::Result result = display.Run(30, pacer, true);
+
+  EXPECT_GT(result.errors, 0);
+  EXPECT_TRUE(result.locked);
+
+  // 5:5 everywhere but around the stall
+  int regular = std::count(result.shown.begin(), result.shown.end(), 5);
+  EXPECT_GE(regular, static_cast<int>(result.shown.size()) - 12);
+}
@@ -0,0 +1,139 @@
+/*
+ *  Copyright (C) 2019 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/VideoPlayer/VideoRenderers/FrameTiming.h"
+#include "filesystem/File.h"
+#include "test/TestUtils.h"
+#include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+TEST(TestFrameTiming, Stages)
+{
+  CFrameTiming timing;
+  int64_t decoded = CurrentHostCounter();
+  uint64_t first = timing.Queued(1000.0, decoded);
+  uint64_t second = timing.Queued(2000.0, 0);
+  uint64_t third = timing.Queued(3000.0, 0);
+
+  timing.Presented(first);
+  timing.Flipped(first);
+  timing.Skipped(second);
+  timing.Presented(third);
+
+  std::vector<CFrameTiming::Frame> frames = timing.GetFrames();
+  ASSERT_EQ(3u, frames.size());
+  EXPECT_EQ(first, frames[0].id);
+  EXPECT_EQ(second, frames[1].id);
+  EXPECT_EQ(third, frames[2].id);
+
+  EXPECT_EQ(1000.0, frames[0].pts);
+  EXPECT_EQ(decoded, frames[0].decoded);
+  EXPECT_GE(frames[0].queued, decoded);
+  EXPECT_GE(frames[0].presented, frames[0].queued);
+  EXPECT_GE(frames[0].flipped, frames[0].presented);
+  EXPECT_FALSE(frames[0].skipped);
+
+  EXPECT_EQ(0, frames[1].decoded);
+  EXPECT_EQ(0, frames[1].presented);
+  EXPECT_TRUE(frames[1].skipped);
+
+  EXPECT_NE(0, frames[2].presented);
+  EXPECT_EQ(0, frames[2].flipped);
+
+  // bob renders a frame twice, the first render counts
+  int64_t flipped = frames[0].flipped;
+  timing.Flipped(first);
+  EXPECT_EQ(flipped, timing.GetFrames()[0].flipped);
+
+  EXPECT_TRUE(StringUtils::EndsWith(timing.GetSummary(), "skipped: 1/3"));
+
+  timing.Reset();
+  EXPECT_TRUE(timing.GetFrames().empty());
+}
+
+TEST(TestFrameTiming, Ring)
+{
+  CFrameTiming timing;
+  std::vector<uint64_t> ids;
+  for (unsigned int i = 0; i < CFrameTiming::RING_SIZE + 10; i++)
+    ids.push_back(timing.Queued(i, 0));
+
+  std::vector<CFrameTiming::Frame> frames = timing.GetFrames();
+  ASSERT_EQ(CFrameTiming::RING_SIZE, frames.size());
+  EXPECT_EQ(ids[10], frames.front().id);
+  EXPECT_EQ(ids.back(), frames.back().id);
+  EXPECT_EQ(10.0, frames.front().pts);
+
+  // frames that were recycled don't touch the slot of the new frame
+  timing.Presented(ids[0]);
+  timing.Skipped(ids[0]);
+  for (auto &frame : timing.GetFrames())
+  {
+    EXPECT_EQ(0, frame.presented);
+    EXPECT_FALSE(frame.skipped);
+  }
+
+  // the summary only covers the last frames
+  EXPECT_TRUE(StringUtils::EndsWith(timing.GetSummary(120), "skipped: 0/120"));
+}
+
+TEST(TestFrameTiming, WriteCSV)
+{
+  CFrameTiming timing;
+  XFILE::CFile* tmp = XBMC_CREATETEMPFILE(".csv");
+  ASSERT_NE(nullptr, tmp);
+  std::string path = XBMC_TEMPFILEPATH(tmp);
+  tmp->Close();
+
+  // nothing recorded
+  EXPECT_FALSE(timing.WriteCSV(path));
+
+  int64_t decoded = CurrentHostCounter();
+  uint64_t first = timing.Queued(40000.0, decoded);
+  timing.Presented(first);
+  timing.Flipped(first);
+  uint64_t second = timing.Queued(80000.0, 0);
+  timing.Skipped(second);
+  ASSERT_TRUE(timing.WriteCSV(path));
+
+  XFILE::auto_buffer buffer;
+  XFILE::CFile file;
+  ASSERT_GT(file.LoadFile(path, buffer), 0);
+  std::vector<std::string> lines = StringUtils::Split(std::string(buffer.get(), buffer.size()), "\n");
+  ASSERT_EQ(4u, lines.size());
+  EXPECT_EQ("frame,pts,decoded,queued,presented,flipped,skipped", lines[0]);
+  EXPECT_TRUE(lines[3].empty());
+
+  // times are relative to the decode time of the first frame
+  std::vector<std::string> row = StringUtils::Split(lines[1], ",");
+  ASSERT_EQ(7u, row.size());
+  EXPECT_EQ(std::to_string(first), row[0]);
+  EXPECT_EQ("40000", row[1]);
+  EXPECT_EQ("0", row[2]);
+  EXPECT_FALSE(row[3].empty());
+  EXPECT_FALSE(row[4].empty());
+  EXPECT_FALSE(row[5].empty());
+  EXPECT_EQ("0", row[6]);
+
+  // stages that were not reached stay empty
+  row = StringUtils::Split(lines[2], ",");
+  ASSERT_EQ(7u, row.size());
+  EXPECT_EQ(std::to_string(second), row[0]);
+  EXPECT_TRUE(row[2].empty());
+  EXPECT_FALSE(row[3].empty());
+  EXPECT_TRUE(row[4].empty());
+  EXPECT_TRUE(row[5].empty());
+  EXPECT_EQ("1", row[6]);
+
+  EXPECT_TRUE(XBMC_DELETETEMPFILE(tmp));
+}
@@ -0,0 +1,174 @@
+/*
+ *  Copyright (C) 2019 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/VideoPlayer/VideoRenderers/OverlayRenderer.h"
+#include "cores/VideoPlayer/VideoRenderers/OverlayRendererUtil.h"
+#include "threads/Thread.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace OVERLAY;
+
+namespace
+{
+std::vector<uint8_t> Bitmap(int width, int height, int stride, uint8_t seed)
+{
+  std::vector<uint8_t> bitmap(stride * height, 0xff);
+  for (int y = 0; y < height; y++)
+    for (int x = 0; x < width; x++)
+      bitmap[y * stride + x] = static_cast<uint8_t>(seed + y * width + x);
+  return bitmap;
+}
+
+/*!
+ * \brief Atlas where all bitmaps collide
+ */
+class CCollidingAtlas : public CGlyphAtlas
+{
+public:
+  explicit CCollidingAtlas(int size) : CGlyphAtlas(size) {}
+
+protected:
+  uint64_t Hash(const uint8_t* bitmap, int width, int height, int stride) const override { return 42; }
+};
+}
+
+TEST(TestGlyphAtlas, Insert)
+{
+  CGlyphAtlas atlas(64);
+  std::vector<uint8_t> a = Bitmap(10, 8, 10, 1);
+  std::vector<uint8_t> b = Bitmap(20, 12, 20, 2);
+  std::vector<uint8_t> c = Bitmap(40, 5, 40, 3);
+  int u, v;
+  bool placed;
+
+  ASSERT_TRUE(atlas.Insert(a.data(), 10, 8, 10, u, v, placed));
+  EXPECT_TRUE(placed);
+  EXPECT_EQ(0, u);
+  EXPECT_EQ(0, v);
+
+  // a pixel apart
+  ASSERT_TRUE(atlas.Insert(b.data(), 20, 12, 20, u, v, placed));
+  EXPECT_TRUE(placed);
+  EXPECT_EQ(11, u);
+  EXPECT_EQ(0, v);
+
+  // next shelf below the highest bitmap
+  ASSERT_TRUE(atlas.Insert(c.data(), 40, 5, 40, u, v, placed));
+  EXPECT_TRUE(placed);
+  EXPECT_EQ(0, u);
+  EXPECT_EQ(13, v);
+  EXPECT_EQ(3u, atlas.GetCount());
+}
+
+TEST(TestGlyphAtlas, Dedup)
+{
+  CGlyphAtlas atlas(64);
+  std::vector<uint8_t> a = Bitmap(10, 8, 10, 1);
+  // same pixels in another buffer with padded rows
+  std::vector<uint8_t> padded = Bitmap(10, 8, 16, 1);
+  int u, v, u2, v2;
+  bool placed;
+
+  ASSERT_TRUE(atlas.Insert(a.data(), 10, 8, 10, u, v, placed));
+  ASSERT_TRUE(atlas.Insert(padded.data(), 10, 8, 16, u2, v2, placed));
+  EXPECT_FALSE(placed);
+  EXPECT_EQ(u, u2);
+  EXPECT_EQ(v, v2);
+  EXPECT_EQ(1u, atlas.GetCount());
+
+  // one different pixel is another glyph
+  padded[7 * 16 + 9]++;
+  ASSERT_TRUE(atlas.Insert(padded.data(), 10, 8, 16, u2, v2, placed));
+  EXPECT_TRUE(placed);
+  EXPECT_NE(u, u2);
+  EXPECT_EQ(2u, atlas.GetCount());
+}
+
+TEST(TestGlyphAtlas, HashCollisions)
+{
+  CCollidingAtlas atlas(64);
+  std::vector<uint8_t> a = Bitmap(10, 8, 10, 1);
+  std::vector<uint8_t> b = Bitmap(10, 8, 10, 2);
+  int u[4], v[4];
+  bool placed;
+
+  ASSERT_TRUE(atlas.Insert(a.data(), 10, 8, 10, u[0], v[0], placed));
+  EXPECT_TRUE(placed);
+
+  // other content
+  ASSERT_TRUE(atlas.Insert(b.data(), 10, 8, 10, u[1], v[1], placed));
+  EXPECT_TRUE(placed);
+
+  // same bytes in other dimensions
+  ASSERT_TRUE(atlas.Insert(a.data(), 8, 10, 8, u[2], v[2], placed));
+  EXPECT_TRUE(placed);
+  EXPECT_EQ(3u, atlas.GetCount());
+
+  // each one is still found among the colliding ones
+  ASSERT_TRUE(atlas.Insert(b.data(), 10, 8, 10, u[3], v[3], placed));
+  EXPECT_FALSE(placed);
+  EXPECT_EQ(u[1], u[3]);
+  EXPECT_EQ(v[1], v[3]);
+  ASSERT_TRUE(atlas.Insert(a.data(), 8, 10, 8, u[3], v[3], placed));
+  EXPECT_FALSE(placed);
+  EXPECT_EQ(u[2], u[3]);
+  EXPECT_EQ(v[2], v[3]);
+}
+
+TEST(TestGlyphAtlas, Full)
+{
+  CGlyphAtlas atlas(32);
+  std::vector<uint8_t> bitmaps[4];
+  int u, v;
+  bool placed;
+
+  // four 15x15 bitmaps with spacing fill the atlas
+  for (int i = 0; i < 4; i++)
+  {
+    bitmaps[i] = Bitmap(15, 15, 15, static_cast<uint8_t>(i * 50));
+    ASSERT_TRUE(atlas.Insert(bitmaps[i].data(), 15, 15, 15, u, v, placed)) << i;
+    EXPECT_TRUE(placed);
+    EXPECT_EQ((i % 2) * 16, u);
+    EXPECT_EQ((i / 2) * 16, v);
+  }
+
+  std::vector<uint8_t> other = Bitmap(4, 4, 4, 7);
+  EXPECT_FALSE(atlas.Insert(other.data(), 4, 4, 4, u, v, placed));
+  EXPECT_FALSE(placed);
+
+  // bitmaps wider than the atlas never fit
+  CGlyphAtlas empty(32);
+  std::vector<uint8_t> wide = Bitmap(32, 1, 32, 7);
+  EXPECT_FALSE(empty.Insert(wide.data(), 32, 1, 32, u, v, placed));
+
+  // the ones in it are still found
+  ASSERT_TRUE(atlas.Insert(bitmaps[3].data(), 15, 15, 15, u, v, placed));
+  EXPECT_FALSE(placed);
+  EXPECT_EQ(16, u);
+  EXPECT_EQ(16, v);
+}
+
+TEST(TestGlyphAtlas, UploadRate)
+{
+  // starts a new period
+  CRenderer::GetUploadRate();
+
+  const unsigned int uploaded = 1000000;
+  CRenderer::AddUploaded(uploaded);
+  XbmcThreads::ThreadSleep(1100);
+
+  // bytes over the elapsed time, once a second
+  unsigned int rate = CRenderer::GetUploadRate();
+  EXPECT_LE(rate, uploaded);
+  EXPECT_GE(rate, uploaded * 8 / 10);
+  CRenderer::AddUploaded(uploaded);
+  EXPECT_EQ(rate, CRenderer::GetUploadRate());
+}
@@ -0,0 +1,122 @@
+/*
+ *  Copyright (C) 2019 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/VideoPlayer/VideoRenderers/PlaneCopyWorkers.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace
+{
+const uint8_t PADDING = 0xEE;
+
+struct Picture
+{
+  Picture(int width, int height, int srcStride, int dstStride, int seed)
+    : src(srcStride * height), dst(dstStride * height, PADDING)
+  {
+    for (size_t i = 0; i < src.size(); i++)
+      src[i] = static_cast<uint8_t>(i * 7 + seed);
+    plane.dst = dst.data();
+    plane.src = src.data();
+    plane.dstStride = dstStride;
+    plane.srcStride = srcStride;
+    plane.width = width;
+    plane.height = height;
+  }
+
+  // rows are copied up to the width, the padding of dst stays untouched
+  void Verify() const
+  {
+    for (int y = 0; y < plane.height; y++)
+    {
+      for (int x = 0; x < plane.dstStride; x++)
+      {
+        uint8_t expected = x < plane.width ? src[y * plane.srcStride + x] : PADDING;
+        ASSERT_EQ(expected, dst[y * plane.dstStride + x]) << "row " << y << " column " << x;
+      }
+    }
+  }
+
+  std::vector<uint8_t> src;
+  std::vector<uint8_t> dst;
+  CPlaneCopyWorkers::Plane plane;
+};
+}
+
+TEST(TestPlaneCopyWorkers, CopyPlane)
+{
+  Picture packed(64, 40, 64, 64, 1);
+  CPlaneCopyWorkers::CopyPlane(packed.plane);
+  packed.Verify();
+
+  Picture strided(50, 33, 80, 64, 2);
+  CPlaneCopyWorkers::CopyPlane(strided.plane);
+  strided.Verify();
+}
+
+TEST(TestPlaneCopyWorkers, NoThreads)
+{
+  CPlaneCopyWorkers workers(0);
+  EXPECT_EQ(0u, workers.GetThreads());
+
+  // copied right away, waiting doesn't block
+  Picture picture(100, 75, 128, 112, 3);
+  workers.Copy(0, {picture.plane});
+  picture.Verify();
+  workers.Wait(0);
+}
+
+TEST(TestPlaneCopyWorkers, Slices)
+{
+  CPlaneCopyWorkers workers(3);
+  EXPECT_EQ(3u, workers.GetThreads());
+
+  // yuv 4:2:0 pictures of odd sizes in a few render buffers, the rows don't
+  // divide evenly into slices
+  std::vector<std::vector<Picture>> pictures;
+  for (int id = 0; id < 4; id++)
+  {
+    int width = 320 + id * 18;
+    int height = 181 + id * 7;
+    pictures.emplace_back();
+    pictures.back().emplace_back(width, height, width + 32, width + 16, id);
+    pictures.back().emplace_back(width / 2, height / 2, width / 2 + 16, width / 2, id + 10);
+    pictures.back().emplace_back(width / 2, height / 2, width / 2 + 16, width / 2, id + 20);
+
+    std::vector<CPlaneCopyWorkers::Plane> planes;
+    for (auto &picture : pictures.back())
+      planes.push_back(picture.plane);
+    workers.Copy(id, planes);
+  }
+
+  for (int id = 3; id >= 0; id--)
+  {
+    workers.Wait(id);
+    for (auto &picture : pictures[id])
+      picture.Verify();
+  }
+
+  // nothing queued for this one
+  workers.Wait(10);
+}
+
+TEST(TestPlaneCopyWorkers, Reuse)
+{
+  CPlaneCopyWorkers workers(2);
+
+  // a render buffer gets the next picture once the previous one is waited for
+  for (int frame = 0; frame < 20; frame++)
+  {
+    Picture picture(64, 96 + frame, 64, 80, frame);
+    workers.Copy(frame % 2, {picture.plane});
+    workers.Wait(frame % 2);
+    picture.Verify();
+  }
+}
@@ -0,0 +1,90 @@
+/*
+ *  Copyright (C) 2019 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/VideoPlayer/VideoRenderers/SeparableScaler.h"
+#include "cores/VideoPlayer/VideoRenderers/VideoShaders/ConvolutionKernels.h"
+
+#include <random>
+
+#include "gtest/gtest.h"
+
+namespace
+{
+std::vector<uint8_t> Scale(CSeparableScaler::Impl impl, ESCALINGMETHOD method, unsigned int channels,
+                           const std::vector<uint8_t> &src, int srcWidth, int srcHeight,
+                           int dstWidth, int dstHeight)
+{
+  CSeparableScaler scaler(method, channels);
+  scaler.SetImpl(impl);
+  std::vector<uint8_t> dst(dstWidth * dstHeight * channels);
+  scaler.Scale(src.data(), srcWidth * channels, srcWidth, srcHeight,
+               dst.data(), dstWidth * channels, dstWidth, dstHeight);
+  return dst;
+}
+}
+
+TEST(TestSeparableScaler, KernelCache)
+{
+  std::shared_ptr<const CConvolutionKernel> a = CConvolutionKernel::Get(VS_SCALINGMETHOD_LANCZOS3, 256);
+  std::shared_ptr<const CConvolutionKernel> b = CConvolutionKernel::Get(VS_SCALINGMETHOD_LANCZOS3, 256);
+  std::shared_ptr<const CConvolutionKernel> c = CConvolutionKernel::Get(VS_SCALINGMETHOD_SPLINE36, 256);
+
+  EXPECT_EQ(a.get(), b.get());
+  EXPECT_NE(a.get(), c.get());
+  EXPECT_EQ(256, a->GetSize());
+}
+
+TEST(TestSeparableScaler, Constant)
+{
+  const ESCALINGMETHOD methods[] = {VS_SCALINGMETHOD_LINEAR, VS_SCALINGMETHOD_CUBIC,
+                                    VS_SCALINGMETHOD_LANCZOS3, VS_SCALINGMETHOD_SPLINE36};
+  std::vector<uint8_t> src(97 * 61 * 4, 201);
+
+  for (ESCALINGMETHOD method : methods)
+  {
+    for (auto size : {std::make_pair(320, 180), std::make_pair(33, 17), std::make_pair(97, 61)})
+    {
+      std::vector<uint8_t> dst = Scale(CSeparableScaler::IMPL_SCALAR, method, 4, src, 97, 61,
+                                       size.first, size.second);
+      for (uint8_t value : dst)
+        ASSERT_EQ(201, value) << "method " << method << " size " << size.first;
+    }
+  }
+}
+
+TEST(TestSeparableScaler, ImplsMatch)
+{
+  std::mt19937 random(1);
+  std::uniform_int_distribution<int> pixel(0, 255);
+
+  const int srcWidth = 203;
+  const int srcHeight = 117;
+  std::vector<uint8_t> src(srcWidth * srcHeight * 4);
+  for (uint8_t &value : src)
+    value = static_cast<uint8_t>(pixel(random));
+
+  for (unsigned int channels : {1u, 4u})
+  {
+    for (auto size : {std::make_pair(64, 37), std::make_pair(411, 233), std::make_pair(7, 3)})
+    {
+      std::vector<uint8_t> reference = Scale(CSeparableScaler::IMPL_SCALAR, VS_SCALINGMETHOD_LANCZOS3,
+                                             channels, src, srcWidth, srcHeight,
+                                             size.first, size.second);
+      for (int impl = CSeparableScaler::IMPL_SCALAR + 1; impl < CSeparableScaler::IMPL_MAX; impl++)
+      {
+        if (!CSeparableScaler::IsSupported(static_cast<CSeparableScaler::Impl>(impl)))
+          continue;
+        std::vector<uint8_t> result = Scale(static_cast<CSeparableScaler::Impl>(impl),
+                                            VS_SCALINGMETHOD_LANCZOS3, channels, src,
+                                            srcWidth, srcHeight, size.first, size.second);
+        EXPECT_EQ(reference, result) << "impl " << impl << " channels " << channels
+                                     << " size " << size.first << "x" << size.second;
+      }
+    }
+  }
+}
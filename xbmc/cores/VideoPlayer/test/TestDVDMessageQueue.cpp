@@ -0,0 +1,272 @@
+/*
+ *  Copyright (C) 2019 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/VideoPlayer/DVDDemuxers/DVDDemuxUtils.h"
+#include "cores/VideoPlayer/DVDMessageQueue.h"
+#include "cores/VideoPlayer/Interface/Addon/TimingConstants.h"
+#include "threads/IRunnable.h"
+
+#include "threads/test/TestHelpers.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+
+namespace
+{
+// a 80 Mbit/s stream, 64 KiB per packet
+const int PACKET_SIZE = 64 * 1024;
+const double PACKET_DURATION = PACKET_SIZE * 8.0 / 80000000 * DVD_TIME_BASE;
+
+CDVDMsg* CreatePacket(int index)
+{
+  DemuxPacket* packet = CDVDDemuxUtils::AllocateDemuxPacket(PACKET_SIZE);
+  packet->iSize = PACKET_SIZE;
+  packet->dts = packet->pts = index * PACKET_DURATION;
+  return new CDVDMsgDemuxerPacket(packet);
+}
+
+double GetPts(CDVDMsg* msg)
+{
+  if (!msg->IsType(CDVDMsg::DEMUXER_PACKET))
+    return DVD_NOPTS_VALUE;
+  return static_cast<CDVDMsgDemuxerPacket*>(msg)->GetPacket()->pts;
+}
+
+class CConsumer : public IRunnable
+{
+public:
+  explicit CConsumer(CDVDMessageQueue& queue) : m_queue(queue) {}
+
+  void Run() override
+  {
+    CDVDMsg* msg;
+    while (m_queue.Get(&msg, 1000) == MSGQ_OK)
+    {
+      bool eof = msg->IsType(CDVDMsg::GENERAL_EOF);
+      if (!eof)
+      {
+        if (GetPts(msg) != m_received * PACKET_DURATION)
+          m_ordered = false;
+        m_received++;
+      }
+      msg->Release();
+      if (eof)
+        break;
+    }
+  }
+
+  int m_received = 0;
+  bool m_ordered = true;
+
+private:
+  CDVDMessageQueue& m_queue;
+};
+
+// closing a stream waits for the player thread to empty its queue
+class CDrainer : public IRunnable
+{
+public:
+  explicit CDrainer(CDVDMessageQueue& queue) : m_queue(queue) {}
+
+  void Run() override
+  {
+    m_queue.WaitUntilEmpty();
+    m_done = true;
+  }
+
+  std::atomic<bool> m_done{false};
+
+private:
+  CDVDMessageQueue& m_queue;
+};
+
+/*!
+ * \brief Hands packets from this thread to a player thread the way the demux
+ * thread does, waiting while the queue is full
+ */
+std::chrono::steady_clock::duration Transfer(bool lockFree, int count, CConsumer*& result)
+{
+  CDVDMessageQueue queue("test");
+  queue.SetLockFree(lockFree);
+  queue.Init();
+  queue.SetMaxDataSize(40 * 1024 * 1024);
+  queue.SetMaxTimeSize(8.0);
+
+  CConsumer* consumer = new CConsumer(queue);
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  thread consumerThread(*consumer);
+  for (int i = 0; i < count; i++)
+  {
+    while (queue.IsFull())
+      SleepMillis(1);
+    queue.Put(CreatePacket(i));
+  }
+  queue.Put(new CDVDMsg(CDVDMsg::GENERAL_EOF));
+  consumerThread.join();
+  std::chrono::steady_clock::duration time = std::chrono::steady_clock::now() - start;
+
+  EXPECT_EQ(0, queue.GetDataSize());
+  queue.End();
+  result = consumer;
+  return time;
+}
+}
+
+class TestDVDMessageQueue : public ::testing::TestWithParam<bool>
+{
+};
+
+TEST_P(TestDVDMessageQueue, Order)
+{
+  CDVDMessageQueue queue("test");
+  queue.SetLockFree(GetParam());
+  queue.Init();
+  EXPECT_EQ(GetParam(), queue.IsLockFree());
+
+  for (int i = 0; i < 3; i++)
+    queue.Put(CreatePacket(i));
+  queue.Put(new CDVDMsg(CDVDMsg::GENERAL_RESYNC), 1);
+  EXPECT_EQ(3 * PACKET_SIZE, queue.GetDataSize());
+  EXPECT_EQ(3u, queue.GetPacketCount(CDVDMsg::DEMUXER_PACKET));
+
+  // the priority lane is served first
+  CDVDMsg* msg;
+  ASSERT_EQ(MSGQ_OK, queue.Get(&msg, 0));
+  EXPECT_TRUE(msg->IsType(CDVDMsg::GENERAL_RESYNC));
+  msg->Release();
+
+  ASSERT_EQ(MSGQ_OK, queue.Get(&msg, 0));
+  EXPECT_EQ(0.0, GetPts(msg));
+
+  // a message put back is served before the others
+  queue.PutBack(msg);
+  for (int i = 0; i < 3; i++)
+  {
+    ASSERT_EQ(MSGQ_OK, queue.Get(&msg, 0));
+    EXPECT_EQ(i * PACKET_DURATION, GetPts(msg));
+    msg->Release();
+  }
+  EXPECT_EQ(MSGQ_TIMEOUT, queue.Get(&msg, 0));
+  EXPECT_EQ(0, queue.GetDataSize());
+  queue.End();
+}
+
+TEST_P(TestDVDMessageQueue, Level)
+{
+  CDVDMessageQueue queue("test");
+  queue.SetLockFree(GetParam());
+  queue.Init();
+  queue.SetMaxDataSize(1000 * PACKET_SIZE);
+  queue.SetMaxTimeSize(1.0);
+
+  // a second of packets fills the queue by time
+  int count = static_cast<int>(DVD_TIME_BASE / PACKET_DURATION);
+  for (int i = 0; i <= count / 2; i++)
+    queue.Put(CreatePacket(i));
+  EXPECT_FALSE(queue.IsDataBased());
+  EXPECT_EQ(50, queue.GetLevel());
+  for (int i = count / 2 + 1; i <= count + 1; i++)
+    queue.Put(CreatePacket(i));
+  EXPECT_EQ(100, queue.GetLevel());
+  EXPECT_EQ(1, queue.GetTimeSize());
+
+  queue.Flush();
+  EXPECT_EQ(0, queue.GetLevel());
+  EXPECT_EQ(0, queue.GetDataSize());
+  queue.End();
+}
+
+TEST_P(TestDVDMessageQueue, Overflow)
+{
+  CDVDMessageQueue queue("test");
+  queue.SetLockFree(GetParam());
+  queue.Init();
+
+  // more than the ring holds spills into the locked list in order
+  const int count = 5000;
+  for (int i = 0; i < count; i++)
+    queue.Put(CreatePacket(i));
+  EXPECT_EQ(static_cast<unsigned>(count), queue.GetPacketCount(CDVDMsg::DEMUXER_PACKET));
+
+  CDVDMsg* msg;
+  for (int i = 0; i < count; i++)
+  {
+    ASSERT_EQ(MSGQ_OK, queue.Get(&msg, 0));
+    ASSERT_EQ(i * PACKET_DURATION, GetPts(msg));
+    msg->Release();
+  }
+  EXPECT_EQ(0, queue.GetDataSize());
+  queue.End();
+}
+
+TEST_P(TestDVDMessageQueue, DrainPriority)
+{
+  CDVDMessageQueue queue("test");
+  queue.SetLockFree(GetParam());
+  queue.Init();
+  for (int i = 0; i < 3; i++)
+    queue.Put(CreatePacket(i));
+
+  CDrainer drainer(queue);
+  thread drainThread(drainer);
+
+  // the audio player only asks for priority messages while it is synced or paused
+  std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (!drainer.m_done && std::chrono::steady_clock::now() < end)
+  {
+    CDVDMsg* msg;
+    int priority = 1;
+    if (queue.Get(&msg, 100, priority) != MSGQ_OK)
+      continue;
+    if (msg->IsType(CDVDMsg::GENERAL_SYNCHRONIZE))
+    {
+      if (!static_cast<CDVDMsgGeneralSynchronize*>(msg)->Wait(100, SYNCSOURCE_AUDIO))
+        queue.Put(msg->Acquire(), 1);
+    }
+    msg->Release();
+  }
+
+  EXPECT_TRUE(drainer.m_done);
+  if (!drainer.m_done)
+    queue.Abort();
+  drainThread.join();
+  EXPECT_EQ(0, queue.GetDataSize());
+  queue.End();
+}
+
+INSTANTIATE_TEST_CASE_P(LockFree, TestDVDMessageQueue, ::testing::Bool());
+
+TEST(TestDVDMessageQueueBenchmark, HighBitrate)
+{
+  // 10 minutes of the stream
+  const int count = static_cast<int>(600 * DVD_TIME_BASE / PACKET_DURATION);
+
+  // alternate the modes and keep the best of a few rounds to even out warm up
+  std::chrono::steady_clock::duration times[2] = { std::chrono::steady_clock::duration::max(),
+                                                   std::chrono::steady_clock::duration::max() };
+  for (int round = 0; round < 3; round++)
+  {
+    for (int lockFree = 0; lockFree < 2; lockFree++)
+    {
+      CConsumer* consumer;
+      times[lockFree] = std::min(times[lockFree], Transfer(lockFree != 0, count, consumer));
+      EXPECT_EQ(count, consumer->m_received);
+      EXPECT_TRUE(consumer->m_ordered);
+      delete consumer;
+    }
+  }
+
+  for (int lockFree = 0; lockFree < 2; lockFree++)
+  {
+    long long us = std::chrono::duration_cast<std::chrono::microseconds>(times[lockFree]).count();
+    std::cout << (lockFree ? "lock free: " : "locked: ") << count << " packets in " << us << " us, "
+              << count * 1000000LL / std::max(1LL, us) << " packets/s" << std::endl;
+  }
+}
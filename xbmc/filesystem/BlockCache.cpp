@@ -0,0 +1,231 @@
+/*
+ *  Copyright (C) 2019 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "BlockCache.h"
+#include "Directory.h"
+#include "File.h"
+#include "FileItem.h"
+#include "ServiceBroker.h"
+#include "settings/AdvancedSettings.h"
+#include "settings/SettingsComponent.h"
+#include "threads/SingleLock.h"
+#include "utils/Digest.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <vector>
+
+using namespace XFILE;
+using KODI::UTILITY::CDigest;
+
+#define BLOCK_EXTENSION ".blk"
+#define TEMP_EXTENSION ".tmp"
+
+constexpr size_t CBlockCache::BLOCK_SIZE;
+
+CBlockCache& CBlockCache::GetInstance()
+{
+  static CBlockCache cache("special://temp/blockcache/",
+    static_cast<uint64_t>(CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_cacheBlockCacheSize) * 1024 * 1024);
+  return cache;
+}
+
+CBlockCache::CBlockCache(const std::string& path, uint64_t maxSize)
+  : m_path(path)
+  , m_maxSize(maxSize)
+{
+}
+
+std::string CBlockCache::GetKey(const std::string& url, int64_t size, const std::string& modified)
+{
+  return CDigest::Calculate(CDigest::Type::SHA256, StringUtils::Format("%s|%" PRId64 "|%s", url.c_str(), size, modified.c_str()));
+}
+
+std::string CBlockCache::GetBlockName(const std::string& key, uint64_t block)
+{
+  return StringUtils::Format("%s-%" PRIu64 BLOCK_EXTENSION, key.c_str(), block);
+}
+
+ssize_t CBlockCache::Read(const std::string& key, int64_t position, char* buffer, size_t size)
+{
+  if (!IsEnabled() || position < 0)
+    return -1;
+
+  const std::string name = GetBlockName(key, position / BLOCK_SIZE);
+  const int64_t offset = position % BLOCK_SIZE;
+
+  {
+    CSingleLock lock(m_critSection);
+    Load();
+
+    auto it = m_entries.find(name);
+    if (it == m_entries.end() || static_cast<uint64_t>(offset) >= it->second->size)
+    {
+      m_stats.misses++;
+      return -1;
+    }
+
+    m_lru.splice(m_lru.begin(), m_lru, it->second);
+    size = static_cast<size_t>(std::min<uint64_t>(size, it->second->size - offset));
+  }
+
+  CFile file;
+  ssize_t read = -1;
+  if (file.Open(m_path + name) && file.Seek(offset, SEEK_SET) == offset)
+    read = file.Read(buffer, size);
+  file.Close();
+
+  CSingleLock lock(m_critSection);
+  if (read != static_cast<ssize_t>(size))
+  {
+    CLog::Log(LOGWARNING, "CBlockCache::Read - dropping unreadable block %s", name.c_str());
+    auto it = m_entries.find(name);
+    if (it != m_entries.end())
+    {
+      m_stats.size -= it->second->size;
+      m_lru.erase(it->second);
+      m_entries.erase(it);
+    }
+    CFile::Delete(m_path + name);
+    m_stats.misses++;
+    return -1;
+  }
+
+  m_stats.hits++;
+  m_stats.bytesRead += read;
+  return read;
+}
+
+bool CBlockCache::Store(const std::string& key, uint64_t block, const char* data, size_t size)
+{
+  if (!IsEnabled() || size == 0 || size > BLOCK_SIZE || size > m_maxSize)
+    return false;
+
+  const std::string name = GetBlockName(key, block);
+
+  {
+    CSingleLock lock(m_critSection);
+    Load();
+
+    if (m_entries.find(name) != m_entries.end())
+      return true;
+
+    Evict(size);
+  }
+
+  // write to a temporary name first, a block file is either complete or absent
+  const std::string path = m_path + name;
+  const std::string tempPath = path + TEMP_EXTENSION;
+  CFile file;
+  bool written = false;
+  if (file.OpenForWrite(tempPath, true))
+  {
+    written = file.Write(data, size) == static_cast<ssize_t>(size);
+    file.Close();
+  }
+
+  if (!written || !CFile::Rename(tempPath, path))
+  {
+    CLog::Log(LOGWARNING, "CBlockCache::Store - failed to write block %s", name.c_str());
+    CFile::Delete(tempPath);
+    return false;
+  }
+
+  CSingleLock lock(m_critSection);
+  if (m_entries.find(name) == m_entries.end())
+  {
+    m_lru.push_front({name, size});
+    m_entries[name] = m_lru.begin();
+    m_stats.size += size;
+    m_stats.bytesStored += size;
+  }
+  return true;
+}
+
+void CBlockCache::Clear()
+{
+  CSingleLock lock(m_critSection);
+  Load();
+
+  for (const auto& entry : m_lru)
+    CFile::Delete(m_path + entry.name);
+
+  m_lru.clear();
+  m_entries.clear();
+  m_stats.size = 0;
+}
+
+SBlockCacheStats CBlockCache::GetStats() const
+{
+  CSingleLock lock(m_critSection);
+  return m_stats;
+}
+
+void CBlockCache::Load()
+{
+  if (m_loaded)
+    return;
+  m_loaded = true;
+
+  CFileItemList items;
+  if (!CDirectory::Exists(m_path))
+  {
+    CDirectory::Create(m_path);
+    return;
+  }
+
+  if (!CDirectory::GetDirectory(m_path, items, "", DIR_FLAG_NO_FILE_DIRS | DIR_FLAG_BYPASS_CACHE))
+    return;
+
+  // the last write time is the best guess of the last use after a restart
+  std::vector<CFileItemPtr> blocks;
+  for (int i = 0; i < items.Size(); i++)
+  {
+    CFileItemPtr item = items[i];
+    if (item->m_bIsFolder)
+      continue;
+
+    if (URIUtils::HasExtension(item->GetPath(), TEMP_EXTENSION))
+      CFile::Delete(item->GetPath());
+    else if (URIUtils::HasExtension(item->GetPath(), BLOCK_EXTENSION))
+      blocks.push_back(item);
+  }
+
+  std::sort(blocks.begin(), blocks.end(), [](const CFileItemPtr& a, const CFileItemPtr& b)
+  {
+    return a->m_dateTime > b->m_dateTime;
+  });
+
+  for (const auto& item : blocks)
+  {
+    const std::string name = URIUtils::GetFileName(item->GetPath());
+    m_lru.push_back({name, static_cast<uint64_t>(item->m_dwSize)});
+    m_entries[name] = std::prev(m_lru.end());
+    m_stats.size += item->m_dwSize;
+  }
+
+  CLog::Log(LOGDEBUG, "CBlockCache - found %u blocks with %" PRIu64 " bytes in %s",
+            static_cast<unsigned int>(m_lru.size()), m_stats.size, m_path.c_str());
+
+  // the cap may have been lowered since the last run
+  Evict(0);
+}
+
+void CBlockCache::Evict(uint64_t required)
+{
+  while (!m_lru.empty() && m_stats.size + required > m_maxSize)
+  {
+    const SEntry& entry = m_lru.back();
+    CFile::Delete(m_path + entry.name);
+    m_stats.size -= entry.size;
+    m_entries.erase(entry.name);
+    m_lru.pop_back();
+  }
+}
@@ -0,0 +1,102 @@
+/*
+ *  Copyright (C) 2019 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "IFile.h"
+#include "threads/CriticalSection.h"
+
+#include <list>
+#include <string>
+#include <unordered_map>
+
+namespace XFILE
+{
+
+struct SBlockCacheStats
+{
+  uint64_t hits = 0;        /**< lookups answered from disk */
+  uint64_t misses = 0;      /**< lookups that had to go to the source */
+  uint64_t bytesRead = 0;   /**< bytes delivered from disk */
+  uint64_t bytesStored = 0; /**< bytes written to disk */
+  uint64_t size = 0;        /**< bytes currently on disk */
+};
+
+/*!
+ \brief Persistent, size bounded cache for blocks of remote files
+
+ Files are identified by a key derived from url, size and modification
+ time, so a changed resource never hits stale data. Each key is split into
+ BLOCK_SIZE aligned blocks, which are stored as individual files in the cache
+ directory and evicted least recently used first once the configured size is
+ exceeded. The content survives restarts, the index is rebuilt from the
+ directory on first use.
+
+ All methods are thread safe.
+ */
+class CBlockCache
+{
+public:
+  /*!
+   \brief The instance backed by special://temp/blockcache/, configured from
+   <cache><blockcachesize> in advancedsettings.xml
+   */
+  static CBlockCache& GetInstance();
+
+  CBlockCache(const std::string& path, uint64_t maxSize);
+  CBlockCache(const CBlockCache&) = delete;
+  CBlockCache& operator=(const CBlockCache&) = delete;
+
+  bool IsEnabled() const { return m_maxSize > 0; }
+
+  static std::string GetKey(const std::string& url, int64_t size, const std::string& modified);
+
+  /*!
+   \brief Read cached data of key starting at position, never across a block end
+   \return bytes read or -1 if the block is not cached
+   */
+  ssize_t Read(const std::string& key, int64_t position, char* buffer, size_t size);
+
+  /*!
+   \brief Store a complete block. Only the last block of a file may be shorter
+   than BLOCK_SIZE.
+   */
+  bool Store(const std::string& key, uint64_t block, const char* data, size_t size);
+
+  /*!
+   \brief Drop all blocks
+   */
+  void Clear();
+
+  SBlockCacheStats GetStats() const;
+
+  static constexpr size_t BLOCK_SIZE = 1024 * 1024;
+
+private:
+  struct SEntry
+  {
+    std::string name;
+    uint64_t size;
+  };
+  using EntryList = std::list<SEntry>;
+
+  static std::string GetBlockName(const std::string& key, uint64_t block);
+  void Load();
+  void Evict(uint64_t required);
+
+  const std::string m_path;
+  const uint64_t m_maxSize;
+
+  mutable CCriticalSection m_critSection;
+  bool m_loaded = false;
+  EntryList m_lru; // most recently used first
+  std::unordered_map<std::string, EntryList::iterator> m_entries;
+  SBlockCacheStats m_stats;
+};
+
+} // namespace XFILE
@@ -46,6 +46,15 @@ void CCacheStrategy::ClearEndOfInput()
   m_bEndOfInput = false;
 }
 
+int CCacheStrategy::LendFromCache(const char** pData, size_t iMaxSize)
+{
+  return CACHE_RC_ERROR;
+}
+
+void CCacheStrategy::ReturnToCache(size_t iSize)
+{
+}
+
 CSimpleFileCache::CSimpleFileCache()
   : m_cacheFileRead(new CacheLocalFile())
   , m_cacheFileWrite(new CacheLocalFile())
@@ -309,6 +318,21 @@ int64_t CDoubleCache::WaitForData(unsigned int iMinAvail, unsigned int iMillis)
   return m_pCache->WaitForData(iMinAvail, iMillis);
 }
 
+bool CDoubleCache::CanLend()
+{
+  return m_pCache->CanLend();
+}
+
+int CDoubleCache::LendFromCache(const char** pData, size_t iMaxSize)
+{
+  return m_pCache->LendFromCache(pData, iMaxSize);
+}
+
+void CDoubleCache::ReturnToCache(size_t iSize)
+{
+  m_pCache->ReturnToCache(iSize);
+}
+
 int64_t CDoubleCache::Seek(int64_t iFilePosition)
 {
   /* Check whether position is NOT in our current cache but IS in our old cache.
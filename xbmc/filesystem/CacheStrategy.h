@@ -33,6 +33,27 @@ public:
   virtual int ReadFromCache(char *pBuffer, size_t iMaxSize) = 0;
   virtual int64_t WaitForData(unsigned int iMinAvail, unsigned int iMillis) = 0;
 
+  /*!
+   \brief Whether cached data can be borrowed through LendFromCache
+   */
+  virtual bool CanLend() { return false; }
+
+  /*!
+   \brief Borrow the contiguous region of cached data at the read position
+   \param pData receives a pointer into the cache. The region stays untouched
+   until it is given back with ReturnToCache, the read position is not moved.
+   \param iMaxSize maximum size of the region
+   \return size of the region, 0 at end of input or a CACHE_RC_* error
+   \sa ReadFromCache
+   */
+  virtual int LendFromCache(const char** pData, size_t iMaxSize);
+
+  /*!
+   \brief Give back a region borrowed with LendFromCache
+   \param iSize number of bytes consumed, the read position moves by this amount
+   */
+  virtual void ReturnToCache(size_t iSize);
+
   virtual int64_t Seek(int64_t iFilePosition) = 0;
 
   /*!
@@ -109,6 +130,10 @@ public:
   int ReadFromCache(char *pBuffer, size_t iMaxSize) override;
   int64_t WaitForData(unsigned int iMinAvail, unsigned int iMillis) override;
 
+  bool CanLend() override;
+  int LendFromCache(const char** pData, size_t iMaxSize) override;
+  void ReturnToCache(size_t iSize) override;
+
   int64_t Seek(int64_t iFilePosition) override;
   bool Reset(int64_t iSourcePosition, bool clearAnyway=true) override;
   void EndOfInput() override;
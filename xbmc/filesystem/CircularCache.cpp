@@ -166,6 +166,44 @@ int CCircularCache::ReadFromCache(char *buf, size_t len)
   return len;
 }
 
+/**
+ * Lends the data up till the buffer wrap point. The writer never
+ * touches data in front of the read position, so the region stays
+ * valid until it is returned
+ */
+int CCircularCache::LendFromCache(const char **buf, size_t len)
+{
+  CSingleLock lock(m_sync);
+
+  size_t pos   = m_cur % m_size;
+  size_t front = (size_t)(m_end - m_cur);
+  size_t avail = std::min(m_size - pos, front);
+
+  if(avail == 0)
+  {
+    if(IsEndOfInput())
+      return 0;
+    else
+      return CACHE_RC_WOULD_BLOCK;
+  }
+
+  if(len > avail)
+    len = avail;
+
+  *buf = (const char*)m_buf + pos;
+
+  return len;
+}
+
+void CCircularCache::ReturnToCache(size_t len)
+{
+  CSingleLock lock(m_sync);
+
+  m_cur = std::min(m_cur + (int64_t)len, m_end);
+
+  m_space.Set();
+}
+
 /* Wait "millis" milliseconds for "minimum" amount of data to come in.
  * Note that caller needs to make sure there's sufficient space in the forward
  * buffer for "minimum" bytes else we may block the full timeout time
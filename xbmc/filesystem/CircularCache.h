@@ -28,6 +28,10 @@ public:
     int ReadFromCache(char *buf, size_t len) override;
     int64_t WaitForData(unsigned int minimum, unsigned int iMillis) override;
 
+    bool CanLend() override { return true; }
+    int LendFromCache(const char **buf, size_t len) override;
+    void ReturnToCache(size_t len) override;
+
     int64_t Seek(int64_t pos) override;
     bool Reset(int64_t pos, bool clearAnyway=true) override;
 
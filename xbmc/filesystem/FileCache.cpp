@@ -13,7 +13,11 @@
 #include "URL.h"
 #include "ServiceBroker.h"
 
+#include "BlockCache.h"
 #include "CircularCache.h"
+#include "CurlFile.h"
+#include "ParallelRangeReader.h"
+#include "WindowedCache.h"
 #include "threads/SingleLock.h"
 #include "utils/log.h"
 #include "settings/AdvancedSettings.h"
@@ -24,6 +28,8 @@
 #endif
 
 #include <cassert>
+#include <climits>
+#include <cstring>
 #include <algorithm>
 #include <memory>
 
@@ -34,6 +40,8 @@
 using namespace XFILE;
 
 #define READ_CACHE_CHUNK_SIZE (128*1024)
+// interval the number of range connections is re-evaluated in
+#define RANGE_ADAPT_INTERVAL_MS 2000
 
 class CWriteRate
 {
@@ -86,6 +94,8 @@ CFileCache::CFileCache(const unsigned int flags)
   , m_pCache(NULL)
   , m_bDeleteCache(true)
   , m_seekPossible(0)
+  , m_blockStart(-1)
+  , m_blockFill(0)
   , m_nSeekResult(0)
   , m_seekPos(0)
   , m_readPos(0)
@@ -105,6 +115,8 @@ CFileCache::CFileCache(const unsigned int flags)
 CFileCache::CFileCache(CCacheStrategy *pCache, bool bDeleteCache /* = true */)
   : CThread("FileCacheStrategy")
   , m_seekPossible(0)
+  , m_blockStart(-1)
+  , m_blockFill(0)
   , m_chunkSize(0)
   , m_writeRate(0)
   , m_writeRateActual(0)
@@ -173,6 +185,30 @@ bool CFileCache::Open(const CURL& url)
   m_chunkSize = CFile::GetChunkSize(m_source.GetChunkSize(), READ_CACHE_CHUNK_SIZE);
   m_fileSize = m_source.GetLength();
 
+  if (CanUseRangeReader(url))
+  {
+    CLog::Log(LOGDEBUG, "CFileCache::Open - using up to %u range connections",
+              CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_cacheMaxConnections);
+    m_rangeReader.reset(new CParallelRangeReader(CURL(m_sourcePath), CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_cacheMaxConnections));
+  }
+
+  // the persistent block cache needs to identify the exact version of the
+  // source and be able to continue the source behind cached blocks
+  m_blockKey.clear();
+  if (CBlockCache::GetInstance().IsEnabled() && m_seekPossible > 0 && m_fileSize > 0)
+  {
+    std::string modified = m_source.GetProperty(FILE_PROPERTY_RESPONSE_HEADER, "Last-Modified");
+    struct __stat64 st;
+    if (modified.empty() && m_source.Stat(&st) == 0)
+      modified = std::to_string(st.st_mtime);
+
+    m_blockKey = CBlockCache::GetKey(m_sourcePath, m_fileSize, modified);
+    if (!m_block)
+      m_block.reset(new char[CBlockCache::BLOCK_SIZE]);
+    m_blockStart = -1;
+    m_blockFill = 0;
+  }
+
   if (!m_pCache)
   {
     if (CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_cacheMemSize == 0)
@@ -203,7 +239,11 @@ bool CFileCache::Open(const CURL& url)
         front /= 2;
         back /= 2;
       }
-      m_pCache = new CCircularCache(front, back);
+      const std::shared_ptr<CAdvancedSettings> advancedSettings = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings();
+      if (advancedSettings->m_cacheBackWindows > 0 && (m_flags & READ_AUDIO_VIDEO))
+        m_pCache = new CWindowedCache(front, back, advancedSettings->m_cacheLowWaterMark, advancedSettings->m_cacheBackWindows);
+      else
+        m_pCache = new CCircularCache(front, back);
       m_forwardCacheSize = front;
     }
 
@@ -256,6 +296,13 @@ void CFileCache::Process()
   CWriteRate limiter;
   CWriteRate average;
   bool cacheReachEOF = false;
+  XbmcThreads::EndTime adaptTimer(RANGE_ADAPT_INTERVAL_MS);
+
+  // position the next read from the source continues at
+  int64_t sourcePos = 0;
+
+  if (m_rangeReader)
+    m_rangeReader->Start(0, m_fileSize);
 
   while (!m_bStop)
   {
@@ -269,10 +316,13 @@ void CFileCache::Process()
       int64_t cacheMaxPos = m_pCache->CachedDataEndPosIfSeekTo(m_seekPos);
       cacheReachEOF = (cacheMaxPos == m_fileSize);
       bool sourceSeekFailed = false;
-      if (!cacheReachEOF)
+      // with the block cache the source is only repositioned once a block is missing
+      if (!cacheReachEOF && m_blockKey.empty())
       {
-        m_nSeekResult = m_source.Seek(cacheMaxPos, SEEK_SET);
-        if (m_nSeekResult != cacheMaxPos)
+        m_nSeekResult = SeekSource(cacheMaxPos);
+        if (m_nSeekResult == cacheMaxPos)
+          sourcePos = cacheMaxPos;
+        else
         {
           CLog::Log(LOGERROR,"CFileCache::Process - Error %d seeking. Seek returned %" PRId64, (int)GetLastError(), m_nSeekResult);
           m_seekPossible = m_source.IoControl(IOCTRL_SEEK_POSSIBLE, NULL);
@@ -330,8 +380,51 @@ void CFileCache::Process()
     }
 
     ssize_t iRead = 0;
-    if (!cacheReachEOF)
-      iRead = m_source.Read(buffer.get(), maxWrite);
+    bool fromBlockCache = false;
+    if (!cacheReachEOF && !m_blockKey.empty())
+    {
+      iRead = CBlockCache::GetInstance().Read(m_blockKey, m_writePos, buffer.get(), maxWrite);
+      fromBlockCache = iRead > 0;
+      if (!fromBlockCache)
+        iRead = 0;
+    }
+
+    if (!cacheReachEOF && !fromBlockCache)
+    {
+      // continue the source behind the data that came from the block cache
+      if (sourcePos != m_writePos && SeekSource(m_writePos) == m_writePos)
+        sourcePos = m_writePos;
+
+      if (sourcePos != m_writePos)
+      {
+        CLog::Log(LOGERROR, "CFileCache::Process - failed to continue source at %" PRId64, m_writePos);
+        iRead = -1;
+      }
+      else if (m_rangeReader)
+      {
+        iRead = m_rangeReader->Read(buffer.get(), maxWrite);
+        if (iRead == CParallelRangeReader::WOULD_BLOCK)
+          continue; // while (!m_bStop)
+
+        if (iRead < 0)
+        {
+          // continue on the regular connection, e.g. when the server refuses ranges
+          CLog::Log(LOGWARNING, "CFileCache::Process - range requests failed, falling back to a single connection");
+          m_rangeReader.reset();
+          if (m_source.Seek(sourcePos, SEEK_SET) == sourcePos)
+            continue; // while (!m_bStop)
+        }
+      }
+      else
+        iRead = m_source.Read(buffer.get(), maxWrite);
+
+      if (iRead > 0)
+      {
+        sourcePos += iRead;
+        if (!m_blockKey.empty())
+          StoreBlocks(m_writePos, buffer.get(), iRead);
+      }
+    }
     if (iRead == 0)
     {
       // Check for actual EOF and retry as long as we still have data in our cache
@@ -438,9 +531,82 @@ void CFileCache::Process()
     {
       m_bFilling = true;
     }
+
+    if (m_rangeReader && adaptTimer.IsTimePast())
+    {
+      const unsigned int targetRate = m_writeRate * CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_cacheReadFactor;
+      m_rangeReader->AdaptConnections(m_writeRateActual, targetRate, m_bFilling);
+      adaptTimer.Set(RANGE_ADAPT_INTERVAL_MS);
+    }
+  }
+}
+
+int64_t CFileCache::SeekSource(int64_t iFilePosition)
+{
+  if (m_rangeReader)
+  {
+    m_rangeReader->Start(iFilePosition, m_fileSize);
+    return iFilePosition;
+  }
+
+  return m_source.Seek(iFilePosition, SEEK_SET);
+}
+
+void CFileCache::StoreBlocks(int64_t iFilePosition, const char* data, size_t size)
+{
+  const int64_t blockSize = CBlockCache::BLOCK_SIZE;
+
+  while (size > 0)
+  {
+    if (m_blockStart < 0 || iFilePosition != m_blockStart + static_cast<int64_t>(m_blockFill))
+    {
+      // not continuous, only whole blocks are stored so resync on the next
+      // block boundary
+      const int64_t next = (iFilePosition + blockSize - 1) / blockSize * blockSize;
+      if (next - iFilePosition >= static_cast<int64_t>(size))
+      {
+        m_blockStart = -1;
+        return;
+      }
+
+      data += next - iFilePosition;
+      size -= next - iFilePosition;
+      iFilePosition = next;
+      m_blockStart = next;
+      m_blockFill = 0;
+    }
+
+    const size_t len = std::min(size, CBlockCache::BLOCK_SIZE - m_blockFill);
+    memcpy(m_block.get() + m_blockFill, data, len);
+    m_blockFill += len;
+    iFilePosition += len;
+    data += len;
+    size -= len;
+
+    if (m_blockFill == CBlockCache::BLOCK_SIZE || m_blockStart + static_cast<int64_t>(m_blockFill) == m_fileSize)
+    {
+      CBlockCache::GetInstance().Store(m_blockKey, m_blockStart / blockSize, m_block.get(), m_blockFill);
+      m_blockStart += m_blockFill;
+      m_blockFill = 0;
+    }
   }
 }
 
+bool CFileCache::CanUseRangeReader(const CURL& url)
+{
+  if (CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_cacheMaxConnections <= 1)
+    return false;
+
+  // ranges are requested through curl's http implementation and need a
+  // resource of known size
+  if (!url.IsProtocol("http") && !url.IsProtocol("https") &&
+      !url.IsProtocol("dav") && !url.IsProtocol("davs"))
+    return false;
+
+  return m_seekPossible > 0 && m_fileSize > 0 &&
+         dynamic_cast<CCurlFile*>(m_source.GetImplementation()) != nullptr;
+}
+
 void CFileCache::OnExit()
 {
   m_bStop = true;
@@ -463,6 +629,11 @@ int CFileCache::Stat(const CURL& url, struct __stat64* buffer)
   return CFile::Stat(url.Get(), buffer);
 }
 
+int CFileCache::Stat(struct __stat64* buffer)
+{
+  return m_source.Stat(buffer);
+}
+
 ssize_t CFileCache::Read(void* lpBuf, size_t uiBufSize)
 {
   CSingleLock lock(m_sync);
@@ -572,6 +743,16 @@ void CFileCache::Close()
   if (m_pCache)
     m_pCache->Close();
 
+  if (!m_blockKey.empty())
+  {
+    const SBlockCacheStats stats = CBlockCache::GetInstance().GetStats();
+    CLog::Log(LOGDEBUG, "CFileCache::Close - block cache hit rate %.1f%% (%" PRIu64 " bytes read, %" PRIu64 " stored, %" PRIu64 " on disk)",
+              stats.hits + stats.misses > 0 ? 100.0 * stats.hits / (stats.hits + stats.misses) : 0.0,
+              stats.bytesRead, stats.bytesStored, stats.size);
+    m_blockKey.clear();
+  }
+
+  m_rangeReader.reset();
   m_source.Close();
 }
 
@@ -623,5 +804,62 @@ int CFileCache::IoControl(EIoControl request, void* param)
   if (request == IOCTRL_SEEK_POSSIBLE)
     return m_seekPossible;
 
+  if (request == IOCTRL_CACHE_LEND)
+  {
+    CSingleLock lock(m_sync);
+    if (!m_pCache || !m_pCache->CanLend())
+      return -1;
+    if (!param)
+      return 0;
+    return LendFromCache(*static_cast<SCacheLend*>(param));
+  }
+
+  if (request == IOCTRL_CACHE_RETURN)
+  {
+    CSingleLock lock(m_sync);
+    if (!m_pCache)
+      return -1;
+    const size_t size = static_cast<SCacheLend*>(param)->size;
+    m_pCache->ReturnToCache(size);
+    m_readPos += size;
+    return 0;
+  }
+
+  return -1;
+}
+
+int CFileCache::LendFromCache(SCacheLend& lend)
+{
+  // same waiting rules as Read
+  const char* data = nullptr;
+  int64_t iRc;
+
+retry:
+  iRc = m_pCache->LendFromCache(&data, std::min<size_t>(lend.size, INT_MAX));
+  if (iRc > 0)
+  {
+    lend.data = reinterpret_cast<const uint8_t*>(data);
+    lend.size = static_cast<size_t>(iRc);
+    return 0;
+  }
+
+  if (iRc == CACHE_RC_WOULD_BLOCK)
+  {
+    iRc = m_pCache->WaitForData(1, 10000);
+    if (iRc > 0)
+      goto retry;
+  }
+
+  if (iRc == 0)
+  {
+    lend.data = nullptr;
+    lend.size = 0;
+    return 0;
+  }
+
+  if (iRc == CACHE_RC_TIMEOUT)
+    CLog::Log(LOGWARNING, "%s - timeout waiting for data", __FUNCTION__);
+  else
+    CLog::Log(LOGERROR, "%s - cache strategy returned unknown error code %d", __FUNCTION__, (int)iRc);
   return -1;
 }
@@ -14,9 +14,11 @@
 #include "File.h"
 #include "threads/Thread.h"
 #include <atomic>
+#include <memory>
 
 namespace XFILE
 {
+  class CParallelRangeReader;
 
   class CFileCache : public IFile, public CThread
   {
@@ -37,6 +39,7 @@ namespace XFILE
     void Close() override;
     bool Exists(const CURL& url) override;
     int Stat(const CURL& url, struct __stat64* buffer) override;
+    int Stat(struct __stat64* buffer) override;
 
     ssize_t Read(void* lpBuf, size_t uiBufSize) override;
 
@@ -56,10 +59,20 @@ namespace XFILE
     }
 
   private:
+    bool CanUseRangeReader(const CURL& url);
+    int64_t SeekSource(int64_t iFilePosition);
+    void StoreBlocks(int64_t iFilePosition, const char* data, size_t size);
+    int LendFromCache(SCacheLend& lend);
+
     CCacheStrategy *m_pCache;
     bool m_bDeleteCache;
     int m_seekPossible;
     CFile m_source;
+    std::unique_ptr<CParallelRangeReader> m_rangeReader;
+    std::string m_blockKey;
+    std::unique_ptr<char[]> m_block;
+    int64_t m_blockStart;
+    size_t m_blockFill;
     std::string m_sourcePath;
     CEvent m_seekEvent;
     CEvent m_seekEnded;
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <stddef.h>
 #include <stdint.h>
 
 namespace XFILE
@@ -54,6 +55,13 @@ struct SCacheStatus
   bool     lowspeed; /**< cache low speed condition detected? */
 };
 
+struct SCacheLend
+{
+  const uint8_t* data; /**< out: cached data at the read position, valid until returned */
+  size_t size;         /**< in: bytes wanted, out: bytes available at data (IOCTRL_CACHE_LEND),
+                            in: bytes consumed (IOCTRL_CACHE_RETURN) */
+};
+
 typedef enum {
   IOCTRL_NATIVE        = 1,  /**< SNativeIoControl structure, containing what should be passed to native ioctrl */
   IOCTRL_SEEK_POSSIBLE = 2,  /**< return 0 if known not to work, 1 if it should work */
@@ -61,6 +69,8 @@ typedef enum {
   IOCTRL_CACHE_SETRATE = 4,  /**< unsigned int with speed limit for caching in bytes per second */
   IOCTRL_SET_CACHE     = 8,  /**< CFileCache */
   IOCTRL_SET_RETRY     = 16, /**< Enable/disable retry within the protocol handler (if supported) */
+  IOCTRL_CACHE_LEND    = 32, /**< SCacheLend structure, borrow cached data instead of copying it. NULL to query support */
+  IOCTRL_CACHE_RETURN  = 33, /**< SCacheLend structure, give back data borrowed with IOCTRL_CACHE_LEND */
 } EIoControl;
 
 enum CURLOPTIONTYPE
@@ -0,0 +1,299 @@
+/*
+ *  Copyright (C) 2019 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "ParallelRangeReader.h"
+#include "CurlFile.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "threads/Thread.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <string.h>
+
+using namespace XFILE;
+
+namespace
+{
+// how long Read waits for data before returning WOULD_BLOCK
+constexpr unsigned int WAIT_SLICE_MS = 100;
+// size of a single read from a range connection
+constexpr size_t FETCH_CHUNK_SIZE = 64 * 1024;
+// connections opened per range before the range is given up
+constexpr unsigned int FETCH_ATTEMPTS = 2;
+}
+
+class CParallelRangeReader::CWorker : public CThread
+{
+public:
+  CWorker(CParallelRangeReader& reader, unsigned int index)
+    : CThread("RangeReader")
+    , m_reader(reader)
+    , m_index(index)
+  {
+  }
+
+protected:
+  void Process() override
+  {
+    m_reader.Fetch(m_index);
+  }
+
+private:
+  CParallelRangeReader& m_reader;
+  unsigned int m_index;
+};
+
+CParallelRangeReader::CParallelRangeReader(const CURL& url, unsigned int maxConnections, unsigned int segmentSize)
+  : m_url(url)
+  , m_maxConnections(std::max(maxConnections, 1u))
+  , m_segmentSize(std::max(segmentSize, 1u))
+  , m_connections(std::min(m_maxConnections, 2u))
+{
+}
+
+CParallelRangeReader::~CParallelRangeReader()
+{
+  Stop();
+}
+
+void CParallelRangeReader::Stop()
+{
+  {
+    CSingleLock lock(m_section);
+    m_stop = true;
+    m_workCond.notifyAll();
+    m_dataCond.notifyAll();
+  }
+
+  for (auto& worker : m_workers)
+    worker->StopThread(true);
+  m_workers.clear();
+}
+
+void CParallelRangeReader::Start(int64_t position, int64_t fileSize)
+{
+  CSingleLock lock(m_section);
+
+  // workers still busy with a discarded segment notice the new generation
+  // on their next read and drop it
+  m_generation++;
+  m_segments.clear();
+  m_position = position;
+  m_nextStart = position;
+  m_fileSize = fileSize;
+
+  if (m_workers.empty())
+  {
+    for (unsigned int i = 0; i < m_maxConnections; i++)
+    {
+      m_workers.emplace_back(new CWorker(*this, i));
+      m_workers.back()->Create();
+    }
+  }
+
+  m_workCond.notifyAll();
+}
+
+ssize_t CParallelRangeReader::Read(void* buf, size_t size)
+{
+  CSingleLock lock(m_section);
+
+  std::shared_ptr<SSegment> segment;
+  size_t offset = 0;
+  size_t avail = 0;
+
+  XbmcThreads::EndTime timeout(WAIT_SLICE_MS);
+  while (true)
+  {
+    if (m_position >= m_fileSize)
+      return 0;
+
+    if (!m_segments.empty())
+    {
+      segment = m_segments.front();
+      offset = static_cast<size_t>(m_position - segment->range.GetFirstPosition());
+      avail = segment->filled - offset;
+      if (avail > 0)
+        break;
+      if (segment->failed)
+        return -1;
+    }
+
+    if (timeout.IsTimePast())
+      return WOULD_BLOCK;
+    m_dataCond.wait(lock, timeout.MillisLeft());
+  }
+
+  size = std::min(size, avail);
+
+  // the published part of a segment isn't touched by the worker anymore and
+  // only this thread removes segments, so the copy doesn't need the lock
+  lock.Leave();
+  memcpy(buf, segment->data.get() + offset, size);
+  lock.Enter();
+
+  m_position += size;
+  if (offset + size == segment->range.GetLength())
+  {
+    m_segments.pop_front();
+    m_workCond.notifyAll();
+  }
+
+  return size;
+}
+
+int64_t CParallelRangeReader::GetPosition() const
+{
+  CSingleLock lock(m_section);
+  return m_position;
+}
+
+void CParallelRangeReader::SetConnections(unsigned int connections)
+{
+  CSingleLock lock(m_section);
+  SetConnectionsLocked(connections);
+}
+
+unsigned int CParallelRangeReader::GetConnections() const
+{
+  CSingleLock lock(m_section);
+  return m_connections;
+}
+
+void CParallelRangeReader::AdaptConnections(unsigned int rate, unsigned int targetRate, bool filling)
+{
+  CSingleLock lock(m_section);
+
+  if (!filling)
+  {
+    // the cache is full, fewer connections keep it full as well
+    if (m_connections > 1)
+      SetConnectionsLocked(m_connections - 1);
+    m_rateAtIncrease = 0;
+  }
+  else if (rate < targetRate && m_connections < m_maxConnections)
+  {
+    // only keep adding connections as long as that improves the rate, a
+    // link that is saturated does not get faster with more of them
+    if (m_rateAtIncrease == 0 || rate > m_rateAtIncrease + m_rateAtIncrease / 10)
+    {
+      SetConnectionsLocked(m_connections + 1);
+      m_rateAtIncrease = rate;
+    }
+  }
+}
+
+void CParallelRangeReader::SetConnectionsLocked(unsigned int connections)
+{
+  connections = std::max(1u, std::min(connections, m_maxConnections));
+  if (connections == m_connections)
+    return;
+
+  CLog::Log(LOGDEBUG, "CParallelRangeReader - using %u connections for %s", connections, m_url.GetRedacted().c_str());
+  m_connections = connections;
+  m_workCond.notifyAll();
+}
+
+bool CParallelRangeReader::CanFetch(unsigned int index) const
+{
+  // limit the data fetched ahead of the reader to two segments per connection
+  return index < m_connections &&
+         m_nextStart < m_fileSize &&
+         m_segments.size() < 2 * m_connections;
+}
+
+void CParallelRangeReader::Fetch(unsigned int index)
+{
+  while (true)
+  {
+    std::shared_ptr<SSegment> segment;
+    unsigned int generation;
+
+    {
+      CSingleLock lock(m_section);
+      while (!m_stop && !CanFetch(index))
+        m_workCond.wait(lock);
+
+      if (m_stop)
+        return;
+
+      const int64_t last = std::min(m_nextStart + m_segmentSize, m_fileSize) - 1;
+      segment = std::make_shared<SSegment>();
+      segment->range = CHttpRange(m_nextStart, last);
+      segment->data.reset(new char[segment->range.GetLength()]);
+      m_nextStart = last + 1;
+      m_segments.push_back(segment);
+      generation = m_generation;
+    }
+
+    if (!FetchSegment(*segment, generation))
+    {
+      CSingleLock lock(m_section);
+      CLog::Log(LOGERROR, "CParallelRangeReader - failed to fetch range %" PRIu64 "-%" PRIu64 " of %s",
+                segment->range.GetFirstPosition(), segment->range.GetLastPosition(),
+                m_url.GetRedacted().c_str());
+      segment->failed = true;
+      m_dataCond.notifyAll();
+    }
+  }
+}
+
+bool CParallelRangeReader::FetchSegment(SSegment& segment, unsigned int generation)
+{
+  const size_t length = static_cast<size_t>(segment.range.GetLength());
+  size_t filled = 0;
+
+  for (unsigned int attempt = 0; attempt < FETCH_ATTEMPTS; attempt++)
+  {
+    // continue where a broken connection stopped
+    std::unique_ptr<IFile> file = OpenRange(CHttpRange(segment.range.GetFirstPosition() + filled,
+                                                       segment.range.GetLastPosition()));
+    if (!file)
+      continue;
+
+    while (filled < length)
+    {
+      ssize_t read = file->Read(segment.data.get() + filled, std::min(length - filled, FETCH_CHUNK_SIZE));
+      if (read <= 0)
+        break;
+      filled += read;
+
+      CSingleLock lock(m_section);
+      // dropped by Start or Stop, nobody is interested anymore
+      if (m_stop || generation != m_generation)
+        return true;
+      segment.filled = filled;
+      m_dataCond.notifyAll();
+    }
+
+    if (filled == length)
+      return true;
+  }
+
+  return false;
+}
+
+std::unique_ptr<IFile> CParallelRangeReader::OpenRange(const CHttpRange& range)
+{
+  std::unique_ptr<CCurlFile> file(new CCurlFile());
+  file->SetRequestHeader("Range", HttpRangeUtils::GenerateRangeHeaderValue(&range));
+
+  if (!file->Open(m_url))
+    return nullptr;
+
+  // a server that ignores the range answers with the whole resource
+  if (file->GetLength() != static_cast<int64_t>(range.GetLength()))
+  {
+    CLog::Log(LOGERROR, "CParallelRangeReader - server did not honour range %" PRIu64 "-%" PRIu64 " of %s",
+              range.GetFirstPosition(), range.GetLastPosition(), m_url.GetRedacted().c_str());
+    return nullptr;
+  }
+
+  return std::move(file);
+}
@@ -0,0 +1,114 @@
+/*
+ *  Copyright (C) 2019 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "IFile.h"
+#include "URL.h"
+#include "threads/Condition.h"
+#include "threads/CriticalSection.h"
+#include "utils/HttpRangeUtils.h"
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+namespace XFILE
+{
+
+/*!
+ \brief Reads a http(s)/dav(s) resource through several concurrent byte range requests
+
+ The file is split into segments which are fetched by a pool of worker
+ threads, each issuing its own "Range: bytes=first-last" request through
+ CCurlFile. Read returns the data strictly in file order, so the caller sees
+ a plain sequential stream. The number of active connections can be changed
+ at any time, AdaptConnections implements the policy used by CFileCache.
+
+ Start, Read and the connection setters must be called from one thread.
+ */
+class CParallelRangeReader
+{
+public:
+  CParallelRangeReader(const CURL& url, unsigned int maxConnections,
+                       unsigned int segmentSize = DEFAULT_SEGMENT_SIZE);
+  virtual ~CParallelRangeReader();
+
+  /*!
+   \brief Discard everything fetched so far and continue at position
+   */
+  void Start(int64_t position, int64_t fileSize);
+
+  /*!
+   \brief Read the next data in file order
+   \return bytes read, 0 at end of file, WOULD_BLOCK if no data arrived within
+           a short wait or -1 if a range could not be fetched
+   */
+  ssize_t Read(void* buf, size_t size);
+
+  int64_t GetPosition() const;
+
+  void SetConnections(unsigned int connections);
+  unsigned int GetConnections() const;
+  unsigned int GetMaxConnections() const { return m_maxConnections; }
+
+  /*!
+   \brief Adjust the number of connections to the measured rate
+   \param rate current fill rate of the cache in bytes per second
+   \param targetRate rate the cache wants to be filled with
+   \param filling true as long as the cache is not (nearly) full
+   */
+  void AdaptConnections(unsigned int rate, unsigned int targetRate, bool filling);
+
+  static constexpr ssize_t WOULD_BLOCK = -2;
+  static constexpr unsigned int DEFAULT_SEGMENT_SIZE = 2 * 1024 * 1024;
+
+protected:
+  /*!
+   \brief Open a file delivering exactly the bytes of range
+   \return the opened file or nullptr on failure
+   */
+  virtual std::unique_ptr<IFile> OpenRange(const CHttpRange& range);
+
+  void Stop();
+
+private:
+  class CWorker;
+
+  struct SSegment
+  {
+    CHttpRange range;
+    std::unique_ptr<char[]> data;
+    size_t filled = 0;
+    bool failed = false;
+  };
+
+  void Fetch(unsigned int index);
+  bool FetchSegment(SSegment& segment, unsigned int generation);
+  bool CanFetch(unsigned int index) const;
+  void SetConnectionsLocked(unsigned int connections);
+
+  CURL m_url;
+  const unsigned int m_maxConnections;
+  const unsigned int m_segmentSize;
+
+  mutable CCriticalSection m_section;
+  XbmcThreads::ConditionVariable m_dataCond;
+  XbmcThreads::ConditionVariable m_workCond;
+  std::deque<std::shared_ptr<SSegment>> m_segments;
+  std::vector<std::unique_ptr<CWorker>> m_workers;
+  int64_t m_position = 0;
+  int64_t m_nextStart = 0;
+  int64_t m_fileSize = 0;
+  unsigned int m_generation = 0;
+  unsigned int m_connections;
+  unsigned int m_rateAtIncrease = 0;
+  bool m_stop = false;
+};
+
+} // namespace XFILE
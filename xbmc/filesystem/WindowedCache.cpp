@@ -0,0 +1,416 @@
+/*
+ *  Copyright (C) 2019 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "WindowedCache.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+
+#include <algorithm>
+#include <string.h>
+
+using namespace XFILE;
+
+namespace
+{
+// poll interval of a waiting reader, data below the low water mark is
+// picked up with at most this delay
+constexpr unsigned int WAIT_SLICE_MS = 50;
+}
+
+CWindowedCache::CWindowedCache(size_t front, size_t back, size_t lowWaterMark, unsigned int windows)
+ : CCacheStrategy()
+ , m_beg(0)
+ , m_end(0)
+ , m_cur(0)
+ , m_waitTarget(-1)
+ , m_buf(nullptr)
+ , m_size(front + back)
+ , m_size_back(back)
+ , m_lowWaterMark(std::min(lowWaterMark, front))
+ , m_windowSize(back)
+ , m_windows(windows)
+{
+}
+
+CWindowedCache::~CWindowedCache()
+{
+  Close();
+}
+
+int CWindowedCache::Open()
+{
+  m_buf = new uint8_t[m_size];
+  m_beg = 0;
+  m_end = 0;
+  m_cur = 0;
+  m_waitTarget = -1;
+  return CACHE_RC_OK;
+}
+
+void CWindowedCache::Close()
+{
+  CSingleLock lock(m_sync);
+
+  delete[] m_buf;
+  m_buf = nullptr;
+
+  for (auto& window : m_windows)
+  {
+    window.buf.reset();
+    window.beg = window.end = 0;
+  }
+}
+
+size_t CWindowedCache::GetWriteLimit(int64_t beg, int64_t cur, int64_t end) const
+{
+  size_t back  = (size_t)(cur - beg); // Backbuffer size
+  size_t front = (size_t)(end - cur); // Frontbuffer size
+  return m_size - std::min(back, m_size_back) - front;
+}
+
+size_t CWindowedCache::GetMaxWriteSize(const size_t& iRequestSize)
+{
+  // the reader only ever moves m_cur forward outside of the lock, so this is
+  // a conservative estimate
+  size_t limit = GetWriteLimit(m_beg, m_cur, m_end);
+
+  // Never return more than limit and size requested by caller
+  return std::min(iRequestSize, limit);
+}
+
+/**
+ * Same contract as CCircularCache::WriteToCache. Space is reserved under the
+ * lock, so a concurrent backward Seek can't move the reader into the region
+ * that is about to be overwritten. The copy itself is done unlocked and
+ * published by advancing m_end.
+ */
+int CWindowedCache::WriteToCache(const char *buf, size_t len)
+{
+  // only the writer changes m_end outside of Reset
+  const int64_t end = m_end;
+  size_t pos = end % m_size;
+
+  {
+    CSingleLock lock(m_sync);
+
+    size_t limit = GetWriteLimit(m_beg, m_cur, end);
+    size_t wrap  = m_size - pos;
+
+    // limit by max forward size
+    if (len > limit)
+      len = limit;
+
+    // limit to wrap point
+    if (len > wrap)
+      len = wrap;
+
+    if (len == 0)
+      return 0;
+
+    // drop history that is going to be overwritten
+    if (end + (int64_t)len - m_beg > (int64_t)m_size)
+      m_beg = end + len - m_size;
+  }
+
+  memcpy(m_buf + pos, buf, len);
+  m_end = end + len;
+
+  const int64_t target = m_waitTarget;
+  if (target >= 0 && end + (int64_t)len >= target)
+    m_written.Set();
+
+  return len;
+}
+
+/**
+ * Reads data from cache. Will only read up till
+ * the buffer wrap point. So multiple calls
+ * may be needed to empty the whole cache
+ */
+int CWindowedCache::ReadFromCache(char *buf, size_t len)
+{
+  // only the reader changes m_cur outside of Reset
+  const int64_t cur = m_cur;
+  const int64_t end = m_end;
+
+  size_t pos   = cur % m_size;
+  size_t front = (size_t)(end - cur);
+  size_t avail = std::min(m_size - pos, front);
+
+  if (avail == 0)
+  {
+    if (IsEndOfInput())
+      return 0;
+    else
+      return CACHE_RC_WOULD_BLOCK;
+  }
+
+  if (len > avail)
+    len = avail;
+
+  if (len == 0)
+    return 0;
+
+  const size_t limitBefore = GetWriteLimit(m_beg, cur, end);
+
+  memcpy(buf, m_buf + pos, len);
+  m_cur = cur + len;
+
+  // the writer polls for space anyway, only wake it up if the read made
+  // room for a reasonably sized write
+  if (limitBefore < m_lowWaterMark && GetWriteLimit(m_beg, cur + len, end) >= m_lowWaterMark)
+    m_space.Set();
+
+  return len;
+}
+
+int CWindowedCache::LendFromCache(const char **buf, size_t len)
+{
+  const int64_t cur = m_cur;
+  const int64_t end = m_end;
+
+  size_t pos   = cur % m_size;
+  size_t front = (size_t)(end - cur);
+  size_t avail = std::min(m_size - pos, front);
+
+  if (avail == 0)
+  {
+    if (IsEndOfInput())
+      return 0;
+    else
+      return CACHE_RC_WOULD_BLOCK;
+  }
+
+  if (len > avail)
+    len = avail;
+
+  // the writer stays behind m_cur, the region is stable until returned
+  *buf = reinterpret_cast<const char*>(m_buf) + pos;
+  return len;
+}
+
+void CWindowedCache::ReturnToCache(size_t len)
+{
+  const int64_t cur = m_cur;
+  const int64_t end = m_end;
+
+  len = std::min(len, (size_t)(end - cur));
+  const size_t limitBefore = GetWriteLimit(m_beg, cur, end);
+
+  m_cur = cur + len;
+
+  if (limitBefore < m_lowWaterMark && GetWriteLimit(m_beg, cur + len, end) >= m_lowWaterMark)
+    m_space.Set();
+}
+
+/* Wait "millis" milliseconds for "minimum" amount of data to come in.
+ * Note that caller needs to make sure there's sufficient space in the forward
+ * buffer for "minimum" bytes else we may block the full timeout time
+ */
+int64_t CWindowedCache::WaitForData(unsigned int minimum, unsigned int millis)
+{
+  int64_t avail = m_end - m_cur;
+
+  if (millis == 0 || IsEndOfInput())
+    return avail;
+
+  if (minimum > m_size - m_size_back)
+    minimum = m_size - m_size_back;
+
+  // ask to be woken up only once a reasonable amount of data is available
+  const int64_t target = std::max<int64_t>(minimum, m_lowWaterMark);
+
+  XbmcThreads::EndTime endtime(millis);
+  while (!IsEndOfInput() && avail < minimum && !endtime.IsTimePast())
+  {
+    m_waitTarget = m_cur + target;
+
+    // check again after announcing, the writer may have finished meanwhile
+    avail = m_end - m_cur;
+    if (avail >= target)
+      break;
+
+    m_written.WaitMSec(std::min(WAIT_SLICE_MS, endtime.MillisLeft()));
+    avail = m_end - m_cur;
+  }
+  m_waitTarget = -1;
+
+  return avail;
+}
+
+int64_t CWindowedCache::Seek(int64_t pos)
+{
+  CSingleLock lock(m_sync);
+
+  // if seek is a bit over what we have, try to wait a few seconds for the data to be available.
+  // we try to avoid a (heavy) seek on the source
+  if (pos >= m_end && pos < m_end + 100000)
+  {
+    /* Make everything in the cache (back & forward) back-cache, to make sure
+     * there's sufficient forward space. Increasing it with only 100000 may not be
+     * sufficient due to variable filesystem chunksize
+     */
+    m_cur = m_end.load();
+    lock.Leave();
+    WaitForData((size_t)(pos - m_cur), 5000);
+    lock.Enter();
+  }
+
+  if (pos >= m_beg && pos <= m_end)
+  {
+    m_cur = pos;
+    return pos;
+  }
+
+  // positions in a back window are restored by Reset on the writer thread
+  return CACHE_RC_ERROR;
+}
+
+bool CWindowedCache::Reset(int64_t pos, bool clearAnyway)
+{
+  CSingleLock lock(m_sync);
+  if (!clearAnyway && pos >= m_beg && pos <= m_end)
+  {
+    m_cur = pos;
+    return false;
+  }
+
+  // look the window up first, CFileCache continues the source at the end
+  // CachedDataEndPosIfSeekTo reported for it, retaining must not drop it
+  SWindow* window = clearAnyway ? nullptr : FindWindow(pos);
+
+  RetainWindow(window);
+
+  if (window)
+  {
+    RestoreWindow(*window, pos);
+    return false;
+  }
+
+  m_end = pos;
+  m_beg = pos;
+  m_cur = pos;
+
+  return true;
+}
+
+void CWindowedCache::EndOfInput()
+{
+  CCacheStrategy::EndOfInput();
+  m_written.Set();
+}
+
+int64_t CWindowedCache::CachedDataEndPosIfSeekTo(int64_t iFilePosition)
+{
+  CSingleLock lock(m_sync);
+
+  if (iFilePosition >= m_beg && iFilePosition <= m_end)
+    return m_end;
+
+  SWindow* window = FindWindow(iFilePosition);
+  if (window)
+    return window->end;
+
+  return iFilePosition;
+}
+
+int64_t CWindowedCache::CachedDataEndPos()
+{
+  return m_end;
+}
+
+bool CWindowedCache::IsCachedPosition(int64_t iFilePosition)
+{
+  CSingleLock lock(m_sync);
+
+  if (iFilePosition >= m_beg && iFilePosition <= m_end)
+    return true;
+
+  return FindWindow(iFilePosition) != nullptr;
+}
+
+CCacheStrategy *CWindowedCache::CreateNew()
+{
+  return new CWindowedCache(m_size - m_size_back, m_size_back, m_lowWaterMark, m_windows.size());
+}
+
+CWindowedCache::SWindow* CWindowedCache::FindWindow(int64_t pos)
+{
+  for (auto& window : m_windows)
+  {
+    if (window.buf && pos >= window.beg && pos < window.end)
+    {
+      window.lastUse = ++m_windowUse;
+      return &window;
+    }
+  }
+  return nullptr;
+}
+
+void CWindowedCache::RetainWindow(const SWindow* keep)
+{
+  if (m_windows.empty() || !m_buf || m_end == m_beg)
+    return;
+
+  // mostly keep what comes after the read position, that is what a seek back
+  // to where we left wants to continue with
+  int64_t beg = std::max<int64_t>(m_beg, m_cur - (int64_t)m_windowSize / 4);
+  int64_t end = std::min<int64_t>(m_end, beg + m_windowSize);
+  if (end <= beg)
+    return;
+
+  // drop windows that overlap the new one, pick the least recently used slot
+  SWindow* slot = nullptr;
+  for (auto& window : m_windows)
+  {
+    if (&window == keep)
+      continue;
+
+    if (window.buf && window.beg < end && beg < window.end)
+      window.beg = window.end = 0;
+
+    if (!slot || window.end == window.beg ||
+        (slot->end != slot->beg && window.lastUse < slot->lastUse))
+      slot = &window;
+  }
+
+  if (!slot)
+    return;
+
+  if (!slot->buf)
+    slot->buf.reset(new uint8_t[m_windowSize]);
+
+  CopyFromBuffer(slot->buf.get(), beg, end - beg);
+  slot->beg = beg;
+  slot->end = end;
+  slot->lastUse = ++m_windowUse;
+}
+
+void CWindowedCache::RestoreWindow(SWindow& window, int64_t pos)
+{
+  CopyToBuffer(window.beg, window.buf.get(), window.end - window.beg);
+  m_beg = window.beg;
+  m_end = window.end;
+  m_cur = pos;
+}
+
+void CWindowedCache::CopyFromBuffer(uint8_t* dst, int64_t pos, size_t len) const
+{
+  size_t offset = pos % m_size;
+  size_t first = std::min(len, m_size - offset);
+  memcpy(dst, m_buf + offset, first);
+  memcpy(dst + first, m_buf, len - first);
+}
+
+void CWindowedCache::CopyToBuffer(int64_t pos, const uint8_t* src, size_t len)
+{
+  size_t offset = pos % m_size;
+  size_t first = std::min(len, m_size - offset);
+  memcpy(m_buf + offset, src, first);
+  memcpy(m_buf, src + first, len - first);
+}
@@ -0,0 +1,92 @@
+/*
+ *  Copyright (C) 2019 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "CacheStrategy.h"
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace XFILE {
+
+/*!
+ \brief Circular memory cache with a lock free data path and retained back windows
+
+ Works like CCircularCache, but
+  - reader and writer exchange data through atomic positions, only seeking
+    and the writer's reservation of buffer space take the lock
+  - a waiting reader is only woken up once the low water mark is available
+    (or its minimum after a short poll), instead of on every write
+  - when a seek discards the buffered data, the region around the read
+    position is kept in one of several back windows. Seeking into a window
+    later restores it into the buffer, the source only continues at its end.
+ */
+class CWindowedCache : public CCacheStrategy
+{
+public:
+  CWindowedCache(size_t front, size_t back, size_t lowWaterMark, unsigned int windows);
+  ~CWindowedCache() override;
+
+  int Open() override;
+  void Close() override;
+
+  size_t GetMaxWriteSize(const size_t& iRequestSize) override;
+  int WriteToCache(const char *buf, size_t len) override;
+  int ReadFromCache(char *buf, size_t len) override;
+  int64_t WaitForData(unsigned int minimum, unsigned int iMillis) override;
+
+  bool CanLend() override { return true; }
+  int LendFromCache(const char **buf, size_t len) override;
+  void ReturnToCache(size_t len) override;
+
+  int64_t Seek(int64_t pos) override;
+  bool Reset(int64_t pos, bool clearAnyway=true) override;
+  void EndOfInput() override;
+
+  int64_t CachedDataEndPosIfSeekTo(int64_t iFilePosition) override;
+  int64_t CachedDataEndPos() override;
+  bool IsCachedPosition(int64_t iFilePosition) override;
+
+  CCacheStrategy *CreateNew() override;
+
+protected:
+  struct SWindow
+  {
+    int64_t beg = 0;
+    int64_t end = 0;
+    unsigned int lastUse = 0;
+    std::unique_ptr<uint8_t[]> buf;
+  };
+
+  size_t GetWriteLimit(int64_t beg, int64_t cur, int64_t end) const;
+  SWindow* FindWindow(int64_t pos);
+  void RetainWindow(const SWindow* keep);
+  void RestoreWindow(SWindow& window, int64_t pos);
+  void CopyFromBuffer(uint8_t* dst, int64_t pos, size_t len) const;
+  void CopyToBuffer(int64_t pos, const uint8_t* src, size_t len);
+
+  std::atomic<int64_t> m_beg;   /**< index in file (not buffer) of beginning of valid data */
+  std::atomic<int64_t> m_end;   /**< index in file (not buffer) of end of valid data */
+  std::atomic<int64_t> m_cur;   /**< current reading index in file */
+  std::atomic<int64_t> m_waitTarget; /**< file index a waiting reader wants to be woken up at, -1 if none */
+  uint8_t          *m_buf;       /**< buffer holding data */
+  size_t            m_size;      /**< size of data buffer used (m_buf) */
+  size_t            m_size_back; /**< guaranteed size of back buffer */
+  size_t            m_lowWaterMark;
+  size_t            m_windowSize;
+  unsigned int      m_windowUse = 0;
+  std::vector<SWindow> m_windows;
+  CCriticalSection  m_sync;
+  CEvent            m_written;
+};
+
+} // namespace XFILE
@@ -0,0 +1,101 @@
+/*
+ *  Copyright (C) 2019 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "filesystem/BlockCache.h"
+#include "filesystem/Directory.h"
+#include "filesystem/SpecialProtocol.h"
+#include "utils/URIUtils.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace XFILE;
+
+class TestBlockCache : public testing::Test
+{
+protected:
+  TestBlockCache()
+  {
+    m_path = URIUtils::AddFileToFolder(CSpecialProtocol::TranslatePath("special://temp/"), "TestBlockCache");
+    URIUtils::AddSlashAtEnd(m_path);
+    CDirectory::RemoveRecursive(m_path);
+  }
+
+  ~TestBlockCache() override
+  {
+    CDirectory::RemoveRecursive(m_path);
+  }
+
+  std::vector<char> MakeBlock(size_t size, char value)
+  {
+    return std::vector<char>(size, value);
+  }
+
+  std::string m_path;
+};
+
+TEST_F(TestBlockCache, Key)
+{
+  const std::string key = CBlockCache::GetKey("http://server/movie.mkv", 1000, "Tue, 01 Jan 2019 00:00:00 GMT");
+  EXPECT_EQ(key, CBlockCache::GetKey("http://server/movie.mkv", 1000, "Tue, 01 Jan 2019 00:00:00 GMT"));
+  EXPECT_NE(key, CBlockCache::GetKey("http://server/movie.mkv", 1001, "Tue, 01 Jan 2019 00:00:00 GMT"));
+  EXPECT_NE(key, CBlockCache::GetKey("http://server/movie.mkv", 1000, "Wed, 02 Jan 2019 00:00:00 GMT"));
+}
+
+TEST_F(TestBlockCache, StoreRead)
+{
+  CBlockCache cache(m_path, 8 * CBlockCache::BLOCK_SIZE);
+  const std::string key = CBlockCache::GetKey("http://server/file", 3 * CBlockCache::BLOCK_SIZE, "");
+
+  char buf[100];
+  EXPECT_EQ(-1, cache.Read(key, 0, buf, sizeof(buf)));
+
+  std::vector<char> block = MakeBlock(CBlockCache::BLOCK_SIZE, 7);
+  EXPECT_TRUE(cache.Store(key, 1, block.data(), block.size()));
+
+  EXPECT_EQ(-1, cache.Read(key, 0, buf, sizeof(buf)));
+  EXPECT_EQ(100, cache.Read(key, CBlockCache::BLOCK_SIZE + 10, buf, sizeof(buf)));
+  EXPECT_EQ(7, buf[99]);
+
+  // reads stop at the block end
+  EXPECT_EQ(50, cache.Read(key, 2 * CBlockCache::BLOCK_SIZE - 50, buf, sizeof(buf)));
+
+  SBlockCacheStats stats = cache.GetStats();
+  EXPECT_EQ(2u, stats.hits);
+  EXPECT_EQ(2u, stats.misses);
+  EXPECT_EQ(CBlockCache::BLOCK_SIZE, stats.size);
+
+  // a new instance finds the blocks on disk
+  CBlockCache reloaded(m_path, 8 * CBlockCache::BLOCK_SIZE);
+  EXPECT_EQ(100, reloaded.Read(key, CBlockCache::BLOCK_SIZE, buf, sizeof(buf)));
+}
+
+TEST_F(TestBlockCache, Evict)
+{
+  CBlockCache cache(m_path, 2 * CBlockCache::BLOCK_SIZE);
+  const std::string key = CBlockCache::GetKey("http://server/file", 10 * CBlockCache::BLOCK_SIZE, "");
+  std::vector<char> block = MakeBlock(CBlockCache::BLOCK_SIZE, 1);
+
+  EXPECT_TRUE(cache.Store(key, 0, block.data(), block.size()));
+  EXPECT_TRUE(cache.Store(key, 1, block.data(), block.size()));
+
+  // use block 0, so block 1 is the least recently used one
+  char buf[10];
+  EXPECT_EQ(10, cache.Read(key, 0, buf, sizeof(buf)));
+
+  EXPECT_TRUE(cache.Store(key, 2, block.data(), block.size()));
+  EXPECT_EQ(10, cache.Read(key, 0, buf, sizeof(buf)));
+  EXPECT_EQ(-1, cache.Read(key, CBlockCache::BLOCK_SIZE, buf, sizeof(buf)));
+  EXPECT_EQ(10, cache.Read(key, 2 * CBlockCache::BLOCK_SIZE, buf, sizeof(buf)));
+  EXPECT_EQ(2 * CBlockCache::BLOCK_SIZE, cache.GetStats().size);
+
+  cache.Clear();
+  EXPECT_EQ(0u, cache.GetStats().size);
+  EXPECT_EQ(-1, cache.Read(key, 0, buf, sizeof(buf)));
+}
@@ -0,0 +1,68 @@
+/*
+ *  Copyright (C) 2019 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "filesystem/CircularCache.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace XFILE;
+
+namespace
+{
+void Fill(CCircularCache& cache, int64_t& pos, size_t len)
+{
+  std::vector<char> data(len);
+  for (size_t i = 0; i < len; i++)
+    data[i] = static_cast<char>((pos + i) % 251);
+  size_t done = 0;
+  while (done < len)
+  {
+    int written = cache.WriteToCache(data.data() + done, len - done);
+    ASSERT_GT(written, 0);
+    done += written;
+  }
+  pos += len;
+}
+}
+
+TEST(TestCircularCache, Lend)
+{
+  CCircularCache cache(3000, 1000);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+  ASSERT_TRUE(cache.CanLend());
+
+  const char* data = nullptr;
+  EXPECT_EQ(CACHE_RC_WOULD_BLOCK, cache.LendFromCache(&data, 100));
+
+  int64_t pos = 0;
+  Fill(cache, pos, 3500);
+
+  // lending doesn't move the read position
+  ASSERT_EQ(100, cache.LendFromCache(&data, 100));
+  EXPECT_EQ(0, data[0]);
+  ASSERT_EQ(100, cache.LendFromCache(&data, 100));
+  EXPECT_EQ(0, data[0]);
+  cache.ReturnToCache(100);
+  ASSERT_EQ(100, cache.LendFromCache(&data, 100));
+  EXPECT_EQ(100, data[0]);
+  cache.ReturnToCache(3000);
+
+  // the region stops at the wrap point
+  Fill(cache, pos, 1500);
+  ASSERT_EQ(900, cache.LendFromCache(&data, 2000));
+  EXPECT_EQ(static_cast<char>(3100 % 251), data[0]);
+  cache.ReturnToCache(900);
+  ASSERT_EQ(1000, cache.LendFromCache(&data, 2000));
+  EXPECT_EQ(static_cast<char>(4000 % 251), data[0]);
+  cache.ReturnToCache(1000);
+
+  cache.EndOfInput();
+  EXPECT_EQ(0, cache.LendFromCache(&data, 100));
+}
@@ -0,0 +1,139 @@
+/*
+ *  Copyright (C) 2019 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "threads/Thread.h"
+#include "utils/URIUtils.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace XFILE;
+
+namespace
+{
+const size_t FILE_SIZE = 8 * 1024 * 1024;
+const int PACKET = 64 * 1024; // bytes the demuxer asks avio for at once
+
+// the avio read callback of the demuxer, see CDVDDemuxFFmpeg::ReadInput
+int ReadInput(CFile& file, bool lend, uint8_t* buf, int size)
+{
+  if (!lend)
+    return static_cast<int>(file.Read(buf, size));
+
+  SCacheLend borrowed = { nullptr, static_cast<size_t>(size) };
+  if (file.IoControl(IOCTRL_CACHE_LEND, &borrowed) < 0)
+    return -1;
+  if (borrowed.size > 0)
+  {
+    memcpy(buf, borrowed.data, borrowed.size);
+    file.IoControl(IOCTRL_CACHE_RETURN, &borrowed);
+  }
+  return static_cast<int>(borrowed.size);
+}
+}
+
+class TestFileCache : public testing::Test
+{
+protected:
+  TestFileCache()
+  {
+    m_path = URIUtils::AddFileToFolder(CSpecialProtocol::TranslatePath("special://temp/"), "TestFileCache.bin");
+
+    std::vector<char> data(FILE_SIZE);
+    for (size_t i = 0; i < FILE_SIZE; i++)
+      data[i] = static_cast<char>(i % 251);
+    CFile file;
+    if (file.OpenForWrite(m_path, true))
+      file.Write(data.data(), data.size());
+  }
+
+  ~TestFileCache() override
+  {
+    CFile::Delete(m_path);
+  }
+
+  // Time the avio reads of all the data the cache holds in front of the
+  // read position, once the cache stopped filling, so only the reading side
+  // is measured. The read data is checked against the file.
+  std::chrono::steady_clock::duration Read(bool lend, size_t& bytes)
+  {
+    bytes = 0;
+    CFile file;
+    EXPECT_TRUE(file.Open(m_path, READ_CACHED));
+    if (lend)
+      EXPECT_EQ(0, file.IoControl(IOCTRL_CACHE_LEND, nullptr));
+
+    SCacheStatus status = {};
+    uint64_t forward = 0;
+    for (int stable = 0; stable < 3 && forward < FILE_SIZE; )
+    {
+      XbmcThreads::ThreadSleep(10);
+      file.IoControl(IOCTRL_CACHE_STATUS, &status);
+      stable = status.forward == forward ? stable + 1 : 0;
+      forward = status.forward;
+    }
+
+    std::vector<uint8_t> packet(PACKET);
+    bool valid = true;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    while (bytes < forward)
+    {
+      int len = ReadInput(file, lend, packet.data(), static_cast<int>(std::min<uint64_t>(PACKET, forward - bytes)));
+      if (len <= 0)
+        break;
+      for (int i = 0; i < len; i += 4096)
+        valid &= packet[i] == static_cast<uint8_t>((bytes + i) % 251);
+      bytes += len;
+    }
+    std::chrono::steady_clock::duration time = std::chrono::steady_clock::now() - start;
+
+    EXPECT_TRUE(valid);
+    EXPECT_EQ(forward, bytes);
+    return time;
+  }
+
+  std::string m_path;
+};
+
+TEST_F(TestFileCache, LendThroughput)
+{
+  // best of a few alternating rounds, the first ones warm up the page cache
+  std::chrono::steady_clock::duration times[2] = { std::chrono::steady_clock::duration::max(),
+                                                   std::chrono::steady_clock::duration::max() };
+  size_t bytes[2] = { 0, 0 };
+  for (int round = 0; round < 3; round++)
+  {
+    for (int lend = 0; lend < 2; lend++)
+    {
+      size_t read;
+      std::chrono::steady_clock::duration time = Read(lend != 0, read);
+      ASSERT_GT(read, 0u);
+      if (time < times[lend])
+      {
+        times[lend] = time;
+        bytes[lend] = read;
+      }
+    }
+  }
+
+  for (int lend = 0; lend < 2; lend++)
+  {
+    long long us = std::chrono::duration_cast<std::chrono::microseconds>(times[lend]).count();
+    long long mibPerSecond = us > 0 ? static_cast<long long>(bytes[lend]) * 1000000 / us / (1024 * 1024) : 0;
+    std::cout << (lend ? "lent:   " : "copied: ") << bytes[lend] << " bytes in " << us << " us, "
+              << mibPerSecond << " MiB/s" << std::endl;
+    RecordProperty(lend ? "LendMiBPerSecond" : "ReadMiBPerSecond", static_cast<int>(mibPerSecond));
+  }
+}
@@ -0,0 +1,154 @@
+/*
+ *  Copyright (C) 2019 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "filesystem/ParallelRangeReader.h"
+#include "threads/Thread.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace XFILE;
+
+namespace
+{
+// serves the file position modulo 251 for a range, in small pieces so that
+// the connections finish out of order
+class CFakeRangeFile : public IFile
+{
+public:
+  explicit CFakeRangeFile(const CHttpRange& range)
+    : m_pos(range.GetFirstPosition())
+    , m_end(range.GetLastPosition() + 1)
+  {
+  }
+
+  bool Open(const CURL& url) override { return true; }
+  bool Exists(const CURL& url) override { return true; }
+  int Stat(const CURL& url, struct __stat64* buffer) override { return -1; }
+  int64_t Seek(int64_t iFilePosition, int iWhence = SEEK_SET) override { return -1; }
+  void Close() override {}
+  int64_t GetPosition() override { return m_pos; }
+  int64_t GetLength() override { return m_end; }
+
+  ssize_t Read(void* bufPtr, size_t bufSize) override
+  {
+    size_t len = std::min<size_t>(bufSize, std::min<int64_t>(m_end - m_pos, 1000));
+    char* buf = static_cast<char*>(bufPtr);
+    for (size_t i = 0; i < len; i++)
+      buf[i] = static_cast<char>((m_pos + i) % 251);
+    m_pos += len;
+    if (m_pos % 3 == 0)
+      XbmcThreads::ThreadSleep(1);
+    return len;
+  }
+
+private:
+  int64_t m_pos;
+  int64_t m_end;
+};
+
+class CTestRangeReader : public CParallelRangeReader
+{
+public:
+  CTestRangeReader(unsigned int maxConnections, unsigned int segmentSize)
+    : CParallelRangeReader(CURL("http://localhost/test"), maxConnections, segmentSize)
+  {
+  }
+
+  int64_t m_failAt = -1;
+
+protected:
+  std::unique_ptr<IFile> OpenRange(const CHttpRange& range) override
+  {
+    if (m_failAt >= 0 && static_cast<int64_t>(range.GetFirstPosition()) <= m_failAt &&
+        m_failAt <= static_cast<int64_t>(range.GetLastPosition()))
+      return nullptr;
+    return std::unique_ptr<IFile>(new CFakeRangeFile(range));
+  }
+};
+
+// reads until len bytes arrived or an error occurred, returns the bytes read
+int64_t ReadAll(CParallelRangeReader& reader, int64_t from, int64_t len)
+{
+  std::vector<char> buf(7000);
+  int64_t done = 0;
+  while (done < len)
+  {
+    ssize_t read = reader.Read(buf.data(), std::min<int64_t>(buf.size(), len - done));
+    if (read == CParallelRangeReader::WOULD_BLOCK)
+      continue;
+    if (read <= 0)
+      break;
+    for (ssize_t i = 0; i < read; i++)
+    {
+      if (static_cast<char>((from + done + i) % 251) != buf[i])
+        return -1;
+    }
+    done += read;
+  }
+  return done;
+}
+}
+
+TEST(TestParallelRangeReader, ReadInOrder)
+{
+  CTestRangeReader reader(4, 50000);
+  reader.SetConnections(4);
+  reader.Start(0, 1000003);
+
+  EXPECT_EQ(1000003, ReadAll(reader, 0, 1000003));
+  EXPECT_EQ(1000003, reader.GetPosition());
+
+  char buf[16];
+  EXPECT_EQ(0, reader.Read(buf, sizeof(buf)));
+}
+
+TEST(TestParallelRangeReader, Restart)
+{
+  CTestRangeReader reader(3, 10000);
+  reader.Start(0, 500000);
+  EXPECT_EQ(123456, ReadAll(reader, 0, 123456));
+
+  reader.Start(345678, 500000);
+  EXPECT_EQ(500000 - 345678, ReadAll(reader, 345678, 500000 - 345678));
+}
+
+TEST(TestParallelRangeReader, FailedRange)
+{
+  CTestRangeReader reader(2, 10000);
+  reader.m_failAt = 25000;
+  reader.Start(0, 100000);
+
+  // everything before the failed segment is delivered
+  EXPECT_EQ(20000, ReadAll(reader, 0, 100000));
+  EXPECT_EQ(20000, reader.GetPosition());
+}
+
+TEST(TestParallelRangeReader, AdaptConnections)
+{
+  CTestRangeReader reader(4, 10000);
+  EXPECT_EQ(2u, reader.GetConnections());
+
+  reader.AdaptConnections(1000, 4000, true);
+  EXPECT_EQ(3u, reader.GetConnections());
+
+  // no improvement, stay
+  reader.AdaptConnections(1050, 4000, true);
+  EXPECT_EQ(3u, reader.GetConnections());
+
+  reader.AdaptConnections(2000, 4000, true);
+  EXPECT_EQ(4u, reader.GetConnections());
+
+  reader.AdaptConnections(3000, 4000, true);
+  EXPECT_EQ(4u, reader.GetConnections());
+
+  // cache full
+  reader.AdaptConnections(3000, 4000, false);
+  EXPECT_EQ(3u, reader.GetConnections());
+}
@@ -0,0 +1,142 @@
+/*
+ *  Copyright (C) 2019 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "filesystem/WindowedCache.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace XFILE;
+
+namespace
+{
+// writes the file position modulo 251 as data, so every byte can be checked
+void WriteRange(CWindowedCache& cache, int64_t from, int64_t to)
+{
+  std::vector<char> data;
+  for (int64_t pos = from; pos < to; )
+  {
+    size_t len = cache.GetMaxWriteSize(to - pos);
+    ASSERT_GT(len, 0u);
+    data.resize(len);
+    for (size_t i = 0; i < len; i++)
+      data[i] = static_cast<char>((pos + i) % 251);
+    int written = cache.WriteToCache(data.data(), len);
+    ASSERT_GT(written, 0);
+    pos += written;
+  }
+}
+
+void CheckRead(CWindowedCache& cache, int64_t from, size_t len)
+{
+  std::vector<char> data(len);
+  size_t done = 0;
+  while (done < len)
+  {
+    int read = cache.ReadFromCache(data.data() + done, len - done);
+    ASSERT_GT(read, 0);
+    done += read;
+  }
+  for (size_t i = 0; i < len; i++)
+    ASSERT_EQ(static_cast<char>((from + i) % 251), data[i]);
+}
+}
+
+TEST(TestWindowedCache, ReadWrite)
+{
+  CWindowedCache cache(3000, 1000, 100, 0);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+
+  char buf[16];
+  EXPECT_EQ(CACHE_RC_WOULD_BLOCK, cache.ReadFromCache(buf, sizeof(buf)));
+
+  WriteRange(cache, 0, 4000);
+  EXPECT_EQ(0u, cache.GetMaxWriteSize(100));
+  EXPECT_EQ(4000, cache.WaitForData(0, 0));
+
+  // only the guaranteed back buffer is kept from what was read
+  CheckRead(cache, 0, 2500);
+  EXPECT_EQ(1500u, cache.GetMaxWriteSize(4000));
+  WriteRange(cache, 4000, 5500);
+  CheckRead(cache, 2500, 3000);
+
+  EXPECT_FALSE(cache.IsCachedPosition(1000));
+  EXPECT_TRUE(cache.IsCachedPosition(4000));
+  EXPECT_EQ(4000, cache.Seek(4000));
+  CheckRead(cache, 4000, 1500);
+
+  cache.EndOfInput();
+  EXPECT_EQ(0, cache.ReadFromCache(buf, sizeof(buf)));
+}
+
+TEST(TestWindowedCache, BackWindows)
+{
+  CWindowedCache cache(3000, 1000, 100, 2);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+
+  WriteRange(cache, 0, 3000);
+  CheckRead(cache, 0, 1000);
+
+  // seek far ahead, the data around the read position is retained
+  EXPECT_EQ(CACHE_RC_ERROR, cache.Seek(200000));
+  EXPECT_TRUE(cache.Reset(200000, false));
+  WriteRange(cache, 200000, 202000);
+  CheckRead(cache, 200000, 500);
+
+  EXPECT_TRUE(cache.IsCachedPosition(1100));
+  EXPECT_EQ(1750, cache.CachedDataEndPosIfSeekTo(1100));
+  EXPECT_EQ(CACHE_RC_ERROR, cache.Seek(1100));
+
+  // seeking back restores the window, the source continues at its end
+  EXPECT_FALSE(cache.Reset(1100, false));
+  EXPECT_EQ(1750, cache.CachedDataEndPos());
+  CheckRead(cache, 1100, 650);
+
+  // the region we just left is retained as well
+  EXPECT_TRUE(cache.IsCachedPosition(200600));
+  EXPECT_EQ(201250, cache.CachedDataEndPosIfSeekTo(200600));
+
+  // a full reset doesn't restore
+  EXPECT_TRUE(cache.Reset(200600, true));
+  EXPECT_EQ(200600, cache.CachedDataEndPos());
+}
+
+TEST(TestWindowedCache, RestoreReported)
+{
+  // a single window, retaining the region we leave would need its slot
+  CWindowedCache cache(3000, 1000, 100, 1);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+
+  WriteRange(cache, 0, 3000);
+  CheckRead(cache, 0, 1000);
+  EXPECT_TRUE(cache.Reset(200000, false));
+  WriteRange(cache, 200000, 202000);
+  CheckRead(cache, 200000, 500);
+
+  // CFileCache continues the source where the reported window ends
+  EXPECT_EQ(1750, cache.CachedDataEndPosIfSeekTo(1100));
+  EXPECT_FALSE(cache.Reset(1100, false));
+  EXPECT_EQ(1750, cache.CachedDataEndPos());
+  CheckRead(cache, 1100, 650);
+}
+
+TEST(TestWindowedCache, WaitForData)
+{
+  CWindowedCache cache(3000, 1000, 100, 0);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+
+  WriteRange(cache, 0, 50);
+
+  // below the low water mark the reader still gets its minimum after polling
+  EXPECT_EQ(50, cache.WaitForData(10, 1000));
+  EXPECT_EQ(50, cache.WaitForData(100, 60));
+
+  cache.EndOfInput();
+  EXPECT_EQ(50, cache.WaitForData(100, 10000));
+}
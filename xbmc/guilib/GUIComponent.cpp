@@ -50,7 +50,10 @@ void CGUIComponent::Deinit()
 {
   CServiceBroker::UnregisterGUI();
 
-  m_pWindowManager->DeInitialize();
+  // a component that was never initialized, as in tests, has no windows and
+  // no windowing system to lock
+  if (m_pWindowManager->Initialized())
+    m_pWindowManager->DeInitialize();
 }
 
 CGUIWindowManager& CGUIComponent::GetWindowManager()
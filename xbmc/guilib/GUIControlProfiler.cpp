@@ -7,10 +7,15 @@
  */
 
 #include "GUIControlProfiler.h"
+#include "GUIComponent.h"
+#include "GUIInfoManager.h"
+#include "ServiceBroker.h"
 #include "utils/XBMCTinyXML.h"
 #include "utils/TimeUtils.h"
 #include "utils/StringUtils.h"
 
+#include <algorithm>
+
 bool CGUIControlProfiler::m_bIsRunning = false;
 
 CGUIControlProfilerItem::CGUIControlProfilerItem(CGUIControlProfiler *pProfiler, CGUIControlProfilerItem *pParent, CGUIControl *pControl)
@@ -237,6 +242,8 @@ bool CGUIControlProfiler::IsRunning(void)
 void CGUIControlProfiler::Start(void)
 {
   m_iFrameCount = 0;
+  m_evaluations = 0;
+  m_maxEvaluations = 0;
   m_bIsRunning = true;
   m_pLastItem = NULL;
   m_ItemHead.Reset(this);
@@ -296,6 +303,11 @@ CGUIControlProfilerItem *CGUIControlProfiler::FindOrAddControl(CGUIControl *pCon
 
 void CGUIControlProfiler::EndFrame(void)
 {
+  // info bools evaluated by the previous frame, the current one is still in progress
+  unsigned int evaluations = CServiceBroker::GetGUI()->GetInfoManager().GetFrameEvaluations();
+  m_evaluations += evaluations;
+  m_maxEvaluations = std::max(m_maxEvaluations, evaluations);
+
   m_iFrameCount++;
   if (m_iFrameCount >= m_iMaxFrameCount)
   {
@@ -326,6 +338,10 @@ bool CGUIControlProfiler::SaveResults(void)
   std::string str = StringUtils::Format("%d", m_iFrameCount);
   root->SetAttribute("framecount", str.c_str());
   root->SetAttribute("timeunit", "ms");
+  str = StringUtils::Format("%u", m_iFrameCount > 0 ? m_evaluations / m_iFrameCount : 0);
+  root->SetAttribute("infoboolevaluations", str.c_str());
+  str = StringUtils::Format("%u", m_maxEvaluations);
+  root->SetAttribute("maxinfoboolevaluations", str.c_str());
   doc.LinkEndChild(root);
 
   m_ItemHead.SaveToXML(root);
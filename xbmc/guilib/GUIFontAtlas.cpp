@@ -0,0 +1,328 @@
+/*
+ *  Copyright (C) 2019 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "GUIFontAtlas.h"
+#include "utils/TimeUtils.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+// empty pixels between glyphs, so filtering doesn't pick up the neighbours
+const unsigned int SPACING = 1;
+
+struct Offset
+{
+  int dx;
+  int dy;
+  int Distance2() const { return dx * dx + dy * dy; }
+};
+
+void Compare(std::vector<Offset> &grid, int width, int height, Offset &offset, int x, int y, int ox, int oy)
+{
+  x += ox;
+  y += oy;
+  if (x < 0 || y < 0 || x >= width || y >= height)
+    return;
+  Offset other = grid[y * width + x];
+  other.dx += ox;
+  other.dy += oy;
+  if (other.Distance2() < offset.Distance2())
+    offset = other;
+}
+
+// 8SSEDT, two sweeps propagating the offset to the nearest seed pixel
+void Sweep(std::vector<Offset> &grid, int width, int height)
+{
+  for (int y = 0; y < height; y++)
+  {
+    for (int x = 0; x < width; x++)
+    {
+      Offset &offset = grid[y * width + x];
+      Compare(grid, width, height, offset, x, y, -1, 0);
+      Compare(grid, width, height, offset, x, y, 0, -1);
+      Compare(grid, width, height, offset, x, y, -1, -1);
+      Compare(grid, width, height, offset, x, y, 1, -1);
+    }
+    for (int x = width - 1; x >= 0; x--)
+      Compare(grid, width, height, grid[y * width + x], x, y, 1, 0);
+  }
+  for (int y = height - 1; y >= 0; y--)
+  {
+    for (int x = width - 1; x >= 0; x--)
+    {
+      Offset &offset = grid[y * width + x];
+      Compare(grid, width, height, offset, x, y, 1, 0);
+      Compare(grid, width, height, offset, x, y, 0, 1);
+      Compare(grid, width, height, offset, x, y, -1, 1);
+      Compare(grid, width, height, offset, x, y, 1, 1);
+    }
+    for (int x = 0; x < width; x++)
+      Compare(grid, width, height, grid[y * width + x], x, y, -1, 0);
+  }
+}
+}
+
+CGUIFontAtlasPage::CGUIFontAtlasPage(unsigned int width, unsigned int height)
+  : m_width(width),
+    m_height(height),
+    m_pixels(width * height, 0),
+    m_shelvesHeight(SPACING)
+{
+}
+
+bool CGUIFontAtlasPage::Allocate(unsigned int width, unsigned int height, unsigned int &x, unsigned int &y)
+{
+  width += SPACING;
+  height += SPACING;
+
+  // the lowest shelf the glyph fills at least 3/4 of, then any shelf if no new one fits
+  Shelf *best = nullptr;
+  bool fitsNewShelf = m_shelvesHeight + height <= m_height;
+  for (auto &shelf : m_shelves)
+  {
+    if (shelf.height < height || shelf.x + width > m_width)
+      continue;
+    if (fitsNewShelf && shelf.height * 3 > height * 4)
+      continue;
+    if (!best || shelf.height < best->height)
+      best = &shelf;
+  }
+
+  if (!best)
+  {
+    if (!fitsNewShelf || SPACING + width > m_width)
+      return false;
+    m_shelves.push_back({ m_shelvesHeight, height, SPACING });
+    m_shelvesHeight += height;
+    best = &m_shelves.back();
+  }
+
+  x = best->x;
+  y = best->y;
+  best->x += width;
+  return true;
+}
+
+void CGUIFontAtlasPage::Copy(unsigned int x, unsigned int y, const uint8_t *pixels, int pitch, unsigned int width, unsigned int height)
+{
+  uint8_t *target = m_pixels.data() + y * m_width + x;
+  for (unsigned int row = 0; row < height; row++)
+  {
+    memcpy(target, pixels, width);
+    pixels += pitch;
+    target += m_width;
+  }
+
+  if (m_dirtyY2 > m_dirtyY1)
+  {
+    m_dirtyY1 = std::min(m_dirtyY1, y);
+    m_dirtyY2 = std::max(m_dirtyY2, y + height);
+  }
+  else
+  {
+    m_dirtyY1 = y;
+    m_dirtyY2 = y + height;
+  }
+}
+
+bool CGUIFontAtlasPage::GetDirtyRows(unsigned int &y1, unsigned int &y2) const
+{
+  y1 = m_dirtyY1;
+  y2 = m_dirtyY2;
+  return y2 > y1;
+}
+
+const CGUIFontAtlasPage::DistanceFieldGlyph* CGUIFontAtlasPage::GetDistanceFieldGlyph(int face, uint32_t letterAndStyle) const
+{
+  auto it = m_distanceFieldGlyphs.find(std::make_pair(face, letterAndStyle));
+  if (it == m_distanceFieldGlyphs.end())
+    return nullptr;
+  return &it->second;
+}
+
+void CGUIFontAtlasPage::AddDistanceFieldGlyph(int face, uint32_t letterAndStyle, const DistanceFieldGlyph &glyph)
+{
+  m_distanceFieldGlyphs[std::make_pair(face, letterAndStyle)] = glyph;
+}
+
+bool CGUIFontAtlasPage::HasFace(int face) const
+{
+  auto it = m_distanceFieldGlyphs.lower_bound(std::make_pair(face, 0u));
+  return it != m_distanceFieldGlyphs.end() && it->first.first == face;
+}
+
+void CGUIFontAtlasPage::Clear()
+{
+  std::fill(m_pixels.begin(), m_pixels.end(), 0);
+  m_shelves.clear();
+  m_shelvesHeight = SPACING;
+  m_distanceFieldGlyphs.clear();
+  m_generation++;
+
+  // the texture still has the old glyphs around the new ones
+  m_dirtyY1 = 0;
+  m_dirtyY2 = m_height;
+}
+
+CGUIFontAtlas::CGUIFontAtlas(unsigned int pageSize, unsigned int maxPages)
+  : m_pageSize(pageSize),
+    m_maxPages(maxPages)
+{
+}
+
+CGUIFontAtlasPagePtr CGUIFontAtlas::AcquirePage(unsigned int width, unsigned int height, int face, unsigned int maxTextureSize,
+                                                unsigned int pageSize)
+{
+  unsigned int size = std::min(std::max(m_pageSize, pageSize), maxTextureSize);
+  if (width + 2 * SPACING > size || height + 2 * SPACING > size)
+    return nullptr;
+
+  // glyphs left on pages no font uses anymore are garbage
+  for (auto &page : m_pages)
+  {
+    if (page.use_count() == 1 && !page->m_shelves.empty())
+      page->Clear();
+  }
+
+  // pages smaller than the font needs are left to the other fonts
+  auto hasRoom = [&](const CGUIFontAtlasPagePtr &page) {
+    return page->GetWidth() >= size && page->GetFreeHeight() >= height + SPACING;
+  };
+
+  CGUIFontAtlasPagePtr best;
+
+  // distance field glyphs are shared on the pages of their face
+  if (face >= 0)
+  {
+    for (auto &page : m_pages)
+    {
+      if (page->HasFace(face) && hasRoom(page) && (!best || page->GetFreeHeight() > best->GetFreeHeight()))
+        best = page;
+    }
+  }
+
+  // the fullest page a font can still settle on, to keep the others free
+  if (!best)
+  {
+    for (auto &page : m_pages)
+    {
+      if (hasRoom(page) && page->GetFreeHeight() >= page->GetHeight() / 4 &&
+          (!best || page->GetFreeHeight() < best->GetFreeHeight()))
+        best = page;
+    }
+  }
+
+  if (!best && m_pages.size() < m_maxPages)
+  {
+    best = std::make_shared<CGUIFontAtlasPage>(size, size);
+    m_pages.push_back(best);
+    return best;
+  }
+
+  // the page used least recently, fonts drawn in this frame keep theirs
+  if (!best)
+  {
+    unsigned int frameTime = GetFrameTime();
+    for (auto &page : m_pages)
+    {
+      if (page->m_lastUsed != frameTime && page->GetWidth() >= size &&
+          (!best || page->m_lastUsed < best->m_lastUsed))
+        best = page;
+    }
+    if (best)
+    {
+      CLog::Log(LOGDEBUG, "CGUIFontAtlas::AcquirePage - clearing page %p used least recently",
+                static_cast<void*>(best.get()));
+      best->Clear();
+    }
+  }
+
+  // all pages are in use, settle for any room or exceed the limit until the next frame
+  if (!best)
+  {
+    for (auto &page : m_pages)
+    {
+      if (hasRoom(page) && (!best || page->GetFreeHeight() > best->GetFreeHeight()))
+        best = page;
+    }
+  }
+  if (!best)
+  {
+    CLog::Log(LOGDEBUG, "CGUIFontAtlas::AcquirePage - all %u pages are in use, adding another",
+              static_cast<unsigned int>(m_pages.size()));
+    best = std::make_shared<CGUIFontAtlasPage>(size, size);
+    m_pages.push_back(best);
+  }
+
+  return best;
+}
+
+void CGUIFontAtlas::ReleaseUnused()
+{
+  m_pages.erase(std::remove_if(m_pages.begin(), m_pages.end(),
+                               [](const CGUIFontAtlasPagePtr &page) { return page.use_count() == 1; }),
+                m_pages.end());
+}
+
+int CGUIFontAtlas::GetFace(const std::string &face)
+{
+  auto it = m_faces.find(face);
+  if (it != m_faces.end())
+    return it->second;
+
+  int id = m_faces.size();
+  m_faces[face] = id;
+  return id;
+}
+
+void CGUIFontAtlas::BuildDistanceField(const uint8_t *coverage, unsigned int width, unsigned int height, int pitch,
+                                       unsigned int spread, std::vector<uint8_t> &field)
+{
+  const int fieldWidth = width + 2 * spread;
+  const int fieldHeight = height + 2 * spread;
+  const Offset none = { fieldWidth + fieldHeight, fieldWidth + fieldHeight };
+  const Offset seed = { 0, 0 };
+
+  // offsets to the nearest inside and the nearest outside pixel
+  std::vector<Offset> toInside(fieldWidth * fieldHeight, none);
+  std::vector<Offset> toOutside(fieldWidth * fieldHeight, seed);
+  for (unsigned int y = 0; y < height; y++)
+  {
+    for (unsigned int x = 0; x < width; x++)
+    {
+      if (coverage[y * pitch + x] >= 128)
+      {
+        size_t pos = (y + spread) * fieldWidth + x + spread;
+        toInside[pos] = seed;
+        toOutside[pos] = none;
+      }
+    }
+  }
+  Sweep(toInside, fieldWidth, fieldHeight);
+  Sweep(toOutside, fieldWidth, fieldHeight);
+
+  field.resize(fieldWidth * fieldHeight);
+  for (size_t pos = 0; pos < field.size(); pos++)
+  {
+    // distances are between pixel centres, the outline is half a pixel from them
+    float distance = std::sqrt(static_cast<float>(toOutside[pos].Distance2())) -
+                     std::sqrt(static_cast<float>(toInside[pos].Distance2()));
+    distance += distance > 0 ? -0.5f : 0.5f;
+    float value = 0.5f + distance / (2 * spread);
+    field[pos] = static_cast<uint8_t>(std::min(std::max(value, 0.0f), 1.0f) * 255.0f + 0.5f);
+  }
+}
+
+unsigned int CGUIFontAtlas::GetFrameTime() const
+{
+  return CTimeUtils::GetFrameTime();
+}
@@ -0,0 +1,184 @@
+/*
+ *  Copyright (C) 2019 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <stdint.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+/*!
+ \ingroup textures
+ \brief Hardware texture of an atlas page, created by the font implementation of the render system
+ */
+class CGUIFontAtlasTexture
+{
+public:
+  virtual ~CGUIFontAtlasTexture() = default;
+};
+
+/*!
+ \ingroup textures
+ \brief A fixed size 8 bit texture holding the glyphs of several fonts
+
+ Glyphs are packed into shelves, rows as high as the first glyph placed in them.
+ The pixels are kept in memory and the font implementations upload the changed
+ rows before drawing with the page.
+ */
+class CGUIFontAtlasPage
+{
+public:
+  CGUIFontAtlasPage(unsigned int width, unsigned int height);
+
+  unsigned int GetWidth() const { return m_width; }
+  unsigned int GetHeight() const { return m_height; }
+  const uint8_t* GetPixels() const { return m_pixels.data(); }
+
+  /*! \brief Height below the lowest shelf, the room left for new shelves
+   */
+  unsigned int GetFreeHeight() const { return m_height - m_shelvesHeight; }
+
+  /*! \brief Incremented whenever the page is cleared, glyphs placed in an older generation are gone
+   */
+  unsigned int GetGeneration() const { return m_generation; }
+
+  /*! \brief Reserves a rectangle for a glyph
+   \param width width of the glyph, the page keeps a pixel of spacing around it
+   \param height height of the glyph
+   \param x set to the left of the rectangle
+   \param y set to the top of the rectangle
+   \return false if the page is full
+   */
+  bool Allocate(unsigned int width, unsigned int height, unsigned int &x, unsigned int &y);
+
+  /*! \brief Copies pixels into a rectangle returned by Allocate and marks its rows for upload
+   */
+  void Copy(unsigned int x, unsigned int y, const uint8_t *pixels, int pitch, unsigned int width, unsigned int height);
+
+  /*! \brief Rows changed since the last upload
+   \return false if nothing changed
+   */
+  bool GetDirtyRows(unsigned int &y1, unsigned int &y2) const;
+  void ClearDirtyRows() { m_dirtyY1 = m_dirtyY2 = 0; }
+
+  CGUIFontAtlasTexture* GetTexture() const { return m_texture.get(); }
+  void SetTexture(CGUIFontAtlasTexture *texture) { m_texture.reset(texture); }
+
+  /*! \brief A glyph rendered as distance field at the reference size, shared
+   by the fonts of a face of all sizes. Positions include the spread.
+   */
+  struct DistanceFieldGlyph
+  {
+    unsigned int x, y;              ///< position in the page
+    unsigned int width, height;     ///< size in the page and at the reference size
+    float offsetX, offsetY;         ///< offset from the pen position on the baseline
+    float advance;
+  };
+
+  const DistanceFieldGlyph* GetDistanceFieldGlyph(int face, uint32_t letterAndStyle) const;
+  void AddDistanceFieldGlyph(int face, uint32_t letterAndStyle, const DistanceFieldGlyph &glyph);
+  bool HasFace(int face) const;
+
+private:
+  friend class CGUIFontAtlas;
+
+  void Clear();
+
+  struct Shelf
+  {
+    unsigned int y;
+    unsigned int height;
+    unsigned int x;
+  };
+
+  unsigned int m_width;
+  unsigned int m_height;
+  std::vector<uint8_t> m_pixels;
+  std::vector<Shelf> m_shelves;
+  unsigned int m_shelvesHeight = 0;
+  unsigned int m_dirtyY1 = 0;
+  unsigned int m_dirtyY2 = 0;
+  unsigned int m_generation = 0;
+  unsigned int m_lastUsed = 0;
+  std::map<std::pair<int, uint32_t>, DistanceFieldGlyph> m_distanceFieldGlyphs;
+  std::unique_ptr<CGUIFontAtlasTexture> m_texture;
+};
+
+typedef std::shared_ptr<CGUIFontAtlasPage> CGUIFontAtlasPagePtr;
+
+/*!
+ \ingroup textures
+ \brief Glyph cache shared by all fonts
+
+ Rather than every font growing its own texture, fonts place their glyphs on
+ one of a small set of fixed size pages. A font draws with a single page, when
+ it's full the font clears its glyphs and continues on another page. Pages no
+ font uses anymore are reused, and when the set is complete the page used least
+ recently is cleared for the font, fonts on it cache their glyphs again.
+
+ Like the fonts, the atlas is used with the graphics context locked.
+ */
+class CGUIFontAtlas
+{
+public:
+  static const unsigned int PAGE_SIZE = 1024;
+  static const unsigned int MAX_PAGES = 8;
+
+  explicit CGUIFontAtlas(unsigned int pageSize = PAGE_SIZE, unsigned int maxPages = MAX_PAGES);
+  virtual ~CGUIFontAtlas() = default;
+
+  /*! \brief Finds a page for a font that needs to place a glyph
+   \param width width of the glyph
+   \param height height of the glyph
+   \param face a face from GetFace to prefer pages holding its distance field glyphs, -1 for none
+   \param maxTextureSize the largest texture the render system supports
+   \param pageSize the smallest page the font can use, for fonts drawing text with more glyphs
+   than fit a page of GetPageSize(). 0 for the default
+   \return the page, nullptr if the glyph is larger than a page
+   */
+  CGUIFontAtlasPagePtr AcquirePage(unsigned int width, unsigned int height, int face, unsigned int maxTextureSize,
+                                   unsigned int pageSize = 0);
+
+  /*! \brief Marks a page as used in this frame, it won't be cleared for other fonts until the next
+   */
+  void Touch(CGUIFontAtlasPage &page) const { page.m_lastUsed = GetFrameTime(); }
+
+  /*! \brief Frees the pages no font uses anymore
+   */
+  void ReleaseUnused();
+
+  /*! \brief Identifies a face (file and aspect) to share distance field glyphs between font sizes
+   */
+  int GetFace(const std::string &face);
+
+  unsigned int GetPageCount() const { return m_pages.size(); }
+  unsigned int GetPageSize() const { return m_pageSize; }
+
+  /*! \brief Converts glyph coverage to a signed distance field
+   \param coverage 8 bit coverage of the glyph
+   \param width width of the glyph
+   \param height height of the glyph
+   \param pitch bytes per row of coverage
+   \param spread distance in pixels covered by the field, the field is padded by it on all sides
+   \param field set to (width + 2 * spread) x (height + 2 * spread) values, 128 on the outline
+   */
+  static void BuildDistanceField(const uint8_t *coverage, unsigned int width, unsigned int height, int pitch,
+                                 unsigned int spread, std::vector<uint8_t> &field);
+
+protected:
+  virtual unsigned int GetFrameTime() const;
+
+private:
+  unsigned int m_pageSize;
+  unsigned int m_maxPages;
+  std::vector<CGUIFontAtlasPagePtr> m_pages;
+  std::map<std::string, int> m_faces;
+};
@@ -9,12 +9,15 @@
 #include "GUIComponent.h"
 #include "GUIFontManager.h"
 #include "windowing/GraphicContext.h"
+#include "windowing/WinSystem.h"
 #include "GUIWindowManager.h"
 #include "addons/Skin.h"
 #include "addons/AddonManager.h"
 #include "addons/FontResource.h"
 #include "GUIFontTTF.h"
 #include "GUIFont.h"
+#include "GUITextLayout.h"
+#include "threads/SingleLock.h"
 #include "utils/XMLUtils.h"
 #include "GUIControlFactory.h"
 #include "filesystem/Directory.h"
@@ -31,6 +34,8 @@
 #include "filesystem/SpecialProtocol.h"
 #endif
 
+#include <memory>
+
 using namespace ADDON;
 
 GUIFontManager::GUIFontManager(void)
@@ -209,6 +214,11 @@ void GUIFontManager::ReloadTTFFonts(void)
   if (!m_vecFonts.size())
     return;   // we haven't even loaded fonts in yet
 
+  // layouts were measured with the old sizes, and layout jobs must not use
+  // the font files we replace
+  CGUITextLayout::ClearLayoutCache();
+  CSingleLock lock(CServiceBroker::GetWinSystem()->GetGfxContext());
+
   for (unsigned int i = 0; i < m_vecFonts.size(); i++)
   {
     CGUIFont* font = m_vecFonts[i];
@@ -247,6 +257,10 @@ void GUIFontManager::Unload(const std::string& strFontName)
   {
     if (StringUtils::EqualsNoCase((*iFont)->GetFontName(), strFontName))
     {
+      // layout jobs check the cache generation with the graphics context
+      // locked, so none of them uses the font once we hold it
+      CGUITextLayout::ClearLayoutCache();
+      CSingleLock lock(CServiceBroker::GetWinSystem()->GetGfxContext());
       delete (*iFont);
       m_vecFonts.erase(iFont);
       return;
@@ -328,6 +342,15 @@ CGUIFont* GUIFontManager::GetDefaultFont(bool border)
 
 void GUIFontManager::Clear()
 {
+  // layout jobs check the cache generation with the graphics context locked,
+  // so none of them uses the fonts once we hold it. there is no window system
+  // anymore when the font manager itself is destroyed
+  CGUITextLayout::ClearLayoutCache();
+  std::unique_ptr<CSingleLock> lock;
+  CWinSystemBase *winSystem = CServiceBroker::GetWinSystem();
+  if (winSystem)
+    lock.reset(new CSingleLock(winSystem->GetGfxContext()));
+
   for (int i = 0; i < (int)m_vecFonts.size(); ++i)
   {
     CGUIFont* pFont = m_vecFonts[i];
@@ -17,6 +17,7 @@
 #include <vector>
 
 #include "windowing/GraphicContext.h"
+#include "GUIFontAtlas.h"
 #include "IMsgTargetCallback.h"
 #include "utils/Color.h"
 #include "utils/GlobalsHandling.h"
@@ -65,6 +66,10 @@ public:
   void Clear();
   void FreeFontFile(CGUIFontTTFBase *pFont);
 
+  /*! \brief the glyph cache shared by the font files
+   */
+  CGUIFontAtlas& GetAtlas() { return m_atlas; }
+
   static void SettingOptionsFontsFiller(std::shared_ptr<const CSetting> setting, std::vector< std::pair<std::string, std::string> > &list, std::string &current, void *data);
 
 protected:
@@ -79,6 +84,7 @@ protected:
   std::vector<OrigFontInfo> m_vecFontInfo;
   RESOLUTION_INFO m_skinResolution;
   bool m_canReload;
+  CGUIFontAtlas m_atlas;
 };
 
 /*!
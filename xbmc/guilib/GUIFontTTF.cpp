@@ -9,10 +9,11 @@
 #include "GUIFont.h"
 #include "GUIFontTTF.h"
 #include "GUIFontManager.h"
-#include "Texture.h"
 #include "windowing/GraphicContext.h"
 #include "ServiceBroker.h"
 #include "filesystem/SpecialProtocol.h"
+#include "settings/AdvancedSettings.h"
+#include "settings/SettingsComponent.h"
 #include "utils/MathUtils.h"
 #include "utils/log.h"
 #include "rendering/RenderSystem.h"
@@ -36,6 +37,7 @@
 #include FT_GLYPH_H
 #include FT_OUTLINE_H
 #include FT_STROKER_H
+#include FT_SIZES_H
 
 #ifdef TARGET_WINDOWS
 #ifdef NDEBUG
@@ -45,8 +47,9 @@
 #endif
 #endif
 
-#define CHARS_PER_TEXTURE_LINE 20 // number of characters to cache per texture line
 #define CHAR_CHUNK    64      // 64 chars allocated at a time (1024 bytes)
+#define DISTANCE_FIELD_SIZE 64   // size distance field glyphs are rendered at
+#define DISTANCE_FIELD_SPREAD 8  // pixels around the outline covered by the distance field
 #define GLYPH_STRENGTH_BOLD 24
 #define GLYPH_STRENGTH_LIGHT -48
 
@@ -102,14 +105,7 @@ public:
       return NULL;
 #endif // ! TARGET_WINDOWS
 
-    unsigned int ydpi = 72; // 72 points to the inch is the freetype default
-    unsigned int xdpi = (unsigned int)MathUtils::round_int(ydpi * aspect);
-
-    // we set our screen res currently to 96dpi in both directions (windows default)
-    // we cache our characters (for rendering speed) so it's probably
-    // not a good idea to allow free scaling of fonts - rather, just
-    // scaling to pixel ratio on screen perhaps?
-    if (FT_Set_Char_Size( face, 0, (int)(size*64 + 0.5f), xdpi, ydpi ))
+    if (!SetSize(face, size, aspect))
     {
       FT_Done_Face(face);
       return NULL;
@@ -118,6 +114,18 @@ public:
     return face;
   };
 
+  static bool SetSize(FT_Face face, float size, float aspect)
+  {
+    unsigned int ydpi = 72; // 72 points to the inch is the freetype default
+    unsigned int xdpi = (unsigned int)MathUtils::round_int(ydpi * aspect);
+
+    // we set our screen res currently to 96dpi in both directions (windows default)
+    // we cache our characters (for rendering speed) so it's probably
+    // not a good idea to allow free scaling of fonts - rather, just
+    // scaling to pixel ratio on screen perhaps?
+    return FT_Set_Char_Size( face, 0, (int)(size*64 + 0.5f), xdpi, ydpi ) == 0;
+  }
+
   FT_Stroker GetStroker()
   {
     if (!m_library)
@@ -151,7 +159,15 @@ XBMC_GLOBAL_REF(CFreeTypeLibrary, g_freeTypeLibrary); // our freetype library
 
 CGUIFontTTFBase::CGUIFontTTFBase(const std::string& strFileName) : m_staticCache(*this), m_dynamicCache(*this)
 {
-  m_texture = NULL;
+  m_pageGeneration = 0;
+  m_pageSize = 0;
+  m_cacheClears = 0;
+  m_dynamicCacheStale = false;
+  m_distanceField = false;
+  m_distanceFieldFace = -1;
+  m_distanceFieldSize = NULL;
+  m_faceSize = NULL;
+  m_glyphScale = 1.0f;
   m_char = NULL;
   m_maxChars = 0;
   m_nestedBeginCount = 0;
@@ -166,12 +182,9 @@ CGUIFontTTFBase::CGUIFontTTFBase(const std::string& strFileName) : m_staticCache
   m_originX = m_originY = 0.0f;
   m_cellBaseLine = m_cellHeight = 0;
   m_numChars = 0;
-  m_posX = m_posY = 0;
-  m_textureHeight = m_textureWidth = 0;
   m_textureScaleX = m_textureScaleY = 0.0;
   m_ellipsesWidth = m_height = 0.0f;
   m_color = 0;
-  m_nTexture = 0;
 
   m_renderSystem = CServiceBroker::GetRenderSystem();
 }
@@ -197,35 +210,80 @@ void CGUIFontTTFBase::RemoveReference()
 
 void CGUIFontTTFBase::ClearCharacterCache()
 {
-  delete(m_texture);
-
-  DeleteHardwareTexture();
-
-  m_texture = NULL;
+  // leave the page, our next character picks one with room
+  m_page.reset();
   delete[] m_char;
   m_char = new Character[CHAR_CHUNK];
   memset(m_charquick, 0, sizeof(m_charquick));
   m_numChars = 0;
   m_maxChars = CHAR_CHUNK;
-  // set the posX and posY so that our texture will be created on first character write.
-  m_posX = m_textureWidth;
-  m_posY = -(int)GetTextureLineHeight();
-  m_textureHeight = 0;
+  m_cacheClears++;
+
+  // the cached vertices refer to the old positions of the characters. Layout jobs
+  // measure text on threads without a GL context, the vertex buffers are freed
+  // by the next Begin() on the render thread, before any of them is drawn again
+  m_staticCache.Flush();
+  m_dynamicCacheStale = true;
+  m_vertexTrans.clear();
+  m_vertex.clear();
+}
+
+bool CGUIFontTTFBase::ValidateCharacterCache()
+{
+  if (!m_page || m_page->GetGeneration() == m_pageGeneration)
+    return false;
+
+  CLog::Log(LOGDEBUG, "%s: Page cleared for another font, caching %i characters again", __FUNCTION__, m_numChars);
+  ClearCharacterCache();
+  return true;
+}
+
+bool CGUIFontTTFBase::AcquirePage(unsigned int width, unsigned int height)
+{
+  CGUIFontAtlas &atlas = g_fontManager.GetAtlas();
+  m_page = atlas.AcquirePage(width, height, m_distanceFieldFace, m_renderSystem->GetMaxTextureSize(), m_pageSize);
+  if (!m_page)
+  {
+    CLog::Log(LOGDEBUG, "%s: Character of %ux%u pixels is larger than a page", __FUNCTION__, width, height);
+    return false;
+  }
+
+  // we may not draw with it this frame, but it shouldn't be cleared before
+  atlas.Touch(*m_page);
+  m_pageGeneration = m_page->GetGeneration();
+  m_textureScaleX = 1.0f / m_page->GetWidth();
+  m_textureScaleY = 1.0f / m_page->GetHeight();
+  return true;
+}
+
+bool CGUIFontTTFBase::GrowPage()
+{
+  unsigned int size = 2 * std::max(m_pageSize, g_fontManager.GetAtlas().GetPageSize());
+  if (size > m_renderSystem->GetMaxTextureSize())
+    return false;
+
+  CLog::Log(LOGDEBUG, "%s: Text of %s needs more characters than fit a page, using pages of %u pixels",
+            __FUNCTION__, m_strFilename.c_str(), size);
+  m_pageSize = size;
+  ClearCharacterCache();
+  return true;
 }
 
 void CGUIFontTTFBase::Clear()
 {
-  delete(m_texture);
-  m_texture = NULL;
+  m_page.reset();
+  g_fontManager.GetAtlas().ReleaseUnused();
   delete[] m_char;
   memset(m_charquick, 0, sizeof(m_charquick));
   m_char = NULL;
   m_maxChars = 0;
   m_numChars = 0;
-  m_posX = 0;
-  m_posY = 0;
   m_nestedBeginCount = 0;
 
+  if (m_distanceFieldSize)
+    FT_Done_Size(m_distanceFieldSize);
+  m_distanceFieldSize = NULL;
+  m_faceSize = NULL;
   if (m_face)
     g_freeTypeLibrary.ReleaseFont(m_face);
   m_face = NULL;
@@ -298,8 +356,7 @@ bool CGUIFontTTFBase::Load(const std::string& strFilename, float height, float a
 
   m_height = height;
 
-  delete(m_texture);
-  m_texture = NULL;
+  m_page.reset();
   delete[] m_char;
   m_char = NULL;
 
@@ -308,18 +365,26 @@ bool CGUIFontTTFBase::Load(const std::string& strFilename, float height, float a
 
   m_strFilename = strFilename;
 
-  m_textureHeight = 0;
-  m_textureWidth = ((m_cellHeight * CHARS_PER_TEXTURE_LINE) & ~63) + 64;
-
-  m_textureWidth = CBaseTexture::PadPow2(m_textureWidth);
-
-  if (m_textureWidth > m_renderSystem->GetMaxTextureSize())
-    m_textureWidth = m_renderSystem->GetMaxTextureSize();
-  m_textureScaleX = 1.0f / m_textureWidth;
-
-  // set the posX and posY so that our texture will be created on first character write.
-  m_posX = m_textureWidth;
-  m_posY = -(int)GetTextureLineHeight();
+  // distance fields are rendered once at a reference size and scaled to all sizes of the
+  // face, so its fonts share the glyphs. The border is drawn by a separate bitmap font.
+  m_distanceField = false;
+  m_distanceFieldFace = -1;
+  m_glyphScale = 1.0f;
+  if (!border && SupportsDistanceField() &&
+      CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_guiFontDistanceField)
+  {
+    m_faceSize = m_face->size;
+    if (FT_New_Size(m_face, &m_distanceFieldSize) == 0 && FT_Activate_Size(m_distanceFieldSize) == 0 &&
+        CFreeTypeLibrary::SetSize(m_face, DISTANCE_FIELD_SIZE, aspect))
+    {
+      m_distanceField = true;
+      m_distanceFieldFace = g_fontManager.GetAtlas().GetFace(strFilename + "@" + std::to_string(aspect));
+      m_glyphScale = height / DISTANCE_FIELD_SIZE;
+    }
+    else
+      CLog::Log(LOGERROR, "%s: Unable to create the distance field size of %s", __FUNCTION__, strFilename.c_str());
+    FT_Activate_Size(m_faceSize);
+  }
 
   // cache the ellipses width
   Character *ellipse = GetCharacter(L'.');
@@ -330,10 +395,23 @@ bool CGUIFontTTFBase::Load(const std::string& strFilename, float height, float a
 
 void CGUIFontTTFBase::Begin()
 {
-  if (m_nestedBeginCount == 0 && m_texture != NULL && FirstBegin())
+  if (m_nestedBeginCount == 0)
   {
-    m_vertexTrans.clear();
-    m_vertex.clear();
+    ValidateCharacterCache();
+    if (m_dynamicCacheStale)
+    {
+      m_dynamicCache.Flush();
+      m_dynamicCacheStale = false;
+    }
+    if (m_page)
+    {
+      g_fontManager.GetAtlas().Touch(*m_page);
+      if (FirstBegin())
+      {
+        m_vertexTrans.clear();
+        m_vertex.clear();
+      }
+    }
   }
   // Keep track of the nested begin/end calls.
   m_nestedBeginCount++;
@@ -447,26 +525,41 @@ void CGUIFontTTFBase::DrawTextInternal(float x, float y, const std::vector<UTILS
     float cursorX = 0; // current position along the line
 
     // Collect all the Character info in a first pass, in case any of them
-    // are not currently cached and cause the texture to be enlarged, which
-    // would invalidate the texture coordinates.
+    // are not currently cached and fill our page, which clears the characters
+    // collected before. Collecting them again places them all on the new page,
+    // unless the text has more characters than fit a page: then we move on to
+    // larger pages.
     std::queue<Character> characters;
-    if (alignment & XBFONT_TRUNCATED)
-      GetCharacter(L'.');
-    for (vecText::const_iterator pos = text.begin(); pos != text.end(); ++pos)
+    size_t firstValid = 0; // characters collected before are on a page we left
+    for (int pass = 0; ; pass++)
     {
-      Character *ch = GetCharacter(*pos);
-      if (!ch)
+      unsigned int cacheClears = m_cacheClears;
+      characters = std::queue<Character>();
+      firstValid = 0;
+      cursorX = 0;
+      if (alignment & XBFONT_TRUNCATED)
+        GetCharacter(L'.');
+      for (vecText::const_iterator pos = text.begin(); pos != text.end(); ++pos)
       {
-        Character null = { 0 };
-        characters.push(null);
-        continue;
-      }
-      characters.push(*ch);
+        unsigned int clears = m_cacheClears;
+        Character *ch = GetCharacter(*pos);
+        if (m_cacheClears != clears)
+          firstValid = characters.size();
+        if (!ch)
+        {
+          Character null = { 0 };
+          characters.push(null);
+          continue;
+        }
+        characters.push(*ch);
 
-      if (maxPixelWidth > 0 &&
-          cursorX + ((alignment & XBFONT_TRUNCATED) ? ch->advance + 3 * m_ellipsesWidth : 0) > maxPixelWidth)
+        if (maxPixelWidth > 0 &&
+            cursorX + ((alignment & XBFONT_TRUNCATED) ? ch->advance + 3 * m_ellipsesWidth : 0) > maxPixelWidth)
+          break;
+        cursorX += ch->advance;
+      }
+      if (m_cacheClears == cacheClears || (pass > 0 && !GrowPage()))
         break;
-      cursorX += ch->advance;
     }
     cursorX = 0;
 
@@ -481,6 +574,13 @@ void CGUIFontTTFBase::DrawTextInternal(float x, float y, const std::vector<UTILS
 
       // grab the next character
       Character *ch = &characters.front();
+      if (firstValid > 0)
+      {
+        // even the largest page can't hold all the characters, keep the place of those we lost
+        ch->left = ch->right;
+        ch->top = ch->bottom;
+        firstValid--;
+      }
       if (ch->letterAndStyle == 0)
       {
         characters.pop();
@@ -570,7 +670,7 @@ float CGUIFontTTFBase::GetTextWidthInternal(vecText::const_iterator start, vecTe
       // and not advance distance - this makes sure that italic text isn't
       // choped on the end (as render width is larger than advance then).
       if (start == end)
-        width += std::max(c->right - c->left + c->offsetX, c->advance);
+        width += std::max((c->right - c->left) * m_glyphScale + c->offsetX, c->advance);
       else
         width += c->advance;
     }
@@ -597,13 +697,6 @@ float CGUIFontTTFBase::GetLineHeight(float lineSpacing) const
   return 0.0f;
 }
 
-const unsigned int CGUIFontTTFBase::spacing_between_characters_in_texture = 1;
-
-unsigned int CGUIFontTTFBase::GetTextureLineHeight() const
-{
-  return m_cellHeight + spacing_between_characters_in_texture;
-}
-
 CGUIFontTTFBase::Character* CGUIFontTTFBase::GetCharacter(character_t chr)
 {
   wchar_t letter = (wchar_t)(chr & 0xffff);
@@ -638,6 +731,10 @@ CGUIFontTTFBase::Character* CGUIFontTTFBase::GetCharacter(character_t chr)
   }
   // if we get to here, then low is where we should insert the new character
 
+  // the characters we have are gone if our page was cleared for another font
+  if (ValidateCharacterCache())
+    low = 0;
+
   // increase the size of the buffer if we need it
   if (m_numChars >= m_maxChars)
   { // need to increase the size of the buffer
@@ -693,6 +790,9 @@ CGUIFontTTFBase::Character* CGUIFontTTFBase::GetCharacter(character_t chr)
 
 bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *ch)
 {
+  if (m_distanceField)
+    return CacheDistanceFieldCharacter(letter, style, ch);
+
   int glyph_index = FT_Get_Char_Index( m_face, letter );
 
   FT_Glyph glyph = NULL;
@@ -728,48 +828,19 @@ bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *
   FT_Bitmap bitmap = bitGlyph->bitmap;
   bool isEmptyGlyph = (bitmap.width == 0 || bitmap.rows == 0);
 
+  // find room for the character on our page, or a page if we have none
+  unsigned int x = 0, y = 0;
   if (!isEmptyGlyph)
   {
-    if (bitGlyph->left < 0)
-      m_posX += -bitGlyph->left;
-
-    // check we have enough room for the character.
-    // cast-fest is here to avoid warnings due to freeetype version differences (signedness of width).
-    if (static_cast<int>(m_posX + bitGlyph->left + bitmap.width) > static_cast<int>(m_textureWidth))
-    { // no space - gotta drop to the next line (which means creating a new texture and copying it across)
-      m_posX = 0;
-      m_posY += GetTextureLineHeight();
-      if (bitGlyph->left < 0)
-        m_posX += -bitGlyph->left;
-
-      if(m_posY + GetTextureLineHeight() >= m_textureHeight)
-      {
-        // create the new larger texture
-        unsigned int newHeight = m_posY + GetTextureLineHeight();
-        // check for max height
-        if (newHeight > m_renderSystem->GetMaxTextureSize())
-        {
-          CLog::Log(LOGDEBUG, "%s: New cache texture is too large (%u > %u pixels long)", __FUNCTION__, newHeight, m_renderSystem->GetMaxTextureSize());
-          FT_Done_Glyph(glyph);
-          return false;
-        }
-
-        CBaseTexture* newTexture = NULL;
-        newTexture = ReallocTexture(newHeight);
-        if(newTexture == NULL)
-        {
-          FT_Done_Glyph(glyph);
-          CLog::Log(LOGDEBUG, "%s: Failed to allocate new texture of height %u", __FUNCTION__, newHeight);
-          return false;
-        }
-        m_texture = newTexture;
-      }
+    if (!m_page && !AcquirePage(bitmap.width, bitmap.rows))
+    {
+      FT_Done_Glyph(glyph);
+      return false;
     }
-
-    if(m_texture == NULL)
+    if (!m_page->Allocate(bitmap.width, bitmap.rows, x, y))
     {
       FT_Done_Glyph(glyph);
-      CLog::Log(LOGDEBUG, "%s: no texture to cache character to", __FUNCTION__);
+      CLog::Log(LOGDEBUG, "%s: Page is full", __FUNCTION__);
       return false;
     }
   }
@@ -777,24 +848,15 @@ bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *
   ch->letterAndStyle = (style << 16) | letter;
   ch->offsetX = (short)bitGlyph->left;
   ch->offsetY = (short)m_cellBaseLine - bitGlyph->top;
-  ch->left = isEmptyGlyph ? 0 : ((float)m_posX + ch->offsetX);
-  ch->top = isEmptyGlyph ? 0 : ((float)m_posY + ch->offsetY);
+  ch->left = (float)x;
+  ch->top = (float)y;
   ch->right = ch->left + bitmap.width;
   ch->bottom = ch->top + bitmap.rows;
   ch->advance = (float)MathUtils::round_int( (float)m_face->glyph->advance.x / 64 );
 
   // we need only render if we actually have some pixels
   if (!isEmptyGlyph)
-  {
-    // ensure our rect will stay inside the texture (it *should* but we need to be certain)
-    unsigned int x1 = std::max(m_posX + ch->offsetX, 0);
-    unsigned int y1 = std::max(m_posY + ch->offsetY, 0);
-    unsigned int x2 = std::min(x1 + bitmap.width, m_textureWidth);
-    unsigned int y2 = std::min(y1 + bitmap.rows, m_textureHeight);
-    CopyCharToTexture(bitGlyph, x1, y1, x2, y2);
-
-    m_posX += spacing_between_characters_in_texture + (unsigned short)std::max(ch->right - ch->left + ch->offsetX, ch->advance);
-  }
+    m_page->Copy(x, y, bitmap.buffer, bitmap.pitch, bitmap.width, bitmap.rows);
   m_numChars++;
 
   // free the glyph
@@ -803,12 +865,88 @@ bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *
   return true;
 }
 
+bool CGUIFontTTFBase::CacheDistanceFieldCharacter(wchar_t letter, uint32_t style, Character *ch)
+{
+  character_t letterAndStyle = (style << 16) | letter;
+
+  // the glyph may be on our page already, placed by another size of the face
+  const unsigned int maxSize = DISTANCE_FIELD_SIZE + 2 * DISTANCE_FIELD_SPREAD;
+  if (!m_page && !AcquirePage(maxSize, maxSize))
+    return false;
+  const CGUIFontAtlasPage::DistanceFieldGlyph *cached = m_page->GetDistanceFieldGlyph(m_distanceFieldFace, letterAndStyle);
+
+  CGUIFontAtlasPage::DistanceFieldGlyph field = { 0 };
+  if (cached)
+    field = *cached;
+  else
+  {
+    // render at the reference size
+    FT_Activate_Size(m_distanceFieldSize);
+    FT_Glyph glyph = NULL;
+    bool loaded = FT_Load_Glyph(m_face, FT_Get_Char_Index(m_face, letter), FT_LOAD_NO_HINTING) == 0;
+    if (loaded)
+    {
+      if (style & FONT_STYLE_BOLD)
+        SetGlyphStrength(m_face->glyph, GLYPH_STRENGTH_BOLD);
+      if (style & FONT_STYLE_ITALICS)
+        ObliqueGlyph(m_face->glyph);
+      if (style & FONT_STYLE_LIGHT)
+        SetGlyphStrength(m_face->glyph, GLYPH_STRENGTH_LIGHT);
+      field.advance = m_face->glyph->advance.x / 64.0f;
+      loaded = FT_Get_Glyph(m_face->glyph, &glyph) == 0;
+    }
+    FT_Activate_Size(m_faceSize);
+    if (!loaded || FT_Glyph_To_Bitmap(&glyph, FT_RENDER_MODE_NORMAL, NULL, 1))
+    {
+      if (glyph)
+        FT_Done_Glyph(glyph);
+      CLog::Log(LOGDEBUG, "%s Failed to render glyph %x", __FUNCTION__, static_cast<uint32_t>(letter));
+      return false;
+    }
+
+    FT_BitmapGlyph bitGlyph = (FT_BitmapGlyph)glyph;
+    FT_Bitmap bitmap = bitGlyph->bitmap;
+    if (bitmap.width && bitmap.rows)
+    {
+      std::vector<uint8_t> pixels;
+      CGUIFontAtlas::BuildDistanceField(bitmap.buffer, bitmap.width, bitmap.rows, bitmap.pitch,
+                                        DISTANCE_FIELD_SPREAD, pixels);
+      field.width = bitmap.width + 2 * DISTANCE_FIELD_SPREAD;
+      field.height = bitmap.rows + 2 * DISTANCE_FIELD_SPREAD;
+      if (!m_page->Allocate(field.width, field.height, field.x, field.y))
+      {
+        FT_Done_Glyph(glyph);
+        CLog::Log(LOGDEBUG, "%s: Page is full", __FUNCTION__);
+        return false;
+      }
+      m_page->Copy(field.x, field.y, pixels.data(), field.width, field.width, field.height);
+      field.offsetX = static_cast<float>(bitGlyph->left) - DISTANCE_FIELD_SPREAD;
+      field.offsetY = -static_cast<float>(bitGlyph->top) - DISTANCE_FIELD_SPREAD;
+    }
+    FT_Done_Glyph(glyph);
+    m_page->AddDistanceFieldGlyph(m_distanceFieldFace, letterAndStyle, field);
+  }
+
+  // scale from the reference size to ours
+  ch->letterAndStyle = letterAndStyle;
+  ch->offsetX = (short)MathUtils::round_int(field.offsetX * m_glyphScale);
+  ch->offsetY = (short)MathUtils::round_int(m_cellBaseLine + field.offsetY * m_glyphScale);
+  ch->left = (float)field.x;
+  ch->top = (float)field.y;
+  ch->right = ch->left + field.width;
+  ch->bottom = ch->top + field.height;
+  ch->advance = (float)MathUtils::round_int(field.advance * m_glyphScale);
+  m_numChars++;
+
+  return true;
+}
+
 void CGUIFontTTFBase::RenderCharacter(float posX, float posY, const Character *ch, UTILS::Color color, bool roundX, std::vector<SVertex> &vertices)
 {
   // actual image width isn't same as the character width as that is
   // just baseline width and height should include the descent
-  const float width = ch->right - ch->left;
-  const float height = ch->bottom - ch->top;
+  const float width = (ch->right - ch->left) * m_glyphScale;
+  const float height = (ch->bottom - ch->top) * m_glyphScale;
 
   // return early if nothing to render
   if (width == 0 || height == 0)
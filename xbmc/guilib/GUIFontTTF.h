@@ -12,6 +12,7 @@
 #include <stdint.h>
 #include <vector>
 
+#include "GUIFontAtlas.h"
 #include "utils/auto_buffer.h"
 #include "utils/Color.h"
 #include "utils/Geometry.h"
@@ -26,7 +27,6 @@ using namespace DirectX::PackedVector;
 
 constexpr size_t LOOKUPTABLE_SIZE = 256 * 8;
 
-class CBaseTexture;
 class CRenderSystemBase;
 
 struct FT_FaceRec_;
@@ -34,12 +34,14 @@ struct FT_LibraryRec_;
 struct FT_GlyphSlotRec_;
 struct FT_BitmapGlyphRec_;
 struct FT_StrokerRec_;
+struct FT_SizeRec_;
 
 typedef struct FT_FaceRec_ *FT_Face;
 typedef struct FT_LibraryRec_ *FT_Library;
 typedef struct FT_GlyphSlotRec_ *FT_GlyphSlot;
 typedef struct FT_BitmapGlyphRec_ *FT_BitmapGlyph;
 typedef struct FT_StrokerRec_ *FT_Stroker;
+typedef struct FT_SizeRec_ *FT_Size;
 
 typedef uint32_t character_t;
 typedef std::vector<character_t> vecText;
@@ -112,29 +114,43 @@ protected:
   // Stuff for pre-rendering for speed
   inline Character *GetCharacter(character_t letter);
   bool CacheCharacter(wchar_t letter, uint32_t style, Character *ch);
+  bool CacheDistanceFieldCharacter(wchar_t letter, uint32_t style, Character *ch);
   void RenderCharacter(float posX, float posY, const Character *ch, UTILS::Color color, bool roundX, std::vector<SVertex> &vertices);
   void ClearCharacterCache();
 
-  virtual CBaseTexture* ReallocTexture(unsigned int& newHeight) = 0;
-  virtual bool CopyCharToTexture(FT_BitmapGlyph bitGlyph, unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2) = 0;
-  virtual void DeleteHardwareTexture() = 0;
+  /*! \brief Clears our characters if the atlas cleared our page for another font
+   \return true if the characters were cleared
+   */
+  bool ValidateCharacterCache();
+
+  /*! \brief Moves on to a page of the atlas with room for a glyph of the given size
+   */
+  bool AcquirePage(unsigned int width, unsigned int height);
+
+  /*! \brief Moves on to pages of twice the size, for text with more characters than fit our page
+   \return false if the render system doesn't support larger textures
+   */
+  bool GrowPage();
+
+  /*! \brief Whether the render system can draw distance field glyphs
+   */
+  virtual bool SupportsDistanceField() const { return false; }
 
   // modifying glyphs
   void SetGlyphStrength(FT_GlyphSlot slot, int glyphStrength);
   static void ObliqueGlyph(FT_GlyphSlot slot);
 
-  CBaseTexture* m_texture;        // texture that holds our rendered characters (8bit alpha only)
+  CGUIFontAtlasPagePtr m_page;       // atlas page that holds our rendered characters
+  unsigned int m_pageGeneration;     // generation of the page our characters were placed in
+  unsigned int m_pageSize;           // smallest page we can use, 0 for the default size of the atlas
+  unsigned int m_cacheClears;        // number of times our characters were cleared
+  bool m_dynamicCacheStale;          // vertex buffers to flush on the render thread, see ClearCharacterCache()
 
-  unsigned int m_textureWidth;       // width of our texture
-  unsigned int m_textureHeight;      // height of our texture
-  int m_posX;                        // current position in the texture
-  int m_posY;
-
-  /*! \brief the height of each line in the texture.
-   Accounts for spacing between lines to avoid characters overlapping.
-   */
-  unsigned int GetTextureLineHeight() const;
-  static const unsigned int spacing_between_characters_in_texture;
+  bool m_distanceField;              // characters are distance fields shared with the other sizes of the face
+  int m_distanceFieldFace;           // face in the atlas, -1 for bitmap characters
+  FT_Size m_distanceFieldSize;       // reference size of m_face distance fields are rendered at
+  FT_Size m_faceSize;                // our size of m_face
+  float m_glyphScale;                // size of the characters on screen relative to their size in the page
 
   UTILS::Color m_color;
 
@@ -157,8 +173,6 @@ protected:
   float m_originX;
   float m_originY;
 
-  unsigned int m_nTexture;
-
   struct CTranslatedVertices
   {
     float translateX;
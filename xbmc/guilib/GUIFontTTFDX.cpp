@@ -9,7 +9,6 @@
 #include "GUIFontTTFDX.h"
 #include "GUIFontManager.h"
 #include "GUIShaderDX.h"
-#include "Texture.h"
 #include "rendering/dx/DeviceResources.h"
 #include "rendering/dx/RenderContext.h"
 #include "utils/log.h"
@@ -26,10 +25,18 @@ using namespace Microsoft::WRL;
 #include FT_FREETYPE_H
 #include FT_GLYPH_H
 
+namespace
+{
+class CGUIFontAtlasTextureDX : public CGUIFontAtlasTexture
+{
+public:
+  CD3DTexture m_texture;
+};
+}
+
 CGUIFontTTFDX::CGUIFontTTFDX(const std::string& strFileName)
 : CGUIFontTTFBase(strFileName)
 {
-  m_speedupTexture = nullptr;
   m_vertexBuffer   = nullptr;
   m_vertexWidth    = 0;
   m_buffers.clear();
@@ -40,11 +47,6 @@ CGUIFontTTFDX::~CGUIFontTTFDX(void)
 {
   DX::Windowing()->Unregister(this);
 
-  if (m_speedupTexture)
-  {
-    delete m_speedupTexture;
-    m_speedupTexture = nullptr;
-  }
   m_vertexBuffer = nullptr;
   m_staticIndexBuffer = nullptr;
   if (!m_buffers.empty())
@@ -60,9 +62,33 @@ CGUIFontTTFDX::~CGUIFontTTFDX(void)
 
 bool CGUIFontTTFDX::FirstBegin()
 {
-  if (!DX::DeviceResources::Get()->GetD3DContext())
+  ComPtr<ID3D11DeviceContext> pContext = DX::DeviceResources::Get()->GetD3DContext();
+  if (!pContext)
     return false;
 
+  // the page is shared with other fonts, which may have placed characters on it as well
+  CGUIFontAtlasTextureDX* texture = static_cast<CGUIFontAtlasTextureDX*>(m_page->GetTexture());
+  if (!texture)
+  {
+    texture = new CGUIFontAtlasTextureDX;
+    if (!texture->m_texture.Create(m_page->GetWidth(), m_page->GetHeight(), 1, D3D11_USAGE_DEFAULT, DXGI_FORMAT_R8_UNORM))
+    {
+      CLog::Log(LOGERROR, "%s: Failed to create a texture for the font page", __FUNCTION__);
+      delete texture;
+      return false;
+    }
+    m_page->SetTexture(texture);
+  }
+
+  unsigned int updateY1, updateY2;
+  if (m_page->GetDirtyRows(updateY1, updateY2))
+  {
+    CD3D11_BOX dstBox(0, updateY1, 0, m_page->GetWidth(), updateY2, 1);
+    pContext->UpdateSubresource(texture->m_texture.Get(), 0, &dstBox,
+                                m_page->GetPixels() + updateY1 * m_page->GetWidth(), m_page->GetWidth(), 0);
+    m_page->ClearDirtyRows();
+  }
+
   CGUIShaderDX* pGUIShader = DX::Windowing()->GetGUIShader();
   pGUIShader->Begin(SHADER_METHOD_RENDER_FONT);
 
@@ -82,6 +108,10 @@ void CGUIFontTTFDX::LastEnd()
   if (m_vertex.empty() && transIsEmpty)
     return;
 
+  CGUIFontAtlasTextureDX* texture = m_page ? static_cast<CGUIFontAtlasTextureDX*>(m_page->GetTexture()) : nullptr;
+  if (!texture)
+    return;
+
   CreateStaticIndexBuffer();
 
   unsigned int offset = 0;
@@ -89,7 +119,7 @@ void CGUIFontTTFDX::LastEnd()
 
   CGUIShaderDX* pGUIShader = DX::Windowing()->GetGUIShader();
   // Set font texture as shader resource
-  pGUIShader->SetShaderViews(1, m_speedupTexture->GetAddressOfSRV());
+  pGUIShader->SetShaderViews(1, texture->m_texture.GetAddressOfSRV());
   // Enable alpha blend
   DX::Windowing()->SetAlphaBlendEnable(true);
   // Set our static index buffer
@@ -215,73 +245,6 @@ void CGUIFontTTFDX::ClearReference(CGUIFontTTFDX* font, CD3DBuffer* pBuffer)
     font->m_buffers.erase(it);
 }
 
-CBaseTexture* CGUIFontTTFDX::ReallocTexture(unsigned int& newHeight)
-{
-  assert(newHeight != 0);
-  assert(m_textureWidth != 0);
-  if(m_textureHeight == 0)
-  {
-    delete m_texture;
-    m_texture = nullptr;
-    delete m_speedupTexture;
-    m_speedupTexture = nullptr;
-  }
-  m_staticCache.Flush();
-  m_dynamicCache.Flush();
-
-  CDXTexture* pNewTexture = new CDXTexture(m_textureWidth, newHeight, XB_FMT_A8);
-  CD3DTexture* newSpeedupTexture = new CD3DTexture();
-  if (!newSpeedupTexture->Create(m_textureWidth, newHeight, 1, D3D11_USAGE_DEFAULT, DXGI_FORMAT_R8_UNORM))
-  {
-    delete newSpeedupTexture;
-    delete pNewTexture;
-    return nullptr;
-  }
-
-  // There might be data to copy from the previous texture
-  if (newSpeedupTexture && m_speedupTexture)
-  {
-    CD3D11_BOX rect(0, 0, 0, m_textureWidth, m_textureHeight, 1);
-    ComPtr<ID3D11DeviceContext> pContext = DX::DeviceResources::Get()->GetImmediateContext();
-    pContext->CopySubresourceRegion(newSpeedupTexture->Get(), 0, 0, 0, 0, m_speedupTexture->Get(), 0, &rect);
-  }
-
-  if (m_texture)
-  {
-    delete m_texture;
-    m_texture = nullptr;
-  }
-  if (m_speedupTexture)
-  {
-    delete m_speedupTexture;
-    m_speedupTexture = nullptr;
-  }
-  m_textureHeight = newHeight;
-  m_textureScaleY = 1.0f / m_textureHeight;
-  m_speedupTexture = newSpeedupTexture;
-
-  return pNewTexture;
-}
-
-bool CGUIFontTTFDX::CopyCharToTexture(FT_BitmapGlyph bitGlyph, unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2)
-{
-  FT_Bitmap bitmap = bitGlyph->bitmap;
-
-  ComPtr<ID3D11DeviceContext> pContext = DX::DeviceResources::Get()->GetImmediateContext();
-  if (m_speedupTexture && m_speedupTexture->Get() && pContext && bitmap.buffer)
-  {
-    CD3D11_BOX dstBox(x1, y1, 0, x2, y2, 1);
-    pContext->UpdateSubresource(m_speedupTexture->Get(), 0, &dstBox, bitmap.buffer, bitmap.pitch, 0);
-    return true;
-  }
-
-  return false;
-}
-
-void CGUIFontTTFDX::DeleteHardwareTexture()
-{
-}
-
 bool CGUIFontTTFDX::UpdateDynamicVertexBuffer(const SVertex* pSysMem, unsigned int vertex_count)
 {
   ComPtr<ID3D11Device> pDevice = DX::DeviceResources::Get()->GetD3DDevice();
@@ -42,18 +42,12 @@ public:
   static void CreateStaticIndexBuffer(void);
   static void DestroyStaticIndexBuffer(void);
 
-protected:
-  CBaseTexture* ReallocTexture(unsigned int& newHeight) override;
-  bool CopyCharToTexture(FT_BitmapGlyph bitGlyph, unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2) override;
-  void DeleteHardwareTexture() override;
-
 private:
   bool UpdateDynamicVertexBuffer(const SVertex* pSysMem, unsigned int count);
   static void AddReference(CGUIFontTTFDX* font, CD3DBuffer* pBuffer);
   static void ClearReference(CGUIFontTTFDX* font, CD3DBuffer* pBuffer);
 
   unsigned m_vertexWidth;
-  CD3DTexture* m_speedupTexture;  // extra texture to speed up reallocations
   Microsoft::WRL::ComPtr<ID3D11Buffer> m_vertexBuffer;
   std::list<CD3DBuffer*> m_buffers;
 
@@ -9,7 +9,6 @@
 #include "GUIFont.h"
 #include "GUIFontTTFGL.h"
 #include "GUIFontManager.h"
-#include "Texture.h"
 #include "TextureManager.h"
 #include "windowing/GraphicContext.h"
 #include "ServiceBroker.h"
@@ -34,12 +33,25 @@
 #define ELEMENT_ARRAY_MAX_CHAR_INDEX (1000)
 #define BUFFER_OFFSET(i) ((char *)NULL + (i))
 
+namespace
+{
+class CGUIFontAtlasTextureGL : public CGUIFontAtlasTexture
+{
+public:
+  CGUIFontAtlasTextureGL() { glGenTextures(1, &m_texture); }
+  ~CGUIFontAtlasTextureGL() override
+  {
+    if (glIsTexture(m_texture))
+      CServiceBroker::GetGUI()->GetTextureManager().ReleaseHwTexture(m_texture);
+  }
+
+  GLuint m_texture = 0;
+};
+}
+
 CGUIFontTTFGL::CGUIFontTTFGL(const std::string& strFileName)
 : CGUIFontTTFBase(strFileName)
 {
-  m_updateY1 = 0;
-  m_updateY2 = 0;
-  m_textureStatus = TEXTURE_VOID;
 }
 
 CGUIFontTTFGL::~CGUIFontTTFGL(void)
@@ -48,7 +60,6 @@ CGUIFontTTFGL::~CGUIFontTTFGL(void)
   // destructed before the CGUIFontTTFGL goes out of scope, because
   // our virtual methods won't be accessible after this point
   m_dynamicCache.Flush();
-  DeleteHardwareTexture();
 }
 
 bool CGUIFontTTFGL::FirstBegin()
@@ -68,48 +79,42 @@ bool CGUIFontTTFGL::FirstBegin()
   GLenum internalFormat = GL_ALPHA;
 #endif
 
-  if (m_textureStatus == TEXTURE_REALLOCATED)
-  {
-    if (glIsTexture(m_nTexture))
-      CServiceBroker::GetGUI()->GetTextureManager().ReleaseHwTexture(m_nTexture);
-    m_textureStatus = TEXTURE_VOID;
-  }
-
-  if (m_textureStatus == TEXTURE_VOID)
+  // the page is shared with other fonts, which may have placed characters on it as well
+  CGUIFontAtlasTextureGL *texture = static_cast<CGUIFontAtlasTextureGL*>(m_page->GetTexture());
+  if (!texture)
   {
     // Have OpenGL generate a texture object handle for us
-    glGenTextures(1, (GLuint*) &m_nTexture);
+    texture = new CGUIFontAtlasTextureGL;
+    m_page->SetTexture(texture);
 
     // Bind the texture object
-    glBindTexture(GL_TEXTURE_2D, m_nTexture);
+    glBindTexture(GL_TEXTURE_2D, texture->m_texture);
 
     // Set the texture's stretching properties
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
-    // Set the texture image -- THIS WORKS, so the pixels must be wrong.
-    glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, m_texture->GetWidth(), m_texture->GetHeight(), 0,
+    glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, m_page->GetWidth(), m_page->GetHeight(), 0,
         pixformat, GL_UNSIGNED_BYTE, 0);
 
     VerifyGLState();
-    m_textureStatus = TEXTURE_UPDATED;
   }
 
-  if (m_textureStatus == TEXTURE_UPDATED)
+  unsigned int updateY1, updateY2;
+  if (m_page->GetDirtyRows(updateY1, updateY2))
   {
-    glBindTexture(GL_TEXTURE_2D, m_nTexture);
-    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, m_updateY1, m_texture->GetWidth(), m_updateY2 - m_updateY1, pixformat, GL_UNSIGNED_BYTE,
-        m_texture->GetPixels() + m_updateY1 * m_texture->GetPitch());
+    glBindTexture(GL_TEXTURE_2D, texture->m_texture);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, updateY1, m_page->GetWidth(), updateY2 - updateY1, pixformat, GL_UNSIGNED_BYTE,
+        m_page->GetPixels() + updateY1 * m_page->GetWidth());
 
-    m_updateY1 = m_updateY2 = 0;
-    m_textureStatus = TEXTURE_READY;
+    m_page->ClearDirtyRows();
   }
 
   // Turn Blending On
   glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE_MINUS_DST_ALPHA, GL_ONE);
   glEnable(GL_BLEND);
   glActiveTexture(GL_TEXTURE0);
-  glBindTexture(GL_TEXTURE_2D, m_nTexture);
+  glBindTexture(GL_TEXTURE_2D, texture->m_texture);
   return true;
 }
 
@@ -117,7 +122,7 @@ void CGUIFontTTFGL::LastEnd()
 {
 #ifdef HAS_GL
   CRenderSystemGL* renderSystem = dynamic_cast<CRenderSystemGL*>(CServiceBroker::GetRenderSystem());
-  renderSystem->EnableShader(SM_FONTS);
+  renderSystem->EnableShader(m_distanceField ? SM_FONTS_SDF : SM_FONTS);
 
   GLint posLoc = renderSystem->ShaderGetPos();
   GLint colLoc = renderSystem->ShaderGetCol();
@@ -318,106 +323,6 @@ void CGUIFontTTFGL::DestroyVertexBuffer(CVertexBuffer &buffer) const
   }
 }
 
-CBaseTexture* CGUIFontTTFGL::ReallocTexture(unsigned int& newHeight)
-{
-  newHeight = CBaseTexture::PadPow2(newHeight);
-
-  CBaseTexture* newTexture = new CTexture(m_textureWidth, newHeight, XB_FMT_A8);
-
-  if (!newTexture || newTexture->GetPixels() == NULL)
-  {
-    CLog::Log(LOGERROR, "GUIFontTTFGL::CacheCharacter: Error creating new cache texture for size %f", m_height);
-    delete newTexture;
-    return NULL;
-  }
-  m_textureHeight = newTexture->GetHeight();
-  m_textureScaleY = 1.0f / m_textureHeight;
-  m_textureWidth = newTexture->GetWidth();
-  m_textureScaleX = 1.0f / m_textureWidth;
-  if (m_textureHeight < newHeight)
-    CLog::Log(LOGWARNING, "%s: allocated new texture with height of %d, requested %d", __FUNCTION__, m_textureHeight, newHeight);
-  m_staticCache.Flush();
-  m_dynamicCache.Flush();
-
-  memset(newTexture->GetPixels(), 0, m_textureHeight * newTexture->GetPitch());
-  if (m_texture)
-  {
-    m_updateY1 = 0;
-    m_updateY2 = m_texture->GetHeight();
-
-    unsigned char* src = m_texture->GetPixels();
-    unsigned char* dst = newTexture->GetPixels();
-    for (unsigned int y = 0; y < m_texture->GetHeight(); y++)
-    {
-      memcpy(dst, src, m_texture->GetPitch());
-      src += m_texture->GetPitch();
-      dst += newTexture->GetPitch();
-    }
-    delete m_texture;
-  }
-
-  m_textureStatus = TEXTURE_REALLOCATED;
-
-  return newTexture;
-}
-
-bool CGUIFontTTFGL::CopyCharToTexture(FT_BitmapGlyph bitGlyph, unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2)
-{
-  FT_Bitmap bitmap = bitGlyph->bitmap;
-
-  unsigned char* source = bitmap.buffer;
-  unsigned char* target = m_texture->GetPixels() + y1 * m_texture->GetPitch() + x1;
-
-  for (unsigned int y = y1; y < y2; y++)
-  {
-    memcpy(target, source, x2-x1);
-    source += bitmap.width;
-    target += m_texture->GetPitch();
-  }
-
-  switch (m_textureStatus)
-  {
-  case TEXTURE_UPDATED:
-    {
-      m_updateY1 = std::min(m_updateY1, y1);
-      m_updateY2 = std::max(m_updateY2, y2);
-    }
-    break;
-
-  case TEXTURE_READY:
-    {
-      m_updateY1 = y1;
-      m_updateY2 = y2;
-      m_textureStatus = TEXTURE_UPDATED;
-    }
-    break;
-
-  case TEXTURE_REALLOCATED:
-    {
-      m_updateY2 = std::max(m_updateY2, y2);
-    }
-    break;
-
-  case TEXTURE_VOID:
-  default:
-    break;
-  }
-
-  return true;
-}
-
-void CGUIFontTTFGL::DeleteHardwareTexture()
-{
-  if (m_textureStatus != TEXTURE_VOID)
-  {
-    if (glIsTexture(m_nTexture))
-      CServiceBroker::GetGUI()->GetTextureManager().ReleaseHwTexture(m_nTexture);
-
-    m_textureStatus = TEXTURE_VOID;
-    m_updateY1 = m_updateY2 = 0;
-  }
-}
-
 void CGUIFontTTFGL::CreateStaticVertexBuffers(void)
 {
   if (m_staticVertexBufferCreated)
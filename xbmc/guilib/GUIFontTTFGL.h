@@ -29,26 +29,13 @@ public:
   static void DestroyStaticVertexBuffers(void);
 
 protected:
-  CBaseTexture* ReallocTexture(unsigned int& newHeight) override;
-  bool CopyCharToTexture(FT_BitmapGlyph bitGlyph, unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2) override;
-  void DeleteHardwareTexture() override;
+#if defined(HAS_GL)
+  bool SupportsDistanceField() const override { return true; }
+#endif
 
   static GLuint m_elementArrayHandle;
 
 private:
-  unsigned int m_updateY1;
-  unsigned int m_updateY2;
-
-  enum TextureStatus
-  {
-    TEXTURE_VOID = 0,
-    TEXTURE_READY,
-    TEXTURE_REALLOCATED,
-    TEXTURE_UPDATED,
-  };
-
-  TextureStatus m_textureStatus;
-
   static bool m_staticVertexBufferCreated;
 };
 
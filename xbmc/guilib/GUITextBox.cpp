@@ -43,6 +43,8 @@ CGUITextBox::CGUITextBox(int parentID, int controlID, float posX, float posY, fl
   m_renderHeight = height;
   if (labelInfoMono)
     SetMonoFont(labelInfoMono->font);
+  // long plots and lyrics are laid out without holding up rendering
+  SetAsyncUpdate(true);
 }
 
 CGUITextBox::CGUITextBox(const CGUITextBox &from)
@@ -93,6 +95,11 @@ void CGUITextBox::UpdateInfo(const CGUIListItem *item)
   if (!CGUITextLayout::Update(item ? m_info.GetItemLabel(item) : m_info.GetLabel(m_parentID), m_width))
     return; // nothing changed
 
+  OnTextChanged();
+}
+
+void CGUITextBox::OnTextChanged()
+{
   // needed update, so reset to the top of the textbox and update our sizing/page control
   SetInvalid();
   m_offset = 0;
@@ -125,6 +132,14 @@ void CGUITextBox::DoProcess(unsigned int currentTime, CDirtyRegionList &dirtyreg
 
 void CGUITextBox::Process(unsigned int currentTime, CDirtyRegionList &dirtyregions)
 {
+  // text laid out by a job. with pushed updates, as in list item layouts,
+  // UpdateInfo isn't called again until the item changes
+  if (CompleteAsyncUpdate())
+  {
+    OnTextChanged();
+    MarkDirtyRegion();
+  }
+
   // update our auto-scrolling as necessary
   if (m_autoScrollTime && m_lines.size() > m_itemsPerPage)
   {
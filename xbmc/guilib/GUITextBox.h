@@ -61,6 +61,7 @@ protected:
   bool UpdateColors() override;
   void UpdateInfo(const CGUIListItem *item = NULL) override;
   void UpdatePageControl();
+  void OnTextChanged();
   void ScrollToOffset(int offset, bool autoScroll = false);
   unsigned int GetRows() const;
   int GetCurrentPage() const;
@@ -11,8 +11,22 @@
 #include "GUIComponent.h"
 #include "GUIControl.h"
 #include "GUIColorManager.h"
+#include "GUITextLayoutJob.h"
+#include "ServiceBroker.h"
+#include "threads/SingleLock.h"
 #include "utils/CharsetConverter.h"
+#include "utils/JobManager.h"
 #include "utils/StringUtils.h"
+#include "windowing/GraphicContext.h"
+#include "windowing/WinSystem.h"
+
+#include <algorithm>
+
+namespace
+{
+// how long a layout job holds the graphics context at a time
+const unsigned int LAYOUT_SLICE_MILLIS = 2;
+}
 
 CGUIString::CGUIString(iString start, iString end, bool carriageReturn)
 {
@@ -40,6 +54,11 @@ CGUITextLayout::CGUITextLayout(CGUIFont *font, bool wrap, float fHeight, CGUIFon
   m_lastUpdateW = false;
 }
 
+CGUITextLayout::~CGUITextLayout()
+{
+  CancelAsyncUpdate();
+}
+
 void CGUITextLayout::SetWrap(bool bWrap)
 {
   m_wrap = bWrap;
@@ -203,11 +222,15 @@ void CGUITextLayout::RenderOutline(float x, float y, UTILS::Color color, UTILS::
 
 bool CGUITextLayout::Update(const std::string &text, float maxWidth, bool forceUpdate /*= false*/, bool forceLTRReadingOrder /*= false*/)
 {
+  bool completed = CompleteAsyncUpdate();
   if (text == m_lastUtf8Text && !forceUpdate && !m_lastUpdateW)
-    return false;
+    return completed;
 
   m_lastUtf8Text = text;
   m_lastUpdateW = false;
+  if (m_asyncUpdate && m_font)
+    return UpdateAsync(text, std::wstring(), maxWidth, forceLTRReadingOrder) || completed;
+
   std::wstring utf16;
   g_charsetConverter.utf8ToW(text, utf16, false);
   UpdateCommon(utf16, maxWidth, forceLTRReadingOrder);
@@ -216,11 +239,15 @@ bool CGUITextLayout::Update(const std::string &text, float maxWidth, bool forceU
 
 bool CGUITextLayout::UpdateW(const std::wstring &text, float maxWidth /*= 0*/, bool forceUpdate /*= false*/, bool forceLTRReadingOrder /*= false*/)
 {
+  bool completed = CompleteAsyncUpdate();
   if (text == m_lastText && !forceUpdate && m_lastUpdateW)
-    return false;
+    return completed;
 
   m_lastText = text;
   m_lastUpdateW = true;
+  if (m_asyncUpdate && m_font)
+    return UpdateAsync(std::string(), text, maxWidth, forceLTRReadingOrder) || completed;
+
   UpdateCommon(text, maxWidth, forceLTRReadingOrder);
   return true;
 }
@@ -242,6 +269,189 @@ void CGUITextLayout::UpdateStyled(const vecText &text, const std::vector<UTILS::
   m_lines.clear();
   m_colors = colors;
 
+  BreakLines(text, maxWidth);
+
+  BidiTransform(m_lines, forceLTRReadingOrder);
+
+  // and cache the width and height for later reading
+  CalcTextExtent();
+}
+
+bool CGUITextLayout::UpdateAsync(const std::string &utf8Text, const std::wstring &text, float maxWidth, bool forceLTRReadingOrder)
+{
+  // whatever is being prepared is out of date
+  CancelAsyncUpdate();
+
+  CGUITextLayoutUpdate::Key key = { utf8Text, text, m_lastUpdateW, m_font, m_font->GetStyle(), m_textColor,
+                                    maxWidth, m_maxHeight, m_wrap, forceLTRReadingOrder };
+  CGUITextLayoutCache &cache = CGUITextLayoutCache::GetInstance();
+  CGUITextLayoutUpdate::LayoutPtr layout = cache.Get(key);
+  if (layout)
+  {
+    m_colors = layout->colors;
+    m_lines = layout->lines;
+    m_textWidth = layout->width;
+    m_textHeight = layout->height;
+    return true;
+  }
+
+  // with nothing on display yet, waiting would only show nothing longer
+  if (m_lines.empty())
+  {
+    std::wstring utf16(text);
+    if (!m_lastUpdateW)
+      g_charsetConverter.utf8ToW(utf8Text, utf16, false);
+    UpdateCommon(utf16, maxWidth, forceLTRReadingOrder);
+
+    std::shared_ptr<CGUITextLayoutUpdate::Layout> newLayout = std::make_shared<CGUITextLayoutUpdate::Layout>();
+    newLayout->colors = m_colors;
+    newLayout->lines = m_lines;
+    newLayout->width = m_textWidth;
+    newLayout->height = m_textHeight;
+    cache.Add(key, newLayout);
+    return true;
+  }
+
+  std::shared_ptr<CGUITextLayoutUpdate> update = std::make_shared<CGUITextLayoutUpdate>(key, cache.GetGeneration());
+  m_pending.m_update = update;
+  CJobManager::GetInstance().Submit([update]() {
+    PrepareLayout(update);
+  }, CJob::PRIORITY_HIGH);
+  return false;
+}
+
+bool CGUITextLayout::CompleteAsyncUpdate()
+{
+  if (!m_pending.m_update)
+    return false;
+
+  // a job that saw the fonts change gives up without a layout
+  CGUITextLayoutCache &cache = CGUITextLayoutCache::GetInstance();
+  const bool stale = m_pending.m_update->m_generation != cache.GetGeneration();
+  CGUITextLayoutUpdate::LayoutPtr layout = m_pending.m_update->GetLayout();
+  if (!layout && !stale)
+    return false;
+
+  std::shared_ptr<CGUITextLayoutUpdate> update = m_pending.m_update;
+  m_pending.m_update.reset();
+
+  if (stale)
+  {
+    // the fonts changed since the job started
+    update->Cancel();
+    std::wstring utf16(update->m_key.text);
+    if (!update->m_key.wide)
+      g_charsetConverter.utf8ToW(update->m_key.utf8Text, utf16, false);
+    UpdateCommon(utf16, update->m_key.maxWidth, update->m_key.forceLTRReadingOrder);
+    return true;
+  }
+
+  cache.Add(update->m_key, layout);
+  m_colors = layout->colors;
+  m_lines = layout->lines;
+  m_textWidth = layout->width;
+  m_textHeight = layout->height;
+  return true;
+}
+
+void CGUITextLayout::CancelAsyncUpdate()
+{
+  if (!m_pending.m_update)
+    return;
+
+  // the job uses our fonts with the graphics context locked, once we hold it the job
+  // is done with them or leaves them alone
+  CWinSystemBase *winSystem = CServiceBroker::GetWinSystem();
+  if (winSystem)
+  {
+    CSingleLock lock(winSystem->GetGfxContext());
+    m_pending.m_update->Cancel();
+  }
+  else
+    m_pending.m_update->Cancel();
+  m_pending.m_update.reset();
+}
+
+void CGUITextLayout::PrepareLayout(const std::shared_ptr<CGUITextLayoutUpdate> &update)
+{
+  const CGUITextLayoutUpdate::Key &key = update->m_key;
+  CWinSystemBase *winSystem = CServiceBroker::GetWinSystem();
+  if (!winSystem)
+    return;
+
+  std::wstring utf16(key.text);
+  if (!key.wide)
+    g_charsetConverter.utf8ToW(key.utf8Text, utf16, false);
+
+  // fonts aren't thread safe and the render thread uses them with the graphics
+  // context locked. the lock is taken in slices, so a long text doesn't hold up
+  // a frame. fonts are deleted with the lock held after the cache generation
+  // moved on, so key.font is alive as long as the generation matches
+  CGUITextLayoutSlices slices(winSystem->GetGfxContext(), LAYOUT_SLICE_MILLIS);
+  auto resume = [&update, &slices]() {
+    return !slices.Next() || (!update->IsCancelled() &&
+                              update->m_generation == CGUITextLayoutCache::GetInstance().GetGeneration());
+  };
+
+  CGUITextLayout layout(key.font, key.wrap, key.maxHeight);
+  std::vector<CGUIString> paragraphs;
+  int maxLines;
+  {
+    if (!resume())
+      return;
+    vecText parsedText;
+    ParseText(utf16, key.style, key.textColor, layout.m_colors, parsedText);
+    maxLines = layout.GetMaxLines();
+    layout.LineBreakText(parsedText, paragraphs);
+  }
+
+  if (key.wrap && key.maxWidth > 0)
+  {
+    for (const auto &paragraph : paragraphs)
+    {
+      if (!resume())
+        return;
+      if (!layout.WrapLine(paragraph, key.maxWidth, maxLines))
+        break;
+    }
+  }
+  else
+    layout.m_lines.swap(paragraphs);
+
+  // remove any trailing blank lines
+  while (!layout.m_lines.empty() && layout.m_lines.back().m_text.empty())
+    layout.m_lines.pop_back();
+  slices.Release();
+
+  BidiTransform(layout.m_lines, key.forceLTRReadingOrder);
+
+  float width = 0;
+  for (const auto &line : layout.m_lines)
+  {
+    if (!resume())
+      return;
+    width = std::max(width, key.font->GetTextWidth(line.m_text));
+  }
+  if (!resume())
+    return;
+  float height = key.font->GetTextHeight(layout.m_lines.size());
+  slices.Release();
+
+  std::shared_ptr<CGUITextLayoutUpdate::Layout> result = std::make_shared<CGUITextLayoutUpdate::Layout>();
+  result->colors.swap(layout.m_colors);
+  result->lines.swap(layout.m_lines);
+  result->width = width;
+  result->height = height;
+  update->SetLayout(result);
+}
+
+void CGUITextLayout::ClearLayoutCache()
+{
+  CGUITextLayoutCache::GetInstance().Clear();
+}
+
+void CGUITextLayout::BreakLines(const vecText &text, float maxWidth)
+{
   // if we need to wrap the text, then do so
   if (m_wrap && maxWidth > 0)
     WrapText(text, maxWidth);
@@ -251,11 +461,6 @@ void CGUITextLayout::UpdateStyled(const vecText &text, const std::vector<UTILS::
   // remove any trailing blank lines
   while (!m_lines.empty() && m_lines.back().m_text.empty())
     m_lines.pop_back();
-
-  BidiTransform(m_lines, forceLTRReadingOrder);
-
-  // and cache the width and height for later reading
-  CalcTextExtent();
 }
 
 // BidiTransform is used to handle RTL text flipping in the string
@@ -488,7 +693,7 @@ void CGUITextLayout::WrapText(const vecText &text, float maxWidth)
   if (!m_font)
     return;
 
-  int nMaxLines = (m_maxHeight > 0 && m_font->GetLineHeight() > 0)?(int)ceilf(m_maxHeight / m_font->GetLineHeight()):-1;
+  int nMaxLines = GetMaxLines();
 
   m_lines.clear();
 
@@ -497,72 +702,81 @@ void CGUITextLayout::WrapText(const vecText &text, float maxWidth)
 
   for (unsigned int i = 0; i < lines.size(); i++)
   {
-    const CGUIString &line = lines[i];
-    vecText::const_iterator lastSpace = line.m_text.begin();
-    vecText::const_iterator pos = line.m_text.begin();
-    unsigned int lastSpaceInLine = 0;
-    vecText curLine;
-    while (pos != line.m_text.end())
+    if (!WrapLine(lines[i], maxWidth, nMaxLines))
+      return;
+  }
+}
+
+bool CGUITextLayout::WrapLine(const CGUIString &line, float maxWidth, int nMaxLines)
+{
+  vecText::const_iterator lastSpace = line.m_text.begin();
+  vecText::const_iterator pos = line.m_text.begin();
+  unsigned int lastSpaceInLine = 0;
+  vecText curLine;
+  while (pos != line.m_text.end())
+  {
+    // Get the current letter in the string
+    character_t letter = *pos;
+    // check for a space
+    if (CanWrapAtLetter(letter))
     {
-      // Get the current letter in the string
-      character_t letter = *pos;
-      // check for a space
-      if (CanWrapAtLetter(letter))
+      float width = m_font->GetTextWidth(curLine);
+      if (width > maxWidth)
       {
-        float width = m_font->GetTextWidth(curLine);
-        if (width > maxWidth)
+        if (lastSpace != line.m_text.begin() && lastSpaceInLine > 0)
         {
-          if (lastSpace != line.m_text.begin() && lastSpaceInLine > 0)
-          {
-            CGUIString string(curLine.begin(), curLine.begin() + lastSpaceInLine, false);
-            m_lines.push_back(string);
-            // check for exceeding our number of lines
-            if (nMaxLines > 0 && m_lines.size() >= (size_t)nMaxLines)
-              return;
-            // skip over spaces
-            pos = lastSpace;
-            while (pos != line.m_text.end() && IsSpace(*pos))
-              ++pos;
-            curLine.clear();
-            lastSpaceInLine = 0;
-            lastSpace = line.m_text.begin();
-            continue;
-          }
+          CGUIString string(curLine.begin(), curLine.begin() + lastSpaceInLine, false);
+          m_lines.push_back(string);
+          // check for exceeding our number of lines
+          if (nMaxLines > 0 && m_lines.size() >= (size_t)nMaxLines)
+            return false;
+          // skip over spaces
+          pos = lastSpace;
+          while (pos != line.m_text.end() && IsSpace(*pos))
+            ++pos;
+          curLine.clear();
+          lastSpaceInLine = 0;
+          lastSpace = line.m_text.begin();
+          continue;
         }
-        lastSpace = pos;
-        lastSpaceInLine = curLine.size();
       }
-      curLine.push_back(letter);
-      ++pos;
+      lastSpace = pos;
+      lastSpaceInLine = curLine.size();
     }
-    // now add whatever we have left to the string
-    float width = m_font->GetTextWidth(curLine);
-    if (width > maxWidth)
+    curLine.push_back(letter);
+    ++pos;
+  }
+  // now add whatever we have left to the string
+  float width = m_font->GetTextWidth(curLine);
+  if (width > maxWidth)
+  {
+    // too long - put up to the last space on if we can + remove it from what's left.
+    if (lastSpace != line.m_text.begin() && lastSpaceInLine > 0)
     {
-      // too long - put up to the last space on if we can + remove it from what's left.
-      if (lastSpace != line.m_text.begin() && lastSpaceInLine > 0)
-      {
-        CGUIString string(curLine.begin(), curLine.begin() + lastSpaceInLine, false);
-        m_lines.push_back(string);
-        // check for exceeding our number of lines
-        if (nMaxLines > 0 && m_lines.size() >= (size_t)nMaxLines)
-          return;
-        curLine.erase(curLine.begin(), curLine.begin() + lastSpaceInLine);
-        while (curLine.size() && IsSpace(curLine.at(0)))
-          curLine.erase(curLine.begin());
-      }
+      CGUIString string(curLine.begin(), curLine.begin() + lastSpaceInLine, false);
+      m_lines.push_back(string);
+      // check for exceeding our number of lines
+      if (nMaxLines > 0 && m_lines.size() >= (size_t)nMaxLines)
+        return false;
+      curLine.erase(curLine.begin(), curLine.begin() + lastSpaceInLine);
+      while (curLine.size() && IsSpace(curLine.at(0)))
+        curLine.erase(curLine.begin());
     }
-    CGUIString string(curLine.begin(), curLine.end(), true);
-    m_lines.push_back(string);
-    // check for exceeding our number of lines
-    if (nMaxLines > 0 && m_lines.size() >= (size_t)nMaxLines)
-      return;
   }
+  CGUIString string(curLine.begin(), curLine.end(), true);
+  m_lines.push_back(string);
+  // check for exceeding our number of lines
+  return nMaxLines <= 0 || m_lines.size() < (size_t)nMaxLines;
+}
+
+int CGUITextLayout::GetMaxLines() const
+{
+  return (m_maxHeight > 0 && m_font && m_font->GetLineHeight() > 0)?(int)ceilf(m_maxHeight / m_font->GetLineHeight()):-1;
 }
 
 void CGUITextLayout::LineBreakText(const vecText &text, std::vector<CGUIString> &lines)
 {
-  int nMaxLines = (m_maxHeight > 0 && m_font && m_font->GetLineHeight() > 0)?(int)ceilf(m_maxHeight / m_font->GetLineHeight()):-1;
+  int nMaxLines = GetMaxLines();
   vecText::const_iterator lineStart = text.begin();
   vecText::const_iterator pos = text.begin();
   while (pos != text.end() && (nMaxLines <= 0 || lines.size() < (size_t)nMaxLines))
@@ -670,6 +884,7 @@ void CGUITextLayout::AppendToUTF32(const std::string &utf8, character_t colStyle
 
 void CGUITextLayout::Reset()
 {
+  CancelAsyncUpdate();
   m_lines.clear();
   m_lastText.clear();
   m_lastUtf8Text.clear();
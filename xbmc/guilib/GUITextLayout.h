@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
 #include <stdint.h>
 #include <vector>
@@ -22,6 +23,7 @@
 #endif
 
 class CGUIFont;
+class CGUITextLayoutUpdate;
 class CScrollInfo;
 
 // Process will be:
@@ -53,6 +55,7 @@ class CGUITextLayout
 {
 public:
   CGUITextLayout(CGUIFont *font, bool wrap, float fHeight=0.0f, CGUIFont *borderFont = NULL);  // this may need changing - we may just use this class to replace CLabelInfo completely
+  ~CGUITextLayout();
 
   bool UpdateScrollinfo(CScrollInfo &scrollInfo);
 
@@ -93,6 +96,18 @@ public:
    */
   void UpdateStyled(const vecText &text, const std::vector<UTILS::Color> &colors, float maxWidth = 0, bool forceLTRReadingOrder = false);
 
+  /*! \brief Lay out changed text on a job worker rather than in Update()
+   The previous text is kept until the new layout is ready, the first Update() or
+   CompleteAsyncUpdate() after that swaps it in and returns true. Text replacing nothing is laid out right away.
+   Layouts are cached by text, font, width and style, so recent texts return at once.
+   \param async whether to lay out text asynchronously, defaults to false.
+   */
+  void SetAsyncUpdate(bool async) { m_asyncUpdate = async; }
+
+  /*! \brief Forget the cached layouts, called when the fonts change
+   */
+  static void ClearLayoutCache();
+
   unsigned int GetTextLength() const;
   void GetFirstText(vecText &text) const;
   void Reset();
@@ -107,6 +122,12 @@ public:
 protected:
   void LineBreakText(const vecText &text, std::vector<CGUIString> &lines);
   void WrapText(const vecText &text, float maxWidth);
+  /*! \brief Appends the wrapped lines of a line without line breaks
+   \return false once nMaxLines lines are reached
+   */
+  bool WrapLine(const CGUIString &line, float maxWidth, int nMaxLines);
+  int GetMaxLines() const;
+  void BreakLines(const vecText &text, float maxWidth);
   static void BidiTransform(std::vector<CGUIString> &lines, bool forceLTRReadingOrder);
   static std::wstring BidiFlip(const std::wstring &text, bool forceLTRReadingOrder);
   void CalcTextExtent();
@@ -144,7 +165,34 @@ protected:
   bool        m_lastUpdateW; ///< true if the last string we updated was the wstring version
   float m_textWidth;
   float m_textHeight;
+
+  /*! \brief Swaps in the layout a job finished
+   Update() does this too. Controls that don't call Update() every frame, like the
+   ones of list item layouts which get their updates pushed, call it when processed.
+   \return true if the layout changed.
+   */
+  bool CompleteAsyncUpdate();
+
+  /*! \brief The update a job prepares for us, copies of the layout start without one
+   */
+  class CPendingUpdate
+  {
+  public:
+    CPendingUpdate() = default;
+    CPendingUpdate(const CPendingUpdate&) {}
+    CPendingUpdate& operator=(const CPendingUpdate&) { return *this; }
+
+    std::shared_ptr<CGUITextLayoutUpdate> m_update;
+  };
+  CPendingUpdate m_pending;
+
 private:
+  bool UpdateAsync(const std::string &utf8Text, const std::wstring &text, float maxWidth, bool forceLTRReadingOrder);
+  void CancelAsyncUpdate();
+  static void PrepareLayout(const std::shared_ptr<CGUITextLayoutUpdate> &update);
+
+  bool m_asyncUpdate = false;
+
   inline bool IsSpace(character_t letter) const XBMC_FORCE_INLINE
   {
     return (letter & 0xffff) == L' ';
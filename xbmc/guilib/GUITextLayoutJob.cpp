@@ -0,0 +1,120 @@
+/*
+ *  Copyright (C) 2019 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "GUITextLayoutJob.h"
+#include "threads/SingleLock.h"
+#include "threads/Thread.h"
+
+bool CGUITextLayoutUpdate::Key::operator==(const Key &other) const
+{
+  return wide == other.wide && font == other.font && style == other.style &&
+         textColor == other.textColor && maxWidth == other.maxWidth &&
+         maxHeight == other.maxHeight && wrap == other.wrap &&
+         forceLTRReadingOrder == other.forceLTRReadingOrder &&
+         (wide ? text == other.text : utf8Text == other.utf8Text);
+}
+
+bool CGUITextLayoutUpdate::IsCancelled() const
+{
+  CSingleLock lock(m_section);
+  return m_cancelled;
+}
+
+void CGUITextLayoutUpdate::Cancel()
+{
+  CSingleLock lock(m_section);
+  m_cancelled = true;
+}
+
+CGUITextLayoutUpdate::LayoutPtr CGUITextLayoutUpdate::GetLayout() const
+{
+  CSingleLock lock(m_section);
+  return m_layout;
+}
+
+void CGUITextLayoutUpdate::SetLayout(const LayoutPtr &layout)
+{
+  CSingleLock lock(m_section);
+  m_layout = layout;
+}
+
+CGUITextLayoutCache& CGUITextLayoutCache::GetInstance()
+{
+  static CGUITextLayoutCache cache;
+  return cache;
+}
+
+CGUITextLayoutUpdate::LayoutPtr CGUITextLayoutCache::Get(const CGUITextLayoutUpdate::Key &key)
+{
+  CSingleLock lock(m_section);
+  for (auto it = m_layouts.begin(); it != m_layouts.end(); ++it)
+  {
+    if (it->first == key)
+    {
+      m_layouts.splice(m_layouts.begin(), m_layouts, it);
+      return it->second;
+    }
+  }
+  return CGUITextLayoutUpdate::LayoutPtr();
+}
+
+void CGUITextLayoutCache::Add(const CGUITextLayoutUpdate::Key &key, const CGUITextLayoutUpdate::LayoutPtr &layout)
+{
+  CSingleLock lock(m_section);
+  m_layouts.emplace_front(key, layout);
+  if (m_layouts.size() > MAX_LAYOUTS)
+    m_layouts.pop_back();
+}
+
+void CGUITextLayoutCache::Clear()
+{
+  CSingleLock lock(m_section);
+  m_layouts.clear();
+  m_generation++;
+}
+
+unsigned int CGUITextLayoutCache::GetGeneration() const
+{
+  CSingleLock lock(m_section);
+  return m_generation;
+}
+
+CGUITextLayoutSlices::CGUITextLayoutSlices(CCriticalSection &section, unsigned int sliceMillis)
+  : m_section(section), m_sliceMillis(sliceMillis)
+{
+}
+
+CGUITextLayoutSlices::~CGUITextLayoutSlices()
+{
+  Release();
+}
+
+bool CGUITextLayoutSlices::Next()
+{
+  if (m_locked)
+  {
+    if (!m_slice.IsTimePast())
+      return false;
+    m_section.unlock();
+    // the lock isn't fair, without a pause we would take it again right away
+    XbmcThreads::ThreadSleep(1);
+  }
+  m_section.lock();
+  m_locked = true;
+  m_slice.Set(m_sliceMillis);
+  return true;
+}
+
+void CGUITextLayoutSlices::Release()
+{
+  if (m_locked)
+  {
+    m_section.unlock();
+    m_locked = false;
+  }
+}
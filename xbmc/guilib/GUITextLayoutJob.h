@@ -0,0 +1,126 @@
+/*
+ *  Copyright (C) 2019 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "GUITextLayout.h"
+#include "threads/CriticalSection.h"
+#include "threads/SystemClock.h"
+
+#include <list>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+class CGUIFont;
+
+/*!
+ \brief A text layout prepared by a job, shared with the CGUITextLayout waiting for it
+ */
+class CGUITextLayoutUpdate
+{
+public:
+  //! \brief What the layout of a text depends on
+  struct Key
+  {
+    std::string utf8Text;
+    std::wstring text;
+    bool wide;
+    CGUIFont *font;
+    uint32_t style;
+    UTILS::Color textColor;
+    float maxWidth;
+    float maxHeight;
+    bool wrap;
+    bool forceLTRReadingOrder;
+
+    bool operator==(const Key &other) const;
+  };
+
+  struct Layout
+  {
+    std::vector<UTILS::Color> colors;
+    std::vector<CGUIString> lines;
+    float width;
+    float height;
+  };
+  typedef std::shared_ptr<const Layout> LayoutPtr;
+
+  CGUITextLayoutUpdate(const Key &key, unsigned int generation) : m_key(key), m_generation(generation) {}
+
+  bool IsCancelled() const;
+  void Cancel();
+
+  LayoutPtr GetLayout() const;
+  void SetLayout(const LayoutPtr &layout);
+
+  const Key m_key;
+  const unsigned int m_generation; //!< generation of the cache the layout was started in
+
+private:
+  mutable CCriticalSection m_section;
+  bool m_cancelled = false;
+  LayoutPtr m_layout;
+};
+
+/*!
+ \brief The layouts of recent texts, most recently used first
+
+ The generation moves on whenever the cache is cleared, which the font manager
+ does before it deletes fonts. Layouts started in an older generation may have
+ been measured with fonts that are gone.
+ */
+class CGUITextLayoutCache
+{
+public:
+  static const size_t MAX_LAYOUTS = 32;
+
+  static CGUITextLayoutCache& GetInstance();
+
+  CGUITextLayoutUpdate::LayoutPtr Get(const CGUITextLayoutUpdate::Key &key);
+  void Add(const CGUITextLayoutUpdate::Key &key, const CGUITextLayoutUpdate::LayoutPtr &layout);
+  void Clear();
+  unsigned int GetGeneration() const;
+
+private:
+  mutable CCriticalSection m_section;
+  std::list<std::pair<CGUITextLayoutUpdate::Key, CGUITextLayoutUpdate::LayoutPtr>> m_layouts;
+  unsigned int m_generation = 0;
+};
+
+/*!
+ \brief Holds a lock in slices of a few milliseconds
+
+ The render thread holds the graphics context for all of a frame, a job that
+ measured a long text in one go delayed the next frame by as long as it took.
+ In slices the render thread only waits for the rest of one.
+ */
+class CGUITextLayoutSlices
+{
+public:
+  CGUITextLayoutSlices(CCriticalSection &section, unsigned int sliceMillis);
+  ~CGUITextLayoutSlices();
+
+  /*!
+   \brief Makes sure the lock is held, lets waiting threads in when the slice is over
+   \return true if the lock was taken anew, what it protects may have changed since
+   */
+  bool Next();
+
+  void Release();
+
+private:
+  CGUITextLayoutSlices(const CGUITextLayoutSlices&) = delete;
+  CGUITextLayoutSlices& operator=(const CGUITextLayoutSlices&) = delete;
+
+  CCriticalSection &m_section;
+  const unsigned int m_sliceMillis;
+  bool m_locked = false;
+  XbmcThreads::EndTime m_slice;
+};
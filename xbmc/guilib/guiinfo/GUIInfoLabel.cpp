@@ -13,9 +13,14 @@
 #include "guilib/GUIComponent.h"
 #include "guilib/GUIListItem.h"
 #include "guilib/LocalizeStrings.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
 #include "utils/StringUtils.h"
 #include "utils/log.h"
 
+#include <algorithm>
+#include <unordered_map>
+
 using namespace KODI::GUILIB::GUIINFO;
 
 CGUIInfoLabel::CGUIInfoLabel(const std::string &label, const std::string &fallback /*= ""*/, int context /*= 0*/)
@@ -34,12 +39,23 @@ int CGUIInfoLabel::GetIntValue(int contextWindow) const
 
 void CGUIInfoLabel::SetLabel(const std::string &label, const std::string &fallback, int context /*= 0*/)
 {
-  m_fallback = fallback;
+  m_fallback = Intern(fallback);
   Parse(label, context);
 }
 
 const std::string &CGUIInfoLabel::GetLabel(int contextWindow, bool preferImage, std::string *fallback /*= NULL*/) const
 {
+  // labels of tracked infos only change when one of the infos publishes a change.
+  // the version is read before the infos, so a change during the update isn't lost
+  unsigned int version = 0;
+  if (!m_versions.empty() && !fallback)
+  {
+    version = GetVersion();
+    if (m_versionValid && !m_dirty && version == m_version &&
+        contextWindow == m_versionContext && preferImage == m_versionImage)
+      return CacheLabel(false);
+  }
+
   bool needsUpdate = m_dirty;
   if (!m_info.empty())
   {
@@ -53,13 +69,22 @@ const std::string &CGUIInfoLabel::GetLabel(int contextWindow, bool preferImage,
           infoLabel = infoMgr.GetImage(portion.m_info, contextWindow, fallback);
         if (infoLabel.empty())
           infoLabel = infoMgr.GetLabel(portion.m_info, contextWindow, fallback);
-        needsUpdate |= portion.NeedsUpdate(infoLabel);
+        needsUpdate |= portion.NeedsUpdate(std::move(infoLabel));
       }
     }
   }
   else
     needsUpdate = !m_label.empty();
 
+  if (!m_versions.empty())
+  {
+    // a fallback has to be fetched from the infos, so it doesn't validate the label
+    m_versionValid = !fallback;
+    m_version = version;
+    m_versionContext = contextWindow;
+    m_versionImage = preferImage;
+  }
+
   return CacheLabel(needsUpdate);
 }
 
@@ -78,7 +103,7 @@ const std::string &CGUIInfoLabel::GetItemLabel(const CGUIListItem *item, bool pr
           infoLabel = infoMgr.GetItemImage(item, 0, portion.m_info, fallback);
         else
           infoLabel = infoMgr.GetItemLabel(static_cast<const CFileItem *>(item), 0, portion.m_info, fallback);
-        needsUpdate |= portion.NeedsUpdate(infoLabel);
+        needsUpdate |= portion.NeedsUpdate(std::move(infoLabel));
       }
     }
   }
@@ -90,16 +115,78 @@ const std::string &CGUIInfoLabel::GetItemLabel(const CGUIListItem *item, bool pr
 
 const std::string &CGUIInfoLabel::CacheLabel(bool rebuild) const
 {
+  // constant labels are returned from the pool rather than copied to m_label
+  const bool constant = m_info.size() == 1 && m_info[0].m_info == 0;
   if (rebuild)
   {
+    // built in place, so the label keeps its capacity from the previous build
     m_label.clear();
-    for (const auto &portion : m_info)
-      m_label += portion.Get();
+    if (!constant)
+    {
+      for (const auto &portion : m_info)
+        portion.AppendTo(m_label);
+    }
     m_dirty = false;
   }
-  if (m_label.empty())  // empty label, use the fallback
-    return m_fallback;
-  return m_label;
+  const std::string &label = constant ? m_info[0].GetPrefix() : m_label;
+  if (label.empty())  // empty label, use the fallback
+    return *m_fallback;
+  return label;
+}
+
+unsigned int CGUIInfoLabel::GetVersion() const
+{
+  unsigned int version = 0;
+  for (const INFO::InfoVersion *counter : m_versions)
+    version += *counter;
+  return version;
+}
+
+namespace
+{
+struct SFragmentPool
+{
+  CCriticalSection section;
+  // the shared strings point to the keys, which keep their address when the map rehashes
+  std::unordered_map<std::string, std::weak_ptr<const std::string>> fragments;
+};
+
+// never destroyed, labels of static objects still release their fragments at exit
+SFragmentPool &GetFragmentPool()
+{
+  static SFragmentPool *pool = new SFragmentPool;
+  return *pool;
+}
+
+void ReleaseFragment(const std::string *str)
+{
+  SFragmentPool &pool = GetFragmentPool();
+  CSingleLock lock(pool.section);
+  // the fragment may have been interned again since the last label released it
+  auto it = pool.fragments.find(*str);
+  if (it != pool.fragments.end() && it->second.expired())
+    pool.fragments.erase(it);
+}
+}
+
+std::shared_ptr<const std::string> CGUIInfoLabel::Intern(const std::string &str)
+{
+  static const std::shared_ptr<const std::string> empty(&StringUtils::Empty, [](const std::string*) {});
+  if (str.empty())
+    return empty;
+
+  // labels set at runtime intern their fragments too, so they are refcounted
+  // rather than kept for the lifetime of the skin
+  SFragmentPool &pool = GetFragmentPool();
+  CSingleLock lock(pool.section);
+  auto it = pool.fragments.emplace(str, std::weak_ptr<const std::string>()).first;
+  std::shared_ptr<const std::string> fragment = it->second.lock();
+  if (!fragment)
+  {
+    fragment = std::shared_ptr<const std::string>(&it->first, ReleaseFragment);
+    it->second = fragment;
+  }
+  return fragment;
 }
 
 bool CGUIInfoLabel::IsEmpty() const
@@ -212,6 +299,8 @@ const static infoformat infoformatmap[] = {{ "$INFO[",    FORMATINFO},
 void CGUIInfoLabel::Parse(const std::string &label, int context)
 {
   m_info.clear();
+  m_versions.clear();
+  m_versionValid = false;
   m_dirty = true;
   // Step 1: Replace all $LOCALIZE[number] with the real string
   std::string work = ReplaceLocalize(label);
@@ -282,45 +371,79 @@ void CGUIInfoLabel::Parse(const std::string &label, int context)
 
   if (!work.empty())
     m_info.push_back(CInfoPortion(0, work, ""));
+
+  // the label is only tracked if all its infos are
+  for (const auto &portion : m_info)
+  {
+    if (!portion.m_info)
+      continue;
+    size_t count = m_versions.size();
+    CServiceBroker::GetGUI()->GetInfoManager().GetInfoVersions(portion.m_info, m_versions);
+    if (m_versions.size() == count)
+    {
+      m_versions.clear();
+      break;
+    }
+  }
+  std::sort(m_versions.begin(), m_versions.end());
+  m_versions.erase(std::unique(m_versions.begin(), m_versions.end()), m_versions.end());
 }
 
-CGUIInfoLabel::CInfoPortion::CInfoPortion(int info, const std::string &prefix, const std::string &postfix, bool escaped /*= false */):
-  m_prefix(prefix),
-  m_postfix(postfix)
+CGUIInfoLabel::CInfoPortion::CInfoPortion(int info, const std::string &prefix, const std::string &postfix, bool escaped /*= false */)
 {
   m_info = info;
   m_escaped = escaped;
   // filter our prefix and postfix for comma's
-  StringUtils::Replace(m_prefix, "$COMMA", ",");
-  StringUtils::Replace(m_postfix, "$COMMA", ",");
-  StringUtils::Replace(m_prefix, "$LBRACKET", "["); StringUtils::Replace(m_prefix, "$RBRACKET", "]");
-  StringUtils::Replace(m_postfix, "$LBRACKET", "["); StringUtils::Replace(m_postfix, "$RBRACKET", "]");
+  std::string pre(prefix), post(postfix);
+  StringUtils::Replace(pre, "$COMMA", ",");
+  StringUtils::Replace(post, "$COMMA", ",");
+  StringUtils::Replace(pre, "$LBRACKET", "["); StringUtils::Replace(pre, "$RBRACKET", "]");
+  StringUtils::Replace(post, "$LBRACKET", "["); StringUtils::Replace(post, "$RBRACKET", "]");
+  m_prefix = Intern(pre);
+  m_postfix = Intern(post);
 }
 
-bool CGUIInfoLabel::CInfoPortion::NeedsUpdate(const std::string &label) const
+bool CGUIInfoLabel::CInfoPortion::NeedsUpdate(std::string &&label) const
 {
   if (m_label != label)
   {
-    m_label = label;
+    m_label = std::move(label);
     return true;
   }
   return false;
 }
 
-std::string CGUIInfoLabel::CInfoPortion::Get() const
+void CGUIInfoLabel::CInfoPortion::AppendTo(std::string &label) const
 {
   if (!m_info)
-    return m_prefix;
+  {
+    label += *m_prefix;
+    return;
+  }
   else if (m_label.empty())
-    return "";
-  std::string label = m_prefix + m_label + m_postfix;
-  if (m_escaped) // escape all quotes and backslashes, then quote
+    return;
+
+  if (!m_escaped)
   {
-    StringUtils::Replace(label, "\\", "\\\\");
-    StringUtils::Replace(label, "\"", "\\\"");
-    return "\"" + label + "\"";
+    label += *m_prefix;
+    label += m_label;
+    label += *m_postfix;
+    return;
   }
-  return label;
+
+  // escape all quotes and backslashes, then quote
+  label += '"';
+  const std::string *parts[] = { m_prefix.get(), &m_label, m_postfix.get() };
+  for (const std::string *part : parts)
+  {
+    for (char c : *part)
+    {
+      if (c == '\\' || c == '"')
+        label += '\\';
+      label += c;
+    }
+  }
+  label += '"';
 }
 
 std::string CGUIInfoLabel::GetLabel(const std::string &label, int contextWindow /*= 0*/, bool preferImage /*= false */)
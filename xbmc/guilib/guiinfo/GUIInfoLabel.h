@@ -13,9 +13,12 @@
 \brief
 */
 
+#include "interfaces/info/InfoBool.h"
+
 #include <string>
 #include <vector>
 #include <functional>
+#include <memory>
 
 class CGUIListItem;
 
@@ -63,7 +66,7 @@ public:
   bool IsConstant() const;
   bool IsEmpty() const;
 
-  const std::string &GetFallback() const { return m_fallback; };
+  const std::string &GetFallback() const { return *m_fallback; };
 
   static std::string GetLabel(const std::string &label, int contextWindow = 0, bool preferImage = false);
   static std::string GetItemLabel(const std::string &label, const CGUIListItem *item, bool preferImage = false);
@@ -112,24 +115,42 @@ private:
    */
   const std::string &CacheLabel(bool rebuild) const;
 
+  /*! \brief Sum of the version counters of the infos in the label, 0 if not tracked
+   \sa CGUIInfoManager::GetInfoVersions
+   */
+  unsigned int GetVersion() const;
+
+  /*! \brief Shared copy of a static fragment of a label. Labels are copied for
+   every item of a list, sharing their fragments keeps those copies cheap.
+   A fragment is dropped from the pool when the last label using it is gone.
+   */
+  static std::shared_ptr<const std::string> Intern(const std::string &str);
+
   class CInfoPortion
   {
   public:
     CInfoPortion(int info, const std::string &prefix, const std::string &postfix, bool escaped = false);
-    bool NeedsUpdate(const std::string &label) const;
-    std::string Get() const;
+    bool NeedsUpdate(std::string &&label) const;
+    void AppendTo(std::string &label) const;
+    const std::string &GetPrefix() const { return *m_prefix; }
     int m_info;
   private:
     bool m_escaped;
     mutable std::string m_label;
-    std::string m_prefix;
-    std::string m_postfix;
+    std::shared_ptr<const std::string> m_prefix;
+    std::shared_ptr<const std::string> m_postfix;
   };
 
   mutable bool        m_dirty = false;
   mutable std::string m_label;
-  std::string m_fallback;
+  std::shared_ptr<const std::string> m_fallback = Intern("");
   std::vector<CInfoPortion> m_info;
+
+  INFO::InfoVersions m_versions;          ///< counters of the infos in the label, empty if any isn't tracked
+  mutable bool m_versionValid = false;    ///< m_label was built for m_version, m_versionContext and m_versionImage
+  mutable unsigned int m_version = 0;
+  mutable int m_versionContext = 0;
+  mutable bool m_versionImage = false;
 };
 
 } // namespace GUIINFO
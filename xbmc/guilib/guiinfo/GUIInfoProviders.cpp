@@ -8,6 +8,7 @@
 
 #include "guilib/guiinfo/GUIInfoProviders.h"
 #include "guilib/guiinfo/IGUIInfoProvider.h"
+#include "threads/SingleLock.h"
 
 #include <algorithm>
 
@@ -56,7 +57,17 @@ void CGUIInfoProviders::RegisterProvider(IGUIInfoProvider *provider, bool bAppen
       m_providers.emplace_back(provider);
     else
       m_providers.insert(m_providers.begin(), provider);
+
+    std::vector<int> infos;
+    provider->GetTrackedInfos(infos);
+
+    CSingleLock lock(m_versionsSection);
+    for (int info : infos)
+      m_infoVersions[info];
   }
+
+  // the new provider may answer infos of other providers
+  InfosChanged();
 }
 
 void CGUIInfoProviders::UnregisterProvider(IGUIInfoProvider *provider)
@@ -64,6 +75,30 @@ void CGUIInfoProviders::UnregisterProvider(IGUIInfoProvider *provider)
   auto it = std::find(m_providers.begin(), m_providers.end(), provider);
   if (it != m_providers.end())
     m_providers.erase(it);
+
+  InfosChanged();
+}
+
+const std::atomic<unsigned int>* CGUIInfoProviders::GetInfoVersion(int info) const
+{
+  CSingleLock lock(m_versionsSection);
+  auto it = m_infoVersions.find(info);
+  if (it == m_infoVersions.end())
+    return nullptr;
+  return &it->second;
+}
+
+void CGUIInfoProviders::InfoChanged(int info)
+{
+  CSingleLock lock(m_versionsSection);
+  auto it = m_infoVersions.find(info);
+  if (it != m_infoVersions.end())
+    ++it->second;
+}
+
+void CGUIInfoProviders::InfosChanged()
+{
+  ++m_resetVersion;
 }
 
 bool CGUIInfoProviders::InitCurrentItem(CFileItem *item)
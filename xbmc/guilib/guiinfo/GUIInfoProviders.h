@@ -8,6 +8,8 @@
 
 #pragma once
 
+#include <atomic>
+#include <map>
 #include <string>
 #include <vector>
 
@@ -23,6 +25,7 @@
 #include "guilib/guiinfo/VideoGUIInfo.h"
 #include "guilib/guiinfo/VisualisationGUIInfo.h"
 #include "guilib/guiinfo/WeatherGUIInfo.h"
+#include "threads/CriticalSection.h"
 
 class CFileItem;
 class CGUIListItem;
@@ -105,6 +108,30 @@ public:
    */
   void UpdateAVInfo(const AudioStreamInfo& audioInfo, const VideoStreamInfo& videoInfo, const SubtitleStreamInfo& subtitleInfo);
 
+  /*!
+   * @brief Get the version of an info tracked by one of the registered providers.
+   * @param info The info id.
+   * @return The version, incremented whenever the info changed, or nullptr if the info is not tracked.
+   */
+  const std::atomic<unsigned int>* GetInfoVersion(int info) const;
+
+  /*!
+   * @brief Get the version incremented whenever all infos may have changed.
+   * @return The version.
+   */
+  const std::atomic<unsigned int>& GetResetVersion() const { return m_resetVersion; }
+
+  /*!
+   * @brief Publish a change of a tracked info. Can be called from any thread.
+   * @param info The info id.
+   */
+  void InfoChanged(int info);
+
+  /*!
+   * @brief Publish a change of all infos.
+   */
+  void InfosChanged();
+
   /*!
    * @brief Get the player guiinfo provider.
    * @return The player guiinfo provider.
@@ -138,6 +165,11 @@ public:
 private:
   std::vector<IGUIInfoProvider *> m_providers;
 
+  // entries are never removed, info bools keep pointers to the versions
+  std::map<int, std::atomic<unsigned int>> m_infoVersions;
+  std::atomic<unsigned int> m_resetVersion{0};
+  mutable CCriticalSection m_versionsSection;
+
   CAddonsGUIInfo m_addonsGUIInfo;
   CGamesGUIInfo m_gamesGUIInfo;
   CGUIControlsGUIInfo m_guiControlsGUIInfo;
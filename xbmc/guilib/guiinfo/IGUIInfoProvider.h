@@ -9,6 +9,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 class CFileItem;
 class CGUIListItem;
@@ -74,6 +75,14 @@ public:
    * @param videoInfo New video stream info.
    */
   virtual void UpdateAVInfo(const AudioStreamInfo& audioInfo, const VideoStreamInfo& videoInfo, const SubtitleStreamInfo& subtitleInfo) = 0;
+
+  /*!
+   * @brief Get the infos whose values only change when the provider publishes it.
+   * Info bools depending on tracked infos only are not re-evaluated every frame.
+   * @param infos Will be filled with the info ids.
+   * @sa CGUIInfoProviders::InfoChanged
+   */
+  virtual void GetTrackedInfos(std::vector<int> &infos) const {}
 };
 
 } // namespace GUIINFO
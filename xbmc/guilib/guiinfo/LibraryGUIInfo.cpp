@@ -9,6 +9,9 @@
 #include "guilib/guiinfo/LibraryGUIInfo.h"
 
 #include "Application.h"
+#include "GUIInfoManager.h"
+#include "ServiceBroker.h"
+#include "guilib/GUIComponent.h"
 #include "music/MusicDatabase.h"
 #include "utils/StringUtils.h"
 #include "video/VideoDatabase.h"
@@ -18,11 +21,6 @@
 
 using namespace KODI::GUILIB::GUIINFO;
 
-CLibraryGUIInfo::CLibraryGUIInfo()
-{
-  ResetLibraryBools();
-}
-
 bool CLibraryGUIInfo::GetLibraryBool(int condition) const
 {
   bool value = false;
@@ -56,8 +54,12 @@ void CLibraryGUIInfo::SetLibraryBool(int condition, bool value)
       m_libraryHasCompilations = value ? 1 : 0;
       break;
     default:
-      break;
+      return;
   }
+
+  InfoChanged(condition);
+  if (condition == LIBRARY_HAS_MOVIES || condition == LIBRARY_HAS_TVSHOWS || condition == LIBRARY_HAS_MUSICVIDEOS)
+    InfoChanged(LIBRARY_HAS_VIDEO);
 }
 
 void CLibraryGUIInfo::ResetLibraryBools()
@@ -70,6 +72,18 @@ void CLibraryGUIInfo::ResetLibraryBools()
   m_libraryHasSingles = -1;
   m_libraryHasCompilations = -1;
   m_libraryRoleCounts.clear();
+
+  std::vector<int> infos;
+  GetTrackedInfos(infos);
+  for (int info : infos)
+    InfoChanged(info);
+}
+
+void CLibraryGUIInfo::InfoChanged(int info) const
+{
+  CGUIComponent *gui = CServiceBroker::GetGUI();
+  if (gui)
+    gui->GetInfoManager().GetInfoProviders().InfoChanged(info);
 }
 
 bool CLibraryGUIInfo::InitCurrentItem(CFileItem *item)
@@ -104,6 +118,8 @@ bool CLibraryGUIInfo::GetBool(bool& value, const CGUIListItem *gitem, int contex
           m_libraryHasMusic = (db.GetSongsCount() > 0) ? 1 : 0;
           db.Close();
         }
+        else
+          InfoChanged(LIBRARY_HAS_MUSIC); // retry
       }
       value = m_libraryHasMusic > 0;
       return true;
@@ -118,6 +134,11 @@ bool CLibraryGUIInfo::GetBool(bool& value, const CGUIListItem *gitem, int contex
           m_libraryHasMovies = db.HasContent(VIDEODB_CONTENT_MOVIES) ? 1 : 0;
           db.Close();
         }
+        else
+        { // retry
+          InfoChanged(LIBRARY_HAS_MOVIES);
+          InfoChanged(LIBRARY_HAS_VIDEO);
+        }
       }
       value = m_libraryHasMovies > 0;
       return true;
@@ -132,6 +153,8 @@ bool CLibraryGUIInfo::GetBool(bool& value, const CGUIListItem *gitem, int contex
           m_libraryHasMovieSets = db.HasSets() ? 1 : 0;
           db.Close();
         }
+        else
+          InfoChanged(LIBRARY_HAS_MOVIE_SETS); // retry
       }
       value = m_libraryHasMovieSets > 0;
       return true;
@@ -146,6 +169,11 @@ bool CLibraryGUIInfo::GetBool(bool& value, const CGUIListItem *gitem, int contex
           m_libraryHasTVShows = db.HasContent(VIDEODB_CONTENT_TVSHOWS) ? 1 : 0;
           db.Close();
         }
+        else
+        { // retry
+          InfoChanged(LIBRARY_HAS_TVSHOWS);
+          InfoChanged(LIBRARY_HAS_VIDEO);
+        }
       }
       value = m_libraryHasTVShows > 0;
       return true;
@@ -160,6 +188,11 @@ bool CLibraryGUIInfo::GetBool(bool& value, const CGUIListItem *gitem, int contex
           m_libraryHasMusicVideos = db.HasContent(VIDEODB_CONTENT_MUSICVIDEOS) ? 1 : 0;
           db.Close();
         }
+        else
+        { // retry
+          InfoChanged(LIBRARY_HAS_MUSICVIDEOS);
+          InfoChanged(LIBRARY_HAS_VIDEO);
+        }
       }
       value = m_libraryHasMusicVideos > 0;
       return true;
@@ -174,6 +207,8 @@ bool CLibraryGUIInfo::GetBool(bool& value, const CGUIListItem *gitem, int contex
           m_libraryHasSingles = (db.GetSinglesCount() > 0) ? 1 : 0;
           db.Close();
         }
+        else
+          InfoChanged(LIBRARY_HAS_SINGLES); // retry
       }
       value = m_libraryHasSingles > 0;
       return true;
@@ -188,6 +223,8 @@ bool CLibraryGUIInfo::GetBool(bool& value, const CGUIListItem *gitem, int contex
           m_libraryHasCompilations = (db.GetCompilationAlbumsCount() > 0) ? 1 : 0;
           db.Close();
         }
+        else
+          InfoChanged(LIBRARY_HAS_COMPILATIONS); // retry
       }
       value = m_libraryHasCompilations > 0;
       return true;
@@ -221,6 +258,8 @@ bool CLibraryGUIInfo::GetBool(bool& value, const CGUIListItem *gitem, int contex
           db.Close();
           m_libraryRoleCounts.emplace_back(std::make_pair(strRole, artistcount));
         }
+        else
+          InfoChanged(LIBRARY_HAS_ROLE); // retry
       }
       value = artistcount > 0;
       return true;
@@ -244,3 +283,17 @@ bool CLibraryGUIInfo::GetBool(bool& value, const CGUIListItem *gitem, int contex
 
   return false;
 }
+
+void CLibraryGUIInfo::GetTrackedInfos(std::vector<int> &infos) const
+{
+  // changes are published by SetLibraryBool and ResetLibraryBools, scanning state is polled
+  infos.push_back(LIBRARY_HAS_MUSIC);
+  infos.push_back(LIBRARY_HAS_MOVIES);
+  infos.push_back(LIBRARY_HAS_MOVIE_SETS);
+  infos.push_back(LIBRARY_HAS_TVSHOWS);
+  infos.push_back(LIBRARY_HAS_MUSICVIDEOS);
+  infos.push_back(LIBRARY_HAS_SINGLES);
+  infos.push_back(LIBRARY_HAS_COMPILATIONS);
+  infos.push_back(LIBRARY_HAS_VIDEO);
+  infos.push_back(LIBRARY_HAS_ROLE);
+}
@@ -26,7 +26,7 @@ class CGUIInfo;
 class CLibraryGUIInfo : public CGUIInfoProvider
 {
 public:
-  CLibraryGUIInfo();
+  CLibraryGUIInfo() = default;
   ~CLibraryGUIInfo() override = default;
 
   // KODI::GUILIB::GUIINFO::IGUIInfoProvider implementation
@@ -34,19 +34,22 @@ public:
   bool GetLabel(std::string& value, const CFileItem *item, int contextWindow, const CGUIInfo &info, std::string *fallback) const override;
   bool GetInt(int& value, const CGUIListItem *item, int contextWindow, const CGUIInfo &info) const override;
   bool GetBool(bool& value, const CGUIListItem *item, int contextWindow, const CGUIInfo &info) const override;
+  void GetTrackedInfos(std::vector<int> &infos) const override;
 
   bool GetLibraryBool(int condition) const;
   void SetLibraryBool(int condition, bool value);
   void ResetLibraryBools();
 
 private:
-  mutable int m_libraryHasMusic;
-  mutable int m_libraryHasMovies;
-  mutable int m_libraryHasTVShows;
-  mutable int m_libraryHasMusicVideos;
-  mutable int m_libraryHasMovieSets;
-  mutable int m_libraryHasSingles;
-  mutable int m_libraryHasCompilations;
+  void InfoChanged(int info) const;
+
+  mutable int m_libraryHasMusic = -1;
+  mutable int m_libraryHasMovies = -1;
+  mutable int m_libraryHasTVShows = -1;
+  mutable int m_libraryHasMusicVideos = -1;
+  mutable int m_libraryHasMovieSets = -1;
+  mutable int m_libraryHasSingles = -1;
+  mutable int m_libraryHasCompilations = -1;
 
   //Count of artists in music library contributing to song by role e.g. composers, conductors etc.
   //For checking visibility of custom nodes for a role.
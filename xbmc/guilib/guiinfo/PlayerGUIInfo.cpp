@@ -12,6 +12,7 @@
 
 #include "Application.h"
 #include "FileItem.h"
+#include "GUIInfoManager.h"
 #include "PlayListPlayer.h"
 #include "ServiceBroker.h"
 #include "cores/AudioEngine/Utils/AEUtil.h"
@@ -143,9 +144,16 @@ bool CPlayerGUIInfo::GetDisplayAfterSeek() const
   return false;
 }
 
+void CPlayerGUIInfo::SetShowTime(bool showtime)
+{
+  if (m_playerShowTime.exchange(showtime) != showtime)
+    InfoChanged(PLAYER_SHOWTIME);
+}
+
 void CPlayerGUIInfo::SetShowInfo(bool showinfo)
 {
-  m_playerShowInfo = showinfo;
+  if (m_playerShowInfo.exchange(showinfo) != showinfo)
+    InfoChanged(PLAYER_SHOWINFO);
 }
 
 bool CPlayerGUIInfo::ToggleShowInfo()
@@ -154,6 +162,35 @@ bool CPlayerGUIInfo::ToggleShowInfo()
   return m_playerShowInfo;
 }
 
+void CPlayerGUIInfo::GetTrackedInfos(std::vector<int> &infos) const
+{
+  // changes are published by the setters
+  infos.push_back(PLAYER_SHOWINFO);
+  infos.push_back(PLAYER_SHOWTIME);
+
+  // changes are published by PlayerStateChanged. Speed, pause and volume change
+  // asynchronously after their events and stay volatile.
+  infos.push_back(PLAYER_HAS_MEDIA);
+  infos.push_back(PLAYER_HAS_AUDIO);
+  infos.push_back(PLAYER_HAS_VIDEO);
+  infos.push_back(PLAYER_HAS_GAME);
+}
+
+void CPlayerGUIInfo::PlayerStateChanged()
+{
+  InfoChanged(PLAYER_HAS_MEDIA);
+  InfoChanged(PLAYER_HAS_AUDIO);
+  InfoChanged(PLAYER_HAS_VIDEO);
+  InfoChanged(PLAYER_HAS_GAME);
+}
+
+void CPlayerGUIInfo::InfoChanged(int info) const
+{
+  CGUIComponent *gui = CServiceBroker::GetGUI();
+  if (gui)
+    gui->GetInfoManager().GetInfoProviders().InfoChanged(info);
+}
+
 bool CPlayerGUIInfo::InitCurrentItem(CFileItem *item)
 {
   if (item && g_application.GetAppPlayer().IsPlaying())
@@ -330,6 +367,25 @@ bool CPlayerGUIInfo::GetLabel(std::string& value, const CFileItem *item, int con
     case PLAYER_PROCESS_AUDIOBITSPERSAMPLE:
       value = StringUtils::FormatNumber(CServiceBroker::GetDataCacheCore().GetAudioBitsPerSample());
       return true;
+    case PLAYER_PROCESS_TIMETOFIRSTFRAME:
+      value = StringUtils::FormatNumber(CServiceBroker::GetDataCacheCore().GetTimeToFirstFrame());
+      return true;
+    case PLAYER_PROCESS_VIDEOTHREADS:
+    {
+      const SVideoDecoderStats stats = CServiceBroker::GetDataCacheCore().GetVideoDecoderStats();
+      value = StringUtils::Format("%s (%d)", stats.threadType.c_str(), stats.threadCount);
+      return true;
+    }
+    case PLAYER_PROCESS_VIDEODROPPED:
+    {
+      const SVideoDecoderStats stats = CServiceBroker::GetDataCacheCore().GetVideoDecoderStats();
+      value = StringUtils::Format("%" PRIu64 " / %" PRIu64 " / %" PRIu64 " / %" PRIu64,
+                                  stats.droppedFrames[static_cast<int>(VideoDropCause::DECODER)],
+                                  stats.droppedFrames[static_cast<int>(VideoDropCause::DEINTERLACER)],
+                                  stats.droppedFrames[static_cast<int>(VideoDropCause::OUTPUT)],
+                                  stats.droppedFrames[static_cast<int>(VideoDropCause::RENDERER)]);
+      return true;
+    }
 
     ///////////////////////////////////////////////////////////////////////////////////////////////
     // PLAYLIST_*
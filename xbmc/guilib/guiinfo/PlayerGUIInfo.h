@@ -12,6 +12,7 @@
 
 #include <atomic>
 #include <memory>
+#include <vector>
 
 #include "XBDateTime.h"
 
@@ -35,15 +36,24 @@ public:
   bool GetLabel(std::string& value, const CFileItem *item, int contextWindow, const CGUIInfo &info, std::string *fallback) const override;
   bool GetInt(int& value, const CGUIListItem *item, int contextWindow, const CGUIInfo &info) const override;
   bool GetBool(bool& value, const CGUIListItem *item, int contextWindow, const CGUIInfo &info) const override;
+  void GetTrackedInfos(std::vector<int> &infos) const override;
+
+  /*!
+   * @brief Publish a change of the tracked infos depending on the player state.
+   * To be called on playback events, after the player changed its state.
+   */
+  void PlayerStateChanged();
 
   bool GetDisplayAfterSeek() const;
   void SetDisplayAfterSeek(unsigned int timeOut = 2500, int seekOffset = 0);
-  void SetShowTime(bool showtime) { m_playerShowTime = showtime; };
+  void SetShowTime(bool showtime);
   void SetShowInfo(bool showinfo);
   bool GetShowInfo() const { return m_playerShowInfo; }
   bool ToggleShowInfo();
 
 private:
+  void InfoChanged(int info) const;
+
   std::unique_ptr<CFileItem> m_currentItem;
 
   unsigned int m_AfterSeekTimeout = 0;
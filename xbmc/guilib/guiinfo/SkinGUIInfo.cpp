@@ -116,3 +116,11 @@ bool CSkinGUIInfo::GetBool(bool& value, const CGUIListItem *gitem, int contextWi
 
   return false;
 }
+
+void CSkinGUIInfo::GetTrackedInfos(std::vector<int> &infos) const
+{
+  // changes are published by CSkinSettings
+  infos.push_back(SKIN_BOOL);
+  infos.push_back(SKIN_STRING);
+  infos.push_back(SKIN_STRING_IS_EQUAL);
+}
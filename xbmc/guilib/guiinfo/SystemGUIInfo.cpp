@@ -644,3 +644,18 @@ bool CSystemGUIInfo::GetBool(bool& value, const CGUIListItem *gitem, int context
 
   return false;
 }
+
+void CSystemGUIInfo::GetTrackedInfos(std::vector<int> &infos) const
+{
+  // constants, never changing
+  infos.push_back(SYSTEM_ALWAYS_TRUE);
+  infos.push_back(SYSTEM_ALWAYS_FALSE);
+  infos.push_back(SYSTEM_PLATFORM_LINUX);
+  infos.push_back(SYSTEM_PLATFORM_WINDOWS);
+  infos.push_back(SYSTEM_PLATFORM_UWP);
+  infos.push_back(SYSTEM_PLATFORM_DARWIN);
+  infos.push_back(SYSTEM_PLATFORM_DARWIN_OSX);
+  infos.push_back(SYSTEM_PLATFORM_DARWIN_IOS);
+  infos.push_back(SYSTEM_PLATFORM_ANDROID);
+  infos.push_back(SYSTEM_PLATFORM_LINUX_RASPBERRY_PI);
+}
@@ -32,6 +32,7 @@ public:
   bool GetLabel(std::string& value, const CFileItem *item, int contextWindow, const CGUIInfo &info, std::string *fallback) const override;
   bool GetInt(int& value, const CGUIListItem *item, int contextWindow, const CGUIInfo &info) const override;
   bool GetBool(bool& value, const CGUIListItem *item, int contextWindow, const CGUIInfo &info) const override;
+  void GetTrackedInfos(std::vector<int> &infos) const override;
 
   float GetFPS() const { return m_fps; };
   void UpdateFPS();
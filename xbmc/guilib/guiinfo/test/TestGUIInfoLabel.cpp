@@ -0,0 +1,68 @@
+/*
+ *  Copyright (C) 2019 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "FileItem.h"
+#include "ServiceBroker.h"
+#include "guilib/GUIComponent.h"
+#include "guilib/guiinfo/GUIInfoLabel.h"
+
+#include "gtest/gtest.h"
+
+using namespace KODI::GUILIB::GUIINFO;
+
+class TestGUIInfoLabel : public ::testing::Test
+{
+protected:
+  static void SetUpTestCase()
+  {
+    // labels look their infos up in the info manager of the gui
+    m_gui = new CGUIComponent();
+    CServiceBroker::RegisterGUI(m_gui);
+  }
+
+  static void TearDownTestCase()
+  {
+    CServiceBroker::UnregisterGUI();
+    delete m_gui;
+    m_gui = nullptr;
+  }
+
+  static CGUIComponent *m_gui;
+};
+
+CGUIComponent *TestGUIInfoLabel::m_gui = nullptr;
+
+TEST_F(TestGUIInfoLabel, Format)
+{
+  CFileItem item;
+  item.SetLabel("Say \"hi\"\\");
+  item.SetLabel2("2019");
+
+  EXPECT_EQ("Say \"hi\"\\ (2019)", CGUIInfoLabel("$INFO[ListItem.Label] $INFO[ListItem.Label2,(,)]").GetItemLabel(&item));
+  EXPECT_EQ("\"Say \\\"hi\\\"\\\\\"", CGUIInfoLabel("$ESCINFO[ListItem.Label]").GetItemLabel(&item));
+  EXPECT_EQ("[2019]", CGUIInfoLabel("$INFO[ListItem.Label2,$LBRACKET,$RBRACKET]").GetItemLabel(&item));
+  EXPECT_EQ("none", CGUIInfoLabel("$INFO[ListItem.Property(unset),a,b]", "none").GetItemLabel(&item));
+
+  CGUIInfoLabel label("$INFO[ListItem.Label2] movies");
+  EXPECT_EQ("2019 movies", label.GetItemLabel(&item));
+  item.SetLabel2("");
+  EXPECT_EQ(" movies", label.GetItemLabel(&item));
+}
+
+TEST_F(TestGUIInfoLabel, Interning)
+{
+  CFileItem item;
+  CGUIInfoLabel a("Watched", "DefaultVideo.png");
+  CGUIInfoLabel b("Watched", "DefaultVideo.png");
+  EXPECT_EQ(&a.GetFallback(), &b.GetFallback());
+  EXPECT_EQ("Watched", a.GetItemLabel(&item));
+  EXPECT_EQ(&a.GetItemLabel(&item), &b.GetItemLabel(&item));
+
+  CGUIInfoLabel copy(a);
+  EXPECT_EQ(&a.GetItemLabel(&item), &copy.GetItemLabel(&item));
+}
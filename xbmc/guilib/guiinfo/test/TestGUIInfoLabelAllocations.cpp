@@ -0,0 +1,113 @@
+/*
+ *  Copyright (C) 2019 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "FileItem.h"
+#include "GUIInfoManager.h"
+#include "ServiceBroker.h"
+#include "guilib/GUIComponent.h"
+#include "guilib/guiinfo/GUIInfoLabel.h"
+#include "test/AllocationCounter.h"
+#include "utils/StringUtils.h"
+
+#include <iostream>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace KODI::GUILIB::GUIINFO;
+
+class TestGUIInfoLabelAllocations : public ::testing::Test
+{
+protected:
+  static void SetUpTestCase()
+  {
+    m_gui = new CGUIComponent();
+    CServiceBroker::RegisterGUI(m_gui);
+  }
+
+  static void TearDownTestCase()
+  {
+    CServiceBroker::UnregisterGUI();
+    delete m_gui;
+    m_gui = nullptr;
+  }
+
+  static CGUIInfoManager &GetInfoManager() { return m_gui->GetInfoManager(); }
+
+  static CGUIComponent *m_gui;
+};
+
+CGUIComponent *TestGUIInfoLabelAllocations::m_gui = nullptr;
+
+TEST_F(TestGUIInfoLabelAllocations, Panel)
+{
+  // labels of a video library panel item
+  const CGUIInfoLabel layout[] = {
+    CGUIInfoLabel("$INFO[ListItem.Label]", "Unknown"),
+    CGUIInfoLabel("$INFO[ListItem.Label2,(,)]"),
+    CGUIInfoLabel("[B]$INFO[ListItem.Label][/B] - $INFO[ListItem.Label2,released ,]"),
+    CGUIInfoLabel("$ESCINFO[ListItem.Label]"),
+    CGUIInfoLabel("Watched", "DefaultVideo.png"),
+  };
+  const int labelInfos[] = { GetInfoManager().TranslateString("ListItem.Label"),
+                             GetInfoManager().TranslateString("ListItem.Label2"),
+                             GetInfoManager().TranslateString("ListItem.Label"),
+                             GetInfoManager().TranslateString("ListItem.Label2"),
+                             GetInfoManager().TranslateString("ListItem.Label") };
+  const unsigned int itemCount = 500;
+  const unsigned int labelCount = sizeof(layout) / sizeof(layout[0]);
+
+  std::vector<CFileItem> items(itemCount);
+  for (unsigned int i = 0; i < itemCount; i++)
+  {
+    items[i].SetLabel(StringUtils::Format("Movie %03u", i));
+    items[i].SetLabel2(StringUtils::Format("%u", 1950 + i % 70));
+  }
+
+  // every item has its own copy of the layout
+  std::vector<std::vector<CGUIInfoLabel>> labels;
+  labels.reserve(itemCount);
+  unsigned int copies = CAllocationCounter::CountThread([&]() {
+    for (unsigned int i = 0; i < itemCount; i++)
+      labels.emplace_back(layout, layout + labelCount);
+  });
+  // the label vector and the info portions of each label, fragments are shared
+  EXPECT_LE(copies, itemCount * (labelCount + 1));
+
+  auto update = [&]() {
+    for (unsigned int i = 0; i < itemCount; i++)
+    {
+      for (const auto &label : labels[i])
+        label.GetItemLabel(&items[i]);
+    }
+  };
+  // what the info manager allocates itself to look up the infos of a frame
+  unsigned int lookups = CAllocationCounter::CountThread([&]() {
+    for (const auto &item : items)
+    {
+      for (int info : labelInfos)
+        GetInfoManager().GetItemLabel(&item, 0, info);
+    }
+  });
+
+  unsigned int first = CAllocationCounter::CountThread(update);
+  unsigned int unchanged = CAllocationCounter::CountThread(update);
+  for (unsigned int i = 0; i < itemCount; i++)
+    items[i].SetLabel(StringUtils::Format("Video %03u", i));
+  unsigned int changed = CAllocationCounter::CountThread(update);
+
+  // once built, labels only allocate what the info manager does
+  EXPECT_EQ(lookups, unchanged);
+  EXPECT_EQ(lookups, changed);
+  EXPECT_EQ("[B]Video 000[/B] - released 1950", labels[0][2].GetItemLabel(&items[0]));
+
+  std::cout << itemCount << " items, " << labelCount << " labels: " << copies
+            << " allocations to copy the layouts, " << first << " to build the labels, "
+            << unchanged << " per update, " << changed << " per update of changed items, "
+            << lookups << " in the info manager" << std::endl;
+}
@@ -0,0 +1,148 @@
+/*
+ *  Copyright (C) 2019 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "guilib/guiinfo/GUIInfoLabels.h"
+#include "guilib/guiinfo/GUIInfoProvider.h"
+#include "guilib/guiinfo/GUIInfoProviders.h"
+#include "interfaces/info/InfoBool.h"
+
+#include "gtest/gtest.h"
+
+using namespace KODI::GUILIB::GUIINFO;
+using namespace INFO;
+
+namespace
+{
+constexpr int TEST_TRACKED = MULTI_INFO_END + 1;
+constexpr int TEST_VOLATILE = MULTI_INFO_END + 2;
+
+class CTestProvider : public CGUIInfoProvider
+{
+public:
+  bool InitCurrentItem(CFileItem *item) override { return false; }
+  bool GetLabel(std::string& value, const CFileItem *item, int contextWindow, const CGUIInfo &info, std::string *fallback) const override { return false; }
+  bool GetInt(int& value, const CGUIListItem *item, int contextWindow, const CGUIInfo &info) const override { return false; }
+  bool GetBool(bool& value, const CGUIListItem *item, int contextWindow, const CGUIInfo &info) const override { return false; }
+  void GetTrackedInfos(std::vector<int> &infos) const override { infos.push_back(TEST_TRACKED); }
+
+  bool m_value = false;
+};
+
+/*!
+ * \brief Info bool over the value of the test provider, tracked like CGUIInfoManager
+ * tracks an InfoSingle
+ */
+class CTestBool : public InfoBool
+{
+public:
+  CTestBool(const CGUIInfoProviders &providers, int info, const CTestProvider &provider)
+    : InfoBool("test", 0, m_refreshCounter, m_evaluations),
+      m_provider(provider)
+  {
+    const InfoVersion *version = providers.GetInfoVersion(info);
+    if (version)
+    {
+      m_versions.push_back(&providers.GetResetVersion());
+      m_versions.push_back(version);
+    }
+  }
+
+  void Update(const CGUIListItem *item) override { m_value = m_provider.m_value; }
+
+  void NextFrame() { m_refreshCounter++; }
+
+  unsigned int m_refreshCounter = 1;
+  unsigned int m_evaluations = 0;
+
+private:
+  const CTestProvider &m_provider;
+};
+
+class TestGUIInfoProviders : public ::testing::Test
+{
+protected:
+  TestGUIInfoProviders() { m_providers.RegisterProvider(&m_provider); }
+  ~TestGUIInfoProviders() override { m_providers.UnregisterProvider(&m_provider); }
+
+  CGUIInfoProviders m_providers;
+  CTestProvider m_provider;
+};
+}
+
+TEST_F(TestGUIInfoProviders, TrackedBoolSkipsUnchanged)
+{
+  CTestBool tracked(m_providers, TEST_TRACKED, m_provider);
+  EXPECT_TRUE(tracked.IsTracked());
+
+  EXPECT_FALSE(tracked.Get());
+  EXPECT_EQ(1u, tracked.m_evaluations);
+
+  // an unpublished change is not seen, the bool isn't evaluated again
+  m_provider.m_value = true;
+  for (int frame = 0; frame < 3; frame++)
+  {
+    tracked.NextFrame();
+    EXPECT_FALSE(tracked.Get());
+  }
+  EXPECT_EQ(1u, tracked.m_evaluations);
+
+  m_providers.InfoChanged(TEST_TRACKED);
+  tracked.NextFrame();
+  EXPECT_TRUE(tracked.Get());
+  EXPECT_EQ(2u, tracked.m_evaluations);
+
+  // once per change only
+  tracked.NextFrame();
+  EXPECT_TRUE(tracked.Get());
+  EXPECT_EQ(2u, tracked.m_evaluations);
+
+  // changes of other infos don't matter
+  m_providers.InfoChanged(PLAYER_SHOWINFO);
+  tracked.NextFrame();
+  tracked.Get();
+  EXPECT_EQ(2u, tracked.m_evaluations);
+
+  // a reset invalidates all tracked bools
+  m_provider.m_value = false;
+  m_providers.InfosChanged();
+  tracked.NextFrame();
+  EXPECT_FALSE(tracked.Get());
+  EXPECT_EQ(3u, tracked.m_evaluations);
+}
+
+TEST_F(TestGUIInfoProviders, VolatileBoolEvaluatesEachFrame)
+{
+  CTestBool untracked(m_providers, TEST_VOLATILE, m_provider);
+  EXPECT_FALSE(untracked.IsTracked());
+
+  EXPECT_FALSE(untracked.Get());
+  m_provider.m_value = true;
+  untracked.NextFrame();
+  EXPECT_TRUE(untracked.Get());
+  EXPECT_EQ(2u, untracked.m_evaluations);
+
+  // but only once per frame
+  EXPECT_TRUE(untracked.Get());
+  EXPECT_EQ(2u, untracked.m_evaluations);
+}
+
+TEST_F(TestGUIInfoProviders, PlayerTrackedInfos)
+{
+  std::vector<int> infos;
+  m_providers.GetPlayerInfoProvider().GetTrackedInfos(infos);
+  EXPECT_FALSE(infos.empty());
+  for (int info : infos)
+    EXPECT_NE(nullptr, m_providers.GetInfoVersion(info)) << info;
+
+  EXPECT_NE(nullptr, m_providers.GetInfoVersion(PLAYER_SHOWINFO));
+  EXPECT_NE(nullptr, m_providers.GetInfoVersion(PLAYER_HAS_VIDEO));
+
+  // the speed reaches the player asynchronously after its events
+  EXPECT_EQ(nullptr, m_providers.GetInfoVersion(PLAYER_PAUSED));
+  EXPECT_EQ(nullptr, m_providers.GetInfoVersion(PLAYER_PLAYING));
+}
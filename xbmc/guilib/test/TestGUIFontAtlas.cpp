@@ -0,0 +1,246 @@
+/*
+ *  Copyright (C) 2019 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "guilib/GUIFontAtlas.h"
+
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace
+{
+class CTestFontAtlas : public CGUIFontAtlas
+{
+public:
+  CTestFontAtlas(unsigned int pageSize, unsigned int maxPages) : CGUIFontAtlas(pageSize, maxPages) {}
+
+  unsigned int m_frameTime = 1;
+
+protected:
+  unsigned int GetFrameTime() const override { return m_frameTime; }
+};
+
+struct Rect
+{
+  unsigned int x, y, width, height;
+};
+
+void Fill(CGUIFontAtlasPage &page, unsigned int size)
+{
+  unsigned int x, y;
+  while (page.Allocate(size, size, x, y))
+    ;
+}
+
+// places the glyphs of a text like a font does, returns how often the font had to leave its page
+unsigned int Place(CGUIFontAtlas &atlas, unsigned int pageSize, unsigned int glyphs, unsigned int size,
+                   CGUIFontAtlasPagePtr &page)
+{
+  unsigned int clears = 0;
+  unsigned int x, y;
+  page = atlas.AcquirePage(size, size, -1, 4096, pageSize);
+  for (unsigned int i = 0; i < glyphs && page; i++)
+  {
+    if (!page->Allocate(size, size, x, y))
+    {
+      clears++;
+      page = atlas.AcquirePage(size, size, -1, 4096, pageSize);
+      if (page)
+        page->Allocate(size, size, x, y);
+    }
+  }
+  return clears;
+}
+}
+
+TEST(TestGUIFontAtlas, Packing)
+{
+  CGUIFontAtlasPage page(256, 256);
+  std::mt19937 random(1);
+  std::uniform_int_distribution<unsigned int> size(1, 24);
+
+  std::vector<Rect> rects;
+  for (;;)
+  {
+    Rect rect = { 0, 0, size(random), size(random) };
+    if (!page.Allocate(rect.width, rect.height, rect.x, rect.y))
+      break;
+    rects.push_back(rect);
+  }
+  ASSERT_GT(rects.size(), 100u);
+
+  unsigned int area = 0;
+  for (size_t i = 0; i < rects.size(); i++)
+  {
+    const Rect &a = rects[i];
+    area += a.width * a.height;
+    EXPECT_LE(a.x + a.width, page.GetWidth());
+    EXPECT_LE(a.y + a.height, page.GetHeight());
+    for (size_t j = 0; j < i; j++)
+    {
+      // glyphs keep a pixel apart so filtering doesn't bleed
+      const Rect &b = rects[j];
+      bool apart = a.x >= b.x + b.width + 1 || b.x >= a.x + a.width + 1 ||
+                   a.y >= b.y + b.height + 1 || b.y >= a.y + a.height + 1;
+      EXPECT_TRUE(apart) << i << " overlaps " << j;
+    }
+  }
+  // shelves keep most of the page in use
+  EXPECT_GT(area, page.GetWidth() * page.GetHeight() / 2);
+
+  unsigned int y1, y2;
+  EXPECT_FALSE(page.GetDirtyRows(y1, y2));
+  std::vector<uint8_t> pixels(rects[0].width * rects[0].height, 255);
+  page.Copy(rects[0].x, rects[0].y, pixels.data(), rects[0].width, rects[0].width, rects[0].height);
+  ASSERT_TRUE(page.GetDirtyRows(y1, y2));
+  EXPECT_EQ(rects[0].y, y1);
+  EXPECT_EQ(rects[0].y + rects[0].height, y2);
+  EXPECT_EQ(255, page.GetPixels()[rects[0].y * page.GetWidth() + rects[0].x]);
+  page.ClearDirtyRows();
+  EXPECT_FALSE(page.GetDirtyRows(y1, y2));
+}
+
+TEST(TestGUIFontAtlas, SharedPages)
+{
+  CTestFontAtlas atlas(128, 2);
+  CGUIFontAtlasPagePtr a = atlas.AcquirePage(10, 10, -1, 4096);
+  CGUIFontAtlasPagePtr b = atlas.AcquirePage(10, 10, -1, 4096);
+  ASSERT_TRUE(a != nullptr);
+  EXPECT_EQ(a, b);
+  EXPECT_EQ(1u, atlas.GetPageCount());
+
+  // glyphs larger than a page are rejected
+  EXPECT_TRUE(atlas.AcquirePage(200, 10, -1, 4096) == nullptr);
+
+  // distance field glyphs are found on the page of their face
+  CGUIFontAtlasPage::DistanceFieldGlyph glyph = { 1, 1, 10, 10, 0, 0, 10 };
+  Fill(*a, 10);
+  b = atlas.AcquirePage(10, 10, -1, 4096);
+  ASSERT_NE(a, b);
+  b->AddDistanceFieldGlyph(7, 'A', glyph);
+  EXPECT_EQ(b, atlas.AcquirePage(10, 10, 7, 4096));
+  EXPECT_TRUE(b->GetDistanceFieldGlyph(7, 'A') != nullptr);
+  EXPECT_TRUE(b->GetDistanceFieldGlyph(7, 'B') == nullptr);
+  EXPECT_EQ(atlas.GetFace("font.ttf@1"), atlas.GetFace("font.ttf@1"));
+  EXPECT_NE(atlas.GetFace("font.ttf@1"), atlas.GetFace("font.ttf@1.2"));
+}
+
+TEST(TestGUIFontAtlas, Eviction)
+{
+  CTestFontAtlas atlas(64, 2);
+  CGUIFontAtlasPagePtr a = atlas.AcquirePage(8, 8, -1, 4096);
+  Fill(*a, 8);
+  CGUIFontAtlasPagePtr b = atlas.AcquirePage(8, 8, -1, 4096);
+  ASSERT_NE(a, b);
+  Fill(*b, 8);
+  atlas.Touch(*a);
+  atlas.Touch(*b);
+  unsigned int generation = a->GetGeneration();
+
+  // both pages were drawn in this frame, the limit is exceeded until the next
+  CGUIFontAtlasPagePtr c = atlas.AcquirePage(8, 8, -1, 4096);
+  EXPECT_NE(a, c);
+  EXPECT_NE(b, c);
+  EXPECT_EQ(3u, atlas.GetPageCount());
+  EXPECT_EQ(generation, a->GetGeneration());
+  c.reset();
+  atlas.ReleaseUnused();
+  EXPECT_EQ(2u, atlas.GetPageCount());
+
+  // the page used least recently is cleared
+  atlas.m_frameTime = 2;
+  atlas.Touch(*a);
+  atlas.m_frameTime = 3;
+  atlas.Touch(*b);
+  c = atlas.AcquirePage(8, 8, -1, 4096);
+  EXPECT_EQ(a, c);
+  EXPECT_NE(generation, a->GetGeneration());
+  EXPECT_EQ(a->GetHeight() - 1, a->GetFreeHeight());
+  unsigned int y1, y2;
+  ASSERT_TRUE(a->GetDirtyRows(y1, y2));
+  EXPECT_EQ(0u, y1);
+  EXPECT_EQ(a->GetHeight(), y2);
+
+  // pages no font holds are reused first
+  Fill(*c, 8);
+  a.reset();
+  c.reset();
+  generation = b->GetGeneration();
+  atlas.m_frameTime = 4;
+  c = atlas.AcquirePage(8, 8, -1, 4096);
+  EXPECT_NE(b, c);
+  EXPECT_EQ(generation, b->GetGeneration());
+  EXPECT_EQ(2u, atlas.GetPageCount());
+}
+
+TEST(TestGUIFontAtlas, LargerPages)
+{
+  CTestFontAtlas atlas(64, 2);
+  EXPECT_EQ(64u, atlas.GetPageSize());
+
+  // a page holds 9 of these glyphs, the text needs 20
+  CGUIFontAtlasPagePtr page;
+  EXPECT_EQ(2u, Place(atlas, 0, 20, 15, page));
+  ASSERT_TRUE(page != nullptr);
+  EXPECT_EQ(64u, page->GetWidth());
+
+  // on a page of twice the size they all fit
+  CGUIFontAtlasPagePtr large;
+  EXPECT_EQ(0u, Place(atlas, 128, 20, 15, large));
+  ASSERT_TRUE(large != nullptr);
+  EXPECT_NE(page, large);
+  EXPECT_EQ(128u, large->GetWidth());
+  EXPECT_EQ(128u, large->GetHeight());
+
+  // a font needing large pages doesn't settle on a small one, even one with room
+  page = atlas.AcquirePage(15, 15, -1, 4096);
+  EXPECT_EQ(64u, page->GetWidth());
+  Fill(*large, 15);
+  atlas.m_frameTime = 2;
+  atlas.Touch(*large);
+  CGUIFontAtlasPagePtr other = atlas.AcquirePage(15, 15, -1, 4096, 128);
+  ASSERT_TRUE(other != nullptr);
+  EXPECT_EQ(128u, other->GetWidth());
+  EXPECT_NE(large, other);
+
+  // pages are no larger than the render system supports
+  CTestFontAtlas limited(64, 2);
+  other = limited.AcquirePage(15, 15, -1, 96, 128);
+  ASSERT_TRUE(other != nullptr);
+  EXPECT_EQ(96u, other->GetWidth());
+}
+
+TEST(TestGUIFontAtlas, DistanceField)
+{
+  // a 10x10 square in a glyph of 20x20
+  const unsigned int size = 20;
+  const unsigned int spread = 4;
+  std::vector<uint8_t> coverage(size * size, 0);
+  for (unsigned int y = 5; y < 15; y++)
+    for (unsigned int x = 5; x < 15; x++)
+      coverage[y * size + x] = 255;
+
+  std::vector<uint8_t> field;
+  CGUIFontAtlas::BuildDistanceField(coverage.data(), size, size, size, spread, field);
+  const unsigned int fieldSize = size + 2 * spread;
+  ASSERT_EQ(fieldSize * fieldSize, field.size());
+
+  auto at = [&](unsigned int x, unsigned int y) { return field[(y + spread) * fieldSize + x + spread]; };
+  // saturated well inside and outside
+  EXPECT_EQ(255, at(10, 10));
+  EXPECT_EQ(0, at(0, 0));
+  EXPECT_EQ(0, field[0]);
+  // the outline lies between the pixels on either side
+  EXPECT_GT(at(5, 10), 128);
+  EXPECT_LT(at(4, 10), 128);
+  EXPECT_NEAR(128, (at(5, 10) + at(4, 10)) / 2, 1);
+  // and the field falls off with the distance
+  EXPECT_GT(at(6, 10), at(5, 10));
+  EXPECT_LT(at(3, 10), at(4, 10));
+}
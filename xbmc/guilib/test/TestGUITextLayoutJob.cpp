@@ -0,0 +1,304 @@
+/*
+ *  Copyright (C) 2019 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "guilib/GUITextLayoutJob.h"
+#include "threads/SingleLock.h"
+#include "threads/Thread.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+namespace
+{
+typedef std::chrono::steady_clock Clock;
+
+CGUITextLayoutUpdate::Key MakeKey(const std::wstring &text)
+{
+  CGUITextLayoutUpdate::Key key = { std::string(), text, true, nullptr, 0, 0xFFFFFFFF,
+                                    400.0f, 0.0f, true, false };
+  return key;
+}
+
+CGUITextLayoutUpdate::LayoutPtr MakeLayout(const std::vector<std::wstring> &lines, float width)
+{
+  std::shared_ptr<CGUITextLayoutUpdate::Layout> layout = std::make_shared<CGUITextLayoutUpdate::Layout>();
+  layout->colors.push_back(0xFFFFFFFF);
+  for (const std::wstring &line : lines)
+  {
+    vecText text(line.begin(), line.end());
+    layout->lines.emplace_back(text.begin(), text.end(), true);
+  }
+  layout->width = width;
+  layout->height = 20.0f * lines.size();
+  return layout;
+}
+
+// a layout without a font, as a control can be before its skin fonts load
+class CTestTextLayout : public CGUITextLayout
+{
+public:
+  CTestTextLayout() : CGUITextLayout(nullptr, false) {}
+
+  void SetPendingUpdate(const std::shared_ptr<CGUITextLayoutUpdate> &update) { m_pending.m_update = update; }
+  bool HasPendingUpdate() const { return m_pending.m_update != nullptr; }
+  using CGUITextLayout::CompleteAsyncUpdate;
+  using CGUITextLayout::m_lines;
+};
+
+const unsigned int SLICE_MILLIS = 2;
+const std::chrono::milliseconds FRAME(8);   // the render thread holds the lock
+const std::chrono::milliseconds FLIP(2);    // and lets go of it while waiting for vsync
+const std::chrono::milliseconds WORK(150);  // measuring a long text
+
+void Spin(std::chrono::microseconds time)
+{
+  Clock::time_point end = Clock::now() + time;
+  while (Clock::now() < end)
+    ;
+}
+
+// the longest the render thread waited for the lock to start a frame while the job ran
+std::chrono::milliseconds MaxFrameDelay(CCriticalSection &section, const std::function<void()> &job)
+{
+  std::atomic<bool> stop(false);
+  Clock::duration maxWait = Clock::duration::zero();
+  std::thread render([&]() {
+    while (!stop)
+    {
+      Clock::time_point start = Clock::now();
+      section.lock();
+      maxWait = std::max(maxWait, Clock::now() - start);
+      std::this_thread::sleep_for(FRAME);
+      section.unlock();
+      std::this_thread::sleep_for(FLIP);
+    }
+  });
+
+  // let the render thread hold the lock first, as it does all the time
+  std::this_thread::sleep_for(FLIP);
+  job();
+  stop = true;
+  render.join();
+  return std::chrono::duration_cast<std::chrono::milliseconds>(maxWait);
+}
+}
+
+TEST(TestGUITextLayoutJob, Slices)
+{
+  CCriticalSection section;
+  CGUITextLayoutSlices slices(section, 60000);
+
+  // the first call takes the lock, later ones keep it for the slice
+  EXPECT_TRUE(slices.Next());
+  EXPECT_FALSE(slices.Next());
+
+  std::atomic<bool> locked(true);
+  std::thread other([&]() {
+    CSingleLock lock(section);
+    locked = false;
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  EXPECT_TRUE(locked);
+
+  slices.Release();
+  other.join();
+  EXPECT_FALSE(locked);
+  EXPECT_TRUE(slices.Next());
+}
+
+TEST(TestGUITextLayoutJob, SliceExpires)
+{
+  CCriticalSection section;
+  CGUITextLayoutSlices slices(section, SLICE_MILLIS);
+  EXPECT_TRUE(slices.Next());
+  std::this_thread::sleep_for(std::chrono::milliseconds(SLICE_MILLIS * 5));
+  // the lock was let go and taken anew
+  EXPECT_TRUE(slices.Next());
+}
+
+TEST(TestGUITextLayoutJob, FrameDelay)
+{
+  CCriticalSection section;
+  const std::chrono::microseconds step(100);
+
+  // the whole measurement under one lock, as the job did before
+  std::chrono::milliseconds whole = MaxFrameDelay(section, [&]() {
+    CSingleLock lock(section);
+    for (Clock::duration done = Clock::duration::zero(); done < WORK; done += step)
+      Spin(step);
+  });
+
+  std::chrono::milliseconds sliced = MaxFrameDelay(section, [&]() {
+    CGUITextLayoutSlices slices(section, SLICE_MILLIS);
+    for (Clock::duration done = Clock::duration::zero(); done < WORK; done += step)
+    {
+      slices.Next();
+      Spin(step);
+    }
+  });
+
+  std::cout << "longest frame delay: " << whole.count() << " ms holding the lock, "
+            << sliced.count() << " ms in slices of " << SLICE_MILLIS << " ms" << std::endl;
+
+  EXPECT_GE(whole, WORK / 2);
+  // the rest of a slice, with room for the scheduler
+  EXPECT_LT(sliced, FRAME);
+}
+
+TEST(TestGUITextLayoutJob, KeyEquality)
+{
+  const CGUITextLayoutUpdate::Key key = MakeKey(L"Plot");
+  EXPECT_TRUE(key == MakeKey(L"Plot"));
+  EXPECT_FALSE(key == MakeKey(L"Plot."));
+
+  // everything the layout depends on is part of the key
+  CGUITextLayoutUpdate::Key other = key;
+  other.font = reinterpret_cast<CGUIFont*>(&other);
+  EXPECT_FALSE(key == other);
+  other = key;
+  other.style = 1;
+  EXPECT_FALSE(key == other);
+  other = key;
+  other.textColor = 0xFF000000;
+  EXPECT_FALSE(key == other);
+  other = key;
+  other.maxWidth = 401.0f;
+  EXPECT_FALSE(key == other);
+  other = key;
+  other.maxHeight = 100.0f;
+  EXPECT_FALSE(key == other);
+  other = key;
+  other.wrap = false;
+  EXPECT_FALSE(key == other);
+  other = key;
+  other.forceLTRReadingOrder = true;
+  EXPECT_FALSE(key == other);
+
+  // only the text that was set is compared
+  other = key;
+  other.utf8Text = "stale";
+  EXPECT_TRUE(key == other);
+  CGUITextLayoutUpdate::Key utf8 = key;
+  utf8.wide = false;
+  utf8.utf8Text = "Plot";
+  EXPECT_FALSE(key == utf8);
+  CGUITextLayoutUpdate::Key utf8Other = utf8;
+  utf8Other.text = L"stale";
+  EXPECT_TRUE(utf8 == utf8Other);
+}
+
+TEST(TestGUITextLayoutJob, CacheEviction)
+{
+  CGUITextLayoutCache cache;
+  const CGUITextLayoutUpdate::LayoutPtr layout = MakeLayout({ L"text" }, 10.0f);
+  for (size_t i = 0; i < CGUITextLayoutCache::MAX_LAYOUTS; i++)
+    cache.Add(MakeKey(std::to_wstring(i)), layout);
+
+  // the oldest layout is used again, so the second oldest goes first
+  EXPECT_EQ(layout, cache.Get(MakeKey(L"0")));
+  cache.Add(MakeKey(L"new"), layout);
+  EXPECT_EQ(layout, cache.Get(MakeKey(L"0")));
+  EXPECT_EQ(nullptr, cache.Get(MakeKey(L"1")));
+  EXPECT_EQ(layout, cache.Get(MakeKey(L"2")));
+  EXPECT_EQ(layout, cache.Get(MakeKey(L"new")));
+
+  unsigned int generation = cache.GetGeneration();
+  cache.Clear();
+  EXPECT_EQ(generation + 1, cache.GetGeneration());
+  EXPECT_EQ(nullptr, cache.Get(MakeKey(L"new")));
+}
+
+TEST(TestGUITextLayoutJob, Complete)
+{
+  CGUITextLayoutCache &cache = CGUITextLayoutCache::GetInstance();
+  const CGUITextLayoutUpdate::Key key = MakeKey(L"first line\nsecond line");
+  std::shared_ptr<CGUITextLayoutUpdate> update = std::make_shared<CGUITextLayoutUpdate>(key, cache.GetGeneration());
+
+  CTestTextLayout layout;
+  layout.SetPendingUpdate(update);
+
+  // nothing to swap in while the job works
+  EXPECT_FALSE(layout.CompleteAsyncUpdate());
+  EXPECT_TRUE(layout.HasPendingUpdate());
+
+  const CGUITextLayoutUpdate::LayoutPtr result = MakeLayout({ L"first line", L"second line" }, 120.0f);
+  update->SetLayout(result);
+  EXPECT_TRUE(layout.CompleteAsyncUpdate());
+  EXPECT_FALSE(layout.HasPendingUpdate());
+  ASSERT_EQ(2u, layout.m_lines.size());
+  EXPECT_EQ(result->lines[1].m_text, layout.m_lines[1].m_text);
+  float width, height;
+  layout.GetTextExtent(width, height);
+  EXPECT_EQ(120.0f, width);
+  EXPECT_EQ(40.0f, height);
+
+  // finished layouts are cached for the next control showing the text
+  EXPECT_EQ(result, cache.Get(key));
+
+  // and only swapped in once
+  EXPECT_FALSE(layout.CompleteAsyncUpdate());
+}
+
+TEST(TestGUITextLayoutJob, CompleteStale)
+{
+  CGUITextLayoutCache &cache = CGUITextLayoutCache::GetInstance();
+  const CGUITextLayoutUpdate::Key key = MakeKey(L"first line\nsecond line\nthird line");
+
+  // the fonts were cleared while the job measured
+  std::shared_ptr<CGUITextLayoutUpdate> measured = std::make_shared<CGUITextLayoutUpdate>(key, cache.GetGeneration());
+  measured->SetLayout(MakeLayout({ L"measured with an old font" }, 500.0f));
+  CTestTextLayout layout;
+  layout.SetPendingUpdate(measured);
+  cache.Clear();
+
+  // the text is laid out again right away and not cached
+  EXPECT_TRUE(layout.CompleteAsyncUpdate());
+  EXPECT_EQ(3u, layout.m_lines.size());
+  EXPECT_EQ(nullptr, cache.Get(key));
+
+  // a job that saw the fonts change gives up without a layout
+  std::shared_ptr<CGUITextLayoutUpdate> abandoned = std::make_shared<CGUITextLayoutUpdate>(MakeKey(L"single line"), cache.GetGeneration());
+  layout.SetPendingUpdate(abandoned);
+  cache.Clear();
+  EXPECT_TRUE(layout.CompleteAsyncUpdate());
+  EXPECT_FALSE(layout.HasPendingUpdate());
+  EXPECT_TRUE(abandoned->IsCancelled());
+  EXPECT_EQ(1u, layout.m_lines.size());
+}
+
+TEST(TestGUITextLayoutJob, CancelPending)
+{
+  std::shared_ptr<CGUITextLayoutUpdate> update = std::make_shared<CGUITextLayoutUpdate>(
+      MakeKey(L"text"), CGUITextLayoutCache::GetInstance().GetGeneration());
+  {
+    CTestTextLayout layout;
+    layout.SetPendingUpdate(update);
+
+    // copies, like the per item copies of a list layout, don't share the update
+    CTestTextLayout copy(layout);
+    EXPECT_FALSE(copy.HasPendingUpdate());
+
+    layout.Reset();
+    EXPECT_TRUE(update->IsCancelled());
+    EXPECT_FALSE(layout.HasPendingUpdate());
+  }
+
+  std::shared_ptr<CGUITextLayoutUpdate> destroyed = std::make_shared<CGUITextLayoutUpdate>(
+      MakeKey(L"text"), CGUITextLayoutCache::GetInstance().GetGeneration());
+  {
+    CTestTextLayout layout;
+    layout.SetPendingUpdate(destroyed);
+  }
+  EXPECT_TRUE(destroyed->IsCancelled());
+}
@@ -11,13 +11,17 @@
 
 namespace INFO
 {
-  InfoBool::InfoBool(const std::string &expression, int context, unsigned int &refreshCounter)
+  InfoBool::InfoBool(const std::string &expression, int context, unsigned int &refreshCounter,
+                     unsigned int &evaluations)
     : m_value(false),
       m_context(context),
       m_listItemDependent(false),
       m_expression(expression),
       m_refreshCounter(0),
-      m_parentRefreshCounter(refreshCounter)
+      m_parentRefreshCounter(refreshCounter),
+      m_evaluations(evaluations),
+      m_version(0),
+      m_evaluated(false)
   {
     StringUtils::ToLower(m_expression);
   }
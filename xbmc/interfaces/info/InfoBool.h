@@ -8,13 +8,18 @@
 
 #pragma once
 
+#include <atomic>
 #include <string>
 #include <memory>
+#include <vector>
 
 class CGUIListItem;
 
 namespace INFO
 {
+typedef std::atomic<unsigned int> InfoVersion;
+typedef std::vector<const InfoVersion*> InfoVersions;
+
 /*!
  \ingroup info
  \brief Base class, wrapping boolean conditions and expressions
@@ -22,7 +27,7 @@ namespace INFO
 class InfoBool
 {
 public:
-  InfoBool(const std::string &expression, int context, unsigned int &refreshCounter);
+  InfoBool(const std::string &expression, int context, unsigned int &refreshCounter, unsigned int &evaluations);
   virtual ~InfoBool() = default;
 
   virtual void Initialize() {};
@@ -34,10 +39,22 @@ public:
   inline bool Get(const CGUIListItem *item = NULL)
   {
     if (item && m_listItemDependent)
-      Update(item);
+      Evaluate(item);
     else if (m_refreshCounter != m_parentRefreshCounter || m_refreshCounter == 0)
     {
-      Update(NULL);
+      if (m_versions.empty())
+        Evaluate(NULL);
+      else
+      {
+        // tracked bools only change when one of the infos they depend on publishes a change
+        unsigned int version = GetVersion();
+        if (!m_evaluated || version != m_version)
+        {
+          Evaluate(NULL);
+          m_version = version;
+          m_evaluated = true;
+        }
+      }
       m_refreshCounter = m_parentRefreshCounter;
     }
     return m_value;
@@ -66,16 +83,43 @@ public:
 
   const std::string &GetExpression() const { return m_expression; }
   bool ListItemDependent() const { return m_listItemDependent; }
+
+  /*! \brief Whether the value of this info bool only changes when the infos it depends on publish a change
+   \sa GetVersions
+   */
+  bool IsTracked() const { return !m_versions.empty(); }
+
+  /*! \brief The version counters of the infos this info bool depends on, empty if it isn't tracked
+   */
+  const InfoVersions &GetVersions() const { return m_versions; }
 protected:
 
   bool m_value;                ///< current value
   int m_context;               ///< contextual information to go with the condition
   bool m_listItemDependent;    ///< do not cache if a listitem pointer is given
   std::string  m_expression;   ///< original expression
+  InfoVersions m_versions;     ///< version counters of the tracked infos this depends on
 
 private:
+  inline void Evaluate(const CGUIListItem *item)
+  {
+    Update(item);
+    m_evaluations++;
+  }
+
+  unsigned int GetVersion() const
+  {
+    unsigned int version = 0;
+    for (const InfoVersion *counter : m_versions)
+      version += *counter;
+    return version;
+  }
+
   unsigned int m_refreshCounter;
   unsigned int &m_parentRefreshCounter;
+  unsigned int &m_evaluations;
+  unsigned int m_version;
+  bool m_evaluated;
 };
 
 typedef std::shared_ptr<InfoBool> InfoPtr;
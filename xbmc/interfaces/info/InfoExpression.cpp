@@ -12,6 +12,7 @@
 #include "GUIInfoManager.h"
 #include "guilib/GUIComponent.h"
 #include "ServiceBroker.h"
+#include <algorithm>
 #include <list>
 #include <memory>
 
@@ -19,7 +20,10 @@ using namespace INFO;
 
 void InfoSingle::Initialize()
 {
-  m_condition = CServiceBroker::GetGUI()->GetInfoManager().TranslateSingleString(m_expression, m_listItemDependent);
+  CGUIInfoManager& infoMgr = CServiceBroker::GetGUI()->GetInfoManager();
+  m_condition = infoMgr.TranslateSingleString(m_expression, m_listItemDependent);
+  if (!m_listItemDependent)
+    infoMgr.GetInfoVersions(m_condition, m_versions);
 }
 
 void InfoSingle::Update(const CGUIListItem *item)
@@ -29,39 +33,173 @@ void InfoSingle::Update(const CGUIListItem *item)
 
 void InfoExpression::Initialize()
 {
-  if (!Parse(m_expression))
+  InfoSubexpressionPtr tree;
+  if (Parse(m_expression, tree))
+    Compile(tree, false);
+  else
   {
     CLog::Log(LOGERROR, "Error parsing boolean expression %s", m_expression.c_str());
-    m_expression_tree = std::make_shared<InfoLeaf>(CServiceBroker::GetGUI()->GetInfoManager().Register("false", 0), false);
+    m_program.clear();
+    m_leaves.clear();
+    Emit(OPCODE_GET, Register("false"));
+    m_untracked = true;
+  }
+
+  // an expression is tracked if all of its leaves are, it then depends on all of their infos
+  if (m_untracked || m_listItemDependent)
+    m_versions.clear();
+  else
+  {
+    std::sort(m_versions.begin(), m_versions.end());
+    m_versions.erase(std::unique(m_versions.begin(), m_versions.end()), m_versions.end());
   }
 }
 
 void InfoExpression::Update(const CGUIListItem *item)
 {
-  m_value = m_expression_tree->Evaluate(item);
+  bool value = false;
+  const size_t size = m_program.size();
+  size_t pc = 0;
+  while (pc < size)
+  {
+    const Instruction &instruction = m_program[pc++];
+    switch (instruction.op)
+    {
+      case OPCODE_GET:
+        value = m_leaves[instruction.arg]->Get(item);
+        break;
+      case OPCODE_GET_NOT:
+        value = !m_leaves[instruction.arg]->Get(item);
+        break;
+      case OPCODE_JUMP_IF_TRUE:
+        if (value)
+          pc = instruction.arg;
+        break;
+      case OPCODE_JUMP_IF_FALSE:
+        if (!value)
+          pc = instruction.arg;
+        break;
+    }
+  }
+  m_value = value;
+}
+
+InfoPtr InfoExpression::Register(const std::string &expression)
+{
+  return CServiceBroker::GetGUI()->GetInfoManager().Register(expression, m_context);
 }
 
 /* Expressions are rewritten at parse time into a form which favours the
- * formation of groups of associative nodes. These groups are then reordered at
- * evaluation time such that nodes whose value renders the evaluation of the
- * remainder of the group unnecessary tend to be evaluated first (these are
- * true nodes for OR subexpressions, or false nodes for AND subexpressions).
- * The end effect is to minimise the number of leaf nodes that need to be
- * evaluated in order to determine the value of the expression. The runtime
- * adaptability has the advantage of not being customised for any particular skin.
+ * formation of groups of associative nodes, and then compiled into a flat
+ * program evaluated in a single loop.
  *
  * The modifications to the expression at parse time fall into two groups:
  * 1) Moving logical NOTs so that they are only applied to leaf nodes.
- *    For example, rewriting ![A+B]|C as !A|!B|C allows reordering such that
- *    any of the three leaves can be evaluated first.
+ *    For example, rewriting ![A+B]|C as !A|!B|C.
  * 2) Combining adjacent AND or OR operations such that each path from the root
  *    to a leaf encounters a strictly alternating pattern of AND and OR
  *    operations. So [A|B]|[C|D+[[E|F]|G] becomes A|B|C|[D+[E|F|G]].
+ *
+ * As NOTs only apply to leaves and all operators are associative, the program
+ * needs no value stack: every leaf loads the value, and after each child of a
+ * group a conditional jump skips the remainder of the group once its result is
+ * known (a true child for OR groups, a false child for AND groups). Jumps onto
+ * other jumps are threaded at compile time, so a decided nested group skips
+ * all enclosing groups it decides in one go.
+ *
+ * Nested groups are registered as expressions of their own, so that identical
+ * subexpressions are shared by all expressions of the skin and evaluated at
+ * most once per frame, like any other info bool. Groups depending on a list
+ * item aren't cached, so they are compiled inline instead.
  */
 
-bool InfoExpression::InfoLeaf::Evaluate(const CGUIListItem *item)
+void InfoExpression::Compile(const InfoSubexpressionPtr &node, bool nested)
 {
-  return m_invert ^ m_info->Get(item);
+  if (node->Type() == NODE_LEAF)
+  {
+    std::shared_ptr<InfoLeaf> leaf = std::static_pointer_cast<InfoLeaf>(node);
+    Emit(leaf->IsInverted() ? OPCODE_GET_NOT : OPCODE_GET, leaf->GetInfo());
+    return;
+  }
+
+  if (nested && !ListItemDependent(node))
+  {
+    InfoPtr info = Register(GetExpression(node, false));
+    if (info)
+    {
+      Emit(OPCODE_GET, info);
+      return;
+    }
+  }
+
+  const std::list<InfoSubexpressionPtr> &children = std::static_pointer_cast<InfoAssociativeGroup>(node)->GetChildren();
+  opcode_t jump = node->Type() == NODE_OR ? OPCODE_JUMP_IF_TRUE : OPCODE_JUMP_IF_FALSE;
+  std::vector<size_t> jumps;
+  for (std::list<InfoSubexpressionPtr>::const_iterator it = children.begin(); it != children.end(); ++it)
+  {
+    if (it != children.begin())
+    {
+      jumps.push_back(m_program.size());
+      m_program.push_back({jump, 0});
+    }
+    Compile(*it, true);
+  }
+  for (size_t i : jumps)
+    m_program[i].arg = m_program.size();
+
+  if (nested)
+    return;
+
+  // thread jumps landing on other jumps, whose outcome is known at that point
+  for (Instruction &instruction : m_program)
+  {
+    if (instruction.op != OPCODE_JUMP_IF_TRUE && instruction.op != OPCODE_JUMP_IF_FALSE)
+      continue;
+    unsigned int target = instruction.arg;
+    while (target < m_program.size() &&
+           (m_program[target].op == OPCODE_JUMP_IF_TRUE || m_program[target].op == OPCODE_JUMP_IF_FALSE))
+      target = m_program[target].op == instruction.op ? m_program[target].arg : target + 1;
+    instruction.arg = target;
+  }
+}
+
+void InfoExpression::Emit(opcode_t op, const InfoPtr &info)
+{
+  std::vector<InfoPtr>::const_iterator it = std::find(m_leaves.begin(), m_leaves.end(), info);
+  if (it == m_leaves.end())
+    it = m_leaves.insert(m_leaves.end(), info);
+  m_program.push_back({op, static_cast<unsigned int>(it - m_leaves.begin())});
+}
+
+std::string InfoExpression::GetExpression(const InfoSubexpressionPtr &node, bool nested)
+{
+  if (node->Type() == NODE_LEAF)
+  {
+    std::shared_ptr<InfoLeaf> leaf = std::static_pointer_cast<InfoLeaf>(node);
+    return (leaf->IsInverted() ? "!" : "") + leaf->GetInfo()->GetExpression();
+  }
+
+  std::string expression;
+  for (const auto &child : std::static_pointer_cast<InfoAssociativeGroup>(node)->GetChildren())
+  {
+    if (!expression.empty())
+      expression += node->Type() == NODE_AND ? '+' : '|';
+    expression += GetExpression(child, true);
+  }
+  return nested ? "[" + expression + "]" : expression;
+}
+
+bool InfoExpression::ListItemDependent(const InfoSubexpressionPtr &node)
+{
+  if (node->Type() == NODE_LEAF)
+    return std::static_pointer_cast<InfoLeaf>(node)->GetInfo()->ListItemDependent();
+
+  for (const auto &child : std::static_pointer_cast<InfoAssociativeGroup>(node)->GetChildren())
+  {
+    if (ListItemDependent(child))
+      return true;
+  }
+  return false;
 }
 
 InfoExpression::InfoAssociativeGroup::InfoAssociativeGroup(
@@ -84,29 +222,6 @@ void InfoExpression::InfoAssociativeGroup::Merge(std::shared_ptr<InfoAssociative
   m_children.splice(m_children.end(), other->m_children);
 }
 
-bool InfoExpression::InfoAssociativeGroup::Evaluate(const CGUIListItem *item)
-{
-  /* Handle either AND or OR by using the relation
-   * A AND B == !(!A OR !B)
-   * to convert ANDs into ORs
-   */
-  std::list<InfoSubexpressionPtr>::iterator last = m_children.end();
-  std::list<InfoSubexpressionPtr>::iterator it = m_children.begin();
-  bool use_and = (m_type == NODE_AND);
-  bool result = use_and ^ (*it)->Evaluate(item);
-  while (!result && ++it != last)
-  {
-    result = use_and ^ (*it)->Evaluate(item);
-    if (result)
-    {
-      /* Move this child to the head of the list so we evaluate faster next time */
-      m_children.push_front(*it);
-      m_children.erase(it);
-    }
-  }
-  return use_and ^ result;
-}
-
 /* Expressions are parsed using the shunting-yard algorithm. Binary operators
  * (AND/OR) are treated as right-associative so that we don't need to make a
  * special case for the unary NOT operator. This has no effect upon the answers
@@ -195,7 +310,19 @@ void InfoExpression::OperatorPop(std::stack<operator_t> &operator_stack, bool &i
   }
 }
 
-bool InfoExpression::Parse(const std::string &expression)
+void InfoExpression::AddLeaf(const InfoPtr &info, bool invert, std::stack<InfoSubexpressionPtr> &nodes)
+{
+  /* Propagate any listItem dependency from the operand to the expression */
+  m_listItemDependent |= info->ListItemDependent();
+  /* Collect the infos of tracked operands, so the expression only updates when one of them changed */
+  if (info->IsTracked())
+    m_versions.insert(m_versions.end(), info->GetVersions().begin(), info->GetVersions().end());
+  else
+    m_untracked = true;
+  nodes.push(std::make_shared<InfoLeaf>(info, invert));
+}
+
+bool InfoExpression::Parse(const std::string &expression, InfoSubexpressionPtr &tree)
 {
   const char *s = expression.c_str();
   std::string operand;
@@ -206,8 +333,6 @@ bool InfoExpression::Parse(const std::string &expression)
   bool after_binaryoperator = true;
   int bracket_count = 0;
 
-  CGUIInfoManager& infoMgr = CServiceBroker::GetGUI()->GetInfoManager();
-
   char c;
   // Skip leading whitespace - don't want it to count as an operand if that's all there is
   while (isspace((unsigned char)(c=*s)))
@@ -234,15 +359,13 @@ bool InfoExpression::Parse(const std::string &expression)
       }
       if (!operand.empty())
       {
-        InfoPtr info = infoMgr.Register(operand, m_context);
+        InfoPtr info = Register(operand);
         if (!info)
         {
           CLog::Log(LOGERROR, "Bad operand '%s'", operand.c_str());
           return false;
         }
-        /* Propagate any listItem dependency from the operand to the expression */
-        m_listItemDependent |= info->ListItemDependent();
-        nodes.push(std::make_shared<InfoLeaf>(info, invert));
+        AddLeaf(info, invert, nodes);
         /* Reuse operand string for next operand */
         operand.clear();
       }
@@ -285,19 +408,17 @@ bool InfoExpression::Parse(const std::string &expression)
   }
   if (!operand.empty())
   {
-    InfoPtr info = infoMgr.Register(operand, m_context);
+    InfoPtr info = Register(operand);
     if (!info)
     {
       CLog::Log(LOGERROR, "Bad operand '%s'", operand.c_str());
       return false;
     }
-    /* Propagate any listItem dependency from the operand to the expression */
-    m_listItemDependent |= info->ListItemDependent();
-    nodes.push(std::make_shared<InfoLeaf>(info, invert));
+    AddLeaf(info, invert, nodes);
   }
   while (!operator_stack.empty())
     OperatorPop(operator_stack, invert, nodes);
 
-  m_expression_tree = nodes.top();
+  tree = nodes.top();
   return true;
 }
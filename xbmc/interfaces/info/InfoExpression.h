@@ -22,8 +22,8 @@ namespace INFO
 class InfoSingle : public InfoBool
 {
 public:
-  InfoSingle(const std::string &expression, int context, unsigned int &refreshCounter)
-    : InfoBool(expression, context, refreshCounter) {};
+  InfoSingle(const std::string &expression, int context, unsigned int &refreshCounter, unsigned int &evaluations)
+    : InfoBool(expression, context, refreshCounter, evaluations) {};
   void Initialize() override;
 
   void Update(const CGUIListItem *item) override;
@@ -36,13 +36,21 @@ private:
 class InfoExpression : public InfoBool
 {
 public:
-  InfoExpression(const std::string &expression, int context, unsigned int &refreshCounter)
-    : InfoBool(expression, context, refreshCounter) {};
+  InfoExpression(const std::string &expression, int context, unsigned int &refreshCounter, unsigned int &evaluations)
+    : InfoBool(expression, context, refreshCounter, evaluations) {};
   ~InfoExpression() override = default;
 
   void Initialize() override;
 
   void Update(const CGUIListItem *item) override;
+
+protected:
+  /*! \brief Register an operand or a shared subexpression of this expression
+   \param expression the condition or expression
+   \return the registered info bool, empty on error
+   */
+  virtual InfoPtr Register(const std::string &expression);
+
 private:
   typedef enum
   {
@@ -61,12 +69,25 @@ private:
     NODE_OR,
   } node_type_t;
 
-  // An abstract base class for nodes in the expression tree
+  typedef enum
+  {
+    OPCODE_GET,           // value = leaf
+    OPCODE_GET_NOT,       // value = !leaf
+    OPCODE_JUMP_IF_TRUE,  // continue at arg if value is true
+    OPCODE_JUMP_IF_FALSE, // continue at arg if value is false
+  } opcode_t;
+
+  struct Instruction
+  {
+    opcode_t op;
+    unsigned int arg;
+  };
+
+  // An abstract base class for nodes in the expression tree, which is only kept while compiling
   class InfoSubexpression
   {
   public:
     virtual ~InfoSubexpression(void) = default; // so we can destruct derived classes using a pointer to their base class
-    virtual bool Evaluate(const CGUIListItem *item) = 0;
     virtual node_type_t Type() const=0;
   };
 
@@ -77,8 +98,9 @@ private:
   {
   public:
     InfoLeaf(InfoPtr info, bool invert) : m_info(info), m_invert(invert) {};
-    bool Evaluate(const CGUIListItem *item) override;
     node_type_t Type() const override { return NODE_LEAF; };
+    const InfoPtr &GetInfo() const { return m_info; }
+    bool IsInverted() const { return m_invert; }
   private:
     InfoPtr m_info;
     bool m_invert;
@@ -91,8 +113,8 @@ private:
     InfoAssociativeGroup(node_type_t type, const InfoSubexpressionPtr &left, const InfoSubexpressionPtr &right);
     void AddChild(const InfoSubexpressionPtr &child);
     void Merge(std::shared_ptr<InfoAssociativeGroup> other);
-    bool Evaluate(const CGUIListItem *item) override;
     node_type_t Type() const override { return m_type; };
+    const std::list<InfoSubexpressionPtr> &GetChildren() const { return m_children; }
   private:
     node_type_t m_type;
     std::list<InfoSubexpressionPtr> m_children;
@@ -100,8 +122,17 @@ private:
 
   static operator_t GetOperator(char ch);
   static void OperatorPop(std::stack<operator_t> &operator_stack, bool &invert, std::stack<InfoSubexpressionPtr> &nodes);
-  bool Parse(const std::string &expression);
-  InfoSubexpressionPtr m_expression_tree;
+  bool Parse(const std::string &expression, InfoSubexpressionPtr &tree);
+  void AddLeaf(const InfoPtr &info, bool invert, std::stack<InfoSubexpressionPtr> &nodes);
+
+  void Compile(const InfoSubexpressionPtr &node, bool nested);
+  void Emit(opcode_t op, const InfoPtr &info);
+  static std::string GetExpression(const InfoSubexpressionPtr &node, bool nested);
+  static bool ListItemDependent(const InfoSubexpressionPtr &node);
+
+  std::vector<Instruction> m_program;
+  std::vector<InfoPtr> m_leaves;
+  bool m_untracked = false;    ///< one of the leaves isn't tracked
 };
 
 };
@@ -0,0 +1,317 @@
+/*
+ *  Copyright (C) 2019 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "FileItem.h"
+#include "filesystem/Directory.h"
+#include "interfaces/info/InfoExpression.h"
+#include "test/TestUtils.h"
+#include "utils/StringUtils.h"
+#include "utils/XBMCTinyXML.h"
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <random>
+
+#include "gtest/gtest.h"
+
+using namespace INFO;
+
+namespace
+{
+/*!
+ * \brief Stand-in for CGUIInfoManager, registering expressions over leaves
+ * whose values are set by the test
+ */
+class CTestInfoRegistry
+{
+public:
+  InfoPtr Register(const std::string &expression);
+  void NextFrame() { m_refreshCounter++; }
+
+  std::map<std::string, InfoPtr> m_bools;
+  std::map<std::string, bool> m_values;
+  unsigned int m_refreshCounter = 0;
+  unsigned int m_evaluations = 0;
+};
+
+class CTestLeaf : public InfoBool
+{
+public:
+  CTestLeaf(CTestInfoRegistry &registry, const std::string &expression)
+    : InfoBool(expression, 0, registry.m_refreshCounter, registry.m_evaluations),
+      m_leafValue(registry.m_values[m_expression]) {}
+
+  void Update(const CGUIListItem *item) override { m_value = m_leafValue; }
+
+private:
+  const bool &m_leafValue;
+};
+
+class CTestExpression : public InfoExpression
+{
+public:
+  CTestExpression(CTestInfoRegistry &registry, const std::string &expression)
+    : InfoExpression(expression, 0, registry.m_refreshCounter, registry.m_evaluations), m_registry(registry) {}
+
+protected:
+  InfoPtr Register(const std::string &expression) override { return m_registry.Register(expression); }
+
+private:
+  CTestInfoRegistry &m_registry;
+};
+
+InfoPtr CTestInfoRegistry::Register(const std::string &expression)
+{
+  std::string condition(expression);
+  StringUtils::Trim(condition);
+  StringUtils::ToLower(condition);
+  if (condition.empty())
+    return InfoPtr();
+
+  auto it = m_bools.find(condition);
+  if (it != m_bools.end())
+    return it->second;
+
+  InfoPtr info;
+  if (condition.find_first_of("|+[]!") != condition.npos)
+    info = std::make_shared<CTestExpression>(*this, condition);
+  else
+    info = std::make_shared<CTestLeaf>(*this, condition);
+  m_bools[condition] = info;
+  info->Initialize();
+  return info;
+}
+
+/*!
+ * \brief Straightforward recursive descent evaluation of an expression
+ */
+class CReferenceEvaluator
+{
+public:
+  CReferenceEvaluator(const std::map<std::string, bool> &values) : m_values(values) {}
+
+  bool Evaluate(const std::string &expression)
+  {
+    m_pos = expression.c_str();
+    return Or();
+  }
+
+private:
+  void Skip() { while (isspace(static_cast<unsigned char>(*m_pos))) m_pos++; }
+
+  bool Or()
+  {
+    bool value = And();
+    for (Skip(); *m_pos == '|'; Skip())
+    {
+      m_pos++;
+      value = And() | value;
+    }
+    return value;
+  }
+
+  bool And()
+  {
+    bool value = Not();
+    for (Skip(); *m_pos == '+'; Skip())
+    {
+      m_pos++;
+      value = Not() & value;
+    }
+    return value;
+  }
+
+  bool Not()
+  {
+    Skip();
+    if (*m_pos == '!')
+    {
+      m_pos++;
+      return !Not();
+    }
+    if (*m_pos == '[')
+    {
+      m_pos++;
+      bool value = Or();
+      Skip();
+      m_pos++; // ]
+      return value;
+    }
+    std::string operand;
+    while (*m_pos && !strchr("[]!+|", *m_pos))
+      operand += *m_pos++;
+    StringUtils::Trim(operand);
+    StringUtils::ToLower(operand);
+    auto it = m_values.find(operand);
+    return it != m_values.end() && it->second;
+  }
+
+  const std::map<std::string, bool> &m_values;
+  const char *m_pos = nullptr;
+};
+
+void AddCondition(const std::string &condition, const std::map<std::string, std::string> &variables,
+                  std::vector<std::string> &conditions)
+{
+  std::string expression(condition);
+  for (const auto &variable : variables)
+    StringUtils::Replace(expression, "$EXP[" + variable.first + "]", "[" + variable.second + "]");
+  // include parameters and other skin variables are resolved by the skin loader
+  if (!StringUtils::Trim(expression).empty() && expression.find('$') == std::string::npos)
+    conditions.push_back(expression);
+}
+
+void CollectConditions(const TiXmlElement *element, const std::map<std::string, std::string> &variables,
+                       std::vector<std::string> &conditions)
+{
+  for (; element; element = element->NextSiblingElement())
+  {
+    const char *condition = element->Attribute("condition");
+    if (condition)
+      AddCondition(condition, variables, conditions);
+    if ((element->ValueStr() == "visible" || element->ValueStr() == "enable" ||
+         element->ValueStr() == "selected") && element->FirstChild())
+      AddCondition(element->FirstChild()->ValueStr(), variables, conditions);
+    CollectConditions(element->FirstChildElement(), variables, conditions);
+  }
+}
+
+/*!
+ * \brief All visibility conditions of Estuary, with expressions substituted
+ */
+std::vector<std::string> GetEstuaryConditions()
+{
+  std::vector<CXBMCTinyXML> docs;
+  CFileItemList items;
+  XFILE::CDirectory::GetDirectory(XBMC_REF_FILE_PATH("/addons/skin.estuary/xml/"), items, ".xml",
+                                  XFILE::DIR_FLAG_DEFAULTS);
+  for (const auto &item : items)
+  {
+    docs.emplace_back();
+    if (!docs.back().LoadFile(item->GetPath()))
+      docs.pop_back();
+  }
+
+  std::map<std::string, std::string> variables;
+  for (const auto &doc : docs)
+  {
+    for (const TiXmlElement *element = doc.RootElement()->FirstChildElement("expression"); element;
+         element = element->NextSiblingElement("expression"))
+    {
+      if (element->Attribute("name") && element->FirstChild())
+        variables[element->Attribute("name")] = element->FirstChild()->ValueStr();
+    }
+  }
+
+  std::vector<std::string> conditions;
+  for (const auto &doc : docs)
+    CollectConditions(doc.RootElement(), variables, conditions);
+  return conditions;
+}
+}
+
+TEST(TestInfoExpression, MatchesReference)
+{
+  const char *expressions[] = {
+    "a + b", "a | b", "!a", "![a]", "!!a", "a + !b | c", "a | b + c", "[a | b] + c", "!a + [b | !c]",
+    "![a + b] | c", "[a + [b | [c + !d]]] | !e", "[[a | b] + [c | d]] | [a + e]", "a+b+c+d+e",
+    "a|b|c|d|e", "!a|!b|!c+!d+e", "[a|b]+[a|b]+!c", " a | [ b + c ] ",
+  };
+  const char *leaves[] = { "a", "b", "c", "d", "e" };
+
+  CTestInfoRegistry registry;
+  std::vector<InfoPtr> infos;
+  for (const char *expression : expressions)
+    infos.push_back(registry.Register(expression));
+
+  for (unsigned int bits = 0; bits < 32; bits++)
+  {
+    for (unsigned int i = 0; i < 5; i++)
+      registry.m_values[leaves[i]] = (bits >> i) & 1;
+    registry.NextFrame();
+
+    CReferenceEvaluator reference(registry.m_values);
+    for (size_t i = 0; i < infos.size(); i++)
+      EXPECT_EQ(reference.Evaluate(expressions[i]), infos[i]->Get()) << expressions[i] << " bits " << bits;
+  }
+}
+
+TEST(TestInfoExpression, SharedSubexpressions)
+{
+  CTestInfoRegistry registry;
+  InfoPtr c = registry.Register("[a | b] + c");
+  InfoPtr d = registry.Register("d + [a|b]");
+
+  // a, b, c, d, a|b and both expressions
+  EXPECT_EQ(7u, registry.m_bools.size());
+  ASSERT_TRUE(registry.m_bools.find("a|b") != registry.m_bools.end());
+
+  registry.m_values["a"] = true;
+  registry.m_values["c"] = true;
+  registry.m_values["d"] = true;
+  registry.NextFrame();
+  unsigned int evaluations = registry.m_evaluations;
+  EXPECT_TRUE(c->Get());
+  EXPECT_TRUE(d->Get());
+  // both expressions, c, d, a|b and a, the shared a|b is evaluated once
+  EXPECT_EQ(6u, registry.m_evaluations - evaluations);
+}
+
+TEST(TestInfoExpression, Estuary)
+{
+  std::vector<std::string> conditions = GetEstuaryConditions();
+  ASSERT_FALSE(conditions.empty());
+
+  CTestInfoRegistry registry;
+  std::vector<InfoPtr> infos;
+  for (const auto &condition : conditions)
+  {
+    infos.push_back(registry.Register(condition));
+    ASSERT_TRUE(infos.back() != nullptr) << condition;
+  }
+
+  std::vector<std::string> leaves;
+  for (const auto &info : registry.m_bools)
+  {
+    if (info.first.find_first_of("|+[]!") == std::string::npos)
+      leaves.push_back(info.first);
+  }
+
+  const int frames = 200;
+  std::mt19937 random(1);
+  std::bernoulli_distribution value(0.5);
+  std::chrono::steady_clock::duration time(0);
+  unsigned int evaluations = 0;
+  for (int frame = 0; frame < frames; frame++)
+  {
+    for (const auto &leaf : leaves)
+      registry.m_values[leaf] = value(random);
+    registry.NextFrame();
+    registry.m_evaluations = 0;
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (const auto &info : infos)
+      info->Get();
+    time += std::chrono::steady_clock::now() - start;
+    evaluations += registry.m_evaluations;
+
+    if (frame % 20 == 0)
+    {
+      CReferenceEvaluator reference(registry.m_values);
+      for (size_t i = 0; i < infos.size(); i++)
+        ASSERT_EQ(reference.Evaluate(conditions[i]), infos[i]->Get()) << conditions[i];
+    }
+  }
+
+  std::cout << conditions.size() << " conditions, " << registry.m_bools.size() << " info bools, "
+            << leaves.size() << " leaves: "
+            << std::chrono::duration_cast<std::chrono::microseconds>(time).count() / frames
+            << " us and " << evaluations / frames << " evaluations per frame" << std::endl;
+}
@@ -29,8 +29,12 @@
 #include "pvr/epg/EpgInfoTag.h"
 #include "pvr/recordings/PVRRecordings.h"
 #include "cores/IPlayer.h"
+#include "cores/VideoPlayer/VideoRenderers/CaptureEncoder.h"
 #include "cores/playercorefactory/PlayerCoreFactory.h"
 #include "SeekHandler.h"
+#include "threads/Event.h"
+#include "threads/SingleLock.h"
+#include "utils/Base64.h"
 #include "utils/Variant.h"
 #include "Util.h"
 #include "settings/DisplaySettings.h"
@@ -273,6 +277,78 @@ JSONRPC_STATUS CPlayerOperations::GetItem(const std::string &method, ITransportL
   return OK;
 }
 
+namespace
+{
+// keeps the first frame of a capture stream
+class CScreenshotCallback : public ICaptureStreamCallback
+{
+public:
+  void OnCaptureFrame(unsigned int captureId, const SCaptureFrame &frame) override
+  {
+    CSingleLock lock(m_section);
+    if (m_frame.data.empty())
+    {
+      m_frame = frame;
+      m_event.Set();
+    }
+  }
+
+  bool Wait(unsigned int millis, SCaptureFrame &frame)
+  {
+    if (!m_event.WaitMSec(millis))
+      return false;
+    CSingleLock lock(m_section);
+    frame = std::move(m_frame);
+    return true;
+  }
+
+private:
+  CCriticalSection m_section;
+  CEvent m_event;
+  SCaptureFrame m_frame;
+};
+}
+
+JSONRPC_STATUS CPlayerOperations::GetScreenshot(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
+{
+  if (GetPlayer(parameterObject["playerid"]) != Video || !g_application.GetAppPlayer().IsRenderingVideo())
+    return FailedToExecute;
+
+  float aspectRatio = g_application.GetAppPlayer().GetRenderAspectRatio();
+  if (aspectRatio <= 0.0f)
+    return FailedToExecute;
+
+  unsigned int width = static_cast<unsigned int>(parameterObject["width"].asUnsignedInteger());
+  unsigned int height = static_cast<unsigned int>(width / aspectRatio);
+  if (height > width)
+  {
+    height = width;
+    width = static_cast<unsigned int>(height * aspectRatio);
+  }
+
+  // the encoder stream does the encoding on a job worker, the render thread
+  // only copies the pixels
+  CScreenshotCallback callback;
+  unsigned int captureId = g_application.GetAppPlayer().RenderCaptureStream(&callback, width, height, 1000,
+                                                                           parameterObject["format"].asString());
+  if (captureId == 0)
+    return FailedToExecute;
+
+  SCaptureFrame frame;
+  bool captured = callback.Wait(2000, frame);
+  // waits for the frames in progress, the callback isn't used afterwards
+  g_application.GetAppPlayer().RenderCaptureRelease(captureId);
+  if (!captured)
+    return FailedToExecute;
+
+  result["width"] = frame.width;
+  result["height"] = frame.height;
+  result["format"] = frame.format;
+  result["data"] = Base64::Encode(reinterpret_cast<const char*>(frame.data.data()),
+                                  static_cast<unsigned int>(frame.data.size()));
+  return OK;
+}
+
 JSONRPC_STATUS CPlayerOperations::PlayPause(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
 {
   CGUIWindowSlideShow *slideshow = NULL;
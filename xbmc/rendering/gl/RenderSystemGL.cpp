@@ -661,6 +661,14 @@ void CRenderSystemGL::InitialiseShaders()
     CLog::Log(LOGERROR, "GUI Shader gl_shader_frag_fonts.glsl - compile and link failed");
   }
 
+  m_pShader[SM_FONTS_SDF].reset(new CGLShader("gl_shader_frag_fonts_sdf.glsl", defines));
+  if (!m_pShader[SM_FONTS_SDF]->CompileAndLink())
+  {
+    m_pShader[SM_FONTS_SDF]->Free();
+    m_pShader[SM_FONTS_SDF].reset();
+    CLog::Log(LOGERROR, "GUI Shader gl_shader_frag_fonts_sdf.glsl - compile and link failed");
+  }
+
   m_pShader[SM_TEXTURE_NOBLEND].reset(new CGLShader("gl_shader_frag_texture_noblend.glsl", defines));
   if (!m_pShader[SM_TEXTURE_NOBLEND]->CompileAndLink())
   {
@@ -700,6 +708,10 @@ void CRenderSystemGL::ReleaseShaders()
     m_pShader[SM_FONTS]->Free();
   m_pShader[SM_FONTS].reset();
 
+  if (m_pShader[SM_FONTS_SDF])
+    m_pShader[SM_FONTS_SDF]->Free();
+  m_pShader[SM_FONTS_SDF].reset();
+
   if (m_pShader[SM_TEXTURE_NOBLEND])
     m_pShader[SM_TEXTURE_NOBLEND]->Free();
   m_pShader[SM_TEXTURE_NOBLEND].reset();
@@ -23,6 +23,7 @@ enum ESHADERMETHOD
   SM_TEXTURE_LIM,
   SM_MULTI,
   SM_FONTS,
+  SM_FONTS_SDF,
   SM_TEXTURE_NOBLEND,
   SM_MULTI_BLENDCOLOR,
   SM_MAX
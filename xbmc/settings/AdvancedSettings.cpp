@@ -176,6 +176,16 @@ void CAdvancedSettings::Initialize()
   m_videoFpsDetect = 1;
   m_maxTempo = 1.55f;
   m_videoPreferStereoStream = false;
+  m_videoLockFreeMessageQueue = false;
+  m_videoProbeCache = false;
+  m_videoProbeCacheSize = 4;
+  m_videoFastStart = false;
+  m_videoKeyframeIndex = false;
+  m_videoKeyframeIndexSize = 16;
+  m_videoRenderQueueDepth.clear();
+  m_videoFrameTimingDump = false;
+  m_videoFramePacing = false;
+  m_videoDecoderThreads.clear();
 
   m_mediacodecForceSoftwareRendering = false;
 
@@ -409,6 +419,13 @@ void CAdvancedSettings::Initialize()
   // the following setting determines the readRate of a player data
   // as multiply of the default data read rate
   m_cacheReadFactor = 4.0f;
+  // number of retained back windows, a non zero value selects CWindowedCache
+  m_cacheBackWindows = 0;
+  m_cacheLowWaterMark = 64 * 1024;
+  // concurrent range requests for http sources, 1 uses a single connection
+  m_cacheMaxConnections = 1;
+  // size of the persistent block cache for remote files in MiB, 0 disables it
+  m_cacheBlockCacheSize = 0;
 
   m_addonPackageFolderSize = 200;
 
@@ -421,6 +438,7 @@ void CAdvancedSettings::Initialize()
   m_guiVisualizeDirtyRegions = false;
   m_guiAlgorithmDirtyRegions = 3;
   m_guiSmartRedraw = false;
+  m_guiFontDistanceField = false;
   m_airTunesPort = 36666;
   m_airPlayPort = 36667;
 
@@ -740,6 +758,61 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetInt(pElement, "fpsdetect", m_videoFpsDetect, 0, 2);
     XMLUtils::GetFloat(pElement, "maxtempo", m_maxTempo, 1.5, 2.1);
     XMLUtils::GetBoolean(pElement, "preferstereostream", m_videoPreferStereoStream);
+    XMLUtils::GetBoolean(pElement, "lockfreemessagequeue", m_videoLockFreeMessageQueue);
+    XMLUtils::GetBoolean(pElement, "probecache", m_videoProbeCache);
+    XMLUtils::GetUInt(pElement, "probecachesize", m_videoProbeCacheSize);
+    XMLUtils::GetBoolean(pElement, "faststart", m_videoFastStart);
+    XMLUtils::GetBoolean(pElement, "keyframeindex", m_videoKeyframeIndex);
+    XMLUtils::GetUInt(pElement, "keyframeindexsize", m_videoKeyframeIndexSize);
+    XMLUtils::GetBoolean(pElement, "frametimingdump", m_videoFrameTimingDump);
+    XMLUtils::GetBoolean(pElement, "framepacing", m_videoFramePacing);
+
+    TiXmlElement* pDecoderThreads = pElement->FirstChildElement("decoderthreads");
+    if (pDecoderThreads)
+    {
+      TiXmlElement* pThreadsOverride = pDecoderThreads->FirstChildElement("override");
+      while (pThreadsOverride)
+      {
+        DecoderThreadsOverride override = {"", 0, -1, ""};
+        XMLUtils::GetString(pThreadsOverride, "codec", override.codec);
+        XMLUtils::GetInt(pThreadsOverride, "minheight", override.minheight, 0, 8640);
+        XMLUtils::GetInt(pThreadsOverride, "threads", override.threads, 0, 64);
+        XMLUtils::GetString(pThreadsOverride, "type", override.type);
+        StringUtils::ToLower(override.codec);
+        StringUtils::ToLower(override.type);
+
+        if (override.type.empty() || override.type == "frame" || override.type == "slice")
+          m_videoDecoderThreads.push_back(override);
+        else
+          CLog::Log(LOGWARNING, "Ignoring malformed decoder threads override, codec:%s type:%s",
+                    override.codec.c_str(), override.type.c_str());
+
+        pThreadsOverride = pThreadsOverride->NextSiblingElement("override");
+      }
+    }
+
+    // render queue depth per renderer, "default" is the renderer of software decoded video
+    TiXmlElement* pQueueDepth = pElement->FirstChildElement("renderqueuedepth");
+    if (pQueueDepth)
+    {
+      TiXmlElement* pDepthOverride = pQueueDepth->FirstChildElement("override");
+      while (pDepthOverride)
+      {
+        std::string renderer;
+        int depth = 0;
+        XMLUtils::GetString(pDepthOverride, "renderer", renderer);
+        XMLUtils::GetInt(pDepthOverride, "depth", depth, 0, 16);
+        StringUtils::ToLower(renderer);
+
+        if (!renderer.empty() && depth > 0)
+          m_videoRenderQueueDepth[renderer] = depth;
+        else
+          CLog::Log(LOGWARNING, "Ignoring malformed render queue depth override, renderer:%s depth:%d",
+                    renderer.c_str(), depth);
+
+        pDepthOverride = pDepthOverride->NextSiblingElement("override");
+      }
+    }
 
     // Store global display latency settings
     TiXmlElement* pVideoLatency = pElement->FirstChildElement("latency");
@@ -864,6 +937,10 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetUInt(pElement, "memorysize", m_cacheMemSize);
     XMLUtils::GetUInt(pElement, "buffermode", m_cacheBufferMode, 0, 4);
     XMLUtils::GetFloat(pElement, "readfactor", m_cacheReadFactor);
+    XMLUtils::GetUInt(pElement, "backwindows", m_cacheBackWindows, 0, 16);
+    XMLUtils::GetUInt(pElement, "lowwatermark", m_cacheLowWaterMark);
+    XMLUtils::GetUInt(pElement, "maxconnections", m_cacheMaxConnections, 1, 16);
+    XMLUtils::GetUInt(pElement, "blockcachesize", m_cacheBlockCacheSize);
   }
 
   pElement = pRootElement->FirstChildElement("jsonrpc");
@@ -1242,6 +1319,7 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetBoolean(pElement, "visualizedirtyregions", m_guiVisualizeDirtyRegions);
     XMLUtils::GetInt(pElement, "algorithmdirtyregions",     m_guiAlgorithmDirtyRegions);
     XMLUtils::GetBoolean(pElement, "smartredraw", m_guiSmartRedraw);
+    XMLUtils::GetBoolean(pElement, "fontdistancefield", m_guiFontDistanceField);
   }
 
   std::string seekSteps;
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <map>
 #include <set>
 #include <string>
 #include <utility>
@@ -92,6 +93,14 @@ struct RefreshOverride
 };
 
 
+struct DecoderThreadsOverride
+{
+  std::string codec; // ffmpeg decoder name, empty matches all
+  int minheight; // smallest coded height the override applies to
+  int threads; // 0 lets ffmpeg decide, -1 keeps the default
+  std::string type; // "frame", "slice" or empty for both
+};
+
 struct RefreshVideoLatency
 {
   float refreshmin;
@@ -174,6 +183,7 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     float m_videoAutoScaleMaxFps;
     std::vector<RefreshOverride> m_videoAdjustRefreshOverrides;
     std::vector<RefreshVideoLatency> m_videoRefreshLatency;
+    std::vector<DecoderThreadsOverride> m_videoDecoderThreads;
     float m_videoDefaultLatency;
     int  m_videoCaptureUseOcclusionQuery;
     bool m_DXVACheckCompatibility;
@@ -183,6 +193,15 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     bool m_mediacodecForceSoftwareRendering;
     float m_maxTempo;
     bool m_videoPreferStereoStream = false;
+    bool m_videoLockFreeMessageQueue = false;
+    bool m_videoProbeCache = false;
+    unsigned int m_videoProbeCacheSize = 4; //!< MiB of probe results kept
+    bool m_videoFastStart = false;
+    bool m_videoKeyframeIndex = false;
+    unsigned int m_videoKeyframeIndexSize = 16; //!< MiB of keyframe indexes kept
+    std::map<std::string, int> m_videoRenderQueueDepth; //!< renderer id -> depth, missing = renderer default
+    bool m_videoFrameTimingDump = false;
+    bool m_videoFramePacing = false;
 
     std::string m_videoDefaultPlayer;
     float m_videoPlayCountMinimumPercent;
@@ -343,11 +362,16 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     bool m_guiVisualizeDirtyRegions;
     int  m_guiAlgorithmDirtyRegions;
     bool m_guiSmartRedraw;
+    bool m_guiFontDistanceField;
     unsigned int m_addonPackageFolderSize;
 
     unsigned int m_cacheMemSize;
     unsigned int m_cacheBufferMode;
     float m_cacheReadFactor;
+    unsigned int m_cacheBackWindows;
+    unsigned int m_cacheLowWaterMark;
+    unsigned int m_cacheMaxConnections;
+    unsigned int m_cacheBlockCacheSize;
 
     bool m_jsonOutputCompact;
     unsigned int m_jsonTcpPort;
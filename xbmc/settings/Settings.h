@@ -308,6 +308,7 @@ public:
   static const std::string SETTING_AUDIOOUTPUT_MAINTAINORIGINALVOLUME;
   static const std::string SETTING_AUDIOOUTPUT_PROCESSQUALITY;
   static const std::string SETTING_AUDIOOUTPUT_ATEMPOTHRESHOLD;
+  static const std::string SETTING_AUDIOOUTPUT_LOWLATENCY;
   static const std::string SETTING_AUDIOOUTPUT_STREAMSILENCE;
   static const std::string SETTING_AUDIOOUTPUT_STREAMNOISE;
   static const std::string SETTING_AUDIOOUTPUT_GUISOUNDMODE;
@@ -14,6 +14,7 @@
 #include "ServiceBroker.h"
 #include "addons/Skin.h"
 #include "guilib/GUIComponent.h"
+#include "guilib/guiinfo/GUIInfoLabels.h"
 #include "settings/Settings.h"
 #include "settings/SettingsComponent.h"
 #include "threads/SingleLock.h"
@@ -49,6 +50,8 @@ const std::string& CSkinSettings::GetString(int setting) const
 void CSkinSettings::SetString(int setting, const std::string &label)
 {
   g_SkinInfo->SetString(setting, label);
+  InfoChanged(SKIN_STRING);
+  InfoChanged(SKIN_STRING_IS_EQUAL);
 }
 
 int CSkinSettings::TranslateBool(const std::string &setting)
@@ -64,11 +67,15 @@ bool CSkinSettings::GetBool(int setting) const
 void CSkinSettings::SetBool(int setting, bool set)
 {
   g_SkinInfo->SetBool(setting, set);
+  InfoChanged(SKIN_BOOL);
 }
 
 void CSkinSettings::Reset(const std::string &setting)
 {
   g_SkinInfo->Reset(setting);
+  InfoChanged(SKIN_BOOL);
+  InfoChanged(SKIN_STRING);
+  InfoChanged(SKIN_STRING_IS_EQUAL);
 }
 
 void CSkinSettings::Reset()
@@ -80,6 +87,13 @@ void CSkinSettings::Reset()
   infoMgr.GetInfoProviders().GetGUIControlsInfoProvider().ResetContainerMovingCache();
 }
 
+void CSkinSettings::InfoChanged(int info)
+{
+  CGUIComponent *gui = CServiceBroker::GetGUI();
+  if (gui)
+    gui->GetInfoManager().GetInfoProviders().InfoChanged(info);
+}
+
 bool CSkinSettings::Load(const TiXmlNode *settings)
 {
   if (settings == nullptr)
@@ -46,6 +46,8 @@ protected:
   ~CSkinSettings() override;
 
 private:
+  static void InfoChanged(int info);
+
   CCriticalSection m_critical;
   std::set<ADDON::CSkinSettingPtr> m_settings;
 };
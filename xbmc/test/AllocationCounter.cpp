@@ -0,0 +1,88 @@
+/*
+ *  Copyright (C) 2019 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "AllocationCounter.h"
+#include "threads/Thread.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+thread_local bool threadCounting = false;
+thread_local unsigned int threadAllocations = 0;
+std::atomic<bool> threadsCounting(false);
+std::atomic<unsigned int> threadsAllocations(0);
+std::vector<std::string> countedThreads;
+
+bool IsCountedThread()
+{
+  const CThread* thread = CThread::GetCurrentThread();
+  if (!thread)
+    return false;
+  for (const std::string& name : countedThreads)
+  {
+    if (thread->GetName() == name)
+      return true;
+  }
+  return false;
+}
+
+void* Allocate(std::size_t size)
+{
+  if (threadCounting)
+    threadAllocations++;
+  if (threadsCounting.load(std::memory_order_acquire) && IsCountedThread())
+    threadsAllocations.fetch_add(1, std::memory_order_relaxed);
+
+  void* ptr = std::malloc(size ? size : 1);
+  if (!ptr)
+    throw std::bad_alloc();
+  return ptr;
+}
+}
+
+void* operator new(std::size_t size)
+{
+  return Allocate(size);
+}
+
+void* operator new[](std::size_t size)
+{
+  return Allocate(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+  std::free(ptr);
+}
+
+unsigned int CAllocationCounter::CountThread(const std::function<void()>& func)
+{
+  threadAllocations = 0;
+  threadCounting = true;
+  func();
+  threadCounting = false;
+  return threadAllocations;
+}
+
+unsigned int CAllocationCounter::CountThreads(const std::vector<std::string>& names, const std::function<void()>& func)
+{
+  countedThreads = names;
+  threadsAllocations = 0;
+  threadsCounting = true;
+  func();
+  threadsCounting = false;
+  return threadsAllocations;
+}
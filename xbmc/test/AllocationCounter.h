@@ -0,0 +1,27 @@
+/*
+ *  Copyright (C) 2019 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+/* Counts the heap allocations made through operator new. Only available in
+ * the alloc-test binary, which replaces the global operator new and delete
+ * for itself; the tests of it are listed as ALLOC_SOURCES.
+ */
+class CAllocationCounter
+{
+public:
+  /* Allocations of the calling thread while func runs. */
+  static unsigned int CountThread(const std::function<void()>& func);
+
+  /* Allocations of the CThreads with the given names while func runs. */
+  static unsigned int CountThreads(const std::vector<std::string>& names, const std::function<void()>& func);
+};
@@ -0,0 +1,114 @@
+/*
+ *  Copyright (C) 2019 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace XbmcThreads
+{
+  /**
+   * Bounded, lock free queue for exactly one producer and one consumer
+   *  thread. TryPush may only be called by the producer, TryPop and Peek
+   *  only by the consumer. Empty and Size can be called from both sides
+   *  and give a snapshot.
+   */
+  template <typename T> class CSPSCQueue
+  {
+  public:
+    /**
+     * capacity is rounded up to the next power of two
+     */
+    explicit CSPSCQueue(size_t capacity)
+    {
+      size_t size = 2;
+      while (size < capacity)
+        size <<= 1;
+      m_items.resize(size);
+      m_mask = size - 1;
+    }
+
+    CSPSCQueue(const CSPSCQueue&) = delete;
+    CSPSCQueue& operator=(const CSPSCQueue&) = delete;
+
+    bool TryPush(T item)
+    {
+      const size_t head = m_head.load(std::memory_order_relaxed);
+      if (head - m_tail.load(std::memory_order_acquire) > m_mask)
+        return false;
+
+      m_items[head & m_mask] = std::move(item);
+      // seq_cst so that a following load of a consumer "waiting" flag can't be
+      // reordered before the publication of the item
+      m_head.store(head + 1, std::memory_order_seq_cst);
+      return true;
+    }
+
+    bool TryPop(T& item)
+    {
+      const size_t tail = m_tail.load(std::memory_order_relaxed);
+      if (tail == m_head.load(std::memory_order_acquire))
+        return false;
+
+      item = std::move(m_items[tail & m_mask]);
+      m_items[tail & m_mask] = T();
+      m_tail.store(tail + 1, std::memory_order_release);
+      return true;
+    }
+
+    /**
+     * Oldest item or nullptr if the queue is empty. The pointer is valid
+     *  until the next TryPop.
+     */
+    T* Peek()
+    {
+      const size_t tail = m_tail.load(std::memory_order_relaxed);
+      if (tail == m_head.load(std::memory_order_acquire))
+        return nullptr;
+      return &m_items[tail & m_mask];
+    }
+
+    bool Empty() const
+    {
+      const size_t tail = m_tail.load(std::memory_order_seq_cst);
+      return m_head.load(std::memory_order_seq_cst) == tail;
+    }
+
+    size_t Size() const
+    {
+      // load tail first, it can only move towards head
+      const size_t tail = m_tail.load(std::memory_order_acquire);
+      return m_head.load(std::memory_order_acquire) - tail;
+    }
+
+    size_t Capacity() const { return m_mask + 1; }
+
+    /**
+     * Call f for every queued item, oldest first. The caller must make sure
+     *  that the consumer does not pop concurrently.
+     */
+    template <typename F> void Visit(F f) const
+    {
+      const size_t tail = m_tail.load(std::memory_order_relaxed);
+      const size_t head = m_head.load(std::memory_order_acquire);
+      for (size_t pos = tail; pos != head; ++pos)
+        f(m_items[pos & m_mask]);
+    }
+
+  private:
+    std::vector<T> m_items;
+    size_t m_mask;
+
+    // keep producer and consumer positions on separate cache lines
+    alignas(64) std::atomic<size_t> m_head{0};
+    alignas(64) std::atomic<size_t> m_tail{0};
+  };
+}
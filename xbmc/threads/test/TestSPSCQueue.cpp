@@ -0,0 +1,107 @@
+/*
+ *  Copyright (C) 2019 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "threads/SPSCQueue.h"
+#include "threads/IRunnable.h"
+
+#include "threads/test/TestHelpers.h"
+
+using namespace XbmcThreads;
+
+//=============================================================================
+// Helper classes
+//=============================================================================
+
+class producer : public IRunnable
+{
+  CSPSCQueue<int>& queue;
+  int count;
+public:
+  producer(CSPSCQueue<int>& q, int n) : queue(q), count(n) {}
+
+  void Run() override
+  {
+    for (int i = 0; i < count; )
+    {
+      if (queue.TryPush(i))
+        i++;
+    }
+  }
+};
+
+//=============================================================================
+
+TEST(TestSPSCQueue, CapacityRoundsUp)
+{
+  CSPSCQueue<int> queue(5);
+  EXPECT_EQ(8u, queue.Capacity());
+}
+
+TEST(TestSPSCQueue, PushPopOrder)
+{
+  CSPSCQueue<int> queue(4);
+  EXPECT_TRUE(queue.Empty());
+  EXPECT_EQ(nullptr, queue.Peek());
+
+  for (int i = 0; i < 4; i++)
+    EXPECT_TRUE(queue.TryPush(i));
+  EXPECT_FALSE(queue.TryPush(4));
+  EXPECT_EQ(4u, queue.Size());
+
+  int sum = 0;
+  queue.Visit([&sum](const int& item) { sum += item; });
+  EXPECT_EQ(6, sum);
+
+  int item;
+  for (int i = 0; i < 4; i++)
+  {
+    ASSERT_NE(nullptr, queue.Peek());
+    EXPECT_EQ(i, *queue.Peek());
+    EXPECT_TRUE(queue.TryPop(item));
+    EXPECT_EQ(i, item);
+  }
+  EXPECT_FALSE(queue.TryPop(item));
+  EXPECT_TRUE(queue.Empty());
+}
+
+TEST(TestSPSCQueue, Wraparound)
+{
+  CSPSCQueue<int> queue(4);
+  int item;
+  for (int i = 0; i < 100; i++)
+  {
+    EXPECT_TRUE(queue.TryPush(i));
+    EXPECT_TRUE(queue.TryPush(i + 1000));
+    EXPECT_TRUE(queue.TryPop(item));
+    EXPECT_EQ(i, item);
+    EXPECT_TRUE(queue.TryPop(item));
+    EXPECT_EQ(i + 1000, item);
+  }
+}
+
+TEST(TestSPSCQueue, ProducerConsumer)
+{
+  const int count = 100000;
+  CSPSCQueue<int> queue(64);
+  producer p(queue, count);
+  thread waitThread(p);
+
+  int expected = 0;
+  while (expected < count)
+  {
+    int item;
+    if (queue.TryPop(item))
+    {
+      ASSERT_EQ(expected, item);
+      expected++;
+    }
+  }
+
+  waitThread.join();
+  EXPECT_TRUE(queue.Empty());
+}
@@ -10,6 +10,7 @@
 #include "threads/Event.h"
 
 #include <cstring>
+#include <queue>
 
 using namespace Actor;
 
@@ -72,6 +73,27 @@ bool Message::Reply(int sig, void *data /* = NULL*/, size_t size /* = 0 */)
   return true;
 }
 
+void MessageQueue::push(Message *msg)
+{
+  if (m_size == m_ring.size())
+  {
+    std::vector<Message*> ring(m_ring.empty() ? 16 : m_ring.size() * 2);
+    for (size_t i = 0; i < m_size; i++)
+      ring[i] = m_ring[(m_head + i) % m_ring.size()];
+    m_ring.swap(ring);
+    m_head = 0;
+  }
+
+  m_ring[(m_head + m_size) % m_ring.size()] = msg;
+  m_size++;
+}
+
+void MessageQueue::pop()
+{
+  m_head = (m_head + 1) % m_ring.size();
+  m_size--;
+}
+
 Protocol::~Protocol()
 {
   Message *msg;
@@ -11,9 +11,9 @@
 #include "threads/CriticalSection.h"
 
 #include <cstddef>
-#include <queue>
 #include <memory>
 #include <string>
+#include <vector>
 
 class CEvent;
 
@@ -68,6 +68,24 @@ private:
     :origin(_origin) {}
 };
 
+/**
+ * fifo of messages, a ring that only grows. std::queue allocates and frees a
+ * node every few messages passing through it
+ */
+class MessageQueue
+{
+public:
+  bool empty() const { return m_size == 0; }
+  Message* front() const { return m_ring[m_head]; }
+  void push(Message *msg);
+  void pop();
+
+private:
+  std::vector<Message*> m_ring;
+  size_t m_head = 0;
+  size_t m_size = 0;
+};
+
 class Protocol
 {
 public:
@@ -98,9 +116,9 @@ public:
 protected:
   CEvent *containerInEvent, *containerOutEvent;
   CCriticalSection criticalSection;
-  std::queue<Message*> outMessages;
-  std::queue<Message*> inMessages;
-  std::queue<Message*> freeMessageQueue;
+  MessageQueue outMessages;
+  MessageQueue inMessages;
+  MessageQueue freeMessageQueue;
   bool inDefered = false, outDefered = false;
 };
 
@@ -25,6 +25,7 @@
 #define HEADER_CONTENT_RANGE_FORMAT_BYTES   "bytes " HEADER_CONTENT_RANGE_VALUE "-" HEADER_CONTENT_RANGE_VALUE "/"
 #define CONTENT_RANGE_FORMAT_TOTAL          HEADER_CONTENT_RANGE_FORMAT_BYTES HEADER_CONTENT_RANGE_VALUE
 #define CONTENT_RANGE_FORMAT_TOTAL_UNKNOWN  HEADER_CONTENT_RANGE_FORMAT_BYTES HEADER_CONTENT_RANGE_VALUE_UNKNOWN
+#define RANGE_FORMAT_BYTES                  "bytes=" HEADER_CONTENT_RANGE_VALUE "-" HEADER_CONTENT_RANGE_VALUE
 
 CHttpRange::CHttpRange(uint64_t firstPosition, uint64_t lastPosition)
   : m_first(firstPosition),
@@ -355,6 +356,14 @@ std::string HttpRangeUtils::GenerateContentRangeHeaderValue(uint64_t start, uint
   return StringUtils::Format(CONTENT_RANGE_FORMAT_TOTAL_UNKNOWN, start, end);
 }
 
+std::string HttpRangeUtils::GenerateRangeHeaderValue(const CHttpRange* range)
+{
+  if (range == NULL || !range->IsValid())
+    return "";
+
+  return StringUtils::Format(RANGE_FORMAT_BYTES, range->GetFirstPosition(), range->GetLastPosition());
+}
+
 #ifdef HAS_WEB_SERVER
 
 std::string HttpRangeUtils::GenerateMultipartBoundary()
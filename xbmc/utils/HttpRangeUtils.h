@@ -124,6 +124,15 @@ public:
   */
   static std::string GenerateContentRangeHeaderValue(uint64_t start, uint64_t end, uint64_t total);
 
+  /*!
+  * \brief Generates a valid Range HTTP request header value for the given
+  * HTTP range definition.
+  *
+  * \param range HTTP range definition used to generate the Range HTTP header
+  * \return Range HTTP header value
+  */
+  static std::string GenerateRangeHeaderValue(const CHttpRange* range);
+
 #ifdef HAS_WEB_SERVER
   /*!
    * \brief Generates a multipart boundary that can be used in ranged HTTP
@@ -885,3 +885,18 @@ TEST(TestHttpRanges, ParseUnorderedOverlapping)
   EXPECT_TRUE(ranges.Get(1, range));
   EXPECT_EQ(range2_4, range);
 }
+
+TEST(TestHttpRangeUtils, GenerateRangeHeaderValue)
+{
+  EXPECT_STREQ("", HttpRangeUtils::GenerateRangeHeaderValue(NULL).c_str());
+
+  CHttpRange invalid;
+  EXPECT_STREQ("", HttpRangeUtils::GenerateRangeHeaderValue(&invalid).c_str());
+
+  CHttpRange range(0, 1023);
+  EXPECT_STREQ(RANGES_START "0-1023", HttpRangeUtils::GenerateRangeHeaderValue(&range).c_str());
+
+  range.SetFirstPosition(2097152);
+  range.SetLastPosition(4194303);
+  EXPECT_STREQ(RANGES_START "2097152-4194303", HttpRangeUtils::GenerateRangeHeaderValue(&range).c_str());
+}
@@ -20,6 +20,8 @@
 #include "Application.h"
 #include "VideoSyncOML.h"
 
+#include "cores/AudioEngine/Sinks/AESinkNULL.h"
+#include "cores/AudioEngine/Sinks/AESinkWAV.h"
 #include "cores/RetroPlayer/process/X11/RPProcessInfoX11.h"
 #include "cores/RetroPlayer/rendering/VideoRenderers/RPRendererOpenGL.h"
 #include "cores/VideoPlayer/DVDCodecs/DVDFactoryCodec.h"
@@ -59,6 +61,14 @@ CWinSystemX11GLContext::CWinSystemX11GLContext()
   {
     OPTIONALS::SndioRegister();
   }
+  else if (StringUtils::EqualsNoCase(envSink, "NULL"))
+  {
+    CAESinkNULL::Register();
+  }
+  else if (StringUtils::EqualsNoCase(envSink, "WAV"))
+  {
+    CAESinkWAV::Register();
+  }
   else
   {
     if (!OPTIONALS::PulseAudioRegister())